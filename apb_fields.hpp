@@ -0,0 +1,319 @@
+#pragma once
+
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+#include "registers.hpp"
+
+/**
+ * @brief A register field whose position and width are known at compile time,
+ * so get() and set() compile to one constant mask and shift.
+ */
+template <unsigned Position, unsigned Width>
+struct BitField
+{
+    static_assert(Width >= 1 && Position + Width <= 32, "field must lie within a 32-bit register");
+
+    static constexpr unsigned position{Position};
+    static constexpr unsigned width{Width};
+    static constexpr uint32_t mask{static_cast<uint32_t>((uint64_t{1} << Width) - 1) << Position};
+
+    [[nodiscard]] static constexpr uint32_t get(uint32_t const reg)
+    {
+        return (reg & mask) >> Position;
+    }
+
+    [[nodiscard]] static constexpr uint32_t set(uint32_t const reg, uint32_t const field)
+    {
+        return (reg & ~mask) | ((field << Position) & mask);
+    }
+};
+
+/**
+ * @brief Field layouts of the Juno APB system registers.
+ *
+ * Only layouts with a documented source are described: SYS_ID and
+ * SYS_PROC_ID0/1, from the register descriptions in the APB system registers
+ * chapter of the Juno r1 ARM Development Platform Technical Reference Manual.
+ * The original board and LogicTile decoders used the same layouts. Every other
+ * APB register is printed as a raw value.
+ */
+namespace apb_fields
+{
+
+namespace sys_id
+{
+using Rev = BitField<28, 4>;
+using Hbi = BitField<16, 10>;
+using Build = BitField<12, 3>;
+using Arch = BitField<8, 3>;
+using Fpga = BitField<0, 7>; // BCD
+} // namespace sys_id
+
+namespace sys_proc_id
+{
+using AppNote = BitField<24, 8>;
+using Rev = BitField<20, 4>;
+using Variant = BitField<16, 4>;
+using Hbi = BitField<0, 12>;
+} // namespace sys_proc_id
+
+} // namespace apb_fields
+
+/**
+ * @brief SYS_ID, decoded.
+ */
+struct SysId
+{
+    uint32_t rev;
+    uint32_t hbi;
+    uint32_t build;
+    uint32_t arch;
+    uint32_t fpga;
+
+    [[nodiscard]] static constexpr SysId decode(uint32_t const value)
+    {
+        using namespace apb_fields::sys_id;
+        return SysId{Rev::get(value), Hbi::get(value), Build::get(value), Arch::get(value), Fpga::get(value)};
+    }
+};
+
+/**
+ * @brief SYS_PROC_ID0 / SYS_PROC_ID1 (one per LogicTile site), decoded.
+ */
+struct SysProcId
+{
+    uint32_t app_note;
+    uint32_t rev;
+    uint32_t variant;
+    uint32_t hbi;
+
+    [[nodiscard]] static constexpr SysProcId decode(uint32_t const value)
+    {
+        using namespace apb_fields::sys_proc_id;
+        return SysProcId{AppNote::get(value), Rev::get(value), Variant::get(value), Hbi::get(value)};
+    }
+};
+
+static_assert(SysId::decode(0x2ab5c3f9).rev == 0x2 && SysId::decode(0x2ab5c3f9).hbi == 0x2b5 &&
+                  SysId::decode(0x2ab5c3f9).build == 0x4 && SysId::decode(0x2ab5c3f9).fpga == 0x79,
+              "SYS_ID field layout");
+static_assert(SysProcId::decode(0x14220225).app_note == 0x14 && SysProcId::decode(0x14220225).hbi == 0x225,
+              "SYS_PROC_ID field layout");
+
+/**
+ * @brief Appends text and numbers to a caller-provided buffer without allocating.
+ *
+ * Writes stop at the end of the buffer; end() then returns nullptr, in the
+ * spirit of std::to_chars reporting errc::value_too_large.
+ */
+class FieldWriter
+{
+public:
+    FieldWriter(char *const first, char *const last) : m_next(first), m_last(last)
+    {
+    }
+
+    FieldWriter &text(char const *const string)
+    {
+        size_t const length{std::strlen(string)};
+        if (m_next && static_cast<size_t>(m_last - m_next) >= length)
+        {
+            std::memcpy(m_next, string, length);
+            m_next += length;
+        }
+        else
+        {
+            m_next = nullptr;
+        }
+        return *this;
+    }
+
+    // Appends [first, last); a null 'last' (a failed format) fails the writer too
+    FieldWriter &text(char const *const first, char const *const last)
+    {
+        if (m_next && last && m_last - m_next >= last - first)
+        {
+            std::memcpy(m_next, first, static_cast<size_t>(last - first));
+            m_next += last - first;
+        }
+        else
+        {
+            m_next = nullptr;
+        }
+        return *this;
+    }
+
+    FieldWriter &character(char const c)
+    {
+        if (m_next && m_next != m_last)
+        {
+            *m_next++ = c;
+        }
+        else
+        {
+            m_next = nullptr;
+        }
+        return *this;
+    }
+
+    FieldWriter &number(uint32_t const value, int const base = 10)
+    {
+        if (m_next)
+        {
+            std::to_chars_result const result{std::to_chars(m_next, m_last, value, base)};
+            m_next = result.ec == std::errc{} ? result.ptr : nullptr;
+        }
+        return *this;
+    }
+
+    // Zero-padded to 'digits' hex digits, as register dumps print them
+    FieldWriter &hex(uint32_t const value, unsigned const digits)
+    {
+        static constexpr char DIGITS[]{"0123456789abcdef"};
+        if (m_next && static_cast<size_t>(m_last - m_next) >= digits)
+        {
+            for (unsigned digit{0}; digit < digits; ++digit)
+            {
+                m_next[digit] = DIGITS[(value >> (4 * (digits - 1 - digit))) & 0xf];
+            }
+            m_next += digits;
+        }
+        else
+        {
+            m_next = nullptr;
+        }
+        return *this;
+    }
+
+    /**
+     * @brief One past the last character written, or nullptr if the buffer was too small.
+     */
+    [[nodiscard]] char *end() const
+    {
+        return m_next;
+    }
+
+private:
+    char *m_next;
+    char *const m_last;
+};
+
+// Enough for the longest decode of any APB register
+constexpr size_t APB_DECODE_BYTES{128};
+
+[[nodiscard]] constexpr char const *board_revision_name(uint32_t const rev)
+{
+    switch (rev)
+    {
+    case 0x0:
+        return "Rev A (Prototype Juno r0)";
+    case 0x1:
+        return "Rev B (Juno r0)";
+    case 0x2:
+        return "Rev C (Juno r1)";
+    case 0x3:
+        return "Rev D (Juno r2)";
+    default:
+        return "Unknown";
+    }
+}
+
+/**
+ * @brief Formats SYS_ID as board revision, HBI, build variant, bus architecture and FPGA build.
+ * @return One past the last character written, or nullptr if [first, last) is too small.
+ */
+inline char *format_board_info(uint32_t const sys_id, char *const first, char *const last)
+{
+    SysId const id{SysId::decode(sys_id)};
+    return FieldWriter(first, last)
+        .text(board_revision_name(id.rev))
+        .text(" HBI")
+        .number(id.hbi, 16)
+        .text(", Board Build Variant: ")
+        .number(id.build, 16)
+        .text(", IOFPGA Bus Arch: ")
+        .text(id.arch == 0x4 ? "AHB" : "AXI")
+        .text(", FPGA Build (BCD): ")
+        .number(id.fpga, 16)
+        .end();
+}
+
+/**
+ * @brief Formats SYS_PROC_IDn as FPGA image, board revision and variant letters, and HBI.
+ * @return One past the last character written, or nullptr if [first, last) is too small.
+ */
+inline char *format_logictile_info(uint32_t const sys_proc_id, char *const first, char *const last)
+{
+    SysProcId const id{SysProcId::decode(sys_proc_id)};
+    return FieldWriter(first, last)
+        .text("FPGA Image: ")
+        .number(id.app_note)
+        .text(", Board Revision: ")
+        .character(static_cast<char>(id.rev + 'A'))
+        .text(", Board Build Variant: ")
+        .character(static_cast<char>(id.variant + 'A'))
+        .text(", HBI")
+        .number(id.hbi, 16)
+        .end();
+}
+
+/**
+ * @brief Formats the decoded fields of any APB register that has them.
+ * @param offset The register's byte offset.
+ * @param value The value read from it.
+ * @return One past the last character written; 'first' itself if the register
+ * has no fields to decode; nullptr if [first, last) is too small.
+ */
+inline char *format_apb_register(uint32_t const offset, uint32_t const value, char *const first, char *const last)
+{
+    switch (offset)
+    {
+    case APBRegister::SYS_ID:
+        return format_board_info(value, first, last);
+    case APBRegister::SYS_PROC_ID0:
+    case APBRegister::SYS_PROC_ID1:
+        return format_logictile_info(value, first, last);
+    case APBRegister::SYS_MISC:
+    {
+        // No documented field names: list the bits that are set
+        FieldWriter writer(first, last);
+        writer.text(value ? "Bits set:" : "No bits set");
+        for (unsigned bit{0}; bit < 32; ++bit)
+        {
+            if ((value >> bit) & 1)
+            {
+                writer.character(' ').number(bit);
+            }
+        }
+        return writer.end();
+    }
+    default:
+        return first;
+    }
+}
+
+/**
+ * @brief Formats a snapshot of every APB register, one "NAME = 0xVALUE  decoded" line each.
+ * @param values One value per APBRegister, in APBRegister::_values() order.
+ * @return One past the last character written, or nullptr if [first, last) is too small.
+ */
+inline char *format_apb_snapshot(uint32_t const *const values, char *const first, char *const last)
+{
+    FieldWriter writer(first, last);
+    char decoded[APB_DECODE_BYTES];
+    for (size_t index{0}; index < APBRegister::_size(); ++index)
+    {
+        APBRegister const reg{APBRegister::_values()[index]};
+        writer.text(reg._to_string()).text(" = 0x").hex(values[index], 8);
+        char const *const decoded_end{format_apb_register(reg, values[index], decoded, decoded + sizeof(decoded))};
+        if (decoded_end != decoded)
+        {
+            writer.text("  ").text(decoded, decoded_end);
+        }
+        writer.character('\n');
+    }
+    return writer.end();
+}
@@ -0,0 +1,389 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#if !defined(AXI_BANDWIDTH_NO_SIMD) && defined(__SSE2__)
+#include <emmintrin.h>
+#define AXI_BANDWIDTH_SSE2 1
+#elif !defined(AXI_BANDWIDTH_NO_SIMD) && defined(__ARM_NEON)
+#include <arm_neon.h>
+#define AXI_BANDWIDTH_NEON 1
+#endif
+
+/**
+ * @brief Read and write sweeps over a mapped region, for characterising the
+ * bandwidth of the LogicTile AXI window (or, on a build host, of RAM).
+ *
+ * Every sweep touches the whole region once per pass, in one of three orders,
+ * at one access width:
+ *   Sequential  ascending addresses
+ *   Strided     every STRIDE bytes, then again one access further on, until all are covered
+ *   Random      a full-period LCG over the accesses, so each is still made exactly once
+ * Widths are single volatile loads/stores of 8 to 64 bits, 128-bit vector
+ * loads/stores (SSE2 movdqa, or NEON ld1/st1), and memcpy: of the whole
+ * region for Sequential, or of 64-byte lines otherwise. With several threads,
+ * each sweeps its own slice of the region and all start together.
+ *
+ * Define AXI_BANDWIDTH_NO_SIMD to leave out the 128-bit sweeps.
+ */
+
+enum class AccessPattern : uint8_t
+{
+    Sequential,
+    Strided,
+    Random
+};
+
+enum class AccessDirection : uint8_t
+{
+    Read,
+    Write
+};
+
+namespace axi_bandwidth_detail
+{
+
+constexpr uint64_t LCG_MULTIPLIER{6364136223846793005ull}; // 1 mod 4, so any odd increment gives a full period mod 2^k
+constexpr size_t MEMCPY_LINE{64};
+
+/**
+ * @brief Calls visit(offset) for each 'width'-byte access to [0, bytes) in 'pattern' order.
+ */
+template <typename Visit>
+inline void for_each_offset(AccessPattern const pattern, size_t const bytes, size_t const width, size_t const stride, Visit &&visit)
+{
+    size_t const count{bytes / width};
+    switch (pattern)
+    {
+    case AccessPattern::Sequential:
+        for (size_t i{0}; i < count; ++i)
+        {
+            visit(i * width);
+        }
+        break;
+    case AccessPattern::Strided:
+    {
+        size_t const step{std::max<size_t>(stride / width, 1)};
+        for (size_t start{0}; start < step; ++start)
+        {
+            for (size_t i{start}; i < count; i += step)
+            {
+                visit(i * width);
+            }
+        }
+        break;
+    }
+    case AccessPattern::Random:
+    {
+        // Indices past 'count' are skipped, which costs at most one extra LCG step per access
+        size_t period{1};
+        while (period < count)
+        {
+            period <<= 1;
+        }
+        uint64_t index{0};
+        for (size_t step{0}; step < period; ++step)
+        {
+            index = (index * LCG_MULTIPLIER + 1) & (period - 1);
+            if (index < count)
+            {
+                visit(static_cast<size_t>(index) * width);
+            }
+        }
+        break;
+    }
+    }
+}
+
+template <typename T>
+uint64_t sweep_scalar(char *const base, size_t const bytes, AccessPattern const pattern, AccessDirection const direction,
+                      size_t const stride)
+{
+    uint64_t sum{0};
+    if (direction == AccessDirection::Read)
+    {
+        for_each_offset(pattern, bytes, sizeof(T), stride,
+                        [&](size_t const offset) { sum ^= *reinterpret_cast<T volatile *>(base + offset); });
+    }
+    else
+    {
+        for_each_offset(pattern, bytes, sizeof(T), stride,
+                        [&](size_t const offset) { *reinterpret_cast<T volatile *>(base + offset) = static_cast<T>(offset); });
+    }
+    return sum;
+}
+
+#if defined(AXI_BANDWIDTH_SSE2)
+inline uint64_t sweep_vector(char *const base, size_t const bytes, AccessPattern const pattern, AccessDirection const direction,
+                             size_t const stride)
+{
+    __m128i sum{_mm_setzero_si128()};
+    if (direction == AccessDirection::Read)
+    {
+        for_each_offset(pattern, bytes, 16, stride, [&](size_t const offset)
+        {
+            sum = _mm_xor_si128(sum, _mm_load_si128(reinterpret_cast<__m128i const *>(base + offset)));
+        });
+    }
+    else
+    {
+        for_each_offset(pattern, bytes, 16, stride, [&](size_t const offset)
+        {
+            _mm_store_si128(reinterpret_cast<__m128i *>(base + offset), _mm_set1_epi64x(static_cast<long long>(offset)));
+        });
+    }
+    alignas(16) uint64_t lanes[2];
+    _mm_store_si128(reinterpret_cast<__m128i *>(lanes), sum);
+    return lanes[0] ^ lanes[1];
+}
+#elif defined(AXI_BANDWIDTH_NEON)
+inline uint64_t sweep_vector(char *const base, size_t const bytes, AccessPattern const pattern, AccessDirection const direction,
+                             size_t const stride)
+{
+    uint8x16_t sum{vdupq_n_u8(0)};
+    if (direction == AccessDirection::Read)
+    {
+        for_each_offset(pattern, bytes, 16, stride, [&](size_t const offset)
+        {
+            sum = veorq_u8(sum, vld1q_u8(reinterpret_cast<uint8_t const *>(base + offset)));
+        });
+    }
+    else
+    {
+        for_each_offset(pattern, bytes, 16, stride, [&](size_t const offset)
+        {
+            vst1q_u8(reinterpret_cast<uint8_t *>(base + offset), vreinterpretq_u8_u64(vdupq_n_u64(offset)));
+        });
+    }
+    uint64x2_t const lanes{vreinterpretq_u64_u8(sum)};
+    return vgetq_lane_u64(lanes, 0) ^ vgetq_lane_u64(lanes, 1);
+}
+#endif
+
+inline uint64_t sweep_memcpy(char *const base, size_t const bytes, AccessPattern const pattern, AccessDirection const direction,
+                             size_t const stride, std::vector<char> &buffer)
+{
+    if (pattern == AccessPattern::Sequential)
+    {
+        if (direction == AccessDirection::Read)
+        {
+            std::memcpy(buffer.data(), base, bytes);
+        }
+        else
+        {
+            std::memcpy(base, buffer.data(), bytes);
+        }
+    }
+    else if (direction == AccessDirection::Read)
+    {
+        for_each_offset(pattern, bytes, MEMCPY_LINE, stride, [&](size_t const offset)
+        {
+            std::memcpy(buffer.data(), base + offset, MEMCPY_LINE);
+            asm volatile("" : : "r"(buffer.data()) : "memory"); // Keep every copy, not just the last
+        });
+    }
+    else
+    {
+        for_each_offset(pattern, bytes, MEMCPY_LINE, stride,
+                        [&](size_t const offset) { std::memcpy(base + offset, buffer.data(), MEMCPY_LINE); });
+    }
+    return static_cast<unsigned char>(buffer[0]);
+}
+
+} // namespace axi_bandwidth_detail
+
+/**
+ * @brief Runs the sweeps over one mapped region and reports GB/s and time per access.
+ */
+class AxiBandwidth
+{
+public:
+    static constexpr size_t DEFAULT_STRIDE{256};
+    static constexpr std::chrono::milliseconds DEFAULT_TEST_TIME{100};
+
+    struct Result
+    {
+        AccessPattern pattern;
+        AccessDirection direction;
+        char const *width; // "8-bit" ... "128-bit", or "memcpy"
+        size_t access_bytes;
+        unsigned threads;
+        double gb_per_s;
+        double ns_per_access; // Per thread: how long each of its accesses took on average
+    };
+
+    /**
+     * @param region The mapped memory to sweep (contents are overwritten by the write sweeps).
+     * @param bytes Size of the region; each thread's slice is a multiple of 64 bytes.
+     * @param stride Distance between consecutive Strided accesses (a multiple of 64).
+     */
+    AxiBandwidth(void *const region, size_t const bytes, size_t const stride = DEFAULT_STRIDE)
+        : m_region(static_cast<char *>(region)), m_bytes(bytes), m_stride(stride)
+    {
+        if (reinterpret_cast<uintptr_t>(region) % axi_bandwidth_detail::MEMCPY_LINE != 0 || bytes < axi_bandwidth_detail::MEMCPY_LINE)
+        {
+            throw std::runtime_error("Error: bandwidth region must be 64-byte aligned and at least 64 bytes.");
+        }
+        if (stride == 0 || stride % axi_bandwidth_detail::MEMCPY_LINE != 0)
+        {
+            throw std::runtime_error("Error: bandwidth stride " + std::to_string(stride) + " is not a multiple of 64 bytes.");
+        }
+    }
+
+    /**
+     * @brief Runs every pattern, direction and width with each thread count.
+     * @param thread_counts Thread counts to run each sweep with (each slice gets its own thread).
+     * @param test_time Each thread repeats its passes until this long has gone by (after at least one).
+     */
+    [[nodiscard]] std::vector<Result> run(std::vector<unsigned> const &thread_counts,
+                                          std::chrono::steady_clock::duration const test_time = DEFAULT_TEST_TIME) const
+    {
+        std::vector<Result> results;
+        for (unsigned const threads : thread_counts)
+        {
+            for (AccessPattern const pattern : {AccessPattern::Sequential, AccessPattern::Strided, AccessPattern::Random})
+            {
+                for (AccessDirection const direction : {AccessDirection::Read, AccessDirection::Write})
+                {
+                    for (Width const &width : WIDTHS)
+                    {
+                        results.push_back(measure(pattern, direction, width, threads, test_time));
+                    }
+                }
+            }
+        }
+        return results;
+    }
+
+    static void print_report(std::vector<Result> const &results, std::ostream &stream)
+    {
+        static constexpr char const *PATTERN_NAMES[]{"sequential", "strided", "random"};
+        stream << std::left << std::setw(19) << "[BW] pattern" << std::setw(7) << "op" << std::setw(9) << "width" << std::right
+               << std::setw(8) << "threads" << std::setw(10) << "GB/s" << std::setw(12) << "ns/access" << '\n';
+        for (Result const &result : results)
+        {
+            stream << "[BW] " << std::left << std::setw(14) << PATTERN_NAMES[static_cast<size_t>(result.pattern)] << std::setw(7)
+                   << (result.direction == AccessDirection::Read ? "read" : "write") << std::setw(9) << result.width << std::right
+                   << std::setw(8) << result.threads << std::fixed << std::setprecision(3) << std::setw(10) << result.gb_per_s
+                   << std::setprecision(2) << std::setw(12) << result.ns_per_access << std::defaultfloat << '\n';
+        }
+        stream << std::flush;
+    }
+
+private:
+    struct Width
+    {
+        char const *name;
+        size_t access_bytes; // 0 for memcpy
+    };
+
+    static constexpr Width WIDTHS[]{{"8-bit", 1},
+                                    {"16-bit", 2},
+                                    {"32-bit", 4},
+                                    {"64-bit", 8},
+#if defined(AXI_BANDWIDTH_SSE2) || defined(AXI_BANDWIDTH_NEON)
+                                    {"128-bit", 16},
+#endif
+                                    {"memcpy", 0}};
+
+    char *const m_region;
+    size_t const m_bytes;
+    size_t const m_stride;
+
+    uint64_t sweep(char *const base, size_t const bytes, AccessPattern const pattern, AccessDirection const direction,
+                   size_t const access_bytes, std::vector<char> &buffer) const
+    {
+        using namespace axi_bandwidth_detail;
+        switch (access_bytes)
+        {
+        case 1:
+            return sweep_scalar<uint8_t>(base, bytes, pattern, direction, m_stride);
+        case 2:
+            return sweep_scalar<uint16_t>(base, bytes, pattern, direction, m_stride);
+        case 4:
+            return sweep_scalar<uint32_t>(base, bytes, pattern, direction, m_stride);
+        case 8:
+            return sweep_scalar<uint64_t>(base, bytes, pattern, direction, m_stride);
+#if defined(AXI_BANDWIDTH_SSE2) || defined(AXI_BANDWIDTH_NEON)
+        case 16:
+            return sweep_vector(base, bytes, pattern, direction, m_stride);
+#endif
+        default:
+            return sweep_memcpy(base, bytes, pattern, direction, m_stride, buffer);
+        }
+    }
+
+    Result measure(AccessPattern const pattern, AccessDirection const direction, Width const &width, unsigned const threads,
+                   std::chrono::steady_clock::duration const test_time) const
+    {
+        size_t const slice{m_bytes / threads / axi_bandwidth_detail::MEMCPY_LINE * axi_bandwidth_detail::MEMCPY_LINE};
+        if (slice == 0)
+        {
+            throw std::runtime_error("Error: bandwidth region is too small for " + std::to_string(threads) + " threads.");
+        }
+        std::atomic<unsigned> ready{0};
+        std::atomic<bool> go{false};
+        std::chrono::steady_clock::time_point start;
+        std::vector<std::chrono::steady_clock::time_point> finished(threads);
+        std::vector<size_t> passes(threads);
+        std::vector<uint64_t> sums(threads);
+        std::vector<std::thread> workers;
+        for (unsigned thread{0}; thread < threads; ++thread)
+        {
+            workers.emplace_back([&, thread]
+            {
+                std::vector<char> buffer(width.access_bytes == 0 ? slice : 0, 0x5a);
+                char *const base{m_region + thread * slice};
+                ready.fetch_add(1);
+                while (!go.load(std::memory_order_acquire))
+                {
+                }
+                uint64_t sum{0};
+                auto now{start};
+                do
+                {
+                    sum ^= sweep(base, slice, pattern, direction, width.access_bytes, buffer);
+                    ++passes[thread];
+                    now = std::chrono::steady_clock::now();
+                } while (now - start < test_time);
+                finished[thread] = now;
+                sums[thread] = sum;
+            });
+        }
+        while (ready.load() != threads)
+        {
+            std::this_thread::yield();
+        }
+        start = std::chrono::steady_clock::now();
+        go.store(true, std::memory_order_release);
+        for (std::thread &worker : workers)
+        {
+            worker.join();
+        }
+
+        size_t const access_bytes{width.access_bytes != 0 ? width.access_bytes
+                                  : pattern == AccessPattern::Sequential ? slice
+                                                                         : axi_bandwidth_detail::MEMCPY_LINE};
+        double bytes{0};
+        double ns_per_access{0};
+        for (unsigned thread{0}; thread < threads; ++thread)
+        {
+            bytes += static_cast<double>(passes[thread] * slice);
+            ns_per_access += std::chrono::duration<double, std::nano>(finished[thread] - start).count() /
+                             static_cast<double>(passes[thread] * (slice / access_bytes)) / threads;
+        }
+        double const seconds{std::chrono::duration<double>(*std::max_element(finished.begin(), finished.end()) - start).count()};
+        return Result{pattern, direction, width.name, access_bytes, threads, bytes / seconds / 1e9, ns_per_access};
+    }
+};
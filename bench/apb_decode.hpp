@@ -0,0 +1,11 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+
+// Entry points into the stringstream decoders apb_fields.hpp replaced
+namespace legacy
+{
+std::string get_board_info(uint32_t sys_id_reg_val);
+std::string get_logictile_info(uint32_t sys_proc_id_1_val);
+} // namespace legacy
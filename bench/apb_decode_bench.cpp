@@ -0,0 +1,154 @@
+// Compares the compile-time field decoders in apb_fields.hpp with the
+// stringstream decoders they replaced, on SYS_ID and SYS_PROC_ID1, and times
+// a full APB snapshot decode. Heap allocations are counted for each path.
+//
+// Usage: apb-decode-bench [VALUES]   (default 1000000)
+
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <new>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../apb_fields.hpp"
+#include "apb_decode.hpp"
+
+namespace
+{
+
+size_t g_allocations{0};
+
+struct Timing
+{
+    double ns;
+    double allocations; // Per decode
+};
+
+template <typename Function>
+Timing measure(Function &&function, size_t const decodes)
+{
+    size_t const allocations_before{g_allocations};
+    auto const start{std::chrono::steady_clock::now()};
+    size_t volatile const checksum{function()};
+    auto const end{std::chrono::steady_clock::now()};
+    (void)checksum;
+    return Timing{std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(decodes),
+                  static_cast<double>(g_allocations - allocations_before) / static_cast<double>(decodes)};
+}
+
+void report(char const *what, Timing const legacy, Timing const fields)
+{
+    std::cout << std::left << std::setw(16) << what << std::right << std::fixed << std::setprecision(2) << std::setw(12) << legacy.ns
+              << std::setw(12) << fields.ns << std::setw(9) << legacy.ns / fields.ns << "x" << std::setw(12) << legacy.allocations
+              << std::setw(12) << fields.allocations << std::endl;
+}
+
+} // namespace
+
+void *operator new(size_t const size)
+{
+    ++g_allocations;
+    if (void *const memory{std::malloc(size ? size : 1)})
+    {
+        return memory;
+    }
+    throw std::bad_alloc();
+}
+
+void operator delete(void *const memory) noexcept
+{
+    std::free(memory);
+}
+
+void operator delete(void *const memory, size_t) noexcept
+{
+    std::free(memory);
+}
+
+int main(int argc, char *argv[])
+{
+    size_t const count{argc > 1 ? std::stoul(argv[1]) : 1000000};
+
+    std::mt19937 rng{42};
+    std::vector<uint32_t> values(count);
+    for (auto &value : values)
+    {
+        value = rng();
+    }
+
+    // The new decoders must reproduce the old text exactly
+    char buffer[APB_DECODE_BYTES];
+    for (size_t i{0}; i < std::min<size_t>(count, 100000); ++i)
+    {
+        if (legacy::get_board_info(values[i]) != std::string(buffer, format_board_info(values[i], buffer, buffer + sizeof(buffer))) ||
+            legacy::get_logictile_info(values[i]) != std::string(buffer, format_logictile_info(values[i], buffer, buffer + sizeof(buffer))))
+        {
+            std::cerr << "Decoders disagree on 0x" << std::hex << values[i] << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "APB decode (" << count << " random values)" << std::endl;
+    std::cout << std::left << std::setw(16) << "register" << std::right << std::setw(12) << "legacy ns" << std::setw(12) << "fields ns"
+              << std::setw(10) << "speedup" << std::setw(12) << "legacy new" << std::setw(12) << "fields new" << std::endl;
+
+    report("SYS_ID",
+           measure([&]
+           {
+               size_t length{0};
+               for (uint32_t const value : values)
+               {
+                   length += legacy::get_board_info(value).size();
+               }
+               return length;
+           }, count),
+           measure([&]
+           {
+               size_t length{0};
+               for (uint32_t const value : values)
+               {
+                   length += static_cast<size_t>(format_board_info(value, buffer, buffer + sizeof(buffer)) - buffer);
+               }
+               return length;
+           }, count));
+    report("SYS_PROC_ID1",
+           measure([&]
+           {
+               size_t length{0};
+               for (uint32_t const value : values)
+               {
+                   length += legacy::get_logictile_info(value).size();
+               }
+               return length;
+           }, count),
+           measure([&]
+           {
+               size_t length{0};
+               for (uint32_t const value : values)
+               {
+                   length += static_cast<size_t>(format_logictile_info(value, buffer, buffer + sizeof(buffer)) - buffer);
+               }
+               return length;
+           }, count));
+
+    // Every APB register at once, as a status dump would print them
+    size_t const snapshots{count / APBRegister::_size()};
+    std::vector<char> text(4096);
+    Timing const snapshot{measure([&]
+    {
+        size_t length{0};
+        for (size_t snapshot_index{0}; snapshot_index < snapshots; ++snapshot_index)
+        {
+            length += static_cast<size_t>(format_apb_snapshot(&values[snapshot_index * APBRegister::_size()], text.data(),
+                                                              text.data() + text.size()) - text.data());
+        }
+        return length;
+    }, snapshots)};
+    std::cout << std::left << std::setw(16) << "full snapshot" << std::right << std::setw(12) << "-" << std::setw(12) << snapshot.ns
+              << std::setw(10) << "-" << std::setw(12) << "-" << std::setw(12) << snapshot.allocations << std::endl;
+    return 0;
+}
@@ -0,0 +1,64 @@
+// The SYS_ID and SYS_PROC_ID1 decoders as reg-test had them before
+// apb_fields.hpp: runtime extract_bits() calls and a std::stringstream per call.
+
+#include <cstdint>
+#include <sstream>
+#include <string>
+
+#include "../bitmanip.hpp"
+#include "apb_decode.hpp"
+
+namespace legacy
+{
+
+std::string get_board_info(uint32_t const sys_id_reg_val)
+{
+    std::stringstream board_info;
+    uint32_t const rev{extract_bits(sys_id_reg_val, 28, 4)};
+    uint32_t const hbi{extract_bits(sys_id_reg_val, 16, 10)};
+    uint32_t const build{extract_bits(sys_id_reg_val, 12, 3)};
+    uint32_t const arch{extract_bits(sys_id_reg_val, 8, 3)};
+    uint32_t const fpga{extract_bits(sys_id_reg_val, 0, 7)};
+
+    std::string board_revision;
+    switch (rev)
+    {
+    case 0x0:
+        board_revision = "Rev A (Prototype Juno r0)";
+        break;
+    case 0x1:
+        board_revision = "Rev B (Juno r0)";
+        break;
+    case 0x2:
+        board_revision = "Rev C (Juno r1)";
+        break;
+    case 0x3:
+        board_revision = "Rev D (Juno r2)";
+        break;
+    default:
+        board_revision = "Unknown";
+        break;
+    }
+
+    board_info << board_revision << " HBI" << std::hex << hbi << ", Board Build Variant: " << build << ", IOFPGA Bus Arch: " << (arch == 0x4 ? "AHB" : "AXI") << ", FPGA Build (BCD): " << fpga;
+
+    return board_info.str();
+}
+
+std::string get_logictile_info(uint32_t const sys_proc_id_1_val)
+{
+    std::stringstream board_info;
+    uint32_t const app_note{extract_bits(sys_proc_id_1_val, 24, 8)};
+    uint32_t const rev{extract_bits(sys_proc_id_1_val, 20, 4)};
+    uint32_t const var{extract_bits(sys_proc_id_1_val, 16, 4)};
+    uint32_t const hbi{extract_bits(sys_proc_id_1_val, 0, 12)};
+
+    char const board_rev {static_cast<char>(rev + 'A')};
+    char const board_variant {static_cast<char>(var + 'A')};
+
+    board_info << "FPGA Image: " << app_note << ", Board Revision: " << board_rev << ", Board Build Variant: " << board_variant << ", HBI" << std::hex << hbi;
+
+    return board_info.str();
+}
+
+} // namespace legacy
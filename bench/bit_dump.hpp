@@ -0,0 +1,9 @@
+#pragma once
+
+#include <cstdint>
+
+// The per-bit iostream print_binary() that bit_dump.hpp replaced
+namespace legacy
+{
+void print_binary(const char *name, uint32_t value);
+} // namespace legacy
@@ -0,0 +1,109 @@
+// Compares the table-driven dump formatter in bit_dump.hpp with the per-bit
+// iostream print_binary() it replaced, dumping uint32_t samples to /dev/null:
+// the legacy print_binary(), the new print_binary() over format_binary(), and
+// dump_values() in binary and hex (one buffer, one write()).
+//
+// Usage: bit-dump-bench [VALUES]   (default 1000000)
+
+#include <chrono>
+#include <cstdint>
+#include <fcntl.h>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <unistd.h>
+#include <vector>
+
+#include "../bitmanip.hpp"
+#include "../bit_dump.hpp"
+#include "bit_dump.hpp"
+
+namespace
+{
+
+// Runs 'function' with stdout (fd 1 and std::cout) pointed at /dev/null
+template <typename Function>
+double measure_ms(Function &&function)
+{
+    std::cout.flush();
+    int const saved{dup(STDOUT_FILENO)};
+    int const null{open("/dev/null", O_WRONLY)};
+    dup2(null, STDOUT_FILENO);
+    auto const start{std::chrono::steady_clock::now()};
+    function();
+    std::cout.flush();
+    auto const end{std::chrono::steady_clock::now()};
+    dup2(saved, STDOUT_FILENO);
+    close(null);
+    close(saved);
+    return std::chrono::duration<double, std::milli>(end - start).count();
+}
+
+template <typename Function>
+std::string capture(Function &&function)
+{
+    std::ostringstream text;
+    std::streambuf *const previous{std::cout.rdbuf(text.rdbuf())};
+    function();
+    std::cout.rdbuf(previous);
+    std::cout.copyfmt(std::ios(nullptr));
+    return text.str();
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    size_t const count{argc > 1 ? std::stoul(argv[1]) : 1000000};
+
+    std::mt19937 rng{42};
+    std::vector<uint32_t> values(count);
+    for (auto &value : values)
+    {
+        value = rng();
+    }
+
+    // The new print_binary() must reproduce the old text exactly
+    for (size_t i{0}; i < std::min<size_t>(count, 10000); ++i)
+    {
+        char const *const name{i % 2 ? "SYS_ID" : "A_LONG_REGISTER_NAME"};
+        if (capture([&] { legacy::print_binary(name, values[i]); }) != capture([&] { print_binary(name, values[i]); }))
+        {
+            std::cerr << "print_binary() disagrees on 0x" << std::hex << values[i] << std::endl;
+            return 1;
+        }
+    }
+
+    double const legacy_ms{measure_ms([&]
+    {
+        for (uint32_t const value : values)
+        {
+            legacy::print_binary("sample", value);
+        }
+    })};
+    double const print_ms{measure_ms([&]
+    {
+        for (uint32_t const value : values)
+        {
+            print_binary("sample", value);
+        }
+    })};
+    double const binary_ms{measure_ms([&] { dump_values(values.data(), count, DumpFormat::Binary, STDOUT_FILENO); })};
+    double const hex_ms{measure_ms([&] { dump_values(values.data(), count, DumpFormat::Hex, STDOUT_FILENO); })};
+
+    std::cout << "Dump " << count << " uint32_t samples to /dev/null" << std::endl;
+    std::cout << std::left << std::setw(26) << "formatter" << std::right << std::setw(12) << "ms" << std::setw(12) << "ns/value"
+              << std::setw(10) << "speedup" << std::endl;
+    auto const report{[&](char const *what, double const ms)
+    {
+        std::cout << std::left << std::setw(26) << what << std::right << std::fixed << std::setprecision(2) << std::setw(12) << ms
+                  << std::setw(12) << ms * 1e6 / static_cast<double>(count) << std::setw(9) << legacy_ms / ms << "x" << std::endl;
+    }};
+    report("legacy print_binary", legacy_ms);
+    report("print_binary", print_ms);
+    report("dump_values binary", binary_ms);
+    report("dump_values hex", hex_ms);
+    return 0;
+}
@@ -0,0 +1,46 @@
+// print_binary() as bitmanip.hpp had it before bit_dump.hpp: one stream
+// insertion per bit, std::setw/std::left for the name and std::endl per line.
+
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <type_traits>
+
+#include "bit_dump.hpp"
+
+namespace legacy
+{
+
+void print_binary(const char *name, uint32_t value)
+{
+    using T = uint32_t;
+
+    // Determine the number of bits based on the type T
+    constexpr size_t BITS = sizeof(T) * 8;
+    std::cout << std::setw(15) << std::left << name << ": ";
+
+    // Iterate from MSB to LSB
+    for (size_t i = 0; i < BITS; ++i)
+    {
+        using UT = typename std::make_unsigned<T>::type;
+        UT u_value = static_cast<UT>(value);
+
+        if ((u_value >> (BITS - 1 - i)) & 1)
+        {
+            std::cout << "1";
+        }
+        else
+        {
+            std::cout << "0";
+        }
+
+        // Add a space every 8 bits for readability
+        if ((i + 1) % 8 == 0 && (i + 1) != BITS)
+        {
+            std::cout << " ";
+        }
+    }
+    std::cout << " (Dec: " << std::dec << value << ")" << std::endl;
+}
+
+} // namespace legacy
@@ -0,0 +1,189 @@
+// Compares the batch field operations in bitmanip_batch.hpp, on every kernel
+// set this CPU can run, with per-sample loops over the bitmanip.hpp templates.
+//
+// Usage: bitmanip-batch-bench [SAMPLES]   (default 4000000)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../bitmanip.hpp"
+#include "../bitmanip_batch.hpp"
+
+namespace
+{
+
+constexpr unsigned FIELD_POS{8};
+constexpr unsigned FIELD_BITS{12};
+constexpr uint32_t WATCH_MASK{0x00000f01};
+
+template <typename Function>
+double ns_per_sample(Function &&function, size_t const samples)
+{
+    double best{1e30};
+    for (unsigned repeat{0}; repeat < 5; ++repeat)
+    {
+        auto const start{std::chrono::steady_clock::now()};
+        uint64_t volatile const checksum{function()};
+        (void)checksum;
+        best = std::min(best, std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best / static_cast<double>(samples);
+}
+
+/**
+ * @brief A status-register capture: a slowly counting field and flag bits that flip every few hundred samples.
+ */
+std::vector<uint32_t> generate(size_t const samples)
+{
+    std::mt19937 rng{42};
+    std::uniform_int_distribution<int> flip{0, 299};
+    std::vector<uint32_t> values(samples);
+    uint32_t value{0x12000000};
+    for (size_t i{0}; i < samples; ++i)
+    {
+        if (i % 16 == 0)
+        {
+            value = insert_bits<uint32_t>(value, extract_bits<uint32_t>(value, FIELD_POS, FIELD_BITS) + 1, FIELD_POS, FIELD_BITS);
+        }
+        if (flip(rng) == 0)
+        {
+            value ^= 1u << (rng() % 4);
+        }
+        values[i] = value;
+    }
+    return values;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    using namespace bitmanip_batch_detail;
+    size_t const samples{argc > 1 ? std::stoul(argv[1]) : 4000000};
+    std::vector<uint32_t> const values{generate(samples)};
+    std::vector<uint32_t> fields(samples);
+    std::vector<uint32_t> targets(samples);
+    std::vector<size_t> indices(samples);
+
+    std::vector<Kernels<uint32_t> const *> kernel_sets{&SCALAR_KERNELS<uint32_t>};
+#if defined(BITMANIP_SIMD_SSE2)
+    kernel_sets.push_back(&sse2::KERNELS<uint32_t>);
+#endif
+#if defined(BITMANIP_SIMD_AVX2)
+    if (__builtin_cpu_supports("avx2"))
+    {
+        kernel_sets.push_back(&avx2::KERNELS<uint32_t>);
+    }
+#endif
+#if defined(BITMANIP_SIMD_NEON)
+    kernel_sets.push_back(&neon::KERNELS<uint32_t>);
+#endif
+
+    // The per-sample template loops the batch kernels replace
+    std::vector<double> baseline{
+        ns_per_sample([&]
+        {
+            for (size_t i{0}; i < samples; ++i)
+            {
+                fields[i] = extract_bits(values[i], FIELD_POS, FIELD_BITS);
+            }
+            return fields[samples / 2];
+        }, samples),
+        ns_per_sample([&]
+        {
+            for (size_t i{0}; i < samples; ++i)
+            {
+                targets[i] = insert_bits(values[i], fields[i], FIELD_POS, FIELD_BITS);
+            }
+            return targets[samples / 2];
+        }, samples),
+        ns_per_sample([&]
+        {
+            uint64_t total{0};
+            for (size_t i{0}; i < samples; ++i)
+            {
+                for (unsigned bit{0}; bit < 32; ++bit)
+                {
+                    total += is_bit_set(values[i], bit);
+                }
+            }
+            return total;
+        }, samples),
+        ns_per_sample([&]
+        {
+            size_t found{0};
+            for (size_t i{1}; i < samples; ++i)
+            {
+                if (extract_bits(values[i] ^ values[i - 1], 0, 12) & WATCH_MASK)
+                {
+                    indices[found++] = i;
+                }
+            }
+            return found;
+        }, samples)};
+
+    // Every kernel set must agree with the templates before its timing means anything
+    size_t const expected_edges{transitions_scalar_all(values.data(), samples, WATCH_MASK, Edge::Any, indices.data(), samples)};
+    for (auto const *kernels : kernel_sets)
+    {
+        kernels->extract(values.data(), fields.data(), samples, FIELD_POS, low_mask<uint32_t>(FIELD_BITS));
+        targets = values;
+        kernels->insert(targets.data(), fields.data(), samples, FIELD_POS, low_mask<uint32_t>(FIELD_BITS));
+        bool ok{kernels->count(values.data(), samples, ~0u) == count_scalar(values.data(), samples, ~0u) &&
+                kernels->transitions(values.data(), samples, WATCH_MASK, Edge::Any, indices.data(), samples) == expected_edges};
+        for (size_t i{0}; i < samples && ok; ++i)
+        {
+            ok = fields[i] == extract_bits(values[i], FIELD_POS, FIELD_BITS) && targets[i] == values[i];
+        }
+        if (!ok)
+        {
+            std::cerr << kernels->isa << " kernels disagree with bitmanip.hpp" << std::endl;
+            return 1;
+        }
+    }
+
+    std::cout << "Batch field operations on " << samples << " uint32_t samples (" << expected_edges << " edges), ns/sample; dispatch selects "
+              << bit_batch_isa() << std::endl;
+    std::cout << std::left << std::setw(14) << "operation" << std::right << std::setw(10) << "bitmanip";
+    for (auto const *kernels : kernel_sets)
+    {
+        std::cout << std::setw(10) << kernels->isa;
+    }
+    std::cout << std::setw(10) << "speedup" << std::endl;
+
+    char const *const names[]{"extract", "insert", "count bits", "transitions"};
+    for (size_t op{0}; op < 4; ++op)
+    {
+        std::cout << std::left << std::setw(14) << names[op] << std::right << std::fixed << std::setprecision(3) << std::setw(10) << baseline[op];
+        double best{1e30};
+        for (auto const *kernels : kernel_sets)
+        {
+            double const ns{ns_per_sample([&]() -> uint64_t
+            {
+                switch (op)
+                {
+                case 0:
+                    kernels->extract(values.data(), fields.data(), samples, FIELD_POS, low_mask<uint32_t>(FIELD_BITS));
+                    return fields[samples / 2];
+                case 1:
+                    kernels->insert(targets.data(), fields.data(), samples, FIELD_POS, low_mask<uint32_t>(FIELD_BITS));
+                    return targets[samples / 2];
+                case 2:
+                    return kernels->count(values.data(), samples, ~0u);
+                default:
+                    return kernels->transitions(values.data(), samples, WATCH_MASK, Edge::Any, indices.data(), samples);
+                }
+            }, samples)};
+            best = std::min(best, ns);
+            std::cout << std::setw(10) << ns;
+        }
+        std::cout << std::setw(9) << std::setprecision(1) << baseline[op] / best << 'x' << std::endl;
+    }
+    return 0;
+}
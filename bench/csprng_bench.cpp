@@ -0,0 +1,230 @@
+// Measures the CSPRNG in csprng.hpp. First checks ChaCha20 against the
+// RFC 8439 block test vector and BLAKE2s against RFC 7693, and every vector
+// kernel against the scalar one. Then times the raw keystream per kernel on
+// one core, and CsprngService::fill() with 1 to THREADS consumer threads at
+// several request sizes, against getrandom() as the baseline. The service is
+// seeded from a simulated AXI region and reseeds every 10 ms, so the
+// consumer threads rekey while they run.
+//
+// Usage: csprng-bench [THREADS] [SECONDS]   (default: one per CPU, 0.5)
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../csprng.hpp"
+
+namespace
+{
+
+bool check_vectors()
+{
+    // RFC 8439 section 2.3.2
+    uint8_t key[CHACHA20_KEY_BYTES];
+    for (size_t i{0}; i < sizeof(key); ++i)
+    {
+        key[i] = static_cast<uint8_t>(i);
+    }
+    uint8_t const nonce[CHACHA20_NONCE_BYTES]{0, 0, 0, 0x09, 0, 0, 0, 0x4a, 0, 0, 0, 0};
+    uint8_t const expected_block[CHACHA20_BLOCK_BYTES]{
+        0x10, 0xf1, 0xe7, 0xe4, 0xd1, 0x3b, 0x59, 0x15, 0x50, 0x0f, 0xdd, 0x1f, 0xa3, 0x20, 0x71, 0xc4,
+        0xc7, 0xd1, 0xf4, 0xc7, 0x33, 0xc0, 0x68, 0x03, 0x04, 0x22, 0xaa, 0x9a, 0xc3, 0xd4, 0x6c, 0x4e,
+        0xd2, 0x82, 0x64, 0x46, 0x07, 0x9f, 0xaa, 0x09, 0x14, 0xc2, 0xd7, 0x05, 0xd9, 0x8b, 0x02, 0xa2,
+        0xb5, 0x12, 0x9c, 0xd1, 0xde, 0x16, 0x4e, 0xb9, 0xcb, 0xd0, 0x83, 0xe8, 0xa2, 0x50, 0x3c, 0x4e};
+    uint8_t block[CHACHA20_BLOCK_BYTES];
+    chacha20_keystream_scalar(key, nonce, 1, block, 1);
+    bool ok{std::memcmp(block, expected_block, sizeof(block)) == 0};
+    chacha20_keystream(key, nonce, 1, block, 1);
+    ok = ok && std::memcmp(block, expected_block, sizeof(block)) == 0;
+
+    // RFC 7693 appendix B
+    uint8_t const expected_digest[csprng_detail::Blake2s::DIGEST_BYTES]{
+        0x50, 0x8c, 0x5e, 0x8c, 0x32, 0x7c, 0x14, 0xe2, 0xe1, 0xa7, 0x2b, 0xa3, 0x4e, 0xeb, 0x45, 0x2f,
+        0x37, 0x45, 0x8b, 0x20, 0x9e, 0xd6, 0x3a, 0x29, 0x4d, 0x99, 0x9b, 0x4c, 0x86, 0x67, 0x59, 0x82};
+    uint8_t digest[csprng_detail::Blake2s::DIGEST_BYTES];
+    csprng_detail::Blake2s().update("abc", 3).final(digest);
+    if (std::memcmp(digest, expected_digest, sizeof(digest)) != 0)
+    {
+        std::cerr << "BLAKE2s(\"abc\") does not match RFC 7693" << std::endl;
+        return false;
+    }
+    if (!ok)
+    {
+        std::cerr << "ChaCha20 block does not match RFC 8439" << std::endl;
+    }
+    return ok;
+}
+
+std::vector<chacha20_detail::Kernel> compiled_kernels()
+{
+    std::vector<chacha20_detail::Kernel> kernels{chacha20_detail::SCALAR_KERNEL};
+#if defined(CHACHA20_SIMD_SSE2)
+    kernels.push_back(chacha20_detail::sse2::KERNEL);
+#endif
+#if defined(CHACHA20_SIMD_AVX2)
+    if (__builtin_cpu_supports("avx2"))
+    {
+        kernels.push_back(chacha20_detail::avx2::KERNEL);
+    }
+#endif
+#if defined(CHACHA20_SIMD_NEON)
+    kernels.push_back(chacha20_detail::neon::KERNEL);
+#endif
+    return kernels;
+}
+
+// Every kernel against scalar, for block counts around each vector width and across the counter wrap
+bool check_kernels(std::vector<chacha20_detail::Kernel> const &kernels)
+{
+    uint8_t key[CHACHA20_KEY_BYTES];
+    uint8_t nonce[CHACHA20_NONCE_BYTES];
+    csprng_detail::os_entropy(key, sizeof(key));
+    csprng_detail::os_entropy(nonce, sizeof(nonce));
+    uint32_t state[16];
+    for (auto const &kernel : kernels)
+    {
+        for (size_t blocks{1}; blocks <= 33; ++blocks)
+        {
+            std::vector<uint8_t> expected(blocks * CHACHA20_BLOCK_BYTES);
+            std::vector<uint8_t> actual(blocks * CHACHA20_BLOCK_BYTES);
+            chacha20_keystream_scalar(key, nonce, 0xFFFFFFF0u, expected.data(), blocks);
+            chacha20_detail::init_state(key, nonce, 0xFFFFFFF0u, state);
+            kernel.blocks(state, actual.data(), blocks);
+            if (expected != actual)
+            {
+                std::cerr << kernel.isa << " keystream differs from scalar at " << blocks << " blocks" << std::endl;
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+void run_kernel(chacha20_detail::Kernel const &kernel, double const seconds)
+{
+    constexpr size_t BLOCKS{CsprngService::BUFFER_BYTES / CHACHA20_BLOCK_BYTES};
+    std::vector<uint8_t> out(BLOCKS * CHACHA20_BLOCK_BYTES);
+    uint8_t const key[CHACHA20_KEY_BYTES]{1};
+    uint8_t const nonce[CHACHA20_NONCE_BYTES]{};
+    uint32_t state[16];
+    chacha20_detail::init_state(key, nonce, 0, state);
+
+    size_t rounds{0};
+    auto const start{std::chrono::steady_clock::now()};
+    auto const end{start + std::chrono::duration<double>(seconds)};
+    while (std::chrono::steady_clock::now() < end)
+    {
+        for (size_t i{0}; i < 64; ++i, ++rounds)
+        {
+            kernel.blocks(state, out.data(), BLOCKS);
+            state[12] += BLOCKS;
+        }
+    }
+    double const elapsed{std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+    double const bytes{static_cast<double>(rounds * out.size())};
+    std::cout << std::left << std::setw(8) << kernel.isa << std::right << std::fixed << std::setprecision(2) << std::setw(10)
+              << bytes / elapsed / 1e9 << " GB/s" << std::endl;
+}
+
+// Aggregate GB/s of 'threads' consumers each asking for 'request' bytes at a time
+template <typename Fill>
+double run_consumers(size_t const threads, size_t const request, double const seconds, Fill &&fill)
+{
+    std::atomic<bool> running{true};
+    std::atomic<uint64_t> total{0};
+    std::vector<std::thread> consumers;
+    for (size_t t{0}; t < threads; ++t)
+    {
+        consumers.emplace_back([&]
+        {
+            std::vector<uint8_t> out(request);
+            uint64_t bytes{0};
+            while (running.load(std::memory_order_relaxed))
+            {
+                for (size_t i{0}; i < 16; ++i)
+                {
+                    fill(out.data(), request);
+                    bytes += request;
+                }
+            }
+            total.fetch_add(bytes);
+        });
+    }
+    auto const start{std::chrono::steady_clock::now()};
+    std::this_thread::sleep_for(std::chrono::duration<double>(seconds));
+    running = false;
+    for (auto &consumer : consumers)
+    {
+        consumer.join();
+    }
+    double const elapsed{std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+    return static_cast<double>(total.load()) / elapsed / 1e9;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    size_t const max_threads{argc > 1 ? std::stoul(argv[1]) : std::max(1u, std::thread::hardware_concurrency())};
+    double const seconds{argc > 2 ? std::stod(argv[2]) : 0.5};
+
+    std::vector<chacha20_detail::Kernel> const kernels{compiled_kernels()};
+    if (!check_vectors() || !check_kernels(kernels))
+    {
+        return 1;
+    }
+    std::cout << "ChaCha20 and BLAKE2s match their RFC test vectors; every kernel matches scalar" << std::endl;
+
+    std::cout << "\nKeystream on one core, " << CsprngService::BUFFER_BYTES / 1024 << " KiB per call" << std::endl;
+    for (auto const &kernel : kernels)
+    {
+        run_kernel(kernel, seconds);
+    }
+
+    RegisterManager axi(AXI_BASE_ADDR, false, true, false);
+    CsprngService::Policy policy;
+    policy.reseed_interval = std::chrono::milliseconds(10);
+    CsprngService service(&axi, policy);
+
+    std::vector<size_t> thread_counts;
+    for (size_t threads{1}; threads < max_threads; threads *= 2)
+    {
+        thread_counts.push_back(threads);
+    }
+    thread_counts.push_back(max_threads);
+    size_t const requests[]{16, 256, 4096, 65536, 1 << 20};
+
+    std::cout << "\nCsprngService::fill() on " << CsprngService::isa() << ", GB/s summed over all threads, " << seconds
+              << " s per run" << std::endl;
+    std::cout << std::right << std::setw(8) << "threads";
+    for (size_t const request : requests)
+    {
+        std::cout << std::setw(10) << (request >= 1024 ? std::to_string(request / 1024) + " KiB" : std::to_string(request) + " B");
+    }
+    std::cout << std::setw(12) << "getrandom" << std::endl;
+    for (size_t const threads : thread_counts)
+    {
+        std::cout << std::setw(8) << threads << std::fixed << std::setprecision(2);
+        for (size_t const request : requests)
+        {
+            std::cout << std::setw(10) << run_consumers(threads, request, seconds, [&](uint8_t *out, size_t const bytes)
+            {
+                service.fill(out, bytes);
+            }) << std::flush;
+        }
+        std::cout << std::setw(12) << run_consumers(threads, 4096, seconds, [](uint8_t *out, size_t const bytes)
+        {
+            csprng_detail::os_entropy(out, bytes);
+        }) << std::endl;
+    }
+    std::cout << "(getrandom with 4 KiB requests)" << std::endl;
+    service.print_counters(std::cout);
+    return 0;
+}
@@ -0,0 +1,59 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+/**
+ * @brief Lookup loops shared by the table-driven and legacy builds of enum.h.
+ *
+ * Each translation unit instantiates these against its own copy of the
+ * register enums, so both variants are timed with identical loop code.
+ */
+namespace enum_lookup
+{
+
+/**
+ * @brief Converts every value to its name 'rounds' times.
+ * @return A checksum of the names, to keep the lookups live.
+ */
+template <typename Enum>
+size_t to_string(uint32_t const *values, size_t const count, size_t const rounds)
+{
+    size_t checksum{0};
+    for (size_t round{0}; round < rounds; ++round)
+    {
+        for (size_t i{0}; i < count; ++i)
+        {
+            checksum += static_cast<unsigned char>(Enum::_from_integral_unchecked(values[i])._to_string()[4]);
+        }
+    }
+    return checksum;
+}
+
+/**
+ * @brief Parses every name 'rounds' times.
+ * @return A checksum of the parsed values, to keep the lookups live.
+ */
+template <typename Enum>
+size_t from_string(char const *const *names, size_t const count, size_t const rounds, bool const nocase)
+{
+    size_t checksum{0};
+    for (size_t round{0}; round < rounds; ++round)
+    {
+        for (size_t i{0}; i < count; ++i)
+        {
+            auto const parsed{nocase ? Enum::_from_string_nocase_nothrow(names[i]) : Enum::_from_string_nothrow(names[i])};
+            checksum += parsed ? parsed->_to_integral() : 1;
+        }
+    }
+    return checksum;
+}
+
+} // namespace enum_lookup
+
+// Entry points into the build of enum.h with BETTER_ENUMS_NO_LOOKUP_TABLES
+namespace legacy
+{
+size_t apb_to_string(uint32_t const *values, size_t count, size_t rounds);
+size_t apb_from_string(char const *const *names, size_t count, size_t rounds, bool nocase);
+} // namespace legacy
@@ -0,0 +1,100 @@
+// Compares the compile-time lookup tables in enum.h with the linear searches
+// they replace, using the APBRegister enum from registers.hpp.
+
+#include <algorithm>
+#include <cctype>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "../registers.hpp"
+#include "enum_lookup.hpp"
+
+// Both directions are now usable in constant expressions
+static_assert(APBRegister::_from_string("SYS_24MHZ") == +APBRegister::SYS_24MHZ, "name lookup");
+static_assert((+APBRegister::SYS_FAN_SPEED)._to_string()[4] == 'F', "value lookup");
+
+namespace
+{
+
+template <typename Function>
+double ns_per_op(Function &&function, size_t const ops)
+{
+    auto const start{std::chrono::steady_clock::now()};
+    size_t volatile const checksum{function()};
+    auto const end{std::chrono::steady_clock::now()};
+    (void)checksum;
+    return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(ops);
+}
+
+void report(char const *operation, double const legacy_ns, double const table_ns)
+{
+    std::cout << std::left << std::setw(22) << operation << std::right << std::fixed << std::setprecision(2)
+              << std::setw(10) << legacy_ns << std::setw(10) << table_ns
+              << std::setw(9) << legacy_ns / table_ns << "x" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    size_t const rounds{argc > 1 ? std::stoul(argv[1]) : 200000};
+
+    // Shuffle so neither variant benefits from a predictable access order
+    std::mt19937 rng{42};
+    std::vector<uint32_t> values;
+    std::vector<std::string> names;
+    std::vector<std::string> lower_names;
+    for (auto const reg : APBRegister::_values())
+    {
+        values.push_back(reg._to_integral());
+        names.emplace_back(reg._to_string());
+    }
+    std::shuffle(values.begin(), values.end(), rng);
+    std::shuffle(names.begin(), names.end(), rng);
+    for (auto const &name : names)
+    {
+        std::string lower{name};
+        std::transform(lower.begin(), lower.end(), lower.begin(), [](unsigned char const c) { return std::tolower(c); });
+        lower_names.push_back(lower);
+    }
+    std::vector<char const *> name_ptrs;
+    std::vector<char const *> lower_ptrs;
+    for (size_t i{0}; i < names.size(); ++i)
+    {
+        name_ptrs.push_back(names[i].c_str());
+        lower_ptrs.push_back(lower_names[i].c_str());
+    }
+
+    size_t const count{values.size()};
+    size_t const ops{count * rounds};
+
+    // Both builds must agree before their timings mean anything
+    if (legacy::apb_to_string(values.data(), count, 1) != enum_lookup::to_string<APBRegister>(values.data(), count, 1) ||
+        legacy::apb_from_string(name_ptrs.data(), count, 1, false) != enum_lookup::from_string<APBRegister>(name_ptrs.data(), count, 1, false) ||
+        legacy::apb_from_string(lower_ptrs.data(), count, 1, true) != enum_lookup::from_string<APBRegister>(lower_ptrs.data(), count, 1, true))
+    {
+        std::cerr << "Legacy and table lookups disagree" << std::endl;
+        return 1;
+    }
+
+    std::cout << "APBRegister lookups (" << count << " constants, " << rounds << " rounds)" << std::endl;
+    std::cout << std::left << std::setw(22) << "operation" << std::right << std::setw(10) << "linear ns" << std::setw(10) << "table ns"
+              << std::setw(10) << "speedup" << std::endl;
+
+    report("_to_string",
+           ns_per_op([&] { return legacy::apb_to_string(values.data(), count, rounds); }, ops),
+           ns_per_op([&] { return enum_lookup::to_string<APBRegister>(values.data(), count, rounds); }, ops));
+    report("_from_string",
+           ns_per_op([&] { return legacy::apb_from_string(name_ptrs.data(), count, rounds, false); }, ops),
+           ns_per_op([&] { return enum_lookup::from_string<APBRegister>(name_ptrs.data(), count, rounds, false); }, ops));
+    report("_from_string_nocase",
+           ns_per_op([&] { return legacy::apb_from_string(lower_ptrs.data(), count, rounds, true); }, ops),
+           ns_per_op([&] { return enum_lookup::from_string<APBRegister>(lower_ptrs.data(), count, rounds, true); }, ops));
+
+    return 0;
+}
@@ -0,0 +1,30 @@
+// The register enums as they were built before compile-time lookup tables:
+// linear value and name searches, with names trimmed at program start.
+#define BETTER_ENUMS_NO_LOOKUP_TABLES
+
+#include <cstddef>
+#include <cstdint>
+
+#include "../enum.h"
+
+namespace legacy
+{
+#include "../registers.hpp"
+} // namespace legacy
+
+#include "enum_lookup.hpp"
+
+namespace legacy
+{
+
+size_t apb_to_string(uint32_t const *values, size_t const count, size_t const rounds)
+{
+    return enum_lookup::to_string<APBRegister>(values, count, rounds);
+}
+
+size_t apb_from_string(char const *const *names, size_t const count, size_t const rounds, bool const nocase)
+{
+    return enum_lookup::from_string<APBRegister>(names, count, rounds, nocase);
+}
+
+} // namespace legacy
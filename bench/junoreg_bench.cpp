@@ -0,0 +1,135 @@
+// Compares reading a register in-process through libjunoreg with running
+// reg-test once per query, as tools had to before the library existed. The
+// in-process paths are the inline window read, the exported junoreg_read()
+// call, and junoreg_read_burst() over the whole region; all use a simulated
+// region so no board is needed.
+//
+// Usage: junoreg-bench [READS] [QUERIES] [REG_TEST]   (default 10000000, 100, ./reg-test)
+
+#include <chrono>
+#include <cstdint>
+#include <fcntl.h>
+#include <iomanip>
+#include <iostream>
+#include <spawn.h>
+#include <string>
+#include <sys/wait.h>
+#include <vector>
+
+#include "../junoreg.h"
+
+extern char **environ;
+
+namespace
+{
+
+template <typename Function>
+double measure_ns(Function &&function, size_t const operations)
+{
+    auto const start{std::chrono::steady_clock::now()};
+    function();
+    auto const end{std::chrono::steady_clock::now()};
+    return std::chrono::duration<double, std::nano>(end - start).count() / static_cast<double>(operations);
+}
+
+// Runs "REG_TEST -s read AXI:AMS_RNGCNT" with its output discarded; false if it could not run or failed
+bool exec_query(std::string const &reg_test)
+{
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_addopen(&actions, 1, "/dev/null", O_WRONLY, 0);
+    posix_spawn_file_actions_addopen(&actions, 2, "/dev/null", O_WRONLY, 0);
+    std::string program{reg_test};
+    std::string simulate{"-s"};
+    std::string read{"read"};
+    std::string target{"AXI:AMS_RNGCNT"};
+    char *argv[]{program.data(), simulate.data(), read.data(), target.data(), nullptr};
+
+    pid_t pid;
+    int const spawned{posix_spawn(&pid, reg_test.c_str(), &actions, nullptr, argv, environ)};
+    posix_spawn_file_actions_destroy(&actions);
+    int status{0};
+    return spawned == 0 && waitpid(pid, &status, 0) == pid && WIFEXITED(status) && WEXITSTATUS(status) == 0;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    size_t const reads{argc > 1 ? std::stoul(argv[1]) : 10000000};
+    size_t const queries{argc > 2 ? std::stoul(argv[2]) : 100};
+    std::string const reg_test{argc > 3 ? argv[3] : "./reg-test"};
+
+    if (junoreg_abi_version() != JUNOREG_ABI_VERSION)
+    {
+        std::cerr << "libjunoreg ABI " << junoreg_abi_version() << " does not match junoreg.h " << JUNOREG_ABI_VERSION << std::endl;
+        return 1;
+    }
+    junoreg_region *const region{junoreg_open(JUNOREG_AXI_BASE, JUNOREG_SIMULATED)};
+    if (!region)
+    {
+        std::cerr << junoreg_last_error() << std::endl;
+        return 1;
+    }
+    junoreg_window window;
+    junoreg_window_of(region, &window);
+    constexpr uint32_t OFFSET{0x00C}; // AMS_RNGCNT
+    constexpr size_t BURST{JUNOREG_REGION_BYTES / 4};
+
+    uint32_t checksum{0};
+    double const inline_ns{measure_ns([&]
+    {
+        for (size_t i{0}; i < reads; ++i)
+        {
+            checksum += junoreg_window_read(&window, OFFSET);
+        }
+    }, reads)};
+    double const call_ns{measure_ns([&]
+    {
+        for (size_t i{0}; i < reads; ++i)
+        {
+            uint32_t value;
+            junoreg_read(region, OFFSET, &value);
+            checksum += value;
+        }
+    }, reads)};
+    std::vector<uint32_t> burst(BURST);
+    size_t const bursts{reads / BURST + 1};
+    double const burst_ns{measure_ns([&]
+    {
+        for (size_t i{0}; i < bursts; ++i)
+        {
+            junoreg_read_burst(region, 0, burst.data(), BURST);
+            checksum += burst[OFFSET / 4];
+        }
+    }, bursts * BURST)};
+    junoreg_close(region);
+
+    bool exec_ok{true};
+    double const exec_ns{measure_ns([&]
+    {
+        for (size_t i{0}; i < queries && exec_ok; ++i)
+        {
+            exec_ok = exec_query(reg_test);
+        }
+    }, queries)};
+    if (!exec_ok)
+    {
+        std::cerr << "Could not run " << reg_test << " (build it with make, or pass its path)" << std::endl;
+        return 1;
+    }
+
+    std::cout << "Read AMS_RNGCNT from a simulated region (checksum " << checksum << ")" << std::endl;
+    std::cout << std::left << std::setw(26) << "path" << std::right << std::setw(14) << "ns/read" << std::setw(14) << "vs exec"
+              << std::endl;
+    auto const report{[&](char const *what, double const ns)
+    {
+        std::cout << std::left << std::setw(26) << what << std::right << std::fixed << std::setprecision(2) << std::setw(14) << ns
+                  << std::setw(13) << exec_ns / ns << "x" << std::endl;
+    }};
+    report("junoreg_window_read", inline_ns);
+    report("junoreg_read", call_ns);
+    report("junoreg_read_burst", burst_ns);
+    report("exec reg-test", exec_ns);
+    return 0;
+}
@@ -0,0 +1,67 @@
+/* Links libjunoreg.a into a plain C program, the way other tools consume it,
+ * and exercises each part of the interface on a simulated region. Built and
+ * run by `make lib`, so a static archive that no longer links from C (a new
+ * C++ runtime dependency missing from the documented link line) fails the
+ * build rather than the first tool that upgrades.
+ *
+ * Build: cc -std=c99 junoreg_c_check.c -L.. -ljunoreg -lstdc++
+ */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "../junoreg.h"
+
+static int failures = 0;
+
+static void check(int const ok, char const *what)
+{
+    if (!ok)
+    {
+        fprintf(stderr, "[ERROR] junoreg C check: %s (%s)\n", what, junoreg_last_error());
+        ++failures;
+    }
+}
+
+int main(void)
+{
+    junoreg_region *region;
+    junoreg_window window;
+    uint32_t value = 0;
+    uint32_t burst[4] = {1, 2, 3, 4};
+    uint32_t readback[4] = {0};
+    char text[256];
+
+    check(junoreg_abi_version() == JUNOREG_ABI_VERSION, "library ABI matches the header");
+
+    region = junoreg_open(JUNOREG_AXI_BASE, JUNOREG_SIMULATED);
+    check(region != NULL, "open a simulated region");
+    if (region == NULL)
+    {
+        return 1;
+    }
+
+    check(junoreg_write(region, 0x10, 0xCAFEBABEu) == JUNOREG_OK, "write");
+    check(junoreg_read(region, 0x10, &value) == JUNOREG_OK && value == 0xCAFEBABEu, "read back a write");
+    check(junoreg_write_burst(region, 0x20, burst, 4) == JUNOREG_OK, "write burst");
+    check(junoreg_read_burst(region, 0x20, readback, 4) == JUNOREG_OK && memcmp(burst, readback, sizeof(burst)) == 0,
+          "read back a burst");
+    check(junoreg_read(region, JUNOREG_REGION_BYTES, &value) == JUNOREG_ERROR && junoreg_last_error()[0] != '\0',
+          "reject an offset past the region");
+
+    check(junoreg_window_of(region, &window) == JUNOREG_OK, "fetch the window");
+    junoreg_window_write(&window, 0x30, 0x12345678u);
+    check(junoreg_window_read(&window, 0x30) == 0x12345678u, "inline window access");
+
+    check(junoreg_decode_board_info(0x02250400u).hbi == 0x225u, "decode SYS_ID");
+    check(junoreg_format_apb_register(JUNOREG_SYS_ID, 0x02250400u, text, sizeof(text)) > 0, "format SYS_ID");
+
+    junoreg_close(region);
+    if (failures != 0)
+    {
+        return 1;
+    }
+    printf("[INFO] libjunoreg.a links and runs from C\n");
+    return 0;
+}
@@ -0,0 +1,81 @@
+// Feeds RegisterManager offsets outside its mapping, on a simulated region,
+// and checks each raw-offset access is rejected before it touches memory: a
+// writeBatch() with one bad entry must throw without issuing any of its
+// stores. Built and run by `make check`.
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+
+#include "../register_manager.hpp"
+
+namespace
+{
+
+int g_failures{0};
+
+void check(bool const ok, char const *const what)
+{
+    if (!ok)
+    {
+        std::cerr << "[ERROR] RegisterManager check: " << what << std::endl;
+        ++g_failures;
+    }
+}
+
+template <typename Function>
+bool throws(Function &&function)
+{
+    try
+    {
+        function();
+    }
+    catch (std::runtime_error const &)
+    {
+        return true;
+    }
+    return false;
+}
+
+} // namespace
+
+int main()
+{
+    RegisterManager const manager(AXI_BASE_ADDR, false, true, false);
+    uint32_t constexpr LAST{MAP_SIZE - 4};
+
+    manager.writeOffset(0x10, 0x11111111);
+    manager.writeOffset(LAST, 0x22222222);
+    check(manager.readOffset(LAST) == 0x22222222, "access the last register of the mapping");
+
+    check(throws([&] { manager.readOffset(MAP_SIZE); }), "reject a read one past the mapping");
+    check(throws([&] { manager.readOffset(0xFFFFFFFC); }), "reject a read far past the mapping");
+    check(throws([&] { manager.writeOffset(MAP_SIZE, 0); }), "reject a write one past the mapping");
+    check(throws([&] { manager.writeOffset(0x12, 0); }), "reject an unaligned write");
+    check(manager.readOffset(0x10) == 0x11111111, "rejected writes leave the registers alone");
+
+    // The bad entry comes last, so a batch that stored before validating would have changed 0x10 and LAST
+    std::array<RegisterWrite, 3> const past_end{{{0x10, 0xAAAAAAAA}, {LAST, 0xBBBBBBBB}, {MAP_SIZE * 8, 0xCCCCCCCC}}};
+    check(throws([&] { manager.writeBatch(past_end, WriteBatchCheck{std::nullopt, true}); }),
+          "reject a batch with an offset past the mapping");
+    std::array<RegisterWrite, 2> const unaligned{{{0x10, 0xAAAAAAAA}, {0x21, 0xBBBBBBBB}}};
+    check(throws([&] { manager.writeBatch(unaligned); }), "reject a batch with an unaligned offset");
+    std::array<RegisterWrite, 1> const in_range{{{0x10, 0xAAAAAAAA}}};
+    check(throws([&] { manager.writeBatch(in_range, WriteBatchCheck{MAP_SIZE, false}); }),
+          "reject a batch whose read-back offset is past the mapping");
+    check(manager.readOffset(0x10) == 0x11111111 && manager.readOffset(LAST) == 0x22222222,
+          "a rejected batch issues none of its stores");
+
+    std::array<RegisterWrite, 3> const valid{{{0x10, 0x33333333}, {LAST, 0x44444444}, {0x10, 0x55555555}}};
+    WriteBatchResult const result{manager.writeBatch(valid, WriteBatchCheck{LAST, true})};
+    check(result.mismatches == 0 && result.read_back_value == 0x44444444 && manager.readOffset(0x10) == 0x55555555,
+          "an in-range batch is written and verified");
+
+    if (g_failures != 0)
+    {
+        return 1;
+    }
+    std::cout << "[INFO] RegisterManager rejects unaligned and out-of-range offsets" << std::endl;
+    return 0;
+}
@@ -0,0 +1,157 @@
+// Load-tests the remote register protocol in register_remote.hpp against
+// several RegisterServers on localhost, each serving its own simulated
+// regions from its own thread. One RemoteClient fans out to all of them and
+// keeps DEPTH batches in flight per board; depth 1 is the request/response
+// lockstep a per-query tool gets. Reports requests/s, ops/s and latency
+// percentiles, then checks subscription sample timing.
+//
+// Usage: remote-bench [BOARDS] [SECONDS]   (default 4, 1)
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "../register_remote.hpp"
+
+namespace
+{
+
+// Simulated regions and a server for one board, run on its own thread
+struct Board
+{
+    RegisterManager scc{SCC_BASE_ADDR, false, true, false};
+    RegisterManager apb{APB_BASE_ADDR, false, true, false};
+    RegisterManager axi{AXI_BASE_ADDR, false, true, false};
+    RegisterServer server{RegisterRegions{&scc, &apb, &axi}, 0, "127.0.0.1"};
+    std::thread thread{[this] { server.run(); }};
+
+    ~Board()
+    {
+        server.stop();
+        thread.join();
+    }
+};
+
+double percentile_us(std::vector<int64_t> &latencies_ns, double const fraction)
+{
+    size_t const index{std::min(latencies_ns.size() - 1, static_cast<size_t>(fraction * static_cast<double>(latencies_ns.size())))};
+    std::nth_element(latencies_ns.begin(), latencies_ns.begin() + static_cast<std::ptrdiff_t>(index), latencies_ns.end());
+    return static_cast<double>(latencies_ns[index]) / 1e3;
+}
+
+void run_load(RemoteClient &client, size_t const depth, size_t const batch, double const seconds)
+{
+    // Alternate writes and reads of a scratch register, so the server does real work on every op
+    std::vector<RegisterOp> ops(batch);
+    for (size_t i{0}; i < batch; ++i)
+    {
+        ops[i] = RegisterOp{i % 2 ? RegisterOp::Kind::Read : RegisterOp::Kind::Write, RegisterRegion::AXI, 0x010,
+                            static_cast<uint32_t>(i), UINT32_MAX, nullptr};
+    }
+
+    std::vector<int64_t> latencies_ns;
+    latencies_ns.reserve(1 << 20);
+    auto const end{std::chrono::steady_clock::now() + std::chrono::duration<double>(seconds)};
+    bool running{true};
+    size_t failed{0};
+    RemoteClient::ReplyHandler resubmit;
+    resubmit = [&](RemoteReply const &reply)
+    {
+        latencies_ns.push_back(reply.latency.count());
+        failed += reply.status != RemoteStatus::Ok || reply.count != batch;
+        if (running)
+        {
+            client.submit(reply.board, ops, resubmit);
+        }
+    };
+
+    auto const start{std::chrono::steady_clock::now()};
+    for (size_t board{0}; board < client.boards(); ++board)
+    {
+        for (size_t i{0}; i < depth; ++i)
+        {
+            client.submit(board, ops, resubmit);
+        }
+    }
+    while (std::chrono::steady_clock::now() < end)
+    {
+        client.poll(std::chrono::milliseconds(10));
+    }
+    running = false;
+    client.wait();
+    double const elapsed{std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+
+    double const requests{static_cast<double>(latencies_ns.size())};
+    std::cout << std::right << std::setw(6) << depth << std::setw(7) << batch << std::fixed << std::setprecision(0) << std::setw(12)
+              << requests / elapsed << std::setw(12) << requests * static_cast<double>(batch) / elapsed << std::setprecision(1)
+              << std::setw(10) << percentile_us(latencies_ns, 0.5) << std::setw(10) << percentile_us(latencies_ns, 0.99)
+              << std::setw(10) << percentile_us(latencies_ns, 0.999) << std::setw(10) << percentile_us(latencies_ns, 1.0)
+              << (failed ? "  FAILED " + std::to_string(failed) : std::string{}) << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    size_t const board_count{argc > 1 ? std::stoul(argv[1]) : 4};
+    double const seconds{argc > 2 ? std::stod(argv[2]) : 1.0};
+
+    std::vector<std::unique_ptr<Board>> boards;
+    std::vector<RemoteEndpoint> endpoints;
+    for (size_t i{0}; i < board_count; ++i)
+    {
+        boards.push_back(std::make_unique<Board>());
+        endpoints.push_back(RemoteEndpoint{"127.0.0.1", boards.back()->server.port()});
+    }
+    RemoteClient client(endpoints);
+
+    std::cout << board_count << " simulated boards on localhost, " << seconds << " s per run" << std::endl;
+    std::cout << std::right << std::setw(6) << "depth" << std::setw(7) << "batch" << std::setw(12) << "requests/s" << std::setw(12)
+              << "ops/s" << std::setw(10) << "p50 us" << std::setw(10) << "p99 us" << std::setw(10) << "p99.9 us" << std::setw(10)
+              << "max us" << std::endl;
+    for (size_t const depth : {1, 8, 32})
+    {
+        for (size_t const batch : {1, 16})
+        {
+            run_load(client, depth, batch, seconds);
+        }
+    }
+
+    // Subscriptions: 1 kHz sampling of one register on every board
+    constexpr uint32_t SAMPLES{200};
+    std::vector<std::vector<uint64_t>> timestamps(board_count);
+    uint64_t dropped{0};
+    std::vector<RegisterOp> const reads{RegisterOp{RegisterOp::Kind::Read, RegisterRegion::AXI, 0x010, 0, UINT32_MAX, nullptr}};
+    for (size_t board{0}; board < board_count; ++board)
+    {
+        client.subscribe(board, reads, std::chrono::microseconds(1000), SAMPLES, [&](RemoteSample const &sample)
+        {
+            timestamps[sample.board].push_back(sample.timestamp_ns);
+            dropped += sample.dropped;
+        });
+    }
+    if (!client.wait())
+    {
+        std::cerr << "Subscriptions did not deliver their samples" << std::endl;
+        return 1;
+    }
+    std::vector<int64_t> jitter_ns;
+    for (auto const &board : timestamps)
+    {
+        for (size_t i{1}; i < board.size(); ++i)
+        {
+            jitter_ns.push_back(std::abs(static_cast<int64_t>(board[i] - board[i - 1]) - 1000000));
+        }
+    }
+    std::cout << "Subscriptions: " << board_count << " x " << SAMPLES << " samples at 1 kHz, " << dropped
+              << " dropped, interval error p50 " << std::setprecision(1) << percentile_us(jitter_ns, 0.5) << " us, p99 "
+              << percentile_us(jitter_ns, 0.99) << " us, max " << percentile_us(jitter_ns, 1.0) << " us" << std::endl;
+    return 0;
+}
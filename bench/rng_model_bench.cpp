@@ -0,0 +1,102 @@
+// Times the DPI-C golden model (rtl/sim/rng_model_dpi.cpp) over the traffic
+// mix of the testbench's constrained-random test: reads spread over the RNG,
+// DMA, counter and unmapped registers a few ACLKs apart, with a previewed and
+// applied write for every fourth read. This is the work the SystemVerilog
+// scoreboard hands to the model per transaction when SCOREBOARD_DPI = 1, so it
+// bounds what the model adds to a long run; the simulator's own call overhead
+// is not included.
+//
+// Usage: rng-model-bench [TRANSACTIONS]   (default 1000000)
+
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+
+extern "C"
+{
+void rng_model_reset();
+int rng_model_read(unsigned long long cycle, unsigned int offset, unsigned int *data);
+unsigned int rng_model_preview_write(unsigned int offset, unsigned int data, unsigned int strobe);
+int rng_model_write(unsigned int offset, unsigned int data, unsigned int strobe);
+}
+
+namespace
+{
+
+struct Transaction
+{
+    uint64_t cycle;
+    uint32_t offset;
+    bool write;
+    uint32_t data; // Write data
+    uint32_t strobe;
+};
+
+// The address and write mixes of rand_ar and rand_w in rng_axi_slave_tb.sv
+std::vector<Transaction> make_traffic(size_t const count)
+{
+    std::mt19937 rng{29};
+    std::vector<Transaction> traffic;
+    traffic.reserve(count);
+    uint64_t cycle{0};
+    for (size_t n{0}; n < count; ++n)
+    {
+        cycle += 1 + (rng() % 4 == 0 ? 1 + rng() % 3 : 0);
+        if (n % 5 == 4)
+        {
+            static constexpr uint32_t WRITE_OFFSETS[]{0x80, 0x00, 0x0C, 0x44, 0x04, 0x04, 0x08};
+            uint32_t const offset{WRITE_OFFSETS[rng() % 7]};
+            uint32_t const data{static_cast<uint32_t>(rng())};
+            uint32_t const strobe{static_cast<uint32_t>(rng() & 0xF)};
+            traffic.push_back({cycle, offset == 0x44 ? offset + static_cast<uint32_t>(rng() & 7) * 4 : offset, true, data, strobe});
+            continue;
+        }
+        uint32_t const low{static_cast<uint32_t>(rng())};
+        uint32_t offset;
+        switch (rng() % 8)
+        {
+        case 0: offset = 0x100; break;
+        case 1: offset = 0x24 + (low & 3) * 4; break;
+        case 2: offset = 0x40 + (low & 7) * 4; break;
+        case 3: offset = 0x10 + (low & 3) * 4; break;
+        default: offset = (low & 3) * 4; break;
+        }
+        traffic.push_back({cycle, offset, false, 0, 0});
+    }
+    return traffic;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    size_t const count{argc > 1 ? std::stoul(argv[1]) : 1000000};
+    std::vector<Transaction> const traffic{make_traffic(count)};
+
+    rng_model_reset();
+    uint64_t checksum{0};
+    auto const start{std::chrono::steady_clock::now()};
+    for (auto const &txn : traffic)
+    {
+        if (!txn.write)
+        {
+            unsigned int data;
+            checksum += static_cast<unsigned>(rng_model_read(txn.cycle, txn.offset, &data)) + data;
+        }
+        else
+        {
+            checksum += rng_model_preview_write(txn.offset, txn.data, txn.strobe);
+            checksum += static_cast<unsigned>(rng_model_write(txn.offset, txn.data, txn.strobe));
+        }
+    }
+    double const seconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+
+    std::cout << "Golden model, " << count << " transactions over " << traffic.back().cycle << " ACLK: " << std::fixed
+              << std::setprecision(1) << seconds * 1e3 << " ms, " << std::setprecision(0) << seconds * 1e9 / count
+              << " ns per transaction (checksum " << std::hex << checksum << std::dec << ")" << std::endl;
+    return 0;
+}
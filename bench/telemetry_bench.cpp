@@ -0,0 +1,246 @@
+// Compares the block-compressed telemetry format (telemetry.hpp) with raw
+// rows of a 64-bit timestamp and 32-bit register values: file size, full
+// decode against read() of the raw file, and random access by time.
+//
+// Usage: telemetry-bench [ROWS] [DIR]   (default 4000000 rows in /tmp)
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <string>
+#include <vector>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "../telemetry.hpp"
+#include "telemetry_decode.hpp"
+
+namespace
+{
+
+constexpr uint32_t COLUMNS{3};
+constexpr uint64_t PERIOD_NS{1000000};
+constexpr uint32_t UNIT_NS{1000};
+
+/**
+ * @brief A synthetic 1 kHz capture of SYS_24MHZ, SYS_100HZ and SYS_FAN_SPEED.
+ *
+ * Samples are taken at absolute deadlines with a few microseconds of wake-up
+ * jitter and an occasional scheduling hiccup of up to half a millisecond, as
+ * a non-RT sampling thread sees on a loaded system.
+ */
+struct Capture
+{
+    std::vector<uint64_t> timestamps_ns;
+    std::vector<uint32_t> values; // Row-major: COLUMNS per row
+};
+
+Capture generate(size_t const rows)
+{
+    std::mt19937_64 rng{42};
+    std::normal_distribution<double> jitter_us{8.0, 3.0};
+    std::uniform_int_distribution<int> hiccup{0, 999};
+    std::uniform_int_distribution<int> hiccup_us{50, 500};
+    std::uniform_int_distribution<int> fan_step{-3, 3};
+
+    Capture capture;
+    capture.timestamps_ns.resize(rows);
+    capture.values.resize(rows * COLUMNS);
+    uint64_t const start_ns{1'000'000'000'000};
+    uint32_t fan_rpm{2400};
+    for (size_t row{0}; row < rows; ++row)
+    {
+        double late_us{std::max(0.0, jitter_us(rng))};
+        if (hiccup(rng) == 0)
+        {
+            late_us += hiccup_us(rng);
+        }
+        uint64_t const t{start_ns + row * PERIOD_NS + static_cast<uint64_t>(late_us * 1000)};
+        if (row % 100 == 0)
+        {
+            fan_rpm += static_cast<uint32_t>(fan_step(rng));
+        }
+        capture.timestamps_ns[row] = t;
+        capture.values[row * COLUMNS + 0] = static_cast<uint32_t>(t * 24 / 1000); // Wraps every ~179 s
+        capture.values[row * COLUMNS + 1] = static_cast<uint32_t>(t / 10'000'000);
+        capture.values[row * COLUMNS + 2] = fan_rpm;
+    }
+    return capture;
+}
+
+template <typename Function>
+double best_seconds(Function &&function, unsigned const repeats)
+{
+    double best{1e30};
+    for (unsigned repeat{0}; repeat < repeats; ++repeat)
+    {
+        auto const start{std::chrono::steady_clock::now()};
+        function();
+        best = std::min(best, std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count());
+    }
+    return best;
+}
+
+bool read_file(std::string const &path, std::vector<char> &buffer)
+{
+    int const fd{open(path.c_str(), O_RDONLY)};
+    if (fd == -1)
+    {
+        return false;
+    }
+    size_t done{0};
+    ssize_t got{0};
+    while (done < buffer.size() && (got = read(fd, buffer.data() + done, buffer.size() - done)) > 0)
+    {
+        done += static_cast<size_t>(got);
+    }
+    close(fd);
+    return done == buffer.size();
+}
+
+// Drops the file's pages from the page cache, so the next read comes from storage
+void evict(std::string const &path)
+{
+    int const fd{open(path.c_str(), O_RDONLY)};
+    if (fd != -1)
+    {
+        fdatasync(fd);
+        posix_fadvise(fd, 0, 0, POSIX_FADV_DONTNEED);
+        close(fd);
+    }
+}
+
+void report(char const *what, double const seconds, size_t const rows, size_t const bytes)
+{
+    std::cout << std::left << std::setw(28) << what << std::right << std::fixed << std::setprecision(2) << std::setw(10)
+              << seconds * 1e3 << " ms" << std::setw(10) << rows / seconds / 1e6 << " Mrows/s" << std::setw(10)
+              << bytes / seconds / 1e9 << " GB/s" << std::endl;
+}
+
+} // namespace
+
+int main(int argc, char *argv[])
+{
+    size_t const rows{argc > 1 ? std::stoul(argv[1]) : 4000000};
+    std::string const dir{argc > 2 ? argv[2] : "/tmp"};
+    std::string const raw_path{dir + "/telemetry-bench.raw"};
+    std::string const packed_path{dir + "/telemetry-bench.rgts"};
+    constexpr size_t RAW_ROW_BYTES{sizeof(uint64_t) + COLUMNS * sizeof(uint32_t)};
+    constexpr double TARGET_RATIO{10.0}; // Packed size against the raw rows, as originally requested
+
+    Capture const capture{generate(rows)};
+
+    // Raw rows, as a naive capture would store them
+    {
+        std::vector<char> raw(rows * RAW_ROW_BYTES);
+        for (size_t row{0}; row < rows; ++row)
+        {
+            std::memcpy(&raw[row * RAW_ROW_BYTES], &capture.timestamps_ns[row], sizeof(uint64_t));
+            std::memcpy(&raw[row * RAW_ROW_BYTES + sizeof(uint64_t)], &capture.values[row * COLUMNS], COLUMNS * sizeof(uint32_t));
+        }
+        std::ofstream(raw_path, std::ios::binary | std::ios::trunc).write(raw.data(), static_cast<std::streamsize>(raw.size()));
+    }
+
+    uint64_t packed_bytes{0};
+    double const encode_seconds{best_seconds([&]
+    {
+        TelemetryWriter writer(packed_path, {"SYS_24MHZ", "SYS_100HZ", "SYS_FAN_SPEED"}, UNIT_NS);
+        for (size_t row{0}; row < rows; ++row)
+        {
+            writer.append(capture.timestamps_ns[row], &capture.values[row * COLUMNS]);
+        }
+        writer.close();
+        packed_bytes = writer.bytes();
+    }, 1)};
+
+    // Both decoders must reproduce the capture (at the stored microsecond resolution)
+    std::vector<uint64_t> timestamps(rows);
+    std::vector<uint32_t> values(rows * COLUMNS);
+    TelemetryReader const reader(packed_path);
+    for (auto const decode : {+[](std::string const &path, uint64_t *t, uint32_t *v)
+                              {
+                                  TelemetryReader const r(path);
+                                  return telemetry_decode::decode_all(r, t, v);
+                              },
+                              &scalar::telemetry_decode_all})
+    {
+        std::fill(timestamps.begin(), timestamps.end(), 0);
+        decode(packed_path, timestamps.data(), values.data());
+        size_t row{0};
+        for (size_t block{0}; block < reader.blocks(); ++block)
+        {
+            size_t const count{reader.block(block).sample_count};
+            for (size_t i{0}; i < count; ++i, ++row)
+            {
+                bool ok{timestamps[row] == capture.timestamps_ns[row] / UNIT_NS * UNIT_NS};
+                for (uint32_t column{0}; column < COLUMNS; ++column)
+                {
+                    ok = ok && values[(row - i) * COLUMNS + column * count + i] == capture.values[row * COLUMNS + column];
+                }
+                if (!ok)
+                {
+                    std::cerr << "Decoded row " << row << " does not match the capture" << std::endl;
+                    return 1;
+                }
+            }
+        }
+    }
+
+    size_t const raw_bytes{rows * RAW_ROW_BYTES};
+    std::cout << "Telemetry: " << rows << " rows of SYS_24MHZ, SYS_100HZ, SYS_FAN_SPEED at 1 kHz, " << reader.blocks()
+              << " blocks" << std::endl;
+    double const ratio{static_cast<double>(raw_bytes) / packed_bytes};
+    std::cout << "  raw " << raw_bytes << " bytes, packed " << packed_bytes << " bytes (" << std::fixed << std::setprecision(1)
+              << ratio << "x, " << std::setprecision(2) << packed_bytes * 8.0 / rows << " bits/row; the " << std::setprecision(0)
+              << TARGET_RATIO << "x target needs " << std::setprecision(2) << RAW_ROW_BYTES * 8.0 / TARGET_RATIO << " bits/row: "
+              << (ratio > TARGET_RATIO ? "met" : "MISSED") << ")" << std::endl;
+    report("encode", encode_seconds, rows, raw_bytes);
+
+    std::vector<char> raw(raw_bytes);
+    uint64_t volatile checksum{0};
+    auto const decode_simd{[&]
+    {
+        TelemetryReader const r(packed_path);
+        checksum += telemetry_decode::decode_all(r, timestamps.data(), values.data());
+    }};
+
+    // Cold: both files start outside the page cache, as when replaying an archived capture
+    report("read() raw rows, cold", best_seconds([&] { evict(raw_path); read_file(raw_path, raw); }, 3), rows, raw_bytes);
+    report("decode (SIMD), cold", best_seconds([&] { evict(packed_path); decode_simd(); }, 3), rows, raw_bytes);
+
+    // Warm: read() is a memcpy from the page cache, the decoder's worst case
+    double const read_cached_seconds{best_seconds([&] { read_file(raw_path, raw); }, 5)};
+    double const simd_cached_seconds{best_seconds(decode_simd, 5)};
+    double const scalar_cached_seconds{best_seconds([&] { checksum += scalar::telemetry_decode_all(packed_path, timestamps.data(), values.data()); }, 5)};
+    report("read() raw rows, cached", read_cached_seconds, rows, raw_bytes);
+    report("decode (SIMD), cached", simd_cached_seconds, rows, raw_bytes);
+    report("decode (scalar), cached", scalar_cached_seconds, rows, raw_bytes);
+    std::cout << "  cached: SIMD decode is " << std::setprecision(2) << scalar_cached_seconds / simd_cached_seconds
+              << "x faster than scalar and " << simd_cached_seconds / read_cached_seconds << "x slower than read()"
+              << std::endl;
+
+    // Random access: seek to a time through the index and decode only that block
+    size_t constexpr LOOKUPS{100000};
+    std::mt19937_64 rng{7};
+    std::uniform_int_distribution<size_t> pick{0, rows - 1};
+    std::vector<uint64_t> block_timestamps(TELEMETRY_MAX_BLOCK_SAMPLES);
+    std::vector<uint32_t> block_values(TELEMETRY_MAX_BLOCK_SAMPLES * COLUMNS);
+    std::vector<uint32_t> scratch;
+    double const lookup_seconds{best_seconds([&]
+    {
+        for (size_t lookup{0}; lookup < LOOKUPS; ++lookup)
+        {
+            size_t const block{reader.find_block(capture.timestamps_ns[pick(rng)] / UNIT_NS * UNIT_NS)};
+            checksum += reader.decode_block(block, block_timestamps.data(), block_values.data(), scratch);
+        }
+    }, 1)};
+    std::cout << std::left << std::setw(28) << "seek + decode block" << std::right << std::setw(10)
+              << lookup_seconds / LOOKUPS * 1e6 << " us per lookup" << std::defaultfloat << std::endl;
+    return 0;
+}
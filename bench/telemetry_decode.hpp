@@ -0,0 +1,44 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * @brief Decode loop shared by the SIMD and scalar builds of telemetry.hpp.
+ *
+ * Each translation unit instantiates it against its own copy of
+ * TelemetryReader, so both decoders are timed with identical loop code.
+ */
+namespace telemetry_decode
+{
+
+/**
+ * @brief Decodes every block of a capture into caller-provided row buffers.
+ * @param timestamps_ns Receives reader.rows() timestamps.
+ * @param values Receives the values, block by block, column-major within each block.
+ * @return A checksum of the decoded rows, to keep the decode live.
+ */
+template <typename Reader>
+uint64_t decode_all(Reader const &reader, uint64_t *timestamps_ns, uint32_t *values)
+{
+    std::vector<uint32_t> scratch;
+    uint64_t checksum{0};
+    size_t row{0};
+    for (size_t block{0}; block < reader.blocks(); ++block)
+    {
+        size_t const count{reader.decode_block(block, timestamps_ns + row, values + row * reader.columns(), scratch)};
+        checksum += timestamps_ns[row + count - 1] + values[row * reader.columns()];
+        row += count;
+    }
+    return checksum;
+}
+
+} // namespace telemetry_decode
+
+// Entry point into the build of telemetry.hpp with TELEMETRY_NO_SIMD
+namespace scalar
+{
+uint64_t telemetry_decode_all(std::string const &path, uint64_t *timestamps_ns, uint32_t *values);
+} // namespace scalar
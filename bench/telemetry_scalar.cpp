@@ -0,0 +1,37 @@
+// telemetry.hpp built without vector intrinsics, for comparison with the
+// SSE2/NEON decoder.
+#define TELEMETRY_NO_SIMD
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace scalar
+{
+#include "../telemetry.hpp"
+} // namespace scalar
+
+#include "telemetry_decode.hpp"
+
+namespace scalar
+{
+
+uint64_t telemetry_decode_all(std::string const &path, uint64_t *timestamps_ns, uint32_t *values)
+{
+    TelemetryReader const reader(path);
+    return telemetry_decode::decode_all(reader, timestamps_ns, values);
+}
+
+} // namespace scalar
@@ -0,0 +1,255 @@
+#pragma once
+
+#include <array>
+#include <cerrno>
+#include <charconv>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <type_traits>
+#include <vector>
+#include <unistd.h>
+
+/**
+ * @brief Table-driven text formatting of register values, for dumping large captures.
+ *
+ * Each byte of a value is one lookup: eight '0'/'1' characters from
+ * BINARY_DIGITS, or two hex digits from HEX_DIGITS, copied straight into the
+ * output buffer. Nothing goes through iostreams, so a dump costs a few copies
+ * per value plus one write() for the whole buffer.
+ */
+
+/**
+ * @brief How a dump prints each value.
+ */
+enum class DumpFormat : uint8_t
+{
+    Binary,  // MSB first, a space between bytes: "00000000 00000000 00000001 00101100"
+    Hex,     // Zero-padded to the type's width: "0000012c"
+    Decimal
+};
+
+namespace bit_dump_detail
+{
+
+constexpr std::array<std::array<char, 8>, 256> make_binary_digits()
+{
+    std::array<std::array<char, 8>, 256> table{};
+    for (unsigned byte{0}; byte < 256; ++byte)
+    {
+        for (unsigned bit{0}; bit < 8; ++bit)
+        {
+            table[byte][bit] = (byte >> (7 - bit)) & 1 ? '1' : '0';
+        }
+    }
+    return table;
+}
+
+constexpr std::array<std::array<char, 2>, 256> make_hex_digits()
+{
+    constexpr char DIGITS[]{"0123456789abcdef"};
+    std::array<std::array<char, 2>, 256> table{};
+    for (unsigned byte{0}; byte < 256; ++byte)
+    {
+        table[byte][0] = DIGITS[byte >> 4];
+        table[byte][1] = DIGITS[byte & 0xf];
+    }
+    return table;
+}
+
+constexpr std::array<std::array<char, 8>, 256> BINARY_DIGITS{make_binary_digits()};
+constexpr std::array<std::array<char, 2>, 256> HEX_DIGITS{make_hex_digits()};
+
+} // namespace bit_dump_detail
+
+/**
+ * @brief Characters format_value() writes at most for a T in 'format'.
+ */
+template <typename T>
+[[nodiscard]] constexpr size_t dump_chars(DumpFormat const format)
+{
+    return format == DumpFormat::Binary ? sizeof(T) * 9 - 1 : format == DumpFormat::Hex ? sizeof(T) * 2 : std::numeric_limits<T>::digits10 + 2;
+}
+
+/**
+ * @brief Writes 'value' in binary, MSB first with a space between bytes.
+ * @return One past the last character written (dump_chars<T>(DumpFormat::Binary) characters).
+ */
+template <typename T>
+char *format_binary(T const value, char *out)
+{
+    using UT = std::make_unsigned_t<T>;
+    UT const bits{static_cast<UT>(value)};
+    for (size_t byte{sizeof(T)}; byte-- > 0;)
+    {
+        std::memcpy(out, bit_dump_detail::BINARY_DIGITS[(bits >> (8 * byte)) & 0xff].data(), 8);
+        out += 8;
+        if (byte != 0)
+        {
+            *out++ = ' ';
+        }
+    }
+    return out;
+}
+
+/**
+ * @brief Writes 'value' as zero-padded lower-case hex.
+ * @return One past the last character written (dump_chars<T>(DumpFormat::Hex) characters).
+ */
+template <typename T>
+char *format_hex(T const value, char *out)
+{
+    using UT = std::make_unsigned_t<T>;
+    UT const bits{static_cast<UT>(value)};
+    for (size_t byte{sizeof(T)}; byte-- > 0;)
+    {
+        std::memcpy(out, bit_dump_detail::HEX_DIGITS[(bits >> (8 * byte)) & 0xff].data(), 2);
+        out += 2;
+    }
+    return out;
+}
+
+/**
+ * @brief Writes 'value' in the given format; 'out' must have room for dump_chars<T>(format).
+ * @return One past the last character written.
+ */
+template <typename T>
+char *format_value(T const value, DumpFormat const format, char *out)
+{
+    switch (format)
+    {
+    case DumpFormat::Binary:
+        return format_binary(value, out);
+    case DumpFormat::Hex:
+        return format_hex(value, out);
+    default:
+        return std::to_chars(out, out + dump_chars<T>(DumpFormat::Decimal), value).ptr;
+    }
+}
+
+/**
+ * @brief Writes all of [data, data + size) to a file descriptor.
+ * @throws std::runtime_error If write() fails.
+ */
+inline void write_all(int const fd, char const *data, size_t size)
+{
+    while (size != 0)
+    {
+        ssize_t const written{write(fd, data, size)};
+        if (written < 0)
+        {
+            if (errno == EINTR)
+            {
+                continue;
+            }
+            throw std::runtime_error(std::string("Error: dump write failed: ") + std::strerror(errno));
+        }
+        data += written;
+        size -= static_cast<size_t>(written);
+    }
+}
+
+/**
+ * @brief Dumps one value per line to 'fd': the whole dump is formatted into a
+ * single buffer, then written with one write() (more only if the kernel takes
+ * it in pieces, as pipes do).
+ */
+template <typename T>
+void dump_values(T const *values, size_t const count, DumpFormat const format, int const fd)
+{
+    std::vector<char> text(count * (dump_chars<T>(format) + 1));
+    char *out{text.data()};
+    for (size_t i{0}; i < count; ++i)
+    {
+        out = format_value(values[i], format, out);
+        *out++ = '\n';
+    }
+    write_all(fd, text.data(), static_cast<size_t>(out - text.data()));
+}
+
+/**
+ * @brief An output buffer for dumps too large to format in one piece: callers
+ * reserve room, format into it and commit, and the buffer goes out in one
+ * write() each time it fills.
+ */
+class DumpBuffer
+{
+public:
+    static constexpr size_t DEFAULT_CAPACITY{4 << 20};
+
+    explicit DumpBuffer(int const fd, size_t const capacity = DEFAULT_CAPACITY) : m_fd(fd), m_buffer(capacity)
+    {
+    }
+
+    ~DumpBuffer()
+    {
+        try
+        {
+            flush();
+        }
+        catch (std::runtime_error const &)
+        {
+        }
+    }
+
+    DumpBuffer(DumpBuffer const &) = delete;
+    DumpBuffer &operator=(DumpBuffer const &) = delete;
+
+    /**
+     * @brief Returns room for at least 'bytes' characters (flushing first if needed); pass the end to commit().
+     */
+    char *reserve(size_t const bytes)
+    {
+        if (m_buffer.size() - m_used < bytes)
+        {
+            flush();
+            if (m_buffer.size() < bytes)
+            {
+                m_buffer.resize(bytes);
+            }
+        }
+        return m_buffer.data() + m_used;
+    }
+
+    void commit(char const *const end)
+    {
+        m_used = static_cast<size_t>(end - m_buffer.data());
+    }
+
+    DumpBuffer &append(char const *const text, size_t const length)
+    {
+        char *const out{reserve(length)};
+        std::memcpy(out, text, length);
+        commit(out + length);
+        return *this;
+    }
+
+    DumpBuffer &append(char const c)
+    {
+        char *const out{reserve(1)};
+        *out = c;
+        commit(out + 1);
+        return *this;
+    }
+
+    template <typename T>
+    DumpBuffer &value(T const value, DumpFormat const format)
+    {
+        commit(format_value(value, format, reserve(dump_chars<T>(format))));
+        return *this;
+    }
+
+    void flush()
+    {
+        write_all(m_fd, m_buffer.data(), m_used);
+        m_used = 0;
+    }
+
+private:
+    int const m_fd;
+    std::vector<char> m_buffer;
+    size_t m_used{0};
+};
@@ -1,8 +1,10 @@
 #pragma once
 
+#include <cstring>
 #include <iostream>
 #include <type_traits>
-#include <iomanip>
+
+#include "bit_dump.hpp"
 
 /**
  * @brief Helper functions for common bit manipulation tasks.
@@ -21,30 +23,20 @@
  */
 template <typename T>
 void print_binary(const char* name, T value) {
-    // Determine the number of bits based on the type T
-    constexpr size_t BITS = sizeof(T) * 8;
-    std::cout << std::setw(15) << std::left << name << ": ";
-
-    // Iterate from MSB to LSB
-    for (size_t i = 0; i < BITS; ++i) {
-        // Use an unsigned type for shifting to prevent undefined behavior
-        // if T is signed and negative, though typically used on positive values.
-        using UT = typename std::make_unsigned<T>::type;
-        UT u_value = static_cast<UT>(value);
-        
-        // Check if the i-th bit from the left (BITS - 1 - i) is set
-        if ((u_value >> (BITS - 1 - i)) & 1) {
-            std::cout << "1";
-        } else {
-            std::cout << "0";
-        }
-
-        // Add a space every 8 bits for readability
-        if ((i + 1) % 8 == 0 && (i + 1) != BITS) {
-            std::cout << " ";
-        }
+    // Name left-aligned in 15 columns, then the line is formatted in place and written at once
+    constexpr size_t NAME_WIDTH = 15;
+    size_t const name_length = std::strlen(name);
+    std::cout.write(name, static_cast<std::streamsize>(name_length));
+    char line[NAME_WIDTH + 2 + dump_chars<T>(DumpFormat::Binary) + 8 + dump_chars<T>(DumpFormat::Decimal) + 2];
+    char *out = line;
+    for (size_t pad = name_length; pad < NAME_WIDTH; ++pad) {
+        *out++ = ' ';
     }
-    std::cout << " (Dec: " << std::dec << value << ")" << std::endl;
+    out = format_binary(value, static_cast<char *>(std::memcpy(out, ": ", 2)) + 2);
+    out = format_value(value, DumpFormat::Decimal, static_cast<char *>(std::memcpy(out, " (Dec: ", 7)) + 7);
+    *out++ = ')';
+    *out++ = '\n';
+    std::cout.write(line, out - line);
 }
 
 // --- Single Bit Operations ---
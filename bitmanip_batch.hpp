@@ -0,0 +1,360 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+// Batch kernels use the baseline vector ISA of the target (SSE2 on x86-64,
+// NEON on AArch64), and on x86-64 with GCC switch to AVX2 at run time when the
+// CPU has it; define BITMANIP_NO_SIMD to build only the scalar kernels.
+#if !defined(BITMANIP_NO_SIMD) && defined(__SSE2__) && defined(__x86_64__)
+#define BITMANIP_SIMD_SSE2
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#define BITMANIP_SIMD_AVX2
+#endif
+#elif !defined(BITMANIP_NO_SIMD) && defined(__ARM_NEON) && defined(__aarch64__)
+#define BITMANIP_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+/**
+ * @brief Which change of a masked field find_transitions() reports.
+ */
+enum class Edge : uint8_t
+{
+    Any,     // Any masked bit changed
+    Rising,  // A masked bit went 0 -> 1
+    Falling  // A masked bit went 1 -> 0
+};
+
+namespace bitmanip_batch_detail
+{
+
+template <typename T>
+[[nodiscard]] constexpr T low_mask(unsigned const num_bits)
+{
+    return num_bits >= sizeof(T) * 8 ? static_cast<T>(~T{0}) : static_cast<T>((T{1} << num_bits) - 1);
+}
+
+template <typename T>
+[[nodiscard]] constexpr T edge_bits(T const previous, T const current, T const mask, Edge const edge)
+{
+    switch (edge)
+    {
+    case Edge::Rising:
+        return static_cast<T>(~previous & current & mask);
+    case Edge::Falling:
+        return static_cast<T>(previous & ~current & mask);
+    default:
+        return static_cast<T>((previous ^ current) & mask);
+    }
+}
+
+// --- Scalar kernels: the fallback, and the tail of every vector kernel ---
+
+template <typename T>
+void extract_scalar(T const *in, T *out, size_t const count, unsigned const start_pos, T const mask)
+{
+    for (size_t i{0}; i < count; ++i)
+    {
+        out[i] = static_cast<T>((in[i] >> start_pos) & mask);
+    }
+}
+
+template <typename T>
+void insert_scalar(T *target, T const *source, size_t const count, unsigned const start_pos, T const mask)
+{
+    T const field_mask{static_cast<T>(mask << start_pos)};
+    for (size_t i{0}; i < count; ++i)
+    {
+        target[i] = static_cast<T>((target[i] & ~field_mask) | ((source[i] << start_pos) & field_mask));
+    }
+}
+
+template <typename T>
+uint64_t count_scalar(T const *values, size_t const count, T const mask)
+{
+    uint64_t total{0};
+    for (size_t i{0}; i < count; ++i)
+    {
+        total += static_cast<uint64_t>(__builtin_popcountll(values[i] & mask));
+    }
+    return total;
+}
+
+// Scans indices [first, last), first >= 1: 'found' counts every edge, indices are stored while they fit
+template <typename T>
+void transitions_scalar(T const *values, size_t const first, size_t const last, T const mask, Edge const edge, size_t *indices,
+                        size_t const max_indices, size_t &found)
+{
+    for (size_t i{first}; i < last; ++i)
+    {
+        if (edge_bits(values[i - 1], values[i], mask, edge) != 0)
+        {
+            if (found < max_indices)
+            {
+                indices[found] = i;
+            }
+            ++found;
+        }
+    }
+}
+
+template <typename T>
+size_t transitions_scalar_all(T const *values, size_t const count, T const mask, Edge const edge, size_t *indices, size_t const max_indices)
+{
+    size_t found{0};
+    transitions_scalar(values, 1, count, mask, edge, indices, max_indices, found);
+    return found;
+}
+
+/**
+ * @brief One implementation of every batch operation for element type T.
+ */
+template <typename T>
+struct Kernels
+{
+    char const *isa;
+    void (*extract)(T const *, T *, size_t, unsigned, T);
+    void (*insert)(T *, T const *, size_t, unsigned, T);
+    uint64_t (*count)(T const *, size_t, T);
+    size_t (*transitions)(T const *, size_t, T, Edge, size_t *, size_t);
+};
+
+template <typename T>
+constexpr Kernels<T> SCALAR_KERNELS{"scalar", extract_scalar<T>, insert_scalar<T>, count_scalar<T>, transitions_scalar_all<T>};
+
+#if defined(BITMANIP_SIMD_SSE2)
+namespace sse2
+{
+constexpr char const *ISA{"SSE2"};
+using Vector = __m128i;
+using Shift = __m128i;
+using Counts = __m128i; // Two 64-bit running totals
+
+inline Vector load(void const *p) { return _mm_loadu_si128(static_cast<__m128i const *>(p)); }
+inline void store(void *p, Vector const v) { _mm_storeu_si128(static_cast<__m128i *>(p), v); }
+template <typename T> Vector broadcast(T const x) { return sizeof(T) == 8 ? _mm_set1_epi64x(static_cast<long long>(x)) : _mm_set1_epi32(static_cast<int>(x)); }
+inline Shift shift_count(unsigned const n) { return _mm_cvtsi32_si128(static_cast<int>(n)); }
+template <typename T> Vector shift_right(Vector const v, Shift const n) { return sizeof(T) == 8 ? _mm_srl_epi64(v, n) : _mm_srl_epi32(v, n); }
+template <typename T> Vector shift_left(Vector const v, Shift const n) { return sizeof(T) == 8 ? _mm_sll_epi64(v, n) : _mm_sll_epi32(v, n); }
+inline Vector and_(Vector const a, Vector const b) { return _mm_and_si128(a, b); }
+inline Vector andnot(Vector const a, Vector const b) { return _mm_andnot_si128(a, b); } // ~a & b
+inline Vector or_(Vector const a, Vector const b) { return _mm_or_si128(a, b); }
+inline Vector xor_(Vector const a, Vector const b) { return _mm_xor_si128(a, b); }
+// Bit k set if lane k is non-zero; SSE2 has no 64-bit compare, so 64-bit lanes combine their two 32-bit halves
+template <typename T> unsigned nonzero_lanes(Vector const v)
+{
+    __m128i const zero32{_mm_cmpeq_epi32(v, _mm_setzero_si128())};
+    return sizeof(T) == 8 ? 0x3u & ~static_cast<unsigned>(_mm_movemask_pd(_mm_castsi128_pd(_mm_and_si128(zero32, _mm_shuffle_epi32(zero32, 0xB1)))))
+                          : 0xFu & ~static_cast<unsigned>(_mm_movemask_ps(_mm_castsi128_ps(zero32)));
+}
+
+inline Counts counts_zero() { return _mm_setzero_si128(); }
+// SSE2 has no byte shuffle, so bits are counted per byte with the SWAR reduction, then summed per 64-bit lane
+inline Counts counts_add(Counts const totals, Vector v)
+{
+    v = _mm_sub_epi8(v, _mm_and_si128(_mm_srli_epi16(v, 1), _mm_set1_epi8(0x55)));
+    v = _mm_add_epi8(_mm_and_si128(v, _mm_set1_epi8(0x33)), _mm_and_si128(_mm_srli_epi16(v, 2), _mm_set1_epi8(0x33)));
+    v = _mm_and_si128(_mm_add_epi8(v, _mm_srli_epi16(v, 4)), _mm_set1_epi8(0x0f));
+    return _mm_add_epi64(totals, _mm_sad_epu8(v, _mm_setzero_si128()));
+}
+inline uint64_t counts_sum(Counts const totals)
+{
+    return static_cast<uint64_t>(_mm_cvtsi128_si64(totals)) + static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(totals, totals)));
+}
+
+#include "bitmanip_batch_kernels.hpp"
+} // namespace sse2
+#endif
+
+#if defined(BITMANIP_SIMD_AVX2)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+namespace avx2
+{
+constexpr char const *ISA{"AVX2"};
+using Vector = __m256i;
+using Shift = __m128i;
+using Counts = __m256i; // Four 64-bit running totals
+
+inline Vector load(void const *p) { return _mm256_loadu_si256(static_cast<__m256i const *>(p)); }
+inline void store(void *p, Vector const v) { _mm256_storeu_si256(static_cast<__m256i *>(p), v); }
+template <typename T> Vector broadcast(T const x) { return sizeof(T) == 8 ? _mm256_set1_epi64x(static_cast<long long>(x)) : _mm256_set1_epi32(static_cast<int>(x)); }
+inline Shift shift_count(unsigned const n) { return _mm_cvtsi32_si128(static_cast<int>(n)); }
+template <typename T> Vector shift_right(Vector const v, Shift const n) { return sizeof(T) == 8 ? _mm256_srl_epi64(v, n) : _mm256_srl_epi32(v, n); }
+template <typename T> Vector shift_left(Vector const v, Shift const n) { return sizeof(T) == 8 ? _mm256_sll_epi64(v, n) : _mm256_sll_epi32(v, n); }
+inline Vector and_(Vector const a, Vector const b) { return _mm256_and_si256(a, b); }
+inline Vector andnot(Vector const a, Vector const b) { return _mm256_andnot_si256(a, b); } // ~a & b
+inline Vector or_(Vector const a, Vector const b) { return _mm256_or_si256(a, b); }
+inline Vector xor_(Vector const a, Vector const b) { return _mm256_xor_si256(a, b); }
+template <typename T> unsigned nonzero_lanes(Vector const v)
+{
+    return sizeof(T) == 8 ? 0xFu & ~static_cast<unsigned>(_mm256_movemask_pd(_mm256_castsi256_pd(_mm256_cmpeq_epi64(v, _mm256_setzero_si256()))))
+                          : 0xFFu & ~static_cast<unsigned>(_mm256_movemask_ps(_mm256_castsi256_ps(_mm256_cmpeq_epi32(v, _mm256_setzero_si256()))));
+}
+
+inline Counts counts_zero() { return _mm256_setzero_si256(); }
+// Nibble lookup with vpshufb, summed per 64-bit lane
+inline Counts counts_add(Counts const totals, Vector const v)
+{
+    __m256i const table{_mm256_setr_epi8(0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4, 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4)};
+    __m256i const nibble{_mm256_set1_epi8(0x0f)};
+    __m256i const bytes{_mm256_add_epi8(_mm256_shuffle_epi8(table, _mm256_and_si256(v, nibble)),
+                                        _mm256_shuffle_epi8(table, _mm256_and_si256(_mm256_srli_epi16(v, 4), nibble)))};
+    return _mm256_add_epi64(totals, _mm256_sad_epu8(bytes, _mm256_setzero_si256()));
+}
+inline uint64_t counts_sum(Counts const totals)
+{
+    __m128i const half{_mm_add_epi64(_mm256_castsi256_si128(totals), _mm256_extracti128_si256(totals, 1))};
+    return static_cast<uint64_t>(_mm_cvtsi128_si64(half)) + static_cast<uint64_t>(_mm_cvtsi128_si64(_mm_unpackhi_epi64(half, half)));
+}
+
+#include "bitmanip_batch_kernels.hpp"
+} // namespace avx2
+#pragma GCC pop_options
+#endif
+
+#if defined(BITMANIP_SIMD_NEON)
+namespace neon
+{
+constexpr char const *ISA{"NEON"};
+using Vector = uint8x16_t;
+using Shift = int;
+using Counts = uint64x2_t;
+
+inline Vector load(void const *p) { return vld1q_u8(static_cast<uint8_t const *>(p)); }
+inline void store(void *p, Vector const v) { vst1q_u8(static_cast<uint8_t *>(p), v); }
+template <typename T> Vector broadcast(T const x) { return sizeof(T) == 8 ? vreinterpretq_u8_u64(vdupq_n_u64(x)) : vreinterpretq_u8_u32(vdupq_n_u32(static_cast<uint32_t>(x))); }
+inline Shift shift_count(unsigned const n) { return static_cast<int>(n); }
+// NEON shifts by a register take a signed count per lane; negative shifts right
+template <typename T> Vector shift_right(Vector const v, Shift const n)
+{
+    return sizeof(T) == 8 ? vreinterpretq_u8_u64(vshlq_u64(vreinterpretq_u64_u8(v), vdupq_n_s64(-n)))
+                          : vreinterpretq_u8_u32(vshlq_u32(vreinterpretq_u32_u8(v), vdupq_n_s32(-n)));
+}
+template <typename T> Vector shift_left(Vector const v, Shift const n)
+{
+    return sizeof(T) == 8 ? vreinterpretq_u8_u64(vshlq_u64(vreinterpretq_u64_u8(v), vdupq_n_s64(n)))
+                          : vreinterpretq_u8_u32(vshlq_u32(vreinterpretq_u32_u8(v), vdupq_n_s32(n)));
+}
+inline Vector and_(Vector const a, Vector const b) { return vandq_u8(a, b); }
+inline Vector andnot(Vector const a, Vector const b) { return vbicq_u8(b, a); } // ~a & b
+inline Vector or_(Vector const a, Vector const b) { return vorrq_u8(a, b); }
+inline Vector xor_(Vector const a, Vector const b) { return veorq_u8(a, b); }
+// NEON has no movemask: weight each all-ones lane by its bit and add across the vector
+template <typename T> unsigned nonzero_lanes(Vector const v)
+{
+    if constexpr (sizeof(T) == 8)
+    {
+        uint64x2_t const weights{1, 2};
+        return static_cast<unsigned>(vaddvq_u64(vandq_u64(vtstq_u64(vreinterpretq_u64_u8(v), vreinterpretq_u64_u8(v)), weights)));
+    }
+    else
+    {
+        uint32x4_t const weights{1, 2, 4, 8};
+        return vaddvq_u32(vandq_u32(vtstq_u32(vreinterpretq_u32_u8(v), vreinterpretq_u32_u8(v)), weights));
+    }
+}
+
+inline Counts counts_zero() { return vdupq_n_u64(0); }
+inline Counts counts_add(Counts const totals, Vector const v) { return vpadalq_u32(totals, vpaddlq_u16(vpaddlq_u8(vcntq_u8(v)))); }
+inline uint64_t counts_sum(Counts const totals) { return vaddvq_u64(totals); }
+
+#include "bitmanip_batch_kernels.hpp"
+} // namespace neon
+#endif
+
+template <typename T>
+Kernels<T> const &select_kernels()
+{
+#if defined(BITMANIP_SIMD_AVX2)
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return avx2::KERNELS<T>;
+    }
+#endif
+#if defined(BITMANIP_SIMD_SSE2)
+    return sse2::KERNELS<T>;
+#elif defined(BITMANIP_SIMD_NEON)
+    return neon::KERNELS<T>;
+#else
+    return SCALAR_KERNELS<T>;
+#endif
+}
+
+/**
+ * @brief The best kernels this CPU supports, chosen on first use.
+ */
+template <typename T>
+Kernels<T> const &kernels()
+{
+    static_assert(std::is_same_v<T, uint32_t> || std::is_same_v<T, uint64_t>, "batch operations take uint32_t or uint64_t samples");
+    static Kernels<T> const &selected{select_kernels<T>()};
+    return selected;
+}
+
+} // namespace bitmanip_batch_detail
+
+/**
+ * @brief Batch versions of the bitmanip.hpp field operations, for post-processing
+ * captured register samples (uint32_t or uint64_t arrays) a vector at a time.
+ *
+ * Positions start from 0 (LSB) and must be below the element width; a field
+ * width at or above the element width covers every remaining bit, as with
+ * extract_bits() and insert_bits().
+ */
+
+/**
+ * @brief Extracts the same field from every value: fields[i] = extract_bits(values[i], start_pos, num_bits).
+ * @param values The samples.
+ * @param fields Output, 'count' elements (may alias 'values').
+ */
+template <typename T>
+void extract_bits_batch(T const *values, T *fields, size_t const count, unsigned const start_pos, unsigned const num_bits)
+{
+    bitmanip_batch_detail::kernels<T>().extract(values, fields, count, start_pos, bitmanip_batch_detail::low_mask<T>(num_bits));
+}
+
+/**
+ * @brief Inserts a field into every target: targets[i] = insert_bits(targets[i], sources[i], start_pos, num_bits).
+ */
+template <typename T>
+void insert_bits_batch(T *targets, T const *sources, size_t const count, unsigned const start_pos, unsigned const num_bits)
+{
+    bitmanip_batch_detail::kernels<T>().insert(targets, sources, count, start_pos, bitmanip_batch_detail::low_mask<T>(num_bits));
+}
+
+/**
+ * @brief Counts the set bits of (values[i] & mask) over every value.
+ */
+template <typename T>
+uint64_t count_set_bits_batch(T const *values, size_t const count, T const mask = static_cast<T>(~T{0}))
+{
+    return bitmanip_batch_detail::kernels<T>().count(values, count, mask);
+}
+
+/**
+ * @brief Finds the samples at which a masked field changes.
+ * @param values The samples.
+ * @param count Number of samples.
+ * @param mask The bits to watch.
+ * @param edge Any change, or only 0 -> 1 or 1 -> 0 transitions of a watched bit.
+ * @param indices Output: index i of each sample that differs from sample i - 1, in order.
+ * @param max_indices Capacity of 'indices'; further transitions are counted but not stored.
+ * @return The total number of transitions, which may exceed max_indices.
+ */
+template <typename T>
+size_t find_transitions(T const *values, size_t const count, T const mask, Edge const edge, size_t *indices, size_t const max_indices)
+{
+    return bitmanip_batch_detail::kernels<T>().transitions(values, count, mask, edge, indices, max_indices);
+}
+
+/**
+ * @brief Names the instruction set the batch operations run on ("AVX2", "SSE2", "NEON" or "scalar").
+ */
+[[nodiscard]] inline char const *bit_batch_isa()
+{
+    return bitmanip_batch_detail::kernels<uint32_t>().isa;
+}
@@ -0,0 +1,93 @@
+// Batch kernels shared by every vector ISA. bitmanip_batch.hpp includes this
+// file once per ISA, inside a namespace that defines Vector, Shift, Counts and
+// the primitives used below, and under that ISA's target options, so each
+// copy is compiled for its own instruction set. Tails shorter than a vector
+// fall through to the scalar kernels.
+
+template <typename T>
+void extract(T const *in, T *out, size_t const count, unsigned const start_pos, T const mask)
+{
+    constexpr size_t LANES{sizeof(Vector) / sizeof(T)};
+    Vector const field_mask{broadcast<T>(mask)};
+    Shift const shift{shift_count(start_pos)};
+    size_t i{0};
+    for (; i + LANES <= count; i += LANES)
+    {
+        store(out + i, and_(shift_right<T>(load(in + i), shift), field_mask));
+    }
+    extract_scalar(in + i, out + i, count - i, start_pos, mask);
+}
+
+template <typename T>
+void insert(T *target, T const *source, size_t const count, unsigned const start_pos, T const mask)
+{
+    constexpr size_t LANES{sizeof(Vector) / sizeof(T)};
+    Vector const field_mask{broadcast<T>(static_cast<T>(mask << start_pos))};
+    Shift const shift{shift_count(start_pos)};
+    size_t i{0};
+    for (; i + LANES <= count; i += LANES)
+    {
+        Vector const kept{andnot(field_mask, load(target + i))};
+        store(target + i, or_(kept, and_(shift_left<T>(load(source + i), shift), field_mask)));
+    }
+    insert_scalar(target + i, source + i, count - i, start_pos, mask);
+}
+
+template <typename T>
+uint64_t count_bits(T const *values, size_t const count, T const mask)
+{
+    constexpr size_t LANES{sizeof(Vector) / sizeof(T)};
+    Vector const bits{broadcast<T>(mask)};
+    Counts totals{counts_zero()};
+    size_t i{0};
+    for (; i + LANES <= count; i += LANES)
+    {
+        totals = counts_add(totals, and_(load(values + i), bits));
+    }
+    return counts_sum(totals) + count_scalar(values + i, count - i, mask);
+}
+
+// One bit per lane marks where an edge is, so each vector costs a compare whether or not it holds any
+template <Edge E, typename T>
+size_t transitions_edge(T const *values, size_t const count, T const mask, size_t *indices, size_t const max_indices)
+{
+    constexpr size_t LANES{sizeof(Vector) / sizeof(T)};
+    Vector const bits{broadcast<T>(mask)};
+    size_t found{0};
+    size_t i{1};
+    for (; i + LANES <= count; i += LANES)
+    {
+        Vector const previous{load(values + i - 1)};
+        Vector const current{load(values + i)};
+        Vector const changed{E == Edge::Rising    ? andnot(previous, current)
+                             : E == Edge::Falling ? andnot(current, previous)
+                                                  : xor_(previous, current)};
+        for (unsigned lanes{nonzero_lanes<T>(and_(changed, bits))}; lanes != 0; lanes &= lanes - 1)
+        {
+            if (found < max_indices)
+            {
+                indices[found] = i + static_cast<size_t>(__builtin_ctz(lanes));
+            }
+            ++found;
+        }
+    }
+    transitions_scalar(values, i, count, mask, E, indices, max_indices, found);
+    return found;
+}
+
+template <typename T>
+size_t transitions(T const *values, size_t const count, T const mask, Edge const edge, size_t *indices, size_t const max_indices)
+{
+    switch (edge)
+    {
+    case Edge::Rising:
+        return transitions_edge<Edge::Rising>(values, count, mask, indices, max_indices);
+    case Edge::Falling:
+        return transitions_edge<Edge::Falling>(values, count, mask, indices, max_indices);
+    default:
+        return transitions_edge<Edge::Any>(values, count, mask, indices, max_indices);
+    }
+}
+
+template <typename T>
+constexpr Kernels<T> KERNELS{ISA, extract<T>, insert<T>, count_bits<T>, transitions<T>};
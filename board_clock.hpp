@@ -0,0 +1,331 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <condition_variable>
+#include <cstdint>
+#include <iostream>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <time.h>
+
+#include "cpu_topology.hpp"
+#include "register_manager.hpp"
+#include "registers.hpp"
+
+/**
+ * @brief The cheapest free-running host counter: the generic timer (cntvct_el0)
+ * on AArch64, CLOCK_MONOTONIC_RAW in nanoseconds elsewhere. Neither is slewed
+ * by NTP, so the board clock can be fitted against it with a straight line.
+ */
+struct HostClock
+{
+    [[nodiscard]] static uint64_t now()
+    {
+#if defined(__aarch64__)
+        uint64_t ticks;
+        asm volatile("isb; mrs %0, cntvct_el0" : "=r"(ticks)::"memory");
+        return ticks;
+#else
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC_RAW, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000 + static_cast<uint64_t>(ts.tv_nsec);
+#endif
+    }
+
+    [[nodiscard]] static double frequency()
+    {
+#if defined(__aarch64__)
+        uint64_t hz;
+        asm volatile("mrs %0, cntfrq_el0" : "=r"(hz));
+        return static_cast<double>(hz);
+#else
+        return 1e9;
+#endif
+    }
+};
+
+/**
+ * @brief Tracks the board's SYS_24MHZ counter against the host clock.
+ *
+ * Each correlation point pairs a SYS_24MHZ read with the host clock at the
+ * midpoint of the read, keeping the fastest of several attempts so bus and
+ * scheduling delays do not skew it. The 32-bit counter (which wraps every
+ * ~179 s) is extended to 64 bits using the current fit to predict the
+ * wrap count, so gaps between points may be much longer than one wrap. A
+ * least-squares line through the most recent WINDOW points gives the
+ * board/host rate (drift) and offset.
+ *
+ * Conversions read a published copy of the fit through a sequence lock, so
+ * now_board_ticks() costs one host clock read and a multiply, with no MMIO,
+ * and is safe to call from any thread while start() keeps the fit current.
+ */
+class BoardClock
+{
+public:
+    static constexpr double NOMINAL_HZ{24e6};
+    static constexpr size_t WINDOW{64};         // Points in the regression
+    static constexpr unsigned READ_ATTEMPTS{8}; // Reads per point; the fastest is kept
+    static constexpr double MIN_SPAN_S{0.01};   // Shorter baselines assume the nominal rate
+
+    /**
+     * @brief Fit quality, for reporting.
+     */
+    struct Fit
+    {
+        size_t points{0};
+        double drift_ppm{0};    // Board rate relative to NOMINAL_HZ, by the host clock
+        double residual_ns{0};  // RMS distance of the points from the line
+        double read_ns{0};      // Round trip of the latest point's SYS_24MHZ read
+        uint64_t wraps{0};      // SYS_24MHZ wraps seen
+    };
+
+    /**
+     * @brief Constructor: Takes the first correlation point. Until the points
+     * span MIN_SPAN_S, conversions assume the nominal 24 MHz rate.
+     * @param apb_reg_access The APB mapping holding SYS_24MHZ.
+     */
+    explicit BoardClock(RegisterManager const &apb_reg_access) : m_apb(apb_reg_access), m_host_hz(HostClock::frequency())
+    {
+        sample();
+    }
+
+    ~BoardClock()
+    {
+        stop();
+    }
+
+    BoardClock(BoardClock const &) = delete;
+    BoardClock &operator=(BoardClock const &) = delete;
+
+    /**
+     * @brief Takes one correlation point and refits.
+     */
+    void sample()
+    {
+        // Keep the read with the shortest round trip: its midpoint is the tightest bound on when it happened
+        uint64_t best_rtt{UINT64_MAX};
+        uint64_t host{0};
+        uint32_t raw{0};
+        for (unsigned attempt{0}; attempt < READ_ATTEMPTS; ++attempt)
+        {
+            uint64_t const before{HostClock::now()};
+            uint32_t const value{m_apb.readReg(APBRegister::SYS_24MHZ)};
+            uint64_t const after{HostClock::now()};
+            if (after - before < best_rtt)
+            {
+                best_rtt = after - before;
+                host = before + (after - before) / 2;
+                raw = value;
+            }
+        }
+
+        std::lock_guard<std::mutex> const lock(m_fit_mutex);
+        uint64_t board{raw};
+        if (m_count != 0)
+        {
+            // Predict the full count, then let the 32-bit read correct the low half
+            uint64_t const predicted{m_count >= 2 ? board_ticks_at(host) : m_points[(m_next + WINDOW - 1) % WINDOW].board +
+                                                                            static_cast<uint32_t>(raw - m_last_raw)};
+            board = predicted + static_cast<int64_t>(static_cast<int32_t>(raw - static_cast<uint32_t>(predicted)));
+            m_fit.wraps += (board >> 32) - (m_points[(m_next + WINDOW - 1) % WINDOW].board >> 32);
+        }
+        m_last_raw = raw;
+        m_points[m_next] = Point{host, board};
+        m_next = (m_next + 1) % WINDOW;
+        m_count = std::min(m_count + 1, WINDOW);
+        m_fit.read_ns = best_rtt * 1e9 / m_host_hz;
+        refit(host, board);
+    }
+
+    /**
+     * @brief Keeps the fit current by sampling every 'interval' on a background thread.
+     * @param interval Time between correlation points.
+     * @param cpus CPUs the thread may run on (empty for any).
+     */
+    void start(std::chrono::milliseconds const interval, std::vector<unsigned> const &cpus = {})
+    {
+        stop();
+        m_running = true;
+        m_thread = std::thread([this, interval, cpus]
+        {
+            if (!CpuTopology::pin_current_thread(cpus))
+            {
+                std::cerr << "[WARN] Could not pin the board clock thread" << std::endl;
+            }
+            std::unique_lock<std::mutex> lock(m_thread_mutex);
+            while (!m_wake.wait_for(lock, interval, [this] { return !m_running; }))
+            {
+                lock.unlock();
+                sample();
+                lock.lock();
+            }
+        });
+    }
+
+    void stop()
+    {
+        {
+            std::lock_guard<std::mutex> const lock(m_thread_mutex);
+            m_running = false;
+        }
+        m_wake.notify_all();
+        if (m_thread.joinable())
+        {
+            m_thread.join();
+        }
+    }
+
+    /**
+     * @brief Returns the current board time in 24 MHz ticks (64-bit, never wraps), without an MMIO read.
+     */
+    [[nodiscard]] uint64_t now_board_ticks() const
+    {
+        return board_ticks_at(HostClock::now());
+    }
+
+    /**
+     * @brief Converts a HostClock::now() reading to board ticks.
+     */
+    [[nodiscard]] uint64_t board_ticks_at(uint64_t const host_ticks) const
+    {
+        Model const model{load_model()};
+        double const elapsed{static_cast<double>(static_cast<int64_t>(host_ticks - model.host))};
+        return model.board + static_cast<uint64_t>(std::llround(elapsed * model.rate));
+    }
+
+    /**
+     * @brief Converts board ticks to the HostClock::now() reading at that moment.
+     */
+    [[nodiscard]] uint64_t host_ticks_at(uint64_t const board_ticks) const
+    {
+        Model const model{load_model()};
+        double const elapsed{static_cast<double>(static_cast<int64_t>(board_ticks - model.board))};
+        return model.host + static_cast<uint64_t>(std::llround(elapsed / model.rate));
+    }
+
+    /**
+     * @brief Converts a board tick count to nanoseconds.
+     */
+    [[nodiscard]] static double ticks_to_ns(double const ticks)
+    {
+        return ticks * 1e9 / NOMINAL_HZ;
+    }
+
+    [[nodiscard]] Fit fit() const
+    {
+        std::lock_guard<std::mutex> const lock(m_fit_mutex);
+        return m_fit;
+    }
+
+private:
+    struct Point
+    {
+        uint64_t host;
+        uint64_t board;
+    };
+
+    // board = board_ref + rate * (host - host_ref)
+    struct Model
+    {
+        uint64_t host;
+        uint64_t board;
+        double rate;
+    };
+
+    RegisterManager const &m_apb;
+    double const m_host_hz;
+
+    mutable std::mutex m_fit_mutex; // Guards the points and m_fit; conversions never take it
+    std::array<Point, WINDOW> m_points{};
+    size_t m_next{0};
+    size_t m_count{0};
+    uint32_t m_last_raw{0};
+    Fit m_fit{};
+
+    // Published model, read lock-free: odd sequence numbers mark an update in progress
+    std::atomic<uint32_t> m_sequence{0};
+    std::atomic<uint64_t> m_model_host{0};
+    std::atomic<uint64_t> m_model_board{0};
+    std::atomic<double> m_model_rate{NOMINAL_HZ / 1e9};
+
+    std::mutex m_thread_mutex;
+    std::condition_variable m_wake;
+    bool m_running{false};
+    std::thread m_thread;
+
+    [[nodiscard]] Model load_model() const
+    {
+        Model model;
+        uint32_t sequence;
+        do
+        {
+            sequence = m_sequence.load(std::memory_order_acquire);
+            model.host = m_model_host.load(std::memory_order_relaxed);
+            model.board = m_model_board.load(std::memory_order_relaxed);
+            model.rate = m_model_rate.load(std::memory_order_relaxed);
+            std::atomic_thread_fence(std::memory_order_acquire);
+        } while ((sequence & 1) || sequence != m_sequence.load(std::memory_order_relaxed));
+        return model;
+    }
+
+    void publish(Model const &model)
+    {
+        uint32_t const sequence{m_sequence.load(std::memory_order_relaxed)};
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        m_model_host.store(model.host, std::memory_order_relaxed);
+        m_model_board.store(model.board, std::memory_order_relaxed);
+        m_model_rate.store(model.rate, std::memory_order_relaxed);
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    // Least-squares fit through the window, anchored at the newest point
+    void refit(uint64_t const latest_host, uint64_t const latest_board)
+    {
+        m_fit.points = m_count;
+        if (m_count < 2)
+        {
+            publish(Model{latest_host, latest_board, NOMINAL_HZ / m_host_hz});
+            return;
+        }
+
+        // Work relative to the newest point so the doubles stay small and exact
+        double sum_x{0}, sum_y{0}, earliest_x{0};
+        for (size_t i{0}; i < m_count; ++i)
+        {
+            double const x{static_cast<double>(static_cast<int64_t>(m_points[i].host - latest_host))};
+            sum_x += x;
+            sum_y += static_cast<double>(static_cast<int64_t>(m_points[i].board - latest_board));
+            earliest_x = std::min(earliest_x, x);
+        }
+        double const mean_x{sum_x / m_count};
+        double const mean_y{sum_y / m_count};
+        double sxx{0}, sxy{0};
+        for (size_t i{0}; i < m_count; ++i)
+        {
+            double const dx{static_cast<double>(static_cast<int64_t>(m_points[i].host - latest_host)) - mean_x};
+            double const dy{static_cast<double>(static_cast<int64_t>(m_points[i].board - latest_board)) - mean_y};
+            sxx += dx * dx;
+            sxy += dx * dy;
+        }
+        double const rate{sxx > 0 && -earliest_x >= MIN_SPAN_S * m_host_hz ? sxy / sxx : NOMINAL_HZ / m_host_hz};
+        double const intercept{mean_y - rate * mean_x}; // Fitted board offset at the newest host time
+
+        double squares{0};
+        for (size_t i{0}; i < m_count; ++i)
+        {
+            double const x{static_cast<double>(static_cast<int64_t>(m_points[i].host - latest_host))};
+            double const y{static_cast<double>(static_cast<int64_t>(m_points[i].board - latest_board))};
+            double const error{y - (intercept + rate * x)};
+            squares += error * error;
+        }
+        m_fit.residual_ns = ticks_to_ns(std::sqrt(squares / m_count));
+        m_fit.drift_ppm = (rate * m_host_hz / NOMINAL_HZ - 1) * 1e6;
+        publish(Model{latest_host, latest_board + static_cast<uint64_t>(std::llround(intercept)), rate});
+    }
+};
@@ -0,0 +1,324 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+
+// The keystream is produced a vector of blocks at a time with the baseline
+// vector ISA of the target (SSE2 on x86-64, NEON on AArch64), and on x86-64
+// with GCC with AVX2 when the CPU has it; define CHACHA20_NO_SIMD to build only
+// the scalar block function.
+#if !defined(CHACHA20_NO_SIMD) && defined(__SSE2__) && defined(__x86_64__)
+#define CHACHA20_SIMD_SSE2
+#include <immintrin.h>
+#if defined(__GNUC__) && !defined(__clang__)
+#define CHACHA20_SIMD_AVX2
+#endif
+#elif !defined(CHACHA20_NO_SIMD) && defined(__ARM_NEON) && defined(__aarch64__)
+#define CHACHA20_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+static_assert(__BYTE_ORDER__ == __ORDER_LITTLE_ENDIAN__, "chacha20.hpp serialises words in host order, which must be little-endian");
+
+constexpr size_t CHACHA20_BLOCK_BYTES{64};
+constexpr size_t CHACHA20_KEY_BYTES{32};
+constexpr size_t CHACHA20_NONCE_BYTES{12};
+
+namespace chacha20_detail
+{
+
+constexpr uint32_t rotl32(uint32_t const x, unsigned const n)
+{
+    return (x << n) | (x >> (32 - n));
+}
+
+constexpr void quarter_round_scalar(uint32_t &a, uint32_t &b, uint32_t &c, uint32_t &d)
+{
+    a += b;
+    d = rotl32(d ^ a, 16);
+    c += d;
+    b = rotl32(b ^ c, 12);
+    a += b;
+    d = rotl32(d ^ a, 8);
+    c += d;
+    b = rotl32(b ^ c, 7);
+}
+
+// RFC 8439 state: constants, 256-bit key, 32-bit block counter, 96-bit nonce
+inline void init_state(uint8_t const *key, uint8_t const *nonce, uint32_t const counter, uint32_t *state)
+{
+    state[0] = 0x61707865; // "expand 32-byte k"
+    state[1] = 0x3320646e;
+    state[2] = 0x79622d32;
+    state[3] = 0x6b206574;
+    std::memcpy(state + 4, key, CHACHA20_KEY_BYTES);
+    state[12] = counter;
+    std::memcpy(state + 13, nonce, CHACHA20_NONCE_BYTES);
+}
+
+// One block at 'counter'; the rest of the state is taken from 'state'
+inline void block_scalar(uint32_t const *state, uint32_t const counter, uint8_t *out)
+{
+    uint32_t input[16];
+    std::memcpy(input, state, sizeof(input));
+    input[12] = counter;
+    uint32_t x[16];
+    std::memcpy(x, input, sizeof(x));
+    for (int round{0}; round < 10; ++round)
+    {
+        quarter_round_scalar(x[0], x[4], x[8], x[12]);
+        quarter_round_scalar(x[1], x[5], x[9], x[13]);
+        quarter_round_scalar(x[2], x[6], x[10], x[14]);
+        quarter_round_scalar(x[3], x[7], x[11], x[15]);
+        quarter_round_scalar(x[0], x[5], x[10], x[15]);
+        quarter_round_scalar(x[1], x[6], x[11], x[12]);
+        quarter_round_scalar(x[2], x[7], x[8], x[13]);
+        quarter_round_scalar(x[3], x[4], x[9], x[14]);
+    }
+    for (size_t w{0}; w < 16; ++w)
+    {
+        x[w] += input[w];
+    }
+    std::memcpy(out, x, CHACHA20_BLOCK_BYTES);
+}
+
+inline void blocks_scalar(uint32_t const *state, uint8_t *out, size_t const count)
+{
+    for (size_t i{0}; i < count; ++i)
+    {
+        block_scalar(state, static_cast<uint32_t>(state[12] + i), out + i * CHACHA20_BLOCK_BYTES);
+    }
+}
+
+/**
+ * @brief One implementation of the multi-block keystream function.
+ */
+struct Kernel
+{
+    char const *isa;
+    void (*blocks)(uint32_t const *, uint8_t *, size_t);
+};
+
+constexpr Kernel SCALAR_KERNEL{"scalar", blocks_scalar};
+
+// Vector primitives: lane k of word w belongs to block k. store_blocks()
+// transposes 4x4 groups of words so each block's 64 bytes land contiguously.
+
+#if defined(CHACHA20_SIMD_SSE2)
+namespace sse2
+{
+constexpr char const *ISA{"SSE2"};
+using Vector = __m128i;
+
+inline Vector broadcast(uint32_t const x) { return _mm_set1_epi32(static_cast<int>(x)); }
+inline Vector lane_offsets() { return _mm_setr_epi32(0, 1, 2, 3); }
+inline Vector add(Vector const a, Vector const b) { return _mm_add_epi32(a, b); }
+inline Vector xor_(Vector const a, Vector const b) { return _mm_xor_si128(a, b); }
+template <int N> Vector rotl(Vector const v) { return _mm_or_si128(_mm_slli_epi32(v, N), _mm_srli_epi32(v, 32 - N)); }
+
+inline void transpose4(Vector &a, Vector &b, Vector &c, Vector &d)
+{
+    Vector const ab_low{_mm_unpacklo_epi32(a, b)};
+    Vector const cd_low{_mm_unpacklo_epi32(c, d)};
+    Vector const ab_high{_mm_unpackhi_epi32(a, b)};
+    Vector const cd_high{_mm_unpackhi_epi32(c, d)};
+    a = _mm_unpacklo_epi64(ab_low, cd_low);
+    b = _mm_unpackhi_epi64(ab_low, cd_low);
+    c = _mm_unpacklo_epi64(ab_high, cd_high);
+    d = _mm_unpackhi_epi64(ab_high, cd_high);
+}
+inline void store_blocks(uint8_t *out, Vector *x)
+{
+    for (size_t group{0}; group < 4; ++group)
+    {
+        Vector *const words{x + group * 4};
+        transpose4(words[0], words[1], words[2], words[3]);
+        for (size_t block{0}; block < 4; ++block)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out + block * CHACHA20_BLOCK_BYTES + group * 16), words[block]);
+        }
+    }
+}
+
+#include "chacha20_kernels.hpp"
+constexpr Kernel KERNEL{ISA, blocks};
+} // namespace sse2
+#endif
+
+#if defined(CHACHA20_SIMD_AVX2)
+#pragma GCC push_options
+#pragma GCC target("avx2")
+namespace avx2
+{
+constexpr char const *ISA{"AVX2"};
+using Vector = __m256i;
+
+inline Vector broadcast(uint32_t const x) { return _mm256_set1_epi32(static_cast<int>(x)); }
+inline Vector lane_offsets() { return _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7); }
+inline Vector add(Vector const a, Vector const b) { return _mm256_add_epi32(a, b); }
+inline Vector xor_(Vector const a, Vector const b) { return _mm256_xor_si256(a, b); }
+// Rotations by whole bytes are one vpshufb instead of two shifts and an or
+template <int N> Vector rotl(Vector const v)
+{
+    if constexpr (N == 16)
+    {
+        return _mm256_shuffle_epi8(v, _mm256_setr_epi8(2, 3, 0, 1, 6, 7, 4, 5, 10, 11, 8, 9, 14, 15, 12, 13, 2, 3, 0, 1, 6, 7, 4, 5, 10,
+                                                       11, 8, 9, 14, 15, 12, 13));
+    }
+    else if constexpr (N == 8)
+    {
+        return _mm256_shuffle_epi8(v, _mm256_setr_epi8(3, 0, 1, 2, 7, 4, 5, 6, 11, 8, 9, 10, 15, 12, 13, 14, 3, 0, 1, 2, 7, 4, 5, 6, 11,
+                                                       8, 9, 10, 15, 12, 13, 14));
+    }
+    else
+    {
+        return _mm256_or_si256(_mm256_slli_epi32(v, N), _mm256_srli_epi32(v, 32 - N));
+    }
+}
+
+// Unpacks work within 128-bit halves: the low half ends up with blocks 0-3, the high half with blocks 4-7
+inline void transpose4(Vector &a, Vector &b, Vector &c, Vector &d)
+{
+    Vector const ab_low{_mm256_unpacklo_epi32(a, b)};
+    Vector const cd_low{_mm256_unpacklo_epi32(c, d)};
+    Vector const ab_high{_mm256_unpackhi_epi32(a, b)};
+    Vector const cd_high{_mm256_unpackhi_epi32(c, d)};
+    a = _mm256_unpacklo_epi64(ab_low, cd_low);
+    b = _mm256_unpackhi_epi64(ab_low, cd_low);
+    c = _mm256_unpacklo_epi64(ab_high, cd_high);
+    d = _mm256_unpackhi_epi64(ab_high, cd_high);
+}
+inline void store_blocks(uint8_t *out, Vector *x)
+{
+    for (size_t group{0}; group < 4; ++group)
+    {
+        Vector *const words{x + group * 4};
+        transpose4(words[0], words[1], words[2], words[3]);
+        for (size_t block{0}; block < 4; ++block)
+        {
+            uint8_t *const low{out + block * CHACHA20_BLOCK_BYTES + group * 16};
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(low), _mm256_castsi256_si128(words[block]));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(low + 4 * CHACHA20_BLOCK_BYTES), _mm256_extracti128_si256(words[block], 1));
+        }
+    }
+}
+
+#include "chacha20_kernels.hpp"
+constexpr Kernel KERNEL{ISA, blocks};
+} // namespace avx2
+#pragma GCC pop_options
+#endif
+
+#if defined(CHACHA20_SIMD_NEON)
+namespace neon
+{
+constexpr char const *ISA{"NEON"};
+using Vector = uint32x4_t;
+
+inline Vector broadcast(uint32_t const x) { return vdupq_n_u32(x); }
+inline Vector lane_offsets() { return Vector{0, 1, 2, 3}; }
+inline Vector add(Vector const a, Vector const b) { return vaddq_u32(a, b); }
+inline Vector xor_(Vector const a, Vector const b) { return veorq_u32(a, b); }
+// Shift left, then shift-right-and-insert the wrapped bits; 16 is a halfword swap
+template <int N> Vector rotl(Vector const v)
+{
+    if constexpr (N == 16)
+    {
+        return vreinterpretq_u32_u16(vrev32q_u16(vreinterpretq_u16_u32(v)));
+    }
+    else
+    {
+        return vsriq_n_u32(vshlq_n_u32(v, N), v, 32 - N);
+    }
+}
+
+inline void transpose4(Vector &a, Vector &b, Vector &c, Vector &d)
+{
+    Vector const ab_even{vtrn1q_u32(a, b)};
+    Vector const ab_odd{vtrn2q_u32(a, b)};
+    Vector const cd_even{vtrn1q_u32(c, d)};
+    Vector const cd_odd{vtrn2q_u32(c, d)};
+    a = vreinterpretq_u32_u64(vtrn1q_u64(vreinterpretq_u64_u32(ab_even), vreinterpretq_u64_u32(cd_even)));
+    b = vreinterpretq_u32_u64(vtrn1q_u64(vreinterpretq_u64_u32(ab_odd), vreinterpretq_u64_u32(cd_odd)));
+    c = vreinterpretq_u32_u64(vtrn2q_u64(vreinterpretq_u64_u32(ab_even), vreinterpretq_u64_u32(cd_even)));
+    d = vreinterpretq_u32_u64(vtrn2q_u64(vreinterpretq_u64_u32(ab_odd), vreinterpretq_u64_u32(cd_odd)));
+}
+inline void store_blocks(uint8_t *out, Vector *x)
+{
+    for (size_t group{0}; group < 4; ++group)
+    {
+        Vector *const words{x + group * 4};
+        transpose4(words[0], words[1], words[2], words[3]);
+        for (size_t block{0}; block < 4; ++block)
+        {
+            vst1q_u8(out + block * CHACHA20_BLOCK_BYTES + group * 16, vreinterpretq_u8_u32(words[block]));
+        }
+    }
+}
+
+#include "chacha20_kernels.hpp"
+constexpr Kernel KERNEL{ISA, blocks};
+} // namespace neon
+#endif
+
+inline Kernel const &select_kernel()
+{
+#if defined(CHACHA20_SIMD_AVX2)
+    if (__builtin_cpu_supports("avx2"))
+    {
+        return avx2::KERNEL;
+    }
+#endif
+#if defined(CHACHA20_SIMD_SSE2)
+    return sse2::KERNEL;
+#elif defined(CHACHA20_SIMD_NEON)
+    return neon::KERNEL;
+#else
+    return SCALAR_KERNEL;
+#endif
+}
+
+/**
+ * @brief The best kernel this CPU supports, chosen on first use.
+ */
+inline Kernel const &kernel()
+{
+    static Kernel const &selected{select_kernel()};
+    return selected;
+}
+
+} // namespace chacha20_detail
+
+/**
+ * @brief Writes ChaCha20 keystream blocks (RFC 8439).
+ * @param key CHACHA20_KEY_BYTES of key.
+ * @param nonce CHACHA20_NONCE_BYTES of nonce.
+ * @param counter The block counter of the first block.
+ * @param out Output, blocks * CHACHA20_BLOCK_BYTES bytes.
+ * @param blocks Number of blocks; the counter wraps after 2^32, so a key and nonce must not be used for more.
+ */
+inline void chacha20_keystream(uint8_t const *key, uint8_t const *nonce, uint32_t const counter, uint8_t *out, size_t const blocks)
+{
+    uint32_t state[16];
+    chacha20_detail::init_state(key, nonce, counter, state);
+    chacha20_detail::kernel().blocks(state, out, blocks);
+}
+
+/**
+ * @brief As chacha20_keystream(), always through the scalar block function (a reference for the vector kernels).
+ */
+inline void chacha20_keystream_scalar(uint8_t const *key, uint8_t const *nonce, uint32_t const counter, uint8_t *out, size_t const blocks)
+{
+    uint32_t state[16];
+    chacha20_detail::init_state(key, nonce, counter, state);
+    chacha20_detail::blocks_scalar(state, out, blocks);
+}
+
+/**
+ * @brief Names the instruction set the keystream is generated with ("AVX2", "SSE2", "NEON" or "scalar").
+ */
+[[nodiscard]] inline char const *chacha20_isa()
+{
+    return chacha20_detail::kernel().isa;
+}
@@ -0,0 +1,55 @@
+// ChaCha20 block kernel shared by every vector ISA. chacha20.hpp includes
+// this file once per ISA, inside a namespace that defines Vector and the
+// primitives used below, and under that ISA's target options. Each vector lane
+// runs one block, so a call produces sizeof(Vector) / 4 blocks; the tail goes
+// through the scalar block function.
+
+inline void quarter_round(Vector &a, Vector &b, Vector &c, Vector &d)
+{
+    a = add(a, b);
+    d = rotl<16>(xor_(d, a));
+    c = add(c, d);
+    b = rotl<12>(xor_(b, c));
+    a = add(a, b);
+    d = rotl<8>(xor_(d, a));
+    c = add(c, d);
+    b = rotl<7>(xor_(b, c));
+}
+
+// Writes 'count' keystream blocks for 'state', whose word 12 is the first block counter
+inline void blocks(uint32_t const *state, uint8_t *out, size_t const count)
+{
+    constexpr size_t LANES{sizeof(Vector) / sizeof(uint32_t)};
+    size_t i{0};
+    for (; i + LANES <= count; i += LANES)
+    {
+        // The input is broadcast again for the final addition rather than held, which would spill registers
+        Vector const counters{add(broadcast(state[12] + static_cast<uint32_t>(i)), lane_offsets())};
+        Vector x[16];
+        for (size_t w{0}; w < 16; ++w)
+        {
+            x[w] = broadcast(state[w]);
+        }
+        x[12] = counters;
+        for (int round{0}; round < 10; ++round)
+        {
+            quarter_round(x[0], x[4], x[8], x[12]);
+            quarter_round(x[1], x[5], x[9], x[13]);
+            quarter_round(x[2], x[6], x[10], x[14]);
+            quarter_round(x[3], x[7], x[11], x[15]);
+            quarter_round(x[0], x[5], x[10], x[15]);
+            quarter_round(x[1], x[6], x[11], x[12]);
+            quarter_round(x[2], x[7], x[8], x[13]);
+            quarter_round(x[3], x[4], x[9], x[14]);
+        }
+        for (size_t w{0}; w < 16; ++w)
+        {
+            x[w] = add(x[w], w == 12 ? counters : broadcast(state[w]));
+        }
+        store_blocks(out + i * CHACHA20_BLOCK_BYTES, x);
+    }
+    for (; i < count; ++i)
+    {
+        block_scalar(state, static_cast<uint32_t>(state[12] + i), out + i * CHACHA20_BLOCK_BYTES);
+    }
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+/**
+ * @brief One online CPU, as described by sysfs.
+ */
+struct CpuInfo
+{
+    unsigned id;
+    unsigned capacity; // Relative performance, 1024 for the fastest core type (cpu_capacity)
+    unsigned cluster;  // Cores sharing a cluster (and on Juno, a core type and L2)
+};
+
+/**
+ * @brief Reads the CPU layout from /sys/devices/system/cpu.
+ *
+ * On big.LITTLE systems such as Juno (two Cortex-A72 and four Cortex-A53
+ * cores) cpu_capacity ranks the core types and cluster_id groups them. Where
+ * the kernel does not export these, as on most x86 machines, every CPU is
+ * reported at capacity 1024 in its physical package.
+ */
+class CpuTopology
+{
+public:
+    static constexpr char const *SYSFS_CPU{"/sys/devices/system/cpu"};
+
+    /**
+     * @brief Returns the online CPUs in id order.
+     */
+    [[nodiscard]] static std::vector<CpuInfo> online()
+    {
+        std::vector<CpuInfo> cpus;
+        for (unsigned const id : parse_list(read_line(std::string(SYSFS_CPU) + "/online")))
+        {
+            std::string const capacity{read_line(cpu_path(id) + "/cpu_capacity")};
+            std::string cluster{read_line(cpu_path(id) + "/topology/cluster_id")};
+            if (cluster.empty() || cluster[0] == '-')
+            {
+                cluster = read_line(cpu_path(id) + "/topology/physical_package_id");
+            }
+            cpus.push_back(CpuInfo{id, capacity.empty() ? 1024u : static_cast<unsigned>(std::strtoul(capacity.c_str(), nullptr, 10)),
+                                   cluster.empty() || cluster[0] == '-' ? 0u : static_cast<unsigned>(std::strtoul(cluster.c_str(), nullptr, 10))});
+        }
+        if (cpus.empty())
+        {
+            // No sysfs (e.g. a container): fall back to the processor count
+            long const count{sysconf(_SC_NPROCESSORS_ONLN)};
+            for (long id{0}; id < std::max(count, 1L); ++id)
+            {
+                cpus.push_back(CpuInfo{static_cast<unsigned>(id), 1024, 0});
+            }
+        }
+        return cpus;
+    }
+
+    /**
+     * @brief Picks the CPU best suited to a latency-critical thread.
+     *
+     * Chooses the highest-capacity core type, and within it the highest
+     * numbered CPU, since CPU 0 usually carries the most interrupts and
+     * housekeeping work.
+     */
+    [[nodiscard]] static unsigned fastest_cpu()
+    {
+        std::vector<CpuInfo> const cpus{online()};
+        return std::max_element(cpus.begin(), cpus.end(), [](CpuInfo const &a, CpuInfo const &b)
+                                { return a.capacity != b.capacity ? a.capacity < b.capacity : a.id < b.id; })
+            ->id;
+    }
+
+    /**
+     * @brief Pins the calling thread to one CPU.
+     * @return True on success.
+     */
+    static bool pin_current_thread(unsigned const cpu)
+    {
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(cpu, &set);
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    }
+
+    /**
+     * @brief Pins the calling thread to a set of CPUs; an empty set leaves it unpinned.
+     * @return True on success.
+     */
+    static bool pin_current_thread(std::vector<unsigned> const &cpus)
+    {
+        if (cpus.empty())
+        {
+            return true;
+        }
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        for (unsigned const cpu : cpus)
+        {
+            CPU_SET(cpu, &set);
+        }
+        return pthread_setaffinity_np(pthread_self(), sizeof(set), &set) == 0;
+    }
+
+    [[nodiscard]] static std::string cpu_path(unsigned const id)
+    {
+        return std::string(SYSFS_CPU) + "/cpu" + std::to_string(id);
+    }
+
+    /**
+     * @brief Reads the first line of a sysfs file, or "" if it cannot be read.
+     */
+    [[nodiscard]] static std::string read_line(std::string const &path)
+    {
+        std::ifstream file(path);
+        std::string line;
+        std::getline(file, line);
+        return line;
+    }
+
+    /**
+     * @brief Parses a kernel CPU list such as "0-3,6".
+     */
+    [[nodiscard]] static std::vector<unsigned> parse_list(std::string const &list)
+    {
+        std::vector<unsigned> ids;
+        size_t position{0};
+        while (position < list.size())
+        {
+            size_t const comma{std::min(list.find(',', position), list.size())};
+            std::string const range{list.substr(position, comma - position)};
+            size_t const dash{range.find('-')};
+            unsigned const first{static_cast<unsigned>(std::strtoul(range.c_str(), nullptr, 10))};
+            unsigned const last{dash == std::string::npos ? first : static_cast<unsigned>(std::strtoul(range.c_str() + dash + 1, nullptr, 10))};
+            for (unsigned id{first}; id <= last && !range.empty(); ++id)
+            {
+                ids.push_back(id);
+            }
+            position = comma + 1;
+        }
+        return ids;
+    }
+};
@@ -0,0 +1,594 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <pthread.h>
+#include <sys/random.h>
+
+#include "chacha20.hpp"
+#include "cpu_topology.hpp"
+#include "register_manager.hpp"
+#include "registers.hpp"
+#include "rng_model.hpp"
+
+namespace csprng_detail
+{
+
+/**
+ * @brief BLAKE2s-256 (RFC 7693), unkeyed: the conditioner that turns seed material into keys.
+ */
+class Blake2s
+{
+public:
+    static constexpr size_t DIGEST_BYTES{32};
+
+    Blake2s()
+    {
+        m_h = IV;
+        m_h[0] ^= 0x01010000u ^ DIGEST_BYTES; // Parameter block: digest length, no key, fanout and depth 1
+    }
+
+    Blake2s &update(void const *data, size_t bytes)
+    {
+        auto const *input{static_cast<uint8_t const *>(data)};
+        while (bytes > 0)
+        {
+            // The last block is only compressed by final(), which flags it
+            if (m_filled == BLOCK_BYTES)
+            {
+                m_total += BLOCK_BYTES;
+                compress(false);
+                m_filled = 0;
+            }
+            size_t const take{std::min(bytes, BLOCK_BYTES - m_filled)};
+            std::memcpy(m_block + m_filled, input, take);
+            m_filled += take;
+            input += take;
+            bytes -= take;
+        }
+        return *this;
+    }
+
+    template <typename T>
+    Blake2s &update(T const &value)
+    {
+        return update(&value, sizeof(value));
+    }
+
+    void final(uint8_t *digest)
+    {
+        m_total += m_filled;
+        std::memset(m_block + m_filled, 0, BLOCK_BYTES - m_filled);
+        compress(true);
+        std::memcpy(digest, m_h.data(), DIGEST_BYTES);
+        std::memset(m_block, 0, sizeof(m_block));
+    }
+
+private:
+    static constexpr size_t BLOCK_BYTES{64};
+    static constexpr std::array<uint32_t, 8> IV{0x6A09E667, 0xBB67AE85, 0x3C6EF372, 0xA54FF53A,
+                                                0x510E527F, 0x9B05688C, 0x1F83D9AB, 0x5BE0CD19};
+    static constexpr uint8_t SIGMA[10][16]{{0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15},
+                                           {14, 10, 4, 8, 9, 15, 13, 6, 1, 12, 0, 2, 11, 7, 5, 3},
+                                           {11, 8, 12, 0, 5, 2, 15, 13, 10, 14, 3, 6, 7, 1, 9, 4},
+                                           {7, 9, 3, 1, 13, 12, 11, 14, 2, 6, 5, 10, 4, 0, 15, 8},
+                                           {9, 0, 5, 7, 2, 4, 10, 15, 14, 1, 11, 12, 6, 8, 3, 13},
+                                           {2, 12, 6, 10, 0, 11, 8, 3, 4, 13, 7, 5, 15, 14, 1, 9},
+                                           {12, 5, 1, 15, 14, 13, 4, 10, 0, 7, 6, 3, 9, 2, 8, 11},
+                                           {13, 11, 7, 14, 12, 1, 3, 9, 5, 0, 15, 4, 8, 6, 2, 10},
+                                           {6, 15, 14, 9, 11, 3, 0, 8, 12, 2, 13, 7, 1, 4, 10, 5},
+                                           {10, 2, 8, 4, 7, 6, 1, 5, 15, 11, 9, 14, 3, 12, 13, 0}};
+
+    static constexpr uint32_t rotr(uint32_t const x, unsigned const n)
+    {
+        return (x >> n) | (x << (32 - n));
+    }
+
+    static void mix(uint32_t *v, size_t const a, size_t const b, size_t const c, size_t const d, uint32_t const x, uint32_t const y)
+    {
+        v[a] = v[a] + v[b] + x;
+        v[d] = rotr(v[d] ^ v[a], 16);
+        v[c] = v[c] + v[d];
+        v[b] = rotr(v[b] ^ v[c], 12);
+        v[a] = v[a] + v[b] + y;
+        v[d] = rotr(v[d] ^ v[a], 8);
+        v[c] = v[c] + v[d];
+        v[b] = rotr(v[b] ^ v[c], 7);
+    }
+
+    void compress(bool const last)
+    {
+        uint32_t m[16];
+        std::memcpy(m, m_block, sizeof(m));
+        uint32_t v[16];
+        for (size_t i{0}; i < 8; ++i)
+        {
+            v[i] = m_h[i];
+            v[i + 8] = IV[i];
+        }
+        v[12] ^= static_cast<uint32_t>(m_total);
+        v[13] ^= static_cast<uint32_t>(m_total >> 32);
+        if (last)
+        {
+            v[14] = ~v[14];
+        }
+        for (auto const &s : SIGMA)
+        {
+            mix(v, 0, 4, 8, 12, m[s[0]], m[s[1]]);
+            mix(v, 1, 5, 9, 13, m[s[2]], m[s[3]]);
+            mix(v, 2, 6, 10, 14, m[s[4]], m[s[5]]);
+            mix(v, 3, 7, 11, 15, m[s[6]], m[s[7]]);
+            mix(v, 0, 5, 10, 15, m[s[8]], m[s[9]]);
+            mix(v, 1, 6, 11, 12, m[s[10]], m[s[11]]);
+            mix(v, 2, 7, 8, 13, m[s[12]], m[s[13]]);
+            mix(v, 3, 4, 9, 14, m[s[14]], m[s[15]]);
+        }
+        for (size_t i{0}; i < 8; ++i)
+        {
+            m_h[i] ^= v[i] ^ v[i + 8];
+        }
+    }
+
+    std::array<uint32_t, 8> m_h{};
+    uint8_t m_block[BLOCK_BYTES]{};
+    size_t m_filled{0};
+    uint64_t m_total{0};
+};
+
+using Key = std::array<uint8_t, CHACHA20_KEY_BYTES>;
+
+inline void os_entropy(void *out, size_t const bytes)
+{
+    auto *p{static_cast<uint8_t *>(out)};
+    size_t filled{0};
+    while (filled < bytes)
+    {
+        ssize_t const got{getrandom(p + filled, bytes - filled, 0)};
+        if (got < 0 && errno != EINTR)
+        {
+            throw std::runtime_error("Error: getrandom failed: " + std::string(std::strerror(errno)));
+        }
+        filled += got > 0 ? static_cast<size_t>(got) : 0;
+    }
+}
+
+// Bumped in the child after fork(), so no thread state is shared with the parent's copy
+inline std::atomic<uint64_t> g_fork_generation{0};
+
+inline void watch_forks()
+{
+    static bool const registered{pthread_atfork(nullptr, nullptr, [] { g_fork_generation.fetch_add(1, std::memory_order_relaxed); }) == 0};
+    (void)registered;
+}
+
+} // namespace csprng_detail
+
+/**
+ * @brief A user-space CSPRNG that expands seed material with ChaCha20 into per-thread buffers.
+ *
+ * A harvester thread periodically reads AMS_RNGDATA and conditions it with
+ * BLAKE2s, together with getrandom() output, the previous seed and a
+ * timestamp, into a 256-bit seed published through a sequence lock. The AXI
+ * RNG is an LFSR that rng_model.hpp predicts from any one word, so it cannot
+ * be the only source: the harvest is scored against LfsrModel and counted as
+ * predictable, and the OS input carries the entropy.
+ *
+ * fill() takes no locks (apart from a moment when it is the one to ask for an
+ * early harvest). Each thread keeps a ChaCha20 key and a buffer of
+ * keystream; every refill replaces the key with the first 32 bytes of its own
+ * output (fast key erasure), and served bytes are wiped, so a thread's state
+ * does not reveal anything it has already returned. Whenever a new seed has
+ * been published, a thread hashes it into its key before the next refill.
+ *
+ * State is per thread and per process: a forked child rekeys from fresh OS
+ * entropy before its first output, but has no harvester thread.
+ */
+class CsprngService
+{
+public:
+    static constexpr size_t BUFFER_BYTES{16384};         // Keystream per thread refill
+    static constexpr size_t DIRECT_CHUNK_BYTES{1 << 20}; // Large fills are written in place, rekeying every chunk
+    static constexpr size_t OS_SEED_BYTES{32};
+    static constexpr uint64_t LFSR_MAX_GAP{uint64_t{1} << 16}; // Clocks between back-to-back RNGDATA reads, generously
+
+    /**
+     * @brief When seeds are harvested and mixed into the thread keys.
+     */
+    struct Policy
+    {
+        std::chrono::milliseconds reseed_interval{1000}; // Harvest period (0 = only at start-up and on reseed())
+        size_t harvest_words{64};                        // AMS_RNGDATA reads per harvest
+        uint64_t reseed_bytes{uint64_t{1} << 30};        // A thread asks for an early harvest after this much output
+        std::vector<unsigned> harvester_cpus;            // CPUs the harvester thread may run on (empty for any)
+    };
+
+    struct Counters
+    {
+        uint64_t harvests;
+        uint64_t harvested_words;
+        uint64_t predictable_words; // Harvested words that followed the LFSR model from their predecessor, or read as zero
+        uint64_t requested_harvests; // Harvests brought forward by reseed_bytes or reseed()
+        uint64_t thread_reseeds;     // Times a thread mixed a new seed into its key
+        uint64_t last_harvest_ns;
+    };
+
+    /**
+     * @brief Harvests the first seed and starts the harvester thread.
+     * @param axi The AXI region to read AMS_RNGDATA from, or nullptr to seed from the OS alone.
+     * @param policy Reseed policy.
+     */
+    CsprngService(RegisterManager const *axi, Policy const &policy)
+        : m_axi{axi}, m_policy{policy}, m_serial{next_serial()}
+    {
+        csprng_detail::watch_forks();
+        harvest();
+        m_harvester = std::thread([this] { harvester(); });
+    }
+
+    /**
+     * @brief As above, with the default Policy.
+     */
+    explicit CsprngService(RegisterManager const *axi) : CsprngService(axi, Policy{})
+    {
+    }
+
+    ~CsprngService()
+    {
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            m_stop = true;
+        }
+        m_wake.notify_one();
+        m_harvester.join();
+        for (auto &word : m_seed_words)
+        {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    CsprngService(CsprngService const &) = delete;
+    CsprngService &operator=(CsprngService const &) = delete;
+
+    /**
+     * @brief Fills 'bytes' bytes with random output; safe and lock-free from any number of threads.
+     */
+    void fill(void *out, size_t bytes)
+    {
+        ThreadStream &stream{thread_stream()};
+        auto *dst{static_cast<uint8_t *>(out)};
+        stream.since_harvest += bytes;
+        if (stream.since_harvest >= m_policy.reseed_bytes)
+        {
+            stream.since_harvest = 0;
+            request_harvest();
+        }
+
+        size_t const buffered{std::min(bytes, stream.available)};
+        serve(stream, dst, buffered);
+        dst += buffered;
+        bytes -= buffered;
+        if (bytes == 0)
+        {
+            return;
+        }
+
+        rekey_if_reseeded(stream);
+        // Whole blocks go straight to the caller; the buffer only covers what is left over
+        while (bytes >= BUFFER_BYTES)
+        {
+            size_t const chunk{std::min(bytes, DIRECT_CHUNK_BYTES) / CHACHA20_BLOCK_BYTES * CHACHA20_BLOCK_BYTES};
+            generate(stream, dst, chunk / CHACHA20_BLOCK_BYTES);
+            dst += chunk;
+            bytes -= chunk;
+        }
+        if (bytes > 0)
+        {
+            refill(stream);
+            serve(stream, dst, bytes);
+        }
+    }
+
+    /**
+     * @brief Returns a random 64-bit value.
+     */
+    [[nodiscard]] uint64_t next_u64()
+    {
+        uint64_t value;
+        fill(&value, sizeof(value));
+        return value;
+    }
+
+    /**
+     * @brief Asks the harvester for a new seed now, without waiting for it.
+     */
+    void reseed()
+    {
+        request_harvest();
+    }
+
+    /**
+     * @brief Seeds published so far (1 after construction).
+     */
+    [[nodiscard]] uint64_t generation() const
+    {
+        return m_sequence.load(std::memory_order_acquire) / 2;
+    }
+
+    [[nodiscard]] Counters counters() const
+    {
+        return Counters{m_harvests.load(std::memory_order_relaxed),          m_harvested_words.load(std::memory_order_relaxed),
+                        m_predictable_words.load(std::memory_order_relaxed), m_requested_harvests.load(std::memory_order_relaxed),
+                        m_thread_reseeds.load(std::memory_order_relaxed),    m_last_harvest_ns.load(std::memory_order_relaxed)};
+    }
+
+    void print_counters(std::ostream &stream) const
+    {
+        Counters const c{counters()};
+        stream << "[CSPRNG] ChaCha20 on " << chacha20_isa() << ": " << c.harvests << " harvests (" << c.requested_harvests
+               << " requested), " << c.harvested_words << " RNGDATA words (" << c.predictable_words << " LFSR-predictable), "
+               << c.thread_reseeds << " thread reseeds, last harvest " << c.last_harvest_ns / 1000 << " us" << std::endl;
+    }
+
+    /**
+     * @brief Names the instruction set the keystream is generated with.
+     */
+    [[nodiscard]] static char const *isa()
+    {
+        return chacha20_isa();
+    }
+
+private:
+    using Key = csprng_detail::Key;
+
+    // Keystream buffer for one thread; bytes [BUFFER_BYTES - available, BUFFER_BYTES) are unserved
+    struct ThreadStream
+    {
+        uint64_t service{0};
+        uint64_t sequence{0}; // Seed sequence last mixed into the key
+        uint64_t fork_generation{0};
+        uint64_t serial{0};
+        uint64_t since_harvest{0};
+        size_t available{0};
+        Key key{};
+        alignas(64) uint8_t buffer[BUFFER_BYTES];
+    };
+
+    static uint64_t next_serial()
+    {
+        static std::atomic<uint64_t> serial{0};
+        return serial.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+
+    ThreadStream &thread_stream()
+    {
+        thread_local ThreadStream stream;
+        thread_local uint64_t const thread_serial{next_serial()};
+        uint64_t const fork_generation{csprng_detail::g_fork_generation.load(std::memory_order_relaxed)};
+        if (stream.service != m_serial || stream.fork_generation != fork_generation)
+        {
+            // First use by this thread, another service, or a forked child: start from the current seed and the OS
+            std::array<uint8_t, OS_SEED_BYTES> os{};
+            csprng_detail::os_entropy(os.data(), os.size());
+            stream.service = m_serial;
+            stream.fork_generation = fork_generation;
+            stream.serial = thread_serial;
+            stream.since_harvest = 0;
+            discard(stream);
+            mix_seed(stream, os.data(), os.size());
+            std::memset(os.data(), 0, os.size());
+        }
+        return stream;
+    }
+
+    void rekey_if_reseeded(ThreadStream &stream)
+    {
+        if (m_sequence.load(std::memory_order_acquire) != stream.sequence)
+        {
+            mix_seed(stream, nullptr, 0);
+            m_thread_reseeds.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    // key = BLAKE2s(seed || key || thread serial || sequence || extra)
+    void mix_seed(ThreadStream &stream, void const *extra, size_t const extra_bytes)
+    {
+        std::array<uint32_t, 8> seed;
+        uint64_t const sequence{read_seed(seed)};
+        csprng_detail::Blake2s hash;
+        hash.update(seed).update(stream.key).update(stream.serial).update(sequence).update(extra, extra_bytes);
+        hash.final(stream.key.data());
+        seed.fill(0);
+        stream.sequence = sequence;
+    }
+
+    void serve(ThreadStream &stream, uint8_t *dst, size_t const bytes)
+    {
+        uint8_t *const src{stream.buffer + BUFFER_BYTES - stream.available};
+        std::memcpy(dst, src, bytes);
+        std::memset(src, 0, bytes);
+        stream.available -= bytes;
+    }
+
+    void discard(ThreadStream &stream)
+    {
+        std::memset(stream.buffer + BUFFER_BYTES - stream.available, 0, stream.available);
+        stream.available = 0;
+    }
+
+    // The first 32 bytes of each refill become the next key and are wiped
+    void refill(ThreadStream &stream)
+    {
+        static constexpr uint8_t NONCE[CHACHA20_NONCE_BYTES]{};
+        chacha20_keystream(stream.key.data(), NONCE, 0, stream.buffer, BUFFER_BYTES / CHACHA20_BLOCK_BYTES);
+        std::memcpy(stream.key.data(), stream.buffer, CHACHA20_KEY_BYTES);
+        std::memset(stream.buffer, 0, CHACHA20_KEY_BYTES);
+        stream.available = BUFFER_BYTES - CHACHA20_KEY_BYTES;
+    }
+
+    // Block 0 becomes the next key, blocks 1..count go to 'out'
+    void generate(ThreadStream &stream, uint8_t *out, size_t const count)
+    {
+        static constexpr uint8_t NONCE[CHACHA20_NONCE_BYTES]{};
+        uint8_t next[CHACHA20_BLOCK_BYTES];
+        chacha20_keystream_scalar(stream.key.data(), NONCE, 0, next, 1);
+        chacha20_keystream(stream.key.data(), NONCE, 1, out, count);
+        std::memcpy(stream.key.data(), next, CHACHA20_KEY_BYTES);
+        std::memset(next, 0, sizeof(next));
+    }
+
+    // Sequence lock: odd while the harvester writes; readers retry until they see one even value on both sides
+    uint64_t read_seed(std::array<uint32_t, 8> &seed) const
+    {
+        for (;;)
+        {
+            uint64_t const before{m_sequence.load(std::memory_order_acquire)};
+            if (before % 2 == 0)
+            {
+                for (size_t i{0}; i < seed.size(); ++i)
+                {
+                    seed[i] = m_seed_words[i].load(std::memory_order_relaxed);
+                }
+                std::atomic_thread_fence(std::memory_order_acquire);
+                if (m_sequence.load(std::memory_order_relaxed) == before)
+                {
+                    return before;
+                }
+            }
+            std::this_thread::yield();
+        }
+    }
+
+    void publish_seed(Key const &seed)
+    {
+        uint64_t const sequence{m_sequence.load(std::memory_order_relaxed)};
+        m_sequence.store(sequence + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+        for (size_t i{0}; i < m_seed_words.size(); ++i)
+        {
+            uint32_t word;
+            std::memcpy(&word, seed.data() + i * 4, sizeof(word));
+            m_seed_words[i].store(word, std::memory_order_relaxed);
+        }
+        m_sequence.store(sequence + 2, std::memory_order_release);
+    }
+
+    // Only the thread that raises the flag takes the mutex, so the wakeup cannot fall between the harvester's check and its wait
+    void request_harvest()
+    {
+        if (!m_requested.exchange(true, std::memory_order_relaxed))
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+        }
+        m_wake.notify_one();
+    }
+
+    // seed = BLAKE2s(previous seed || RNGDATA words || OS entropy || time || harvest count)
+    void harvest()
+    {
+        auto const start{std::chrono::steady_clock::now()};
+        std::vector<uint32_t> words(m_axi ? m_policy.harvest_words : 0);
+        for (uint32_t &word : words)
+        {
+            word = m_axi->readReg(AXIRegister::AMS_RNGDATA);
+        }
+        std::array<uint8_t, OS_SEED_BYTES> os{};
+        csprng_detail::os_entropy(os.data(), os.size());
+
+        std::array<uint32_t, 8> previous;
+        read_seed(previous);
+        uint64_t const count{m_harvests.load(std::memory_order_relaxed)};
+        int64_t const now{start.time_since_epoch().count()};
+        csprng_detail::Blake2s hash;
+        hash.update(previous).update(words.data(), words.size() * sizeof(uint32_t)).update(os).update(now).update(count);
+        Key seed;
+        hash.final(seed.data());
+        publish_seed(seed);
+        seed.fill(0);
+        os.fill(0);
+        previous.fill(0);
+
+        uint64_t clocks{0};
+        // A zero word is a dead bus rather than an LFSR sample, and no more random
+        size_t const predictable{(words.size() > 1 ? LfsrModel::score(words.data(), words.size(), LFSR_MAX_GAP, clocks) : 0) +
+                                 static_cast<size_t>(std::count(words.begin(), words.end(), 0u))};
+        std::fill(words.begin(), words.end(), 0);
+        m_harvested_words.fetch_add(words.size(), std::memory_order_relaxed);
+        m_predictable_words.fetch_add(predictable, std::memory_order_relaxed);
+        m_harvests.fetch_add(1, std::memory_order_relaxed);
+        m_last_harvest_ns.store(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                                    std::chrono::steady_clock::now() - start).count()), std::memory_order_relaxed);
+    }
+
+    void harvester()
+    {
+        if (!CpuTopology::pin_current_thread(m_policy.harvester_cpus))
+        {
+            std::cerr << "[WARN] Could not pin the CSPRNG harvester thread" << std::endl;
+        }
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(m_mutex);
+                auto const woken{[this] { return m_stop || m_requested.load(std::memory_order_relaxed); }};
+                if (m_policy.reseed_interval.count() > 0)
+                {
+                    m_wake.wait_for(lock, m_policy.reseed_interval, woken);
+                }
+                else
+                {
+                    m_wake.wait(lock, woken);
+                }
+                if (m_stop)
+                {
+                    return;
+                }
+            }
+            if (m_requested.exchange(false, std::memory_order_relaxed))
+            {
+                m_requested_harvests.fetch_add(1, std::memory_order_relaxed);
+            }
+            try
+            {
+                harvest();
+            }
+            catch (std::runtime_error const &e)
+            {
+                // Keep serving from the last seed; the thread keys stay unpredictable without new input
+                std::cerr << "[WARN] " << e.what() << std::endl;
+            }
+        }
+    }
+
+    RegisterManager const *m_axi;
+    Policy m_policy;
+    uint64_t m_serial;
+
+    alignas(64) std::atomic<uint64_t> m_sequence{0};
+    std::array<std::atomic<uint32_t>, 8> m_seed_words{};
+
+    alignas(64) std::atomic<bool> m_requested{false};
+    std::atomic<uint64_t> m_harvests{0};
+    std::atomic<uint64_t> m_harvested_words{0};
+    std::atomic<uint64_t> m_predictable_words{0};
+    std::atomic<uint64_t> m_requested_harvests{0};
+    std::atomic<uint64_t> m_thread_reseeds{0};
+    std::atomic<uint64_t> m_last_harvest_ns{0};
+
+    std::mutex m_mutex;
+    std::condition_variable m_wake;
+    bool m_stop{false};
+    std::thread m_harvester;
+};
@@ -0,0 +1,211 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "register_manager.hpp"
+#include "registers.hpp"
+#include "rng_model.hpp"
+
+/**
+ * @brief Zero-copy consumer for the RNG DMA ring buffer.
+ *
+ * Maps the ring (a reserved-memory carve-out, or any DRAM reachable through
+ * /dev/mem) and hands contiguous runs of freshly produced words straight to the
+ * caller. The engine will not overwrite a word until the consumer index
+ * register has moved past it, so callers may read the span in place.
+ *
+ * When the AXI RegisterManager is simulated, the ring is anonymous memory and
+ * the engine is simulated too. Before each consume(), it fills the free space
+ * in whole bursts of LFSR output and advances AMS_DMAPROD, as axi_rng_dma.v
+ * does. The host side then runs its normal register protocol without a board
+ * or root access.
+ */
+class DmaRingConsumer
+{
+private:
+    RegisterManager const &m_axi_reg_access;
+    int m_fd{-1};
+    void *m_ring_base{nullptr};
+    const size_t m_ring_bytes;
+    const uint32_t m_ring_words;
+    const bool m_simulated;
+    uint32_t m_cons_index{0};
+    uint32_t m_ring_offset{0}; // Word offset of m_cons_index in the ring, wrapped like the engine's ring_offset
+    uint32_t m_engine_offset{0}; // Simulated engine: word offset of its next burst
+    uint32_t m_engine_lfsr{LfsrModel::RESET_STATE}; // Simulated engine: LFSR state behind its last word
+
+public:
+    /**
+     * @brief Constructor: Maps the ring and programs the DMA descriptor.
+     * @param axi_reg_access Register access for the AXI slave owning the DMA engine.
+     * @param ring_physical_base Physical address of the ring, DMA_BURST_BYTES aligned.
+     * @param ring_bytes Ring size in bytes, a non-zero multiple of DMA_BURST_BYTES.
+     */
+    DmaRingConsumer(RegisterManager const &axi_reg_access, uint64_t const ring_physical_base, size_t const ring_bytes)
+        : m_axi_reg_access(axi_reg_access),
+          m_ring_bytes(ring_bytes),
+          m_ring_words(static_cast<uint32_t>(ring_bytes / sizeof(uint32_t))),
+          m_simulated(axi_reg_access.isSimulated())
+    {
+        if (ring_bytes == 0 || ring_bytes % DMA_BURST_BYTES != 0 || ring_physical_base % MAP_SIZE != 0 || ring_physical_base > UINT32_MAX)
+        {
+            throw std::runtime_error("Error: DMA ring must be page-aligned, below 4GB and a multiple of 64 bytes.");
+        }
+
+        if (m_simulated)
+        {
+            m_ring_base = mmap(0, m_ring_bytes, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (m_ring_base == MAP_FAILED)
+            {
+                throw std::runtime_error("Error: mmap failed to allocate simulated DMA ring buffer.");
+            }
+        }
+        else
+        {
+            m_fd = open("/dev/mem", O_RDWR | O_SYNC);
+            if (m_fd == -1)
+            {
+                throw std::runtime_error("Error: Could not open /dev/mem. Must run as root or with appropriate permissions.");
+            }
+
+            m_ring_base = mmap(0, m_ring_bytes, PROT_READ, MAP_SHARED, m_fd, ring_physical_base);
+            if (m_ring_base == MAP_FAILED)
+            {
+                close(m_fd);
+                throw std::runtime_error("Error: mmap failed to map DMA ring buffer.");
+            }
+        }
+
+        // Stop any previous run and reset both indices before describing the ring
+        m_axi_reg_access.writeReg(AXIRegister::AMS_DMACTRL, 0);
+        m_axi_reg_access.writeReg(AXIRegister::AMS_DMACTRL, DMACTRL_CLEAR);
+        m_axi_reg_access.writeReg(AXIRegister::AMS_DMACONS, 0);
+        if (m_simulated)
+        {
+            // The clear resets the producer index in hardware; the simulated register file needs it done by hand
+            m_axi_reg_access.writeReg(AXIRegister::AMS_DMAPROD, 0);
+        }
+        m_axi_reg_access.writeReg(AXIRegister::AMS_DMABASE, static_cast<uint32_t>(ring_physical_base));
+        m_axi_reg_access.writeReg(AXIRegister::AMS_DMALEN, static_cast<uint32_t>(m_ring_bytes));
+
+        std::cout << "[INFO] " << (m_simulated ? "Allocated simulated " : "Mapped ") << m_ring_bytes
+                  << " byte DMA ring at physical address 0x" << std::hex << ring_physical_base << " to virtual address "
+                  << m_ring_base << std::dec << std::endl;
+    }
+
+    /**
+     * @brief Destructor: Stops the engine and unmaps the ring.
+     */
+    ~DmaRingConsumer()
+    {
+        m_axi_reg_access.writeReg(AXIRegister::AMS_DMACTRL, 0);
+        if (m_ring_base != MAP_FAILED && m_ring_base != nullptr)
+        {
+            munmap(m_ring_base, m_ring_bytes);
+        }
+        if (m_fd != -1)
+        {
+            close(m_fd);
+        }
+    }
+
+    DmaRingConsumer(DmaRingConsumer const &) = delete;
+    DmaRingConsumer &operator=(DmaRingConsumer const &) = delete;
+
+    void start() const
+    {
+        m_axi_reg_access.writeReg(AXIRegister::AMS_DMACTRL, DMACTRL_ENABLE);
+    }
+
+    [[nodiscard]] bool error() const
+    {
+        return m_axi_reg_access.readReg(AXIRegister::AMS_DMACTRL) & DMACTRL_ERROR;
+    }
+
+    /**
+     * @brief Passes every word produced since the last call to 'sink', then releases them.
+     * @param sink Callable invoked as sink(uint32_t const *words, size_t count) once or twice
+     *             (twice when the available data wraps the end of the ring).
+     * @return The number of words consumed.
+     */
+    template <typename Sink>
+    size_t consume(Sink &&sink)
+    {
+        if (m_simulated)
+        {
+            run_simulated_engine();
+        }
+        uint32_t const prod_index{m_axi_reg_access.readReg(AXIRegister::AMS_DMAPROD)};
+        // Order the ring reads after the producer index read
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        uint32_t const available{prod_index - m_cons_index};
+        if (available == 0)
+        {
+            return 0;
+        }
+        if (available > m_ring_words)
+        {
+            throw std::runtime_error("Error: DMA producer index is more than one ring ahead of the consumer.");
+        }
+
+        auto const *ring{static_cast<uint32_t const *>(m_ring_base)};
+        // The indices run freely to 2^32, which a ring that is not a power of two does not divide, so the
+        // offset cannot be derived as m_cons_index % m_ring_words; it is tracked and wrapped on its own
+        uint32_t const first{std::min(available, m_ring_words - m_ring_offset)};
+        sink(ring + m_ring_offset, size_t{first});
+        if (first < available)
+        {
+            sink(ring, size_t{available - first});
+        }
+
+        // Only hand the space back once the sink has finished with it
+        std::atomic_thread_fence(std::memory_order_release);
+        m_cons_index = prod_index;
+        m_ring_offset = first < available ? available - first : m_ring_offset + first;
+        if (m_ring_offset == m_ring_words)
+        {
+            m_ring_offset = 0;
+        }
+        m_axi_reg_access.writeReg(AXIRegister::AMS_DMACONS, m_cons_index);
+        return available;
+    }
+
+private:
+    /**
+     * @brief Does what axi_rng_dma.v would have done since the last call: while
+     * enabled, write whole bursts of LFSR words wherever the consumer index
+     * leaves room, then publish the new producer index.
+     */
+    void run_simulated_engine()
+    {
+        if (!(m_axi_reg_access.readReg(AXIRegister::AMS_DMACTRL) & DMACTRL_ENABLE))
+        {
+            return;
+        }
+        uint32_t constexpr BURST_WORDS{DMA_BURST_BYTES / sizeof(uint32_t)};
+        uint32_t prod_index{m_axi_reg_access.readReg(AXIRegister::AMS_DMAPROD)};
+        uint32_t const cons_index{m_axi_reg_access.readReg(AXIRegister::AMS_DMACONS)};
+        auto *const ring{static_cast<uint32_t *>(m_ring_base)};
+        while (prod_index - cons_index + BURST_WORDS <= m_ring_words)
+        {
+            for (uint32_t word{0}; word < BURST_WORDS; ++word)
+            {
+                m_engine_lfsr = LfsrModel::step(m_engine_lfsr);
+                ring[m_engine_offset + word] = m_engine_lfsr;
+            }
+            prod_index += BURST_WORDS;
+            m_engine_offset = m_engine_offset + BURST_WORDS == m_ring_words ? 0 : m_engine_offset + BURST_WORDS;
+        }
+        std::atomic_thread_fence(std::memory_order_release);
+        m_axi_reg_access.writeReg(AXIRegister::AMS_DMAPROD, prod_index);
+    }
+};
@@ -106,6 +106,14 @@
 #   endif
 #endif
 
+// Compile-time lookup tables need C++14 relaxed constexpr to be generated.
+// Define BETTER_ENUMS_NO_LOOKUP_TABLES to fall back to linear searches.
+#if defined(BETTER_ENUMS_HAVE_CONSTEXPR) && !defined(BETTER_ENUMS_NO_LOOKUP_TABLES)
+#   if __cplusplus >= 201402L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201402L)
+#       define BETTER_ENUMS_HAVE_LOOKUP_TABLES
+#   endif
+#endif
+
 // GCC (and maybe clang) can be made to warn about using 0 or NULL when nullptr
 // is available, so Better Enums tries to use nullptr. This passage uses
 // availability of constexpr as a proxy for availability of nullptr, i.e. it
@@ -535,6 +543,196 @@ struct _initialize_at_program_start {
     _initialize_at_program_start() { Enum::initialize(); }
 };
 
+
+
+#ifdef BETTER_ENUMS_HAVE_LOOKUP_TABLES
+
+// Compile-time name trimming. Names are copied up to their initializer into
+// one character array, so no storage is written at program start.
+
+template <std::size_t Size, std::size_t Count>
+struct _trimmed_names {
+    char            _storage[Size];
+    std::size_t     _offsets[Count];
+};
+
+template <std::size_t Size, std::size_t Count>
+constexpr _trimmed_names<Size, Count>
+_trim_names_constexpr(const char * const *raw_names)
+{
+    _trimmed_names<Size, Count> result{};
+    std::size_t                 offset = 0;
+
+    for (std::size_t index = 0; index < Count; ++index) {
+        result._offsets[index] = offset;
+
+        std::size_t length = 0;
+        for (; !_ends_name(raw_names[index][length]); ++length)
+            result._storage[offset + length] = raw_names[index][length];
+        result._storage[offset + length] = '\0';
+
+        offset += length + 1;
+    }
+
+    return result;
+}
+
+
+
+// Lookup tables. Keys (values, or hashes of names) are mapped to indexes into
+// the value and name arrays through a table of at least eight slots per
+// constant. Values that span fewer slots than the table index it directly;
+// otherwise a multiplier is searched for at compile time that places every
+// key in its own slot, so a lookup is one multiply, one load and one compare.
+
+constexpr unsigned short    _empty_slot = 0xFFFF;
+
+constexpr std::size_t _table_slots(std::size_t count)
+{
+    std::size_t slots = 8;
+    while (slots < count * 8)
+        slots <<= 1;
+    return slots;
+}
+
+constexpr unsigned _table_bits(std::size_t slots)
+{
+    unsigned bits = 0;
+    while ((std::size_t(1) << bits) < slots)
+        ++bits;
+    return bits;
+}
+
+// splitmix64 finalizer
+constexpr unsigned long long _mix(unsigned long long x)
+{
+    x ^= x >> 30;
+    x *= 0xBF58476D1CE4E5B9ULL;
+    x ^= x >> 27;
+    x *= 0x94D049BB133111EBULL;
+    x ^= x >> 31;
+    return x;
+}
+
+// FNV-1a over a name, stopping where the stringized constant's name ends
+constexpr unsigned long long _name_hash(const char *name, bool nocase)
+{
+    unsigned long long hash = 0xCBF29CE484222325ULL;
+    for (std::size_t index = 0; !_ends_name(name[index]); ++index) {
+        char c = nocase ? _to_lower_ascii(name[index]) : name[index];
+        hash = (hash ^ static_cast<unsigned char>(c)) * 0x100000001B3ULL;
+    }
+    return _mix(hash);
+}
+
+template <std::size_t Count>
+struct _lookup_table {
+    static_assert(Count < _empty_slot, "too many constants for lookup table");
+
+    unsigned long long  _base;
+    unsigned long long  _multiplier;
+    unsigned            _shift;
+    bool                _valid;
+    unsigned short      _slots[_table_slots(Count)];
+
+    constexpr std::size_t find(unsigned long long key) const
+    {
+        return
+            _slots[(((key - _base) * _multiplier) >> _shift) &
+                   (_table_slots(Count) - 1)];
+    }
+};
+
+// Fills the table, failing if two distinct keys share a slot. Equal keys are
+// aliases (e.g. two constants with one value) and keep the first index, as
+// the linear searches do.
+template <std::size_t Count>
+constexpr bool _try_place(_lookup_table<Count> &table,
+                          const unsigned long long *keys, bool allow_aliases)
+{
+    for (std::size_t slot = 0; slot < _table_slots(Count); ++slot)
+        table._slots[slot] = _empty_slot;
+
+    for (std::size_t index = 0; index < Count; ++index) {
+        std::size_t slot =
+            (((keys[index] - table._base) * table._multiplier) >>
+                table._shift) & (_table_slots(Count) - 1);
+
+        if (table._slots[slot] == _empty_slot)
+            table._slots[slot] = static_cast<unsigned short>(index);
+        else if (!allow_aliases || keys[table._slots[slot]] != keys[index])
+            return false;
+    }
+
+    return true;
+}
+
+template <std::size_t Count>
+constexpr _lookup_table<Count>
+_build_table(const unsigned long long *keys, unsigned long long base,
+             bool dense, bool allow_aliases)
+{
+    _lookup_table<Count> table{};
+    table._base = base;
+
+    if (dense) {
+        table._multiplier = 1;
+        table._shift = 0;
+        table._valid = _try_place(table, keys, allow_aliases);
+        return table;
+    }
+
+    table._shift = 64 - _table_bits(_table_slots(Count));
+    for (unsigned long long attempt = 1; attempt <= 1024; ++attempt) {
+        table._multiplier = _mix(attempt) | 1;
+        if (_try_place(table, keys, allow_aliases)) {
+            table._valid = true;
+            return table;
+        }
+    }
+
+    // Callers fall back to the linear searches
+    table._valid = false;
+    return table;
+}
+
+template <typename Enum, std::size_t Count>
+constexpr _lookup_table<Count> _make_value_table(const Enum *values)
+{
+    typename Enum::_integral    lowest = values[0]._value;
+    typename Enum::_integral    highest = values[0]._value;
+    unsigned long long          keys[Count] = {};
+
+    for (std::size_t index = 0; index < Count; ++index) {
+        if (values[index]._value < lowest)
+            lowest = values[index]._value;
+        if (values[index]._value > highest)
+            highest = values[index]._value;
+        keys[index] = static_cast<unsigned long long>(values[index]._value);
+    }
+
+    unsigned long long base = static_cast<unsigned long long>(lowest);
+    unsigned long long span = static_cast<unsigned long long>(highest) - base;
+
+    return
+        _build_table<Count>(keys, base, span < _table_slots(Count), true);
+}
+
+template <std::size_t Count>
+constexpr _lookup_table<Count> _make_name_table(const char * const *names,
+                                                bool nocase)
+{
+    unsigned long long keys[Count] = {};
+
+    for (std::size_t index = 0; index < Count; ++index)
+        keys[index] = _name_hash(names[index], nocase);
+
+    // Names differing only in case are aliases when matched without case
+    return _build_table<Count>(keys, 0, false, nocase);
+}
+
+#endif // #ifdef BETTER_ENUMS_HAVE_LOOKUP_TABLES
+
 } // namespace better_enums
 
 
@@ -727,6 +925,12 @@ class BETTER_ENUMS_CLASS_ATTRIBUTE Enum {                                      \
     _from_string_loop(const char *name, std::size_t index = 0);                \
     BETTER_ENUMS_CONSTEXPR_ static _optional_index                             \
     _from_string_nocase_loop(const char *name, std::size_t index = 0);         \
+    BETTER_ENUMS_CONSTEXPR_ static _optional_index                             \
+    _find_value(_integral value);                                              \
+    BETTER_ENUMS_CONSTEXPR_ static _optional_index                             \
+    _find_name(const char *name);                                              \
+    BETTER_ENUMS_CONSTEXPR_ static _optional_index                             \
+    _find_name_nocase(const char *name);                                       \
                                                                                \
     friend struct ::better_enums::_initialize_at_program_start<Enum>;          \
 };                                                                             \
@@ -746,6 +950,8 @@ BETTER_ENUMS_IGNORE_OLD_CAST_END                                               \
                                                                                \
 BETTER_ENUMS_ID(GenerateStrings(Enum, __VA_ARGS__))                            \
                                                                                \
+BETTER_ENUMS_LOOKUP_TABLES(Enum)                                               \
+                                                                               \
 }                                                                              \
                                                                                \
 BETTER_ENUMS_IGNORE_ATTRIBUTES_HEADER                                          \
@@ -791,6 +997,8 @@ Enum::_from_string_nocase_loop(const char *name, std::size_t index)            \
                     _from_string_nocase_loop(name, index + 1);                 \
 }                                                                              \
                                                                                \
+BETTER_ENUMS_DEFINE_FIND(Enum)                                                 \
+                                                                               \
 BETTER_ENUMS_CONSTEXPR_ inline Enum::_integral Enum::_to_integral() const      \
 {                                                                              \
     return _integral(_value);                                                  \
@@ -798,7 +1006,7 @@ BETTER_ENUMS_CONSTEXPR_ inline Enum::_integral Enum::_to_integral() const      \
                                                                                \
 BETTER_ENUMS_CONSTEXPR_ inline std::size_t Enum::_to_index() const             \
 {                                                                              \
-    return *_from_value_loop(_value);                                          \
+    return *_find_value(_value);                                               \
 }                                                                              \
                                                                                \
 BETTER_ENUMS_CONSTEXPR_ inline Enum                                            \
@@ -837,7 +1045,7 @@ Enum::_from_integral_nothrow(_integral value)                                  \
 {                                                                              \
     return                                                                     \
         ::better_enums::_map_index<Enum>(BETTER_ENUMS_NS(Enum)::_value_array,  \
-                                         _from_value_loop(value));             \
+                                         _find_value(value));                  \
 }                                                                              \
                                                                                \
 BETTER_ENUMS_IF_EXCEPTIONS(                                                    \
@@ -855,7 +1063,7 @@ ToStringConstexpr inline const char* Enum::_to_string() const                  \
         ::better_enums::_or_null(                                              \
             ::better_enums::_map_index<const char*>(                           \
                 BETTER_ENUMS_NS(Enum)::_name_array(),                          \
-                _from_value_loop(CallInitialize(_value))));                    \
+                _find_value(CallInitialize(_value))));                         \
 }                                                                              \
                                                                                \
 BETTER_ENUMS_CONSTEXPR_ inline Enum::_optional                                 \
@@ -863,7 +1071,7 @@ Enum::_from_string_nothrow(const char *name)                                   \
 {                                                                              \
     return                                                                     \
         ::better_enums::_map_index<Enum>(                                      \
-            BETTER_ENUMS_NS(Enum)::_value_array, _from_string_loop(name));     \
+            BETTER_ENUMS_NS(Enum)::_value_array, _find_name(name));            \
 }                                                                              \
                                                                                \
 BETTER_ENUMS_IF_EXCEPTIONS(                                                    \
@@ -880,7 +1088,7 @@ Enum::_from_string_nocase_nothrow(const char *name)                            \
 {                                                                              \
     return                                                                     \
         ::better_enums::_map_index<Enum>(BETTER_ENUMS_NS(Enum)::_value_array,  \
-                                         _from_string_nocase_loop(name));      \
+                                         _find_name_nocase(name));             \
 }                                                                              \
                                                                                \
 BETTER_ENUMS_IF_EXCEPTIONS(                                                    \
@@ -895,17 +1103,17 @@ BETTER_ENUMS_CONSTEXPR_ inline Enum Enum::_from_string_nocase(const char *name)\
                                                                                \
 BETTER_ENUMS_CONSTEXPR_ inline bool Enum::_is_valid(_integral value)           \
 {                                                                              \
-    return _from_value_loop(value);                                            \
+    return _find_value(value);                                                 \
 }                                                                              \
                                                                                \
 BETTER_ENUMS_CONSTEXPR_ inline bool Enum::_is_valid(const char *name)          \
 {                                                                              \
-    return _from_string_loop(name);                                            \
+    return _find_name(name);                                                   \
 }                                                                              \
                                                                                \
 BETTER_ENUMS_CONSTEXPR_ inline bool Enum::_is_valid_nocase(const char *name)   \
 {                                                                              \
-    return _from_string_nocase_loop(name);                                     \
+    return _find_name_nocase(name);                                            \
 }                                                                              \
                                                                                \
 BETTER_ENUMS_CONSTEXPR_ inline const char* Enum::_name()                       \
@@ -1135,6 +1343,127 @@ operator >>(std::basic_istream<Char, Traits>& stream, Enum &value)             \
 
 
 
+#ifdef BETTER_ENUMS_HAVE_LOOKUP_TABLES
+
+// C++14 table version: names trimmed at compile time, without the
+// per-character expansion of the all-constexpr version
+#define BETTER_ENUMS_CXX14_TABLE_TRIM_STRINGS_ARRAYS(Enum, ...)                \
+    constexpr const char    *_the_raw_names[] =                                \
+        { BETTER_ENUMS_ID(BETTER_ENUMS_STRINGIZE(__VA_ARGS__)) };              \
+                                                                               \
+    constexpr const char * const * _raw_names()                                \
+    {                                                                          \
+        return _the_raw_names;                                                 \
+    }                                                                          \
+                                                                               \
+    constexpr auto          _trimmed =                                         \
+        ::better_enums::_trim_names_constexpr<                                 \
+            sizeof(BETTER_ENUMS_ID(                                            \
+                BETTER_ENUMS_RESERVE_STORAGE(__VA_ARGS__))),                   \
+            Enum::_size_constant>(_the_raw_names);                             \
+                                                                               \
+    constexpr const char * const    _the_name_array[] =                        \
+        { BETTER_ENUMS_ID(BETTER_ENUMS_REFER_TO_TRIMMED(Enum, __VA_ARGS__)) }; \
+                                                                               \
+    constexpr const char * const * _name_array()                               \
+    {                                                                          \
+        return _the_name_array;                                                \
+    }
+
+// BETTER_ENUMS_PP_MAP counts indexes down from the first constant
+#define BETTER_ENUMS_REFER_TO_TRIMMED_SINGLE(Enum, index, expression)          \
+    _trimmed._storage + _trimmed._offsets[Enum::_size_constant - 1 - index],
+
+#define BETTER_ENUMS_REFER_TO_TRIMMED(Enum, ...)                               \
+    BETTER_ENUMS_ID(                                                           \
+        BETTER_ENUMS_PP_MAP(                                                   \
+            BETTER_ENUMS_REFER_TO_TRIMMED_SINGLE, Enum, __VA_ARGS__))
+
+#define BETTER_ENUMS_LOOKUP_TABLES(Enum)                                       \
+constexpr ::better_enums::_lookup_table<Enum::_size_constant>   _value_table = \
+    ::better_enums::_make_value_table<Enum, Enum::_size_constant>(             \
+        _value_array);                                                         \
+constexpr ::better_enums::_lookup_table<Enum::_size_constant>   _name_table =  \
+    ::better_enums::_make_name_table<Enum::_size_constant>(                    \
+        _raw_names(), false);                                                  \
+constexpr ::better_enums::_lookup_table<Enum::_size_constant>                  \
+                                                    _name_nocase_table =       \
+    ::better_enums::_make_name_table<Enum::_size_constant>(                    \
+        _raw_names(), true);
+
+#define BETTER_ENUMS_DEFINE_FIND(Enum)                                         \
+constexpr inline Enum::_optional_index Enum::_find_value(_integral value)      \
+{                                                                              \
+    if (!BETTER_ENUMS_NS(Enum)::_value_table._valid)                           \
+        return _from_value_loop(value);                                        \
+                                                                               \
+    std::size_t index = BETTER_ENUMS_NS(Enum)::_value_table.find(              \
+        static_cast<unsigned long long>(value));                               \
+                                                                               \
+    return                                                                     \
+        index < _size() &&                                                     \
+        BETTER_ENUMS_NS(Enum)::_value_array[index]._value == value ?           \
+            _optional_index(index) : _optional_index();                        \
+}                                                                              \
+                                                                               \
+constexpr inline Enum::_optional_index Enum::_find_name(const char *name)      \
+{                                                                              \
+    if (!BETTER_ENUMS_NS(Enum)::_name_table._valid)                            \
+        return _from_string_loop(name);                                        \
+                                                                               \
+    std::size_t index = BETTER_ENUMS_NS(Enum)::_name_table.find(               \
+        ::better_enums::_name_hash(name, false));                              \
+                                                                               \
+    return                                                                     \
+        index < _size() &&                                                     \
+        ::better_enums::_names_match(                                          \
+            BETTER_ENUMS_NS(Enum)::_raw_names()[index], name) ?                \
+            _optional_index(index) : _optional_index();                        \
+}                                                                              \
+                                                                               \
+constexpr inline Enum::_optional_index                                         \
+Enum::_find_name_nocase(const char *name)                                      \
+{                                                                              \
+    if (!BETTER_ENUMS_NS(Enum)::_name_nocase_table._valid)                     \
+        return _from_string_nocase_loop(name);                                 \
+                                                                               \
+    std::size_t index = BETTER_ENUMS_NS(Enum)::_name_nocase_table.find(        \
+        ::better_enums::_name_hash(name, true));                               \
+                                                                               \
+    return                                                                     \
+        index < _size() &&                                                     \
+        ::better_enums::_names_match_nocase(                                   \
+            BETTER_ENUMS_NS(Enum)::_raw_names()[index], name) ?                \
+            _optional_index(index) : _optional_index();                        \
+}
+
+#else
+
+#define BETTER_ENUMS_LOOKUP_TABLES(Enum)
+
+#define BETTER_ENUMS_DEFINE_FIND(Enum)                                         \
+BETTER_ENUMS_CONSTEXPR_ inline Enum::_optional_index                           \
+Enum::_find_value(_integral value)                                             \
+{                                                                              \
+    return _from_value_loop(value);                                            \
+}                                                                              \
+                                                                               \
+BETTER_ENUMS_CONSTEXPR_ inline Enum::_optional_index                           \
+Enum::_find_name(const char *name)                                             \
+{                                                                              \
+    return _from_string_loop(name);                                            \
+}                                                                              \
+                                                                               \
+BETTER_ENUMS_CONSTEXPR_ inline Enum::_optional_index                           \
+Enum::_find_name_nocase(const char *name)                                      \
+{                                                                              \
+    return _from_string_nocase_loop(name);                                     \
+}
+
+#endif // #ifdef BETTER_ENUMS_HAVE_LOOKUP_TABLES
+
+
+
 // User feature selection.
 
 #ifdef BETTER_ENUMS_STRICT_CONVERSION
@@ -1161,7 +1490,18 @@ operator >>(std::basic_istream<Char, Traits>& stream, Enum &value)             \
 
 #ifdef BETTER_ENUMS_HAVE_CONSTEXPR
 
-#ifdef BETTER_ENUMS_CONSTEXPR_TO_STRING
+#if defined(BETTER_ENUMS_HAVE_LOOKUP_TABLES)
+#   define BETTER_ENUMS_DEFAULT_TRIM_STRINGS_ARRAYS                            \
+        BETTER_ENUMS_CXX14_TABLE_TRIM_STRINGS_ARRAYS
+#   define BETTER_ENUMS_DEFAULT_TO_STRING_KEYWORD                              \
+        BETTER_ENUMS_CONSTEXPR_TO_STRING_KEYWORD
+#   define BETTER_ENUMS_DEFAULT_DECLARE_INITIALIZE                             \
+        BETTER_ENUMS_DECLARE_EMPTY_INITIALIZE
+#   define BETTER_ENUMS_DEFAULT_DEFINE_INITIALIZE                              \
+        BETTER_ENUMS_DO_NOT_DEFINE_INITIALIZE
+#   define BETTER_ENUMS_DEFAULT_CALL_INITIALIZE                                \
+        BETTER_ENUMS_DO_NOT_CALL_INITIALIZE
+#elif defined(BETTER_ENUMS_CONSTEXPR_TO_STRING)
 #   define BETTER_ENUMS_DEFAULT_TRIM_STRINGS_ARRAYS                            \
         BETTER_ENUMS_CXX11_FULL_CONSTEXPR_TRIM_STRINGS_ARRAYS
 #   define BETTER_ENUMS_DEFAULT_TO_STRING_KEYWORD                              \
@@ -0,0 +1,183 @@
+// libjunoreg: the C interface in junoreg.h over RegisterManager and the
+// apb_fields.hpp decoders. Built with hidden visibility, so only the
+// JUNOREG_API functions are exported.
+//
+// Build: make lib (produces libjunoreg.so and libjunoreg.a)
+
+#include "junoreg.h"
+
+#include <array>
+#include <exception>
+#include <string>
+#include <utility>
+
+#include "apb_fields.hpp"
+#include "register_manager.hpp"
+#include "registers.hpp"
+
+static_assert(JUNOREG_SCC_BASE == SCC_BASE_ADDR && JUNOREG_APB_BASE == APB_BASE_ADDR && JUNOREG_AXI_BASE == AXI_BASE_ADDR,
+              "junoreg.h region bases must match registers.hpp");
+static_assert(JUNOREG_REGION_BYTES == MAP_SIZE, "junoreg.h region size must match registers.hpp");
+static_assert(JUNOREG_SYS_ID == APBRegister::SYS_ID && JUNOREG_SYS_PROC_ID0 == APBRegister::SYS_PROC_ID0 &&
+                  JUNOREG_SYS_PROC_ID1 == APBRegister::SYS_PROC_ID1,
+              "junoreg.h APB offsets must match registers.hpp");
+
+struct junoreg_region
+{
+    RegisterManager manager;
+};
+
+namespace
+{
+
+thread_local std::string t_last_error;
+
+int fail(std::string message)
+{
+    t_last_error = std::move(message);
+    return JUNOREG_ERROR;
+}
+
+// Checks that 'count' registers from 'offset' lie inside the region
+int check_range(junoreg_region const *const region, uint32_t const offset, size_t const count)
+{
+    if (!region)
+    {
+        return fail("Error: region is NULL.");
+    }
+    if (offset % 4 != 0 || offset >= MAP_SIZE || count > (MAP_SIZE - offset) / 4)
+    {
+        return fail("Error: " + std::to_string(count) + " registers at byte offset " + std::to_string(offset) + " do not fit in the " +
+                    std::to_string(MAP_SIZE) + "-byte region.");
+    }
+    return JUNOREG_OK;
+}
+
+} // namespace
+
+extern "C"
+{
+
+int junoreg_abi_version(void)
+{
+    return JUNOREG_ABI_VERSION;
+}
+
+char const *junoreg_last_error(void)
+{
+    return t_last_error.c_str();
+}
+
+junoreg_region *junoreg_open(uint64_t const physical_base, unsigned const flags)
+{
+    if (physical_base % MAP_SIZE != 0)
+    {
+        fail("Error: physical base is not page-aligned.");
+        return nullptr;
+    }
+    try
+    {
+        return new junoreg_region{RegisterManager(physical_base, false, (flags & JUNOREG_SIMULATED) != 0, false)};
+    }
+    catch (std::exception const &error)
+    {
+        fail(error.what());
+        return nullptr;
+    }
+}
+
+void junoreg_close(junoreg_region *const region)
+{
+    delete region;
+}
+
+int junoreg_read(junoreg_region const *const region, uint32_t const offset, uint32_t *const value)
+{
+    if (check_range(region, offset, 1) != JUNOREG_OK)
+    {
+        return JUNOREG_ERROR;
+    }
+    *value = region->manager.readOffset(offset);
+    return JUNOREG_OK;
+}
+
+int junoreg_write(junoreg_region const *const region, uint32_t const offset, uint32_t const value)
+{
+    if (check_range(region, offset, 1) != JUNOREG_OK)
+    {
+        return JUNOREG_ERROR;
+    }
+    region->manager.writeOffset(offset, value);
+    return JUNOREG_OK;
+}
+
+int junoreg_read_burst(junoreg_region const *const region, uint32_t const offset, uint32_t *const values, size_t const count)
+{
+    if (check_range(region, offset, count) != JUNOREG_OK)
+    {
+        return JUNOREG_ERROR;
+    }
+    volatile uint32_t const *const registers{region->manager.mappedBase() + offset / 4};
+    for (size_t i{0}; i < count; ++i)
+    {
+        values[i] = registers[i];
+    }
+    return JUNOREG_OK;
+}
+
+int junoreg_write_burst(junoreg_region const *const region, uint32_t const offset, uint32_t const *const values, size_t const count)
+{
+    if (check_range(region, offset, count) != JUNOREG_OK)
+    {
+        return JUNOREG_ERROR;
+    }
+    // A burst never leaves the region, so one page's worth of writes covers any of them
+    std::array<RegisterWrite, MAP_SIZE / 4> writes;
+    for (size_t i{0}; i < count; ++i)
+    {
+        writes[i] = RegisterWrite{offset + static_cast<uint32_t>(i * 4), values[i]};
+    }
+    region->manager.writeBatch(writes.data(), count);
+    return JUNOREG_OK;
+}
+
+int junoreg_window_of(junoreg_region const *const region, junoreg_window *const window)
+{
+    if (!region)
+    {
+        return fail("Error: region is NULL.");
+    }
+    *window = junoreg_window{region->manager.mappedBase(), MAP_SIZE, region->manager.physicalBase()};
+    return JUNOREG_OK;
+}
+
+junoreg_board_info junoreg_decode_board_info(uint32_t const sys_id)
+{
+    SysId const id{SysId::decode(sys_id)};
+    return junoreg_board_info{id.rev, id.hbi, id.build, id.arch, id.fpga};
+}
+
+junoreg_logictile_info junoreg_decode_logictile_info(uint32_t const sys_proc_id)
+{
+    SysProcId const id{SysProcId::decode(sys_proc_id)};
+    return junoreg_logictile_info{id.app_note, id.rev, id.variant, id.hbi};
+}
+
+int junoreg_format_apb_register(uint32_t const offset, uint32_t const value, char *const text, size_t const size)
+{
+    if (size == 0)
+    {
+        return fail("Error: text buffer is empty.");
+    }
+    // Leave room for the terminator
+    char *const end{format_apb_register(offset, value, text, text + size - 1)};
+    if (!end)
+    {
+        text[0] = '\0';
+        return fail("Error: text buffer of " + std::to_string(size) + " bytes is too small.");
+    }
+    *end = '\0';
+    return static_cast<int>(end - text);
+}
+
+} // extern "C"
@@ -0,0 +1,169 @@
+#pragma once
+
+/*
+ * C interface to the Juno register regions, built as libjunoreg.so and
+ * libjunoreg.a (make lib). It wraps RegisterManager and the apb_fields.hpp
+ * decoders so other tools can read and write registers in-process instead of
+ * running reg-test once per query.
+ *
+ * Every call that can fail returns JUNOREG_OK or JUNOREG_ERROR and leaves a
+ * message for junoreg_last_error(). The junoreg_window_* functions are the
+ * exception: they are inline loads and stores through a mapping fetched once
+ * with junoreg_window_of(), with no call and no checking per access.
+ *
+ * The ABI only grows: existing functions and structs keep their signatures
+ * and layouts, and JUNOREG_ABI_VERSION is bumped when functions are added.
+ */
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#if defined(__GNUC__)
+#define JUNOREG_API __attribute__((visibility("default")))
+#else
+#define JUNOREG_API
+#endif
+
+#define JUNOREG_ABI_VERSION 1
+
+#define JUNOREG_OK 0
+#define JUNOREG_ERROR (-1)
+
+/* Physical bases of the regions reg-test knows (registers.hpp) */
+#define JUNOREG_SCC_BASE 0x60010000ull
+#define JUNOREG_APB_BASE 0x1C010000ull
+#define JUNOREG_AXI_BASE 0x64000000ull
+
+/* Bytes mapped per region; offsets must be 4-byte aligned and below this */
+#define JUNOREG_REGION_BYTES 4096u
+
+/* APB offsets of the board identification registers */
+#define JUNOREG_SYS_ID 0x000u
+#define JUNOREG_SYS_PROC_ID0 0x084u
+#define JUNOREG_SYS_PROC_ID1 0x088u
+
+/* junoreg_open() flags */
+#define JUNOREG_SIMULATED 0x1u /* Back the region with anonymous memory instead of /dev/mem */
+
+typedef struct junoreg_region junoreg_region;
+
+/**
+ * @brief A region's mapping, for the inline junoreg_window_* accessors.
+ */
+typedef struct junoreg_window
+{
+    volatile uint32_t *base;
+    size_t bytes;
+    uint64_t physical_base;
+} junoreg_window;
+
+/**
+ * @brief SYS_ID, decoded.
+ */
+typedef struct junoreg_board_info
+{
+    uint32_t rev;   /* Board revision, 0 = Rev A */
+    uint32_t hbi;   /* HBI board number */
+    uint32_t build; /* Board build variant */
+    uint32_t arch;  /* IOFPGA bus architecture: 4 = AHB, otherwise AXI */
+    uint32_t fpga;  /* FPGA build, BCD */
+} junoreg_board_info;
+
+/**
+ * @brief SYS_PROC_ID0 / SYS_PROC_ID1 (one per LogicTile site), decoded.
+ */
+typedef struct junoreg_logictile_info
+{
+    uint32_t app_note; /* FPGA image (application note number) */
+    uint32_t rev;      /* Board revision, 0 = A */
+    uint32_t variant;  /* Board build variant, 0 = A */
+    uint32_t hbi;      /* HBI board number */
+} junoreg_logictile_info;
+
+/**
+ * @brief Returns JUNOREG_ABI_VERSION as the library was built, to check against the header.
+ */
+JUNOREG_API int junoreg_abi_version(void);
+
+/**
+ * @brief Describes the last failure on the calling thread ("" if none).
+ */
+JUNOREG_API char const *junoreg_last_error(void);
+
+/**
+ * @brief Maps JUNOREG_REGION_BYTES of registers at a page-aligned physical address.
+ * @param physical_base The region's physical address, e.g. JUNOREG_AXI_BASE.
+ * @param flags Zero or JUNOREG_SIMULATED.
+ * @return The region, or NULL on failure (see junoreg_last_error()).
+ */
+JUNOREG_API junoreg_region *junoreg_open(uint64_t physical_base, unsigned flags);
+
+/**
+ * @brief Unmaps a region; NULL is ignored.
+ */
+JUNOREG_API void junoreg_close(junoreg_region *region);
+
+/**
+ * @brief Reads the register at a byte offset into *value.
+ */
+JUNOREG_API int junoreg_read(junoreg_region const *region, uint32_t offset, uint32_t *value);
+
+/**
+ * @brief Writes the register at a byte offset.
+ */
+JUNOREG_API int junoreg_write(junoreg_region const *region, uint32_t offset, uint32_t value);
+
+/**
+ * @brief Reads 'count' consecutive registers starting at a byte offset.
+ */
+JUNOREG_API int junoreg_read_burst(junoreg_region const *region, uint32_t offset, uint32_t *values, size_t count);
+
+/**
+ * @brief Writes 'count' consecutive registers back-to-back, followed by a single barrier.
+ */
+JUNOREG_API int junoreg_write_burst(junoreg_region const *region, uint32_t offset, uint32_t const *values, size_t count);
+
+/**
+ * @brief Fills *window with the region's mapping, valid until junoreg_close().
+ */
+JUNOREG_API int junoreg_window_of(junoreg_region const *region, junoreg_window *window);
+
+/**
+ * @brief Decodes a SYS_ID value.
+ */
+JUNOREG_API junoreg_board_info junoreg_decode_board_info(uint32_t sys_id);
+
+/**
+ * @brief Decodes a SYS_PROC_IDn value.
+ */
+JUNOREG_API junoreg_logictile_info junoreg_decode_logictile_info(uint32_t sys_proc_id);
+
+/**
+ * @brief Formats the decoded fields of an APB register as reg-test prints them, NUL-terminated.
+ * @return The length written (0 if the register has no fields), or JUNOREG_ERROR if 'size' is too small.
+ */
+JUNOREG_API int junoreg_format_apb_register(uint32_t offset, uint32_t value, char *text, size_t size);
+
+/**
+ * @brief Reads a register through a window: one load, no call and no checks.
+ */
+static inline uint32_t junoreg_window_read(junoreg_window const *window, uint32_t offset)
+{
+    return window->base[offset / 4];
+}
+
+/**
+ * @brief Writes a register through a window: one store, no call, no checks and no barrier.
+ */
+static inline void junoreg_window_write(junoreg_window const *window, uint32_t offset, uint32_t value)
+{
+    window->base[offset / 4] = value;
+}
+
+#ifdef __cplusplus
+} /* extern "C" */
+#endif
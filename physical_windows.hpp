@@ -0,0 +1,272 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iostream>
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+/**
+ * @brief Reads and writes anywhere in physical memory through a cache of mapped windows.
+ *
+ * RegisterManager maps one MAP_SIZE page at a fixed base. PhysicalWindows
+ * instead splits the physical address space into fixed-size, size-aligned
+ * windows and maps each one the first time it is touched, all from one shared
+ * /dev/mem descriptor. The most recently used windows stay mapped up to a cap
+ * on mapped bytes, and the least recently used is unmapped to make room, so a
+ * sparse walk over megabytes of address space costs at most one mmap per
+ * window it visits (while the windows fit under the cap).
+ *
+ * With huge_aligned, windows are 2 MiB (or a multiple) and are also placed at
+ * 2 MiB-aligned virtual addresses, so the kernel can back them with block
+ * mappings where it supports that for the device.
+ *
+ * In simulated mode the windows come from a sparse memfd instead of /dev/mem,
+ * so data survives eviction and the cache behaves the same way without a board.
+ */
+class PhysicalWindows
+{
+public:
+    static constexpr size_t DEFAULT_WINDOW_BYTES{64 << 10};
+    static constexpr size_t HUGE_WINDOW_BYTES{2 << 20};
+    static constexpr size_t DEFAULT_MAX_MAPPED_BYTES{64 << 20};
+
+    struct Counters
+    {
+        uint64_t hits{0};   // Accesses to a window that was already mapped
+        uint64_t maps{0};   // mmap calls
+        uint64_t unmaps{0}; // Windows evicted to stay under the cap
+        size_t mapped_bytes{0};
+    };
+
+    /**
+     * @param window_bytes Size of each window: a multiple of the page size (2 MiB with huge_aligned).
+     * @param max_mapped_bytes Cap on the bytes mapped at once (at least one window).
+     * @param huge_aligned Round windows up to 2 MiB and align their virtual addresses to 2 MiB.
+     * @param simulated Back physical memory with a sparse memfd instead of /dev/mem.
+     */
+    explicit PhysicalWindows(size_t const window_bytes = DEFAULT_WINDOW_BYTES, size_t const max_mapped_bytes = DEFAULT_MAX_MAPPED_BYTES,
+                             bool const huge_aligned = false, bool const simulated = false)
+        : m_window_bytes(huge_aligned ? round_up(window_bytes, HUGE_WINDOW_BYTES) : window_bytes),
+          m_max_mapped_bytes(max_mapped_bytes),
+          m_huge_aligned(huge_aligned),
+          m_simulated(simulated)
+    {
+        size_t const page{static_cast<size_t>(sysconf(_SC_PAGESIZE))};
+        if (m_window_bytes == 0 || m_window_bytes % page != 0 || (m_window_bytes & (m_window_bytes - 1)) != 0)
+        {
+            throw std::runtime_error("Error: window size " + std::to_string(window_bytes) + " is not a power-of-two multiple of the page size.");
+        }
+        if (m_max_mapped_bytes < m_window_bytes)
+        {
+            throw std::runtime_error("Error: mapped-bytes cap " + std::to_string(max_mapped_bytes) + " is smaller than one window.");
+        }
+
+        m_fd = m_simulated ? memfd_create("juno-physical", MFD_CLOEXEC) : open("/dev/mem", O_RDWR | O_SYNC | O_CLOEXEC);
+        if (m_fd == -1)
+        {
+            throw std::runtime_error(m_simulated ? "Error: Could not create simulated physical memory."
+                                                 : "Error: Could not open /dev/mem. Must run as root or with appropriate permissions.");
+        }
+    }
+
+    ~PhysicalWindows()
+    {
+        for (Window const &window : m_lru)
+        {
+            munmap(window.base, m_window_bytes);
+        }
+        close(m_fd);
+    }
+
+    PhysicalWindows(PhysicalWindows const &) = delete;
+    PhysicalWindows &operator=(PhysicalWindows const &) = delete;
+
+    /**
+     * @brief Returns a pointer to [physical, physical + bytes), mapping its window if needed.
+     *
+     * The pointer stays valid until a later access evicts the window, so hold
+     * it only across accesses that fit under the cap alongside it.
+     * @throws std::runtime_error If the range crosses a window boundary or the mapping fails.
+     */
+    void *span(uint64_t const physical, size_t const bytes)
+    {
+        uint64_t const index{physical / m_window_bytes};
+        uint64_t const offset{physical % m_window_bytes};
+        if (bytes > m_window_bytes - offset)
+        {
+            throw std::runtime_error("Error: physical range at 0x" + to_hex(physical) + " crosses a " + std::to_string(m_window_bytes) +
+                                     "-byte window boundary.");
+        }
+        return static_cast<char *>(window(index)) + offset;
+    }
+
+    template <typename T>
+    T read(uint64_t const physical)
+    {
+        return *static_cast<T volatile *>(span(physical, sizeof(T)));
+    }
+
+    template <typename T>
+    void write(uint64_t const physical, T const value)
+    {
+        *static_cast<T volatile *>(span(physical, sizeof(T))) = value;
+    }
+
+    [[nodiscard]] size_t windowBytes() const
+    {
+        return m_window_bytes;
+    }
+
+    [[nodiscard]] Counters counters() const
+    {
+        Counters counters{m_counters};
+        counters.mapped_bytes = m_lru.size() * m_window_bytes;
+        return counters;
+    }
+
+    void print_counters(std::ostream &stream) const
+    {
+        Counters const totals{counters()};
+        stream << "[WINDOW] " << m_window_bytes / 1024 << " KiB windows" << (m_huge_aligned ? " (2 MiB aligned)" : "") << ": "
+               << totals.maps << " maps, " << totals.unmaps << " unmaps, " << totals.hits << " hits, " << totals.mapped_bytes / 1024
+               << " KiB mapped of " << m_max_mapped_bytes / 1024 << " KiB" << std::endl;
+    }
+
+private:
+    struct Window
+    {
+        uint64_t index;
+        void *base;
+    };
+
+    size_t const m_window_bytes;
+    size_t const m_max_mapped_bytes;
+    bool const m_huge_aligned;
+    bool const m_simulated;
+    int m_fd{-1};
+    off_t m_simulated_bytes{0};
+
+    // Most recently used first; the map finds a window's list node
+    std::list<Window> m_lru;
+    std::unordered_map<uint64_t, std::list<Window>::iterator> m_windows;
+    uint64_t m_last_index{UINT64_MAX};
+    void *m_last_base{nullptr};
+    Counters m_counters;
+
+    static size_t round_up(size_t const value, size_t const multiple)
+    {
+        return (value + multiple - 1) / multiple * multiple;
+    }
+
+    static std::string to_hex(uint64_t const value)
+    {
+        char text[17];
+        return std::string(text, static_cast<size_t>(std::snprintf(text, sizeof(text), "%llx", static_cast<unsigned long long>(value))));
+    }
+
+    void *window(uint64_t const index)
+    {
+        // Runs of accesses usually stay in one window, which then needs no lookup at all
+        if (index == m_last_index)
+        {
+            ++m_counters.hits;
+            return m_last_base;
+        }
+
+        auto const found{m_windows.find(index)};
+        if (found != m_windows.end())
+        {
+            ++m_counters.hits;
+            m_lru.splice(m_lru.begin(), m_lru, found->second);
+        }
+        else
+        {
+            while ((m_lru.size() + 1) * m_window_bytes > m_max_mapped_bytes)
+            {
+                evict();
+            }
+            m_lru.push_front(Window{index, map(index)});
+            m_windows.emplace(index, m_lru.begin());
+        }
+        m_last_index = index;
+        m_last_base = m_lru.front().base;
+        return m_last_base;
+    }
+
+    void evict()
+    {
+        Window const &oldest{m_lru.back()};
+        if (munmap(oldest.base, m_window_bytes) == -1)
+        {
+            std::cerr << "[ERROR] Failed to unmap physical window 0x" << to_hex(oldest.index * m_window_bytes) << "." << std::endl;
+        }
+        if (oldest.index == m_last_index)
+        {
+            m_last_index = UINT64_MAX;
+        }
+        m_windows.erase(oldest.index);
+        m_lru.pop_back();
+        ++m_counters.unmaps;
+    }
+
+    void *map(uint64_t const index)
+    {
+        off_t const physical{static_cast<off_t>(index * m_window_bytes)};
+        if (m_simulated && physical + static_cast<off_t>(m_window_bytes) > m_simulated_bytes)
+        {
+            // Sparse, so only the pages actually touched take memory
+            m_simulated_bytes = physical + static_cast<off_t>(m_window_bytes);
+            if (ftruncate(m_fd, m_simulated_bytes) == -1)
+            {
+                throw std::runtime_error("Error: Could not grow simulated physical memory to 0x" + to_hex(m_simulated_bytes) + ".");
+            }
+        }
+
+        void *hint{nullptr};
+        void *reservation{MAP_FAILED};
+        if (m_huge_aligned)
+        {
+            // Reserve twice the window and place the mapping on the 2 MiB boundary inside it
+            reservation = mmap(nullptr, m_window_bytes * 2, PROT_NONE, MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+            if (reservation == MAP_FAILED)
+            {
+                throw std::runtime_error("Error: mmap failed to reserve an aligned physical window.");
+            }
+            hint = reinterpret_cast<void *>(round_up(reinterpret_cast<uintptr_t>(reservation), HUGE_WINDOW_BYTES));
+        }
+
+        void *const base{mmap(hint, m_window_bytes, PROT_READ | PROT_WRITE, MAP_SHARED | (hint ? MAP_FIXED : 0), m_fd, physical)};
+        if (reservation != MAP_FAILED)
+        {
+            // Release the unused slack on either side of the window
+            char *const start{static_cast<char *>(reservation)};
+            char *const end{start + m_window_bytes * 2};
+            char *const aligned{static_cast<char *>(hint)};
+            if (aligned > start)
+            {
+                munmap(start, static_cast<size_t>(aligned - start));
+            }
+            if (base == MAP_FAILED)
+            {
+                munmap(aligned, m_window_bytes);
+            }
+            if (aligned + m_window_bytes < end)
+            {
+                munmap(aligned + m_window_bytes, static_cast<size_t>(end - aligned - m_window_bytes));
+            }
+        }
+        if (base == MAP_FAILED)
+        {
+            throw std::runtime_error("Error: mmap failed to map physical window 0x" + to_hex(static_cast<uint64_t>(physical)) + ".");
+        }
+        ++m_counters.maps;
+        return base;
+    }
+};
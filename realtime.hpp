@@ -0,0 +1,245 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <fcntl.h>
+#include <malloc.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <sys/prctl.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "cpu_topology.hpp"
+
+/**
+ * @brief Puts the process in a low-jitter state for latency-sensitive register work.
+ *
+ * In order, the constructor:
+ *   - stops malloc returning memory to the kernel, then locks and pre-faults
+ *     the stack and heap, so later accesses never take a page fault;
+ *   - pins the process to one CPU (by default the highest-numbered core of
+ *     the fastest type, an A72 on Juno) and switches it to SCHED_FIFO;
+ *   - holds /dev/cpu_dma_latency at 0 so the CPU does not enter deep idle
+ *     states between polls, and sets its cpufreq governor to "performance";
+ *   - reduces timer slack to 1ns so absolute sleeps wake on time.
+ * Each step that fails (typically for lack of root or a missing sysfs file)
+ * prints a warning and the others still apply. Threads created afterwards
+ * inherit the affinity and scheduling policy. The destructor restores the
+ * governor and releases the latency request.
+ *
+ * SCHED_FIFO threads that spin (polls, short waits) can hold their CPU for
+ * as long as the kernel's RT throttling allows (sched_rt_runtime_us, 95% by
+ * default), so keep that limit in place when experimenting.
+ */
+class RealtimeSession
+{
+public:
+    static constexpr int DEFAULT_PRIORITY{49};            // Below PREEMPT_RT's interrupt threads (50)
+    static constexpr size_t STACK_PREFAULT_BYTES{512 * 1024};
+    static constexpr size_t HEAP_PREFAULT_BYTES{16 * 1024 * 1024};
+
+    /**
+     * @brief Constructor: Applies every real-time setting it can.
+     * @param cpu The CPU to pin to, or -1 to choose the fastest.
+     * @param priority The SCHED_FIFO priority.
+     * @param stream Where to print the settings that took effect.
+     */
+    explicit RealtimeSession(int const cpu = -1, int const priority = DEFAULT_PRIORITY, std::ostream &stream = std::cout)
+        : m_cpu(cpu >= 0 ? static_cast<unsigned>(cpu) : CpuTopology::fastest_cpu())
+    {
+        // Freed memory stays in the (locked) arena instead of being unmapped and faulted in again
+        mallopt(M_TRIM_THRESHOLD, -1);
+        mallopt(M_MMAP_MAX, 0);
+        bool const locked{mlockall(MCL_CURRENT | MCL_FUTURE) == 0};
+        if (!locked)
+        {
+            warn("mlockall", errno);
+        }
+        prefault_stack();
+        prefault_heap();
+
+        cpu_set_t set;
+        CPU_ZERO(&set);
+        CPU_SET(m_cpu, &set);
+        if (sched_setaffinity(0, sizeof(set), &set) == -1)
+        {
+            warn("sched_setaffinity", errno);
+        }
+        sched_param const param{priority};
+        bool const fifo{sched_setscheduler(0, SCHED_FIFO, &param) == 0};
+        if (!fifo)
+        {
+            warn("sched_setscheduler(SCHED_FIFO)", errno);
+        }
+
+        // Held for the life of the session; the kernel drops the request when the fd closes
+        m_dma_latency_fd = open("/dev/cpu_dma_latency", O_WRONLY);
+        int32_t const no_latency{0};
+        if (m_dma_latency_fd == -1 || write(m_dma_latency_fd, &no_latency, sizeof(no_latency)) != sizeof(no_latency))
+        {
+            warn("/dev/cpu_dma_latency", errno);
+        }
+
+        m_governor_path = CpuTopology::cpu_path(m_cpu) + "/cpufreq/scaling_governor";
+        m_saved_governor = CpuTopology::read_line(m_governor_path);
+        if (!m_saved_governor.empty() && m_saved_governor != "performance" && !write_sysfs(m_governor_path, "performance"))
+        {
+            warn("cpufreq governor", errno);
+            m_saved_governor.clear();
+        }
+        else if (m_saved_governor == "performance")
+        {
+            m_saved_governor.clear();
+        }
+
+        prctl(PR_SET_TIMERSLACK, 1UL);
+
+        stream << "[RT] CPU " << m_cpu << " (capacity " << capacity(m_cpu) << "), "
+                  << (fifo ? "SCHED_FIFO priority " + std::to_string(priority) : std::string("default scheduling")) << ", memory "
+                  << (locked ? "locked" : "not locked") << std::endl;
+    }
+
+    ~RealtimeSession()
+    {
+        if (!m_saved_governor.empty())
+        {
+            write_sysfs(m_governor_path, m_saved_governor);
+        }
+        if (m_dma_latency_fd != -1)
+        {
+            close(m_dma_latency_fd);
+        }
+    }
+
+    RealtimeSession(RealtimeSession const &) = delete;
+    RealtimeSession &operator=(RealtimeSession const &) = delete;
+
+    [[nodiscard]] unsigned cpu() const
+    {
+        return m_cpu;
+    }
+
+    /**
+     * @brief Measures wake-up latency and interruptions, and prints a histogram.
+     *
+     * Sleeps to 'iterations' absolute deadlines 'period_us' apart, recording
+     * how late each wake-up is, then spins for 'spin_ms' recording the longest
+     * gap between consecutive clock reads (time the thread was not running).
+     */
+    static void calibrate(unsigned const iterations, unsigned const period_us, unsigned const spin_ms, std::ostream &stream)
+    {
+        // Bucket k holds latencies in [2^(k-1), 2^k) microseconds; bucket 0 is below 1us
+        std::array<unsigned, 16> histogram{};
+        uint64_t min_ns{UINT64_MAX}, max_ns{0}, total_ns{0};
+        uint64_t deadline{now_ns()};
+        for (unsigned iteration{0}; iteration < iterations; ++iteration)
+        {
+            deadline += uint64_t{period_us} * 1000;
+            timespec const ts{static_cast<time_t>(deadline / 1'000'000'000), static_cast<long>(deadline % 1'000'000'000)};
+            while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR)
+            {
+            }
+            uint64_t const late{now_ns() - deadline};
+            uint64_t const late_us{late / 1000};
+            ++histogram[std::min<size_t>(late_us ? 64 - __builtin_clzll(late_us) : 0, histogram.size() - 1)];
+            min_ns = std::min(min_ns, late);
+            max_ns = std::max(max_ns, late);
+            total_ns += late;
+        }
+
+        uint64_t max_gap_ns{0};
+        uint64_t const spin_end{now_ns() + uint64_t{spin_ms} * 1'000'000};
+        for (uint64_t previous{now_ns()}, now{previous}; now < spin_end; previous = now)
+        {
+            now = now_ns();
+            max_gap_ns = std::max(max_gap_ns, now - previous);
+        }
+
+        stream << std::fixed << std::setprecision(2) << "[RT] Wake-up latency over " << iterations << " x " << period_us
+               << "us sleeps: min " << min_ns / 1e3 << " us, mean " << total_ns / 1e3 / std::max(iterations, 1u) << " us, max "
+               << max_ns / 1e3 << " us; longest interruption in a " << spin_ms << " ms spin " << max_gap_ns / 1e3 << " us\n";
+        unsigned const peak{*std::max_element(histogram.begin(), histogram.end())};
+        size_t const trailing_empty{static_cast<size_t>(std::find_if(histogram.rbegin(), histogram.rend(), [](unsigned count) { return count != 0; }) -
+                                              histogram.rbegin())};
+        for (size_t bucket{0}; bucket < histogram.size() - trailing_empty; ++bucket)
+        {
+            std::string const range{bucket == 0 ? "< 1us"
+                                    : bucket == histogram.size() - 1
+                                        ? ">= " + std::to_string(1u << (bucket - 1)) + "us"
+                                        : std::to_string(1u << (bucket - 1)) + "-" + std::to_string(1u << bucket) + "us"};
+            stream << "[RT] " << std::setw(14) << range << std::setw(8) << histogram[bucket] << ' '
+                   << std::string(peak ? (histogram[bucket] * 50 + peak - 1) / peak : 0, '#') << '\n';
+        }
+        stream << std::defaultfloat << std::flush;
+    }
+
+private:
+    unsigned const m_cpu;
+    int m_dma_latency_fd{-1};
+    std::string m_governor_path;
+    std::string m_saved_governor; // Non-empty when the governor must be restored
+
+    [[nodiscard]] static uint64_t now_ns()
+    {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000 + static_cast<uint64_t>(ts.tv_nsec);
+    }
+
+    [[nodiscard]] static unsigned capacity(unsigned const cpu)
+    {
+        for (auto const &info : CpuTopology::online())
+        {
+            if (info.id == cpu)
+            {
+                return info.capacity;
+            }
+        }
+        return 0;
+    }
+
+    static void warn(char const *what, int const error)
+    {
+        std::cerr << "[WARN] RT: " << what << " failed: " << std::strerror(error) << std::endl;
+    }
+
+    static bool write_sysfs(std::string const &path, std::string const &value)
+    {
+        std::ofstream file(path);
+        file << value << std::flush;
+        return static_cast<bool>(file);
+    }
+
+    // Touch the stack below this frame, so its pages are mapped (and locked) before they are needed
+    __attribute__((noinline)) static void prefault_stack()
+    {
+        volatile char stack[STACK_PREFAULT_BYTES];
+        for (size_t offset{0}; offset < sizeof(stack); offset += 4096)
+        {
+            stack[offset] = 0;
+        }
+    }
+
+    static void prefault_heap()
+    {
+        char *const heap{static_cast<char *>(std::malloc(HEAP_PREFAULT_BYTES))};
+        if (heap)
+        {
+            for (size_t offset{0}; offset < HEAP_PREFAULT_BYTES; offset += 4096)
+            {
+                static_cast<char volatile *>(heap)[offset] = 0;
+            }
+            std::free(heap);
+        }
+    }
+};
@@ -1,9 +1,13 @@
 #include <cstring>
+#include <cstdlib>
 #include <iostream>
 #include <iomanip>
 #include <string>
 #include <map>
+#include <sstream>
+#include <optional>
 #include <unistd.h>
+#include <getopt.h>
 #include <fcntl.h>
 #include <sys/mman.h>
 #include <cstdint>
@@ -11,219 +15,34 @@
 #include <array>
 #include <chrono>
 #include <thread>
+#include <atomic>
+#include <algorithm>
 
 #include "enum.h"
 #include "bitmanip.hpp"
+#include "bit_dump.hpp"
+#include "apb_fields.hpp"
+#include "registers.hpp"
+#include "rng_model.hpp"
+#include "register_manager.hpp"
+#include "register_ops.hpp"
+#include "register_script.hpp"
+#include "register_trace.hpp"
+#include "register_replay.hpp"
+#include "telemetry.hpp"
+#include "register_sampler.hpp"
+#include "board_clock.hpp"
+#include "realtime.hpp"
+#include "thread_placement.hpp"
+#include "shadow_registers.hpp"
+#include "physical_windows.hpp"
+#include "axi_bandwidth.hpp"
+#include "register_remote.hpp"
+#include "csprng.hpp"
+#include "dma_ring.hpp"
 #include <random>
 
-// NOTE: These must be page-aligned addresses for mmap.
-constexpr uint64_t SCC_BASE_ADDR{0x60010000}; // System Control Controller
-constexpr uint64_t APB_BASE_ADDR{0x1C010000}; // Juno Advanced Peripheral Bus
-constexpr uint64_t AXI_BASE_ADDR{0x64000000}; // LogicTile Spare AXI Slave
-
-// The size of the memory region to map. We map one standard page (4KB) to ensure we cover most registers around the base address.
-constexpr size_t MAP_SIZE{4096}; // 4KB, standard page size
-
-BETTER_ENUM(SCCRegister, uint32_t,
-            SCC_LED = 0x104
-)
-
-BETTER_ENUM(APBRegister, uint32_t,
-            SYS_ID = 0x000,
-            SYS_SQ = 0x004,
-            SYS_LED = 0x008,
-            SYS_100HZ = 0x0024,
-            SYS_FLAG = 0x0030,
-            SYS_FLAGSCLR = 0x0034,
-            SYS_NVFLAGS = 0x0038,
-            SYS_NVFLAGSCLR = 0x003C,
-            SYS_CFGSW = 0x0058,
-            SYS_24MHZ = 0x005C,
-            SYS_MISC = 0x0060,
-            SYS_PCIE_CNTL = 0x0070,
-            SYS_PCIE_GBE_L = 0x0074,
-            SYS_PCIE_GBE_H = 0x0078,
-            SYS_PROC_ID0 = 0x0084,
-            SYS_PROC_ID1 = 0x0088,
-            SYS_FAN_SPEED = 0x0120)
-
-BETTER_ENUM(AXIRegister, uint32_t,
-            AMS_RNGDATA = 0x000,
-            AMS_RNGCTRL = 0x004,
-            AMS_RNGSEED = 0x008,
-            AMS_RNGCNT = 0x00C)
-
-/**
- * @brief Manages memory mapping and provides read/write access to hardware registers.
- *
- * This class handles opening /dev/mem and mapping the physical base address
- * into the process's virtual memory space.
- */
-class RegisterManager
-{
-private:
-    int m_fd{-1};
-    void *m_map_base{nullptr};
-    const uint64_t m_physical_base;
-    const bool m_logging;
-
-public:
-    /**
-     * @brief Constructor: Initializes the memory map.
-     * @param physical_base The starting physical address to map.
-     * @param logging Whether to log accesses to stdout
-     */
-    RegisterManager(uint64_t const physical_base, bool const logging) : m_physical_base(physical_base), m_logging(logging)
-    {
-        m_fd = open("/dev/mem", O_RDWR | O_SYNC);
-        if (m_fd == -1)
-        {
-            throw std::runtime_error("Error: Could not open /dev/mem. Must run as root or with appropriate permissions.");
-        }
-
-        // 2. Map the physical address range into virtual memory
-        m_map_base = mmap(
-            0,                      // addr: Let the kernel choose the address
-            MAP_SIZE,               // len: The size of the memory region
-            PROT_READ | PROT_WRITE, // prot: Read/Write access
-            MAP_SHARED,             // flags: Share changes with other processes/hardware
-            m_fd,                   // fd: File descriptor for /dev/mem
-            m_physical_base         // offset: The physical address start
-        );
-
-        if (m_map_base == MAP_FAILED)
-        {
-            close(m_fd);
-            throw std::runtime_error("Error: mmap failed to map physical address.");
-        }
-
-        std::cout << "[INFO] Successfully mapped physical address 0x" << std::hex
-                  << m_physical_base << " to virtual address " << m_map_base << std::dec << std::endl;
-    }
-
-    /**
-     * @brief Destructor: Cleans up the memory map and file descriptor.
-     */
-    ~RegisterManager()
-    {
-        if (m_map_base != MAP_FAILED && m_map_base != nullptr)
-        {
-            if (munmap(m_map_base, MAP_SIZE) == -1)
-            {
-                std::cerr << "[ERROR] Failed to unmap memory." << std::endl;
-            }
-            else
-            {
-                std::cout << "[INFO] Memory unmapped successfully." << std::endl;
-            }
-        }
-        if (m_fd != -1)
-        {
-            close(m_fd);
-        }
-    }
-
-    /**
-     * @brief Reads a 32-bit value from a register offset.
-     * @param reg Register enum which encodes it's offset from the base address.
-     * @return The 32-bit value read from the register.
-     */
-    template <typename T>
-    uint32_t readReg(T const &reg) const
-    {
-        if (!m_map_base)
-        {
-            std::cerr << "[ERROR] Cannot read: memory not mapped." << std::endl;
-            return 0;
-        }
-        uint32_t const offset{static_cast<uint32_t>(reg)};
-        volatile uint32_t *reg_ptr{(volatile uint32_t *)((char *)m_map_base + offset)};
-        uint32_t const value{*reg_ptr};
-
-        if (m_logging)
-        {
-            std::cout << "  > Read 0x" << std::hex << std::setw(8) << std::setfill('0') << value
-                      << " from register " << (+reg)._to_string() << " (base 0x" << m_physical_base << " + offset 0x" << offset << std::dec << ")" << std::endl;
-        }
-        return value;
-    }
-
-    /**
-     * @brief Writes a 32-bit value to a register offset.
-     * @param reg Register enum which encodes it's offset from the base address.
-     * @param value The 32-bit value to write.
-     */
-    template <typename T>
-    void writeReg(T const &reg, uint32_t value) const
-    {
-        if (!m_map_base)
-        {
-            std::cerr << "[ERROR] Cannot write: memory not mapped." << std::endl;
-            return;
-        }
-        uint32_t const offset{static_cast<uint32_t>(reg)};
-        volatile uint32_t *reg_ptr{(volatile uint32_t *)((char *)m_map_base + offset)};
-
-        if (m_logging)
-        {
-            std::cout << "  > Writing 0x" << std::hex << std::setw(8) << std::setfill('0') << value
-                      << " to register " << (+reg)._to_string() << " (base 0x" << m_physical_base << " offset 0x" << offset << std::dec << ")" << std::endl;
-        }
-        *reg_ptr = value;
-    }
-};
-
-[[nodiscard]] static std::string get_board_info(uint32_t const sys_id_reg_val)
-{
-    std::stringstream board_info;
-    uint32_t const rev{extract_bits(sys_id_reg_val, 28, 4)};
-    uint32_t const hbi{extract_bits(sys_id_reg_val, 16, 10)};
-    uint32_t const build{extract_bits(sys_id_reg_val, 12, 3)};
-    uint32_t const arch{extract_bits(sys_id_reg_val, 8, 3)};
-    uint32_t const fpga{extract_bits(sys_id_reg_val, 0, 7)};
-
-    std::string board_revision;
-    switch (rev)
-    {
-    case 0x0:
-        board_revision = "Rev A (Prototype Juno r0)";
-        break;
-    case 0x1:
-        board_revision = "Rev B (Juno r0)";
-        break;
-    case 0x2:
-        board_revision = "Rev C (Juno r1)";
-        break;
-    case 0x3:
-        board_revision = "Rev D (Juno r2)";
-        break;
-    default:
-        board_revision = "Unknown";
-        break;
-    }
-
-    board_info << board_revision << " HBI" << std::hex << hbi << ", Board Build Variant: " << build << ", IOFPGA Bus Arch: " << (arch == 0x4 ? "AHB" : "AXI") << ", FPGA Build (BCD): " << fpga;
-
-    return board_info.str();
-}
-
-[[nodiscard]] static std::string get_logictile_info(uint32_t const sys_proc_id_1_val)
-{
-    std::stringstream board_info;
-    uint32_t const app_note{extract_bits(sys_proc_id_1_val, 24, 8)};
-    uint32_t const rev{extract_bits(sys_proc_id_1_val, 20, 4)};
-    uint32_t const var{extract_bits(sys_proc_id_1_val, 16, 4)};
-    uint32_t const hbi{extract_bits(sys_proc_id_1_val, 0, 12)};
-
-    char const board_rev {static_cast<char>(rev + 'A')};
-    char const board_variant {static_cast<char>(var + 'A')};
-
-    board_info << "FPGA Image: " << app_note << ", Board Revision: " << board_rev << ", Board Build Variant: " << board_variant << ", HBI" << std::hex << hbi;
-
-    return board_info.str();
-}
-
-void logictile_led_test_sequence(RegisterManager const &scc_reg_access)
+void logictile_led_test_sequence(ShadowRegisters &scc_shadow)
 {
     // LED Animation Sequences
     std::cout << "\n[LED Animation] Starting light show..." << std::endl;
@@ -232,12 +51,12 @@ void logictile_led_test_sequence(RegisterManager const &scc_reg_access)
     std::cout << "[LED Animation] Knight Rider sweep..." << std::endl;
     for (int i = 0; i < 8; ++i)
     {
-        scc_reg_access.writeReg(SCCRegister::SCC_LED, 1 << i);
+        scc_shadow.write(SCCRegister::SCC_LED, 1 << i);
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
     for (int i = 6; i >= 1; --i)
     {
-        scc_reg_access.writeReg(SCCRegister::SCC_LED, 1 << i);
+        scc_shadow.write(SCCRegister::SCC_LED, 1 << i);
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
 
@@ -245,7 +64,7 @@ void logictile_led_test_sequence(RegisterManager const &scc_reg_access)
     std::cout << "[LED Animation] Binary counter..." << std::endl;
     for (uint32_t i = 0; i < 256; ++i)
     {
-        scc_reg_access.writeReg(SCCRegister::SCC_LED, i);
+        scc_shadow.write(SCCRegister::SCC_LED, i);
         std::this_thread::sleep_for(std::chrono::milliseconds(50));
     }
 
@@ -261,7 +80,7 @@ void logictile_led_test_sequence(RegisterManager const &scc_reg_access)
     {
         for (auto const &pattern : expand_patterns)
         {
-            scc_reg_access.writeReg(SCCRegister::SCC_LED, pattern);
+            scc_shadow.write(SCCRegister::SCC_LED, pattern);
             std::this_thread::sleep_for(std::chrono::milliseconds(150));
         }
     }
@@ -270,9 +89,9 @@ void logictile_led_test_sequence(RegisterManager const &scc_reg_access)
     std::cout << "[LED Animation] Alternating chase..." << std::endl;
     for (int i = 0; i < 8; ++i)
     {
-        scc_reg_access.writeReg(SCCRegister::SCC_LED, 0b10101010);
+        scc_shadow.write(SCCRegister::SCC_LED, 0b10101010);
         std::this_thread::sleep_for(std::chrono::milliseconds(200));
-        scc_reg_access.writeReg(SCCRegister::SCC_LED, 0b01010101);
+        scc_shadow.write(SCCRegister::SCC_LED, 0b01010101);
         std::this_thread::sleep_for(std::chrono::milliseconds(200));
     }
 
@@ -288,7 +107,7 @@ void logictile_led_test_sequence(RegisterManager const &scc_reg_access)
     {
         for (auto const &pattern : collapse_patterns)
         {
-            scc_reg_access.writeReg(SCCRegister::SCC_LED, pattern);
+            scc_shadow.write(SCCRegister::SCC_LED, pattern);
             std::this_thread::sleep_for(std::chrono::milliseconds(150));
         }
     }
@@ -300,7 +119,7 @@ void logictile_led_test_sequence(RegisterManager const &scc_reg_access)
     std::uniform_int_distribution<> distrib(0, 255);
     for (int i = 0; i < 30; ++i)
     {
-        scc_reg_access.writeReg(SCCRegister::SCC_LED, distrib(gen));
+        scc_shadow.write(SCCRegister::SCC_LED, distrib(gen));
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
 
@@ -315,7 +134,7 @@ void logictile_led_test_sequence(RegisterManager const &scc_reg_access)
                 pattern |= (1 << (i - 1));
             if (i > 1)
                 pattern |= (1 << (i - 2));
-            scc_reg_access.writeReg(SCCRegister::SCC_LED, pattern);
+            scc_shadow.write(SCCRegister::SCC_LED, pattern);
             std::this_thread::sleep_for(std::chrono::milliseconds(100));
         }
     }
@@ -324,14 +143,15 @@ void logictile_led_test_sequence(RegisterManager const &scc_reg_access)
     std::cout << "[LED Animation] Grand finale!" << std::endl;
     for (int i = 0; i < 5; ++i)
     {
-        scc_reg_access.writeReg(SCCRegister::SCC_LED, 0b11111111);
+        // SCC_LED is write-owned, so these read-modify-writes never read the bus
+        scc_shadow.modify(SCCRegister::SCC_LED, 0, 0b11111111);
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
-        scc_reg_access.writeReg(SCCRegister::SCC_LED, 0b00000000);
+        scc_shadow.modify(SCCRegister::SCC_LED, 0b11111111, 0);
         std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
 
     // All off
-    scc_reg_access.writeReg(SCCRegister::SCC_LED, 0b00000000);
+    scc_shadow.write(SCCRegister::SCC_LED, 0b00000000);
     std::cout << "[LED Animation] Show complete!" << std::endl;
 }
 
@@ -339,11 +159,33 @@ void axi_slave_rng_test_sequence(RegisterManager const &axi_reg_access)
 {
     std::cout << "AXI Slave RNG Peripheral Test:" << std::endl;
     uint32_t const rnd_count_expected{10};
+    std::array<uint32_t, rnd_count_expected> samples{};
     for (uint32_t rnd_count{0}; rnd_count < rnd_count_expected; ++rnd_count)
     {
-        uint32_t const rnd{axi_reg_access.readReg(AXIRegister::AMS_RNGDATA)};
-        std::cout << "RNGDATA Read " << rnd_count << ": " << std::hex << rnd << std::endl;
+        samples[rnd_count] = axi_reg_access.readReg(AXIRegister::AMS_RNGDATA);
+        std::cout << "RNGDATA Read " << rnd_count << ": " << std::hex << samples[rnd_count] << std::endl;
+    }
+
+    // The LFSR free-runs on ACLK, so successive reads are a short hop apart in its sequence
+    uint64_t clocks{0};
+    size_t const on_sequence{LfsrModel::score(samples.data(), samples.size(), uint64_t{1} << 22, clocks)};
+    std::cout << "RNGDATA " << std::dec << on_sequence << "/" << samples.size() - 1 << " Reads Follow The LFSR Model";
+    if (on_sequence != 0)
+    {
+        std::cout << " (avg " << clocks / on_sequence << " ACLK Between Reads)";
+    }
+    std::cout << std::endl;
+    // The LFSR never reaches zero, so a zero read is a dead slave or bus and is never on-sequence
+    size_t const zero_reads{static_cast<size_t>(std::count(samples.begin(), samples.end(), 0u))};
+    if (zero_reads != 0)
+    {
+        std::cerr << "RNGDATA Read Zero " << zero_reads << " Times; The LFSR Never Outputs Zero" << std::endl;
     }
+    if (on_sequence != samples.size() - 1 || zero_reads != 0)
+    {
+        std::cerr << "RNG Sequence Test failed" << std::endl;
+    }
+
     uint32_t const rng_readcnt{axi_reg_access.readReg(AXIRegister::AMS_RNGCNT)};
     std::cout << "RNGCNT Indicates RNGDATA Read " << std::dec << rng_readcnt << " Times" << std::endl;
     if (rng_readcnt != rnd_count_expected)
@@ -363,6 +205,403 @@ void axi_slave_rng_test_sequence(RegisterManager const &axi_reg_access)
     }
 }
 
+void axi_dma_ring_test_sequence(RegisterManager const &axi_reg_access, uint64_t const ring_physical_base, size_t const ring_bytes)
+{
+    std::cout << "AXI RNG DMA Ring Test:" << std::endl;
+    DmaRingConsumer consumer(axi_reg_access, ring_physical_base, ring_bytes);
+
+    // Stream ten ring's worth of data, or give up after five seconds
+    uint64_t const target_words{10 * (ring_bytes / sizeof(uint32_t))};
+    uint64_t total_words{0};
+    uint64_t zero_words{0};
+    uint32_t checksum{0};
+
+    auto const start_time{std::chrono::steady_clock::now()};
+    auto const deadline{start_time + std::chrono::seconds(5)};
+    consumer.start();
+    while (total_words < target_words && std::chrono::steady_clock::now() < deadline)
+    {
+        total_words += consumer.consume([&](uint32_t const *words, size_t count)
+        {
+            for (size_t i{0}; i < count; ++i)
+            {
+                checksum ^= words[i];
+                zero_words += (words[i] == 0);
+            }
+        });
+        if (consumer.error())
+        {
+            std::cerr << "RNG DMA Test failed: engine reported a write error" << std::endl;
+            return;
+        }
+    }
+    double const seconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - start_time).count()};
+
+    std::cout << "Consumed " << total_words << " words in " << seconds << " s ("
+              << (total_words * sizeof(uint32_t)) / seconds / 1e6 << " MB/s), checksum 0x"
+              << std::hex << checksum << std::dec << std::endl;
+    if (total_words < target_words || zero_words != 0)
+    {
+        std::cerr << "RNG DMA Test failed (" << zero_words << " zero words)" << std::endl;
+    }
+    else
+    {
+        std::cout << "RNG DMA Test succeeded" << std::endl;
+    }
+}
+
+void axi_slave_perf_sample_sequence(RegisterManager const &axi_reg_access, unsigned const interval_ms, unsigned const samples,
+                                    TelemetryWriter *telemetry)
+{
+    std::cout << "AXI Slave Performance Counters (" << interval_ms << " ms interval):" << std::endl;
+
+    // Start every interval from zero so the 32-bit counters never wrap between samples
+    axi_reg_access.writeReg(AXIRegister::AMS_PERFCTRL, PERFCTRL_CLEAR);
+    auto last_sample{std::chrono::steady_clock::now()};
+    for (unsigned sample{0}; sample < samples; ++sample)
+    {
+        std::this_thread::sleep_until(last_sample + std::chrono::milliseconds(interval_ms));
+        axi_reg_access.writeReg(AXIRegister::AMS_PERFCTRL, PERFCTRL_SNAPSHOT | PERFCTRL_CLEAR);
+        auto const now{std::chrono::steady_clock::now()};
+        double const seconds{std::chrono::duration<double>(now - last_sample).count()};
+        last_sample = now;
+
+        // Includes the nine accesses of this readout, attributed to the next interval
+        uint32_t const cycles{axi_reg_access.readReg(AXIRegister::AMS_PERFCYCLES)};
+        uint32_t const idle{axi_reg_access.readReg(AXIRegister::AMS_PERFIDLE)};
+        uint32_t const rbeats{axi_reg_access.readReg(AXIRegister::AMS_PERFRBEATS)};
+        uint32_t const wbeats{axi_reg_access.readReg(AXIRegister::AMS_PERFWBEATS)};
+        uint32_t const rstall{axi_reg_access.readReg(AXIRegister::AMS_PERFRSTALL)};
+        uint32_t const bstall{axi_reg_access.readReg(AXIRegister::AMS_PERFBSTALL)};
+        uint32_t const slverr{axi_reg_access.readReg(AXIRegister::AMS_PERFSLVERR)};
+        uint32_t const maxout{axi_reg_access.readReg(AXIRegister::AMS_PERFMAXOUT)};
+        if (telemetry)
+        {
+            uint32_t const row[]{cycles, idle, rbeats, wbeats, rstall, bstall, slverr, maxout};
+            telemetry->append(static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(now.time_since_epoch()).count()), row);
+        }
+
+        double const busy_pct{cycles ? 100.0 * (cycles - idle) / cycles : 0.0};
+        double const rstall_pct{cycles ? 100.0 * rstall / cycles : 0.0};
+        double const bstall_pct{cycles ? 100.0 * bstall / cycles : 0.0};
+        double const mbytes_per_s{(uint64_t{rbeats} + wbeats) * sizeof(uint32_t) / seconds / 1e6};
+
+        std::cout << std::fixed << std::setprecision(2)
+                  << "[PERF] ACLK " << cycles / seconds / 1e6 << " MHz, busy " << busy_pct
+                  << "%, R stall " << rstall_pct << "%, B stall " << bstall_pct << "%, "
+                  << rbeats << " R / " << wbeats << " W beats, " << mbytes_per_s << " MB/s, "
+                  << slverr << " SLVERR, max outstanding " << maxout
+                  << std::defaultfloat << std::endl;
+    }
+}
+
+void board_clock_sequence(RegisterManager const &apb_reg_access, unsigned const seconds, std::vector<unsigned> const &cpus)
+{
+    std::cout << "Correlating SYS_24MHZ with the host clock for " << seconds << " s:" << std::endl;
+    BoardClock clock(apb_reg_access);
+    clock.start(std::chrono::milliseconds(100), cpus);
+    for (unsigned second{0}; second < seconds; ++second)
+    {
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        BoardClock::Fit const fit{clock.fit()};
+        std::cout << std::fixed << std::setprecision(2) << "[CLOCK] " << fit.points << " points, drift " << fit.drift_ppm
+                  << " ppm, residual " << fit.residual_ns << " ns, read " << fit.read_ns << " ns, " << fit.wraps << " wraps"
+                  << std::defaultfloat << std::endl;
+    }
+    clock.stop();
+
+    // Check predictions against fresh reads, and what a prediction costs compared to one
+    constexpr unsigned CHECKS{1000};
+    double worst_error_ns{0};
+    for (unsigned check{0}; check < CHECKS; ++check)
+    {
+        uint64_t const before{clock.now_board_ticks()};
+        uint32_t const raw{apb_reg_access.readReg(APBRegister::SYS_24MHZ)};
+        uint64_t const after{clock.now_board_ticks()};
+        // The read happened between the two predictions; count only distance outside that bracket
+        int32_t const below{static_cast<int32_t>(static_cast<uint32_t>(before) - raw)};
+        int32_t const above{static_cast<int32_t>(raw - static_cast<uint32_t>(after))};
+        worst_error_ns = std::max(worst_error_ns, BoardClock::ticks_to_ns(std::max({below, above, 0})));
+    }
+
+    auto const time_per_call{[](auto &&function)
+    {
+        constexpr unsigned CALLS{100000};
+        uint64_t volatile sink{0};
+        auto const start{std::chrono::steady_clock::now()};
+        for (unsigned call{0}; call < CALLS; ++call)
+        {
+            sink = sink + function();
+        }
+        return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / CALLS;
+    }};
+    double const predict_ns{time_per_call([&] { return clock.now_board_ticks(); })};
+    double const read_ns{time_per_call([&] { return apb_reg_access.readReg(APBRegister::SYS_24MHZ); })};
+    std::cout << std::fixed << std::setprecision(1) << "[CLOCK] Worst prediction error " << worst_error_ns << " ns over " << CHECKS
+              << " reads; now_board_ticks() " << predict_ns << " ns vs SYS_24MHZ read " << read_ns << " ns" << std::defaultfloat
+              << std::endl;
+}
+
+void write_batch_sequence(RegisterManager const &scc_reg_access, RegisterManager const &axi_reg_access, unsigned const rounds)
+{
+    // 16 stores per batch, as an LED animation frame or a control register sequence would issue them
+    constexpr size_t BATCH{16};
+    struct Target
+    {
+        char const *name;
+        RegisterManager const &manager;
+        uint32_t offset;
+    };
+    for (Target const &target : {Target{"SCC_LED", scc_reg_access, SCCRegister::SCC_LED},
+                                 Target{"AMS_RNGCTRL", axi_reg_access, AXIRegister::AMS_RNGCTRL}})
+    {
+        RegisterManager const &manager{target.manager};
+        uint32_t const saved{manager.readOffset(target.offset)};
+        std::array<RegisterWrite, BATCH> writes{};
+        for (size_t i{0}; i < BATCH; ++i)
+        {
+            writes[i] = RegisterWrite{target.offset, static_cast<uint32_t>(1u << (i % 8))};
+        }
+
+        auto const ns_per_write{[&](auto &&issue_batch)
+        {
+            auto const start{std::chrono::steady_clock::now()};
+            for (unsigned round{0}; round < rounds; ++round)
+            {
+                issue_batch();
+            }
+            return std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count() / (rounds * BATCH);
+        }};
+        double const posted_ns{ns_per_write([&]
+        {
+            for (RegisterWrite const &write : writes)
+            {
+                manager.writeOffset(write.offset, write.value);
+            }
+        })};
+        double const confirmed_ns{ns_per_write([&]
+        {
+            for (RegisterWrite const &write : writes)
+            {
+                manager.writeOffset(write.offset, write.value);
+                io_write_barrier();
+                manager.readOffset(write.offset);
+            }
+        })};
+        double const batch_ns{ns_per_write([&] { manager.writeBatch(writes, WriteBatchCheck{target.offset, false}); })};
+        size_t mismatches{0};
+        double const verify_ns{ns_per_write([&] { mismatches += manager.writeBatch(writes, WriteBatchCheck{std::nullopt, true}).mismatches; })};
+        manager.writeOffset(target.offset, saved);
+
+        std::cout << std::fixed << std::setprecision(1) << "[BATCH] " << target.name << ": " << posted_ns << " ns/write posted, "
+                  << confirmed_ns << " ns/write with a barrier and read-back each, " << batch_ns << " ns/write batched with one read-back ("
+                  << confirmed_ns / batch_ns << "x), " << verify_ns << " ns/write batched and verified, " << mismatches << " mismatches"
+                  << std::defaultfloat << std::endl;
+    }
+}
+
+void physical_scan_sequence(PhysicalWindows &windows, uint64_t const base, uint64_t const bytes, uint64_t const stride)
+{
+    std::cout << "[WINDOW] Reading every " << stride << " bytes of 0x" << std::hex << base << "-0x" << base + bytes << std::dec << std::endl;
+    for (unsigned pass{1}; pass <= 2; ++pass)
+    {
+        PhysicalWindows::Counters const before{windows.counters()};
+        uint32_t checksum{0};
+        uint64_t reads{0};
+        auto const start{std::chrono::steady_clock::now()};
+        for (uint64_t offset{0}; offset < bytes; offset += stride)
+        {
+            checksum ^= windows.read<uint32_t>(base + offset);
+            ++reads;
+        }
+        double const ns{std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - start).count()};
+        PhysicalWindows::Counters const after{windows.counters()};
+        std::cout << std::fixed << std::setprecision(1) << "[WINDOW] Pass " << pass << ": " << reads << " reads, " << ns / reads
+                  << " ns/read, " << after.maps - before.maps << " maps, " << after.unmaps - before.unmaps << " unmaps, checksum 0x"
+                  << std::hex << checksum << std::dec << std::defaultfloat << std::endl;
+    }
+    windows.print_counters(std::cout);
+}
+
+void axi_bandwidth_sequence(uint64_t const base, size_t const bytes, unsigned const threads, bool const simulated)
+{
+    // One window covering the whole region, so the sweeps see a single contiguous mapping
+    size_t window_bytes{PhysicalWindows::DEFAULT_WINDOW_BYTES};
+    while (window_bytes < bytes)
+    {
+        window_bytes <<= 1;
+    }
+    if (base % window_bytes != 0)
+    {
+        throw std::runtime_error("Error: bandwidth region base must be aligned to " + std::to_string(window_bytes) + " bytes.");
+    }
+    PhysicalWindows windows(window_bytes, window_bytes, false, simulated);
+    AxiBandwidth const bandwidth(windows.span(base, bytes), bytes);
+
+    std::vector<unsigned> thread_counts{1};
+    if (threads > 1)
+    {
+        thread_counts.push_back(threads);
+    }
+    std::cout << "[BW] Sweeping " << bytes / 1024 << " KiB at 0x" << std::hex << base << std::dec << (simulated ? " (simulated)" : "")
+              << std::endl;
+    AxiBandwidth::print_report(bandwidth.run(thread_counts), std::cout);
+}
+
+void print_telemetry_csv(std::string const &path, DumpFormat const format)
+{
+    TelemetryReader const reader(path);
+    DumpBuffer out(STDOUT_FILENO);
+    out.append("timestamp_ns", 12);
+    for (uint32_t column{0}; column < reader.columns(); ++column)
+    {
+        std::string const &name{reader.column_name(column)};
+        out.append(',').append(name.data(), name.size());
+    }
+    out.append('\n');
+
+    std::vector<uint64_t> timestamps;
+    std::vector<uint32_t> values;
+    std::vector<uint32_t> scratch;
+    for (size_t block{0}; block < reader.blocks(); ++block)
+    {
+        size_t const count{reader.block(block).sample_count};
+        timestamps.resize(count);
+        values.resize(count * reader.columns());
+        reader.decode_block(block, timestamps.data(), values.data(), scratch);
+        for (size_t row{0}; row < count; ++row)
+        {
+            out.value(timestamps[row], DumpFormat::Decimal);
+            for (uint32_t column{0}; column < reader.columns(); ++column)
+            {
+                out.append(',').value(values[column * count + row], format);
+            }
+            out.append('\n');
+        }
+    }
+    out.flush();
+}
+
+void run_register_sampler(std::vector<SampleSpec> const &specs, RegisterRegions const &regions, double const seconds, int const cpu)
+{
+    std::cout << "[SAMPLE] Sampling " << specs.size() << " registers for " << seconds << " s"
+              << (cpu >= 0 ? " on CPU " + std::to_string(cpu) : std::string{}) << std::endl;
+    RegisterSampler const sampler(specs, regions);
+    RegisterSampler::Report const report{sampler.run(static_cast<uint64_t>(seconds * 1e9), cpu, [](uint32_t, uint64_t, uint32_t) {})};
+    sampler.print_report(report, std::cout);
+}
+
+bool run_register_script(RegisterScript const &script, RegisterRegions const &regions, bool const timing)
+{
+    std::vector<RegisterScript::OpStats> stats;
+    RegisterScript::Result const result{script.run(regions, timing ? &stats : nullptr)};
+
+    double const seconds{std::chrono::duration<double>(result.elapsed).count()};
+    std::cout << "[SCRIPT] " << result.ops_executed << " ops in " << std::fixed << std::setprecision(3) << seconds * 1e3
+              << " ms (" << (seconds > 0 ? result.ops_executed / seconds / 1e6 : 0.0) << " Mops/s)" << std::defaultfloat << std::endl;
+    if (timing)
+    {
+        script.print_report(stats, std::cout);
+    }
+    if (!result.completed)
+    {
+        std::cerr << "[SCRIPT] Poll at line " << script.line(result.failed_op) << " timed out, last read 0x" << std::hex
+                  << result.failed_value << std::dec << std::endl;
+    }
+    return result.completed;
+}
+
+bool run_remote_register_ops(std::vector<RegisterOp> const &ops, std::vector<RemoteEndpoint> const &endpoints)
+{
+    RemoteClient client(endpoints);
+    std::vector<std::ostringstream> output(client.boards());
+    bool completed{true};
+    for (size_t board{0}; board < client.boards(); ++board)
+    {
+        client.submit(board, ops, [&](RemoteReply const &reply)
+        {
+            std::ostringstream &text{output[reply.board]};
+            std::string const prefix{"[" + client.endpoint(reply.board).name() + "] "};
+            for (size_t i{0}; i < reply.count; ++i)
+            {
+                RegisterOp const &op{ops[i]};
+                if (op.kind == RegisterOp::Kind::Write)
+                {
+                    continue;
+                }
+                if (reply.status == RemoteStatus::PollTimeout && i + 1 == reply.count)
+                {
+                    text << prefix << "Error: poll of " << op << " timed out, last read 0x" << std::hex << reply.values[i] << std::dec
+                         << '\n';
+                    break;
+                }
+                text << prefix << op << " = 0x" << std::hex << std::setw(8) << std::setfill('0') << reply.values[i] << std::dec;
+                if (op.region == RegisterRegion::APB && op.kind == RegisterOp::Kind::Read)
+                {
+                    char decoded[APB_DECODE_BYTES];
+                    char const *const end{format_apb_register(op.offset, reply.values[i], decoded, decoded + sizeof(decoded))};
+                    if (end && end != decoded)
+                    {
+                        text << "  ";
+                        text.write(decoded, end - decoded);
+                    }
+                }
+                text << '\n';
+            }
+            if (reply.status == RemoteStatus::BadRequest)
+            {
+                text << prefix << "Error: the server rejected the request.\n";
+            }
+            completed = completed && reply.status == RemoteStatus::Ok;
+        });
+    }
+
+    // Every board runs its batch at once, so the slowest poll bounds the wait
+    auto const timeout{std::chrono::duration_cast<std::chrono::milliseconds>(POLL_TIMEOUT) * static_cast<int>(ops.size() + 1)};
+    if (!client.wait(timeout))
+    {
+        std::cerr << "Error: timed out waiting for " << client.outstanding() << " boards to reply." << std::endl;
+        return false;
+    }
+    for (auto const &text : output)
+    {
+        std::cout << text.str();
+    }
+    std::cout << std::flush;
+    return completed;
+}
+
+void run_register_server(RegisterRegions const &regions, uint16_t const port, std::string const &bind_address, bool const read_only)
+{
+    RegisterServer server(regions, port, bind_address, read_only);
+    server.stopOnSignals();
+    std::cout << "[REMOTE] Serving registers on " << server.bind_address() << ":" << server.port() << (read_only ? " read-only" : "")
+              << " (Ctrl-C to stop)" << std::endl;
+    server.run();
+    server.print_counters(std::cout);
+}
+
+void random_output_sequence(RegisterManager const &axi_reg_access, uint64_t const bytes, std::vector<unsigned> const &harvester_cpus)
+{
+    // stdout carries the random bytes, so the report goes to stderr
+    CsprngService::Policy policy;
+    policy.harvester_cpus = harvester_cpus;
+    CsprngService service(&axi_reg_access, policy);
+    std::vector<char> chunk(1 << 20);
+    auto const start{std::chrono::steady_clock::now()};
+    for (uint64_t left{bytes}; left != 0;)
+    {
+        size_t const count{static_cast<size_t>(std::min<uint64_t>(left, chunk.size()))};
+        service.fill(chunk.data(), count);
+        write_all(STDOUT_FILENO, chunk.data(), count);
+        left -= count;
+    }
+    double const seconds{std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count()};
+    std::cerr << "[CSPRNG] " << bytes << " bytes in " << std::fixed << std::setprecision(3) << seconds << " s ("
+              << (seconds > 0 ? static_cast<double>(bytes) / seconds / 1e6 : 0.0) << " MB/s)" << std::defaultfloat << std::endl;
+    service.print_counters(std::cerr);
+}
+
 void print_usage(char const *program_name)
 {
     std::cout << "Usage: " << program_name << " [OPTIONS]\n"
@@ -370,7 +609,52 @@ void print_usage(char const *program_name)
               << "  -v         Enable verbose logging of register accesses\n"
               << "  -l         Run LED test sequence\n"
               << "  -r         Run RNG test sequence\n"
+              << "  -d ADDR[:BYTES]\n"
+              << "             Run RNG DMA ring test into physical ADDR (default 1MB ring)\n"
+              << "  -p MS[:N]  Sample AXI slave performance counters every MS milliseconds, N times (default 10)\n"
+              << "  -m FILE    With -p, also store the samples in a compressed telemetry file\n"
+              << "  -M FILE    Print a telemetry file as CSV\n"
+              << "  -F FORMAT  With -M, print register values as dec, hex or bin (default dec)\n"
+              << "  -B ROUNDS  Time ROUNDS batches of 16 writes to SCC_LED and AMS_RNGCTRL, per write and batched\n"
+              << "  -A ADDR:BYTES[:STRIDE]\n"
+              << "             Read a word every STRIDE bytes (default 4096) of a physical range through mapped windows\n"
+              << "  --huge-windows\n"
+              << "             With -A, map 2 MiB windows at 2 MiB-aligned addresses instead of 64 KiB ones\n"
+              << "  -b ADDR[:BYTES]\n"
+              << "             Measure read/write bandwidth over BYTES (default 1MB) at physical ADDR, for each pattern and width\n"
+              << "  -j THREADS With -b, also run every sweep with THREADS threads (default: one per CPU)\n"
+              << "  -K SECONDS Correlate SYS_24MHZ with the host clock and report drift and prediction error\n"
+              << "  -S REGION:REG@HZ\n"
+              << "             Sample a register at HZ (repeatable; registers run at independent rates)\n"
+              << "  -D SECONDS With -S, how long to sample (default 1)\n"
+              << "  -c CPU     With -S, pin the sampling thread to CPU; with --rt, pin the process to CPU\n"
+              << "  -P         Measure per-core register read latency and place threads by it: -S samples and --random\n"
+              << "             harvests on the fastest CPU, -K refreshes the clock on the others (LITTLE cores on big.LITTLE)\n"
+              << "  --rt       Lock memory, run SCHED_FIFO on the fastest core and report wake-up jitter before starting\n"
+              << "  --serve PORT\n"
+              << "             Serve register batches and subscriptions to remote clients on TCP PORT (until Ctrl-C)\n"
+              << "  --serve-bind ADDR\n"
+              << "             With --serve, listen on IPv4 ADDR (default 127.0.0.1; 0.0.0.0 for every interface)\n"
+              << "  --serve-read-only\n"
+              << "             With --serve, reject any batch that writes a register\n"
+              << "  --remote HOST[:PORT][,HOST[:PORT]...]\n"
+              << "             Run the operations below on every listed board at once, through their --serve servers\n"
+              << "  --random BYTES\n"
+              << "             Write BYTES of CSPRNG output, seeded from AMS_RNGDATA and the OS, to stdout\n"
+              << "  -s         Simulate the register regions in memory (no board or root needed)\n"
+              << "  -x SCRIPT  Run a register script (source or compiled)\n"
+              << "  -C OUT     With -x, save the compiled script to OUT instead of running it\n"
+              << "  -t         With -x, report per-op timing\n"
+              << "  -w TRACE   Record every register access of this run to TRACE\n"
+              << "  -R TRACE   Replay a recorded trace and compare the values read\n"
+              << "  -g SCALE   With -R, multiply recorded timing by SCALE (default 1, 0 = back-to-back)\n"
               << "  -h         Display this help message\n"
+              << "Operations (run in order, after the options):\n"
+              << "  read REGION:REG                 Print a register\n"
+              << "  write REGION:REG=VALUE          Write a register\n"
+              << "  poll REGION:REG[&MASK]==VALUE   Wait up to 1s for a register to match (or !=VALUE)\n"
+              << "  REGION is SCC, APB or AXI; REG is a register name or byte offset, e.g.\n"
+              << "  " << program_name << " read APB:SYS_ID write SCC:SCC_LED=0xff poll AXI:AMS_RNGCNT!=0\n"
               << std::endl;
 }
 
@@ -379,10 +663,62 @@ int main(int argc, char *argv[])
     bool verbose{false};
     bool run_led_test{false};
     bool run_rng_test{false};
+    bool run_dma_test{false};
+    uint64_t dma_ring_base{0};
+    size_t dma_ring_bytes{1 << 20};
+    bool run_perf_sample{false};
+    unsigned perf_interval_ms{1000};
+    unsigned perf_samples{10};
+    bool simulated{false};
+    std::string script_path;
+    std::string compiled_path;
+    bool script_timing{false};
+    std::string trace_path;
+    std::string replay_path;
+    double replay_scale{1.0};
+    std::string telemetry_path;
+    std::string telemetry_dump_path;
+    DumpFormat telemetry_dump_format{DumpFormat::Decimal};
+    std::vector<SampleSpec> sample_specs;
+    double sample_seconds{1.0};
+    int sample_cpu{-1};
+    unsigned clock_seconds{0};
+    unsigned batch_rounds{0};
+    uint64_t scan_base{0};
+    uint64_t scan_bytes{0};
+    uint64_t scan_stride{4096};
+    bool huge_windows{false};
+    bool run_bandwidth{false};
+    uint64_t bandwidth_base{0};
+    size_t bandwidth_bytes{1 << 20};
+    unsigned bandwidth_threads{std::max(1u, std::thread::hardware_concurrency())};
+    bool realtime{false};
+    bool place_threads{false};
+    bool serve{false};
+    uint16_t serve_port{REMOTE_DEFAULT_PORT};
+    std::string serve_bind{REMOTE_DEFAULT_BIND};
+    bool serve_read_only{false};
+    std::vector<RemoteEndpoint> remote_endpoints;
+    uint64_t random_bytes{0};
     int opt;
 
     // Parse command-line arguments
-    while ((opt = getopt(argc, argv, "vlrh")) != -1)
+    constexpr int OPTION_RT{256};
+    constexpr int OPTION_HUGE_WINDOWS{257};
+    constexpr int OPTION_SERVE{258};
+    constexpr int OPTION_REMOTE{259};
+    constexpr int OPTION_RANDOM{260};
+    constexpr int OPTION_SERVE_BIND{261};
+    constexpr int OPTION_SERVE_READ_ONLY{262};
+    option const long_options[]{{"rt", no_argument, nullptr, OPTION_RT},
+                                {"huge-windows", no_argument, nullptr, OPTION_HUGE_WINDOWS},
+                                {"serve", required_argument, nullptr, OPTION_SERVE},
+                                {"remote", required_argument, nullptr, OPTION_REMOTE},
+                                {"random", required_argument, nullptr, OPTION_RANDOM},
+                                {"serve-bind", required_argument, nullptr, OPTION_SERVE_BIND},
+                                {"serve-read-only", no_argument, nullptr, OPTION_SERVE_READ_ONLY},
+                                {nullptr, 0, nullptr, 0}};
+    while ((opt = getopt_long(argc, argv, "vlrd:p:m:M:F:B:A:b:j:K:S:D:c:Psx:C:tw:R:g:h", long_options, nullptr)) != -1)
     {
         switch (opt)
         {
@@ -395,6 +731,243 @@ int main(int argc, char *argv[])
         case 'r':
             run_rng_test = true;
             break;
+        case 'd':
+        {
+            char *end{nullptr};
+            dma_ring_base = std::strtoull(optarg, &end, 0);
+            if (*end == ':')
+            {
+                dma_ring_bytes = std::strtoull(end + 1, &end, 0);
+            }
+            if (*end != '\0')
+            {
+                print_usage(argv[0]);
+                return 1;
+            }
+            run_dma_test = true;
+            break;
+        }
+        case 'p':
+        {
+            char *end{nullptr};
+            perf_interval_ms = static_cast<unsigned>(std::strtoul(optarg, &end, 0));
+            if (*end == ':')
+            {
+                perf_samples = static_cast<unsigned>(std::strtoul(end + 1, &end, 0));
+            }
+            if (*end != '\0' || perf_interval_ms == 0)
+            {
+                print_usage(argv[0]);
+                return 1;
+            }
+            run_perf_sample = true;
+            break;
+        }
+        case 'm':
+            telemetry_path = optarg;
+            break;
+        case 'M':
+            telemetry_dump_path = optarg;
+            break;
+        case 'F':
+            if (std::strcmp(optarg, "dec") == 0)
+            {
+                telemetry_dump_format = DumpFormat::Decimal;
+            }
+            else if (std::strcmp(optarg, "hex") == 0)
+            {
+                telemetry_dump_format = DumpFormat::Hex;
+            }
+            else if (std::strcmp(optarg, "bin") == 0)
+            {
+                telemetry_dump_format = DumpFormat::Binary;
+            }
+            else
+            {
+                print_usage(argv[0]);
+                return 1;
+            }
+            break;
+        case 'B':
+        {
+            char *end{nullptr};
+            batch_rounds = static_cast<unsigned>(std::strtoul(optarg, &end, 0));
+            if (*end != '\0' || batch_rounds == 0)
+            {
+                print_usage(argv[0]);
+                return 1;
+            }
+            break;
+        }
+        case 'A':
+        {
+            char *end{nullptr};
+            scan_base = std::strtoull(optarg, &end, 0);
+            if (*end == ':')
+            {
+                scan_bytes = std::strtoull(end + 1, &end, 0);
+            }
+            if (*end == ':')
+            {
+                scan_stride = std::strtoull(end + 1, &end, 0);
+            }
+            if (*end != '\0' || scan_bytes == 0 || scan_stride == 0 || scan_base % 4 != 0 || scan_stride % 4 != 0)
+            {
+                print_usage(argv[0]);
+                return 1;
+            }
+            break;
+        }
+        case 'b':
+        {
+            char *end{nullptr};
+            bandwidth_base = std::strtoull(optarg, &end, 0);
+            if (*end == ':')
+            {
+                bandwidth_bytes = std::strtoull(end + 1, &end, 0);
+            }
+            if (*end != '\0' || bandwidth_bytes == 0)
+            {
+                print_usage(argv[0]);
+                return 1;
+            }
+            run_bandwidth = true;
+            break;
+        }
+        case 'j':
+        {
+            char *end{nullptr};
+            bandwidth_threads = static_cast<unsigned>(std::strtoul(optarg, &end, 0));
+            if (*end != '\0' || bandwidth_threads == 0)
+            {
+                print_usage(argv[0]);
+                return 1;
+            }
+            break;
+        }
+        case 'K':
+        {
+            char *end{nullptr};
+            clock_seconds = static_cast<unsigned>(std::strtoul(optarg, &end, 0));
+            if (*end != '\0' || clock_seconds == 0)
+            {
+                print_usage(argv[0]);
+                return 1;
+            }
+            break;
+        }
+        case 'S':
+            try
+            {
+                sample_specs.push_back(parse_sample_spec(optarg));
+            }
+            catch (const std::runtime_error &e)
+            {
+                std::cerr << e.what() << std::endl;
+                return 1;
+            }
+            break;
+        case 'D':
+        {
+            char *end{nullptr};
+            sample_seconds = std::strtod(optarg, &end);
+            if (*end != '\0' || !(sample_seconds > 0))
+            {
+                print_usage(argv[0]);
+                return 1;
+            }
+            break;
+        }
+        case 'c':
+        {
+            char *end{nullptr};
+            sample_cpu = static_cast<int>(std::strtol(optarg, &end, 0));
+            if (*end != '\0' || sample_cpu < 0)
+            {
+                print_usage(argv[0]);
+                return 1;
+            }
+            break;
+        }
+        case 'P':
+            place_threads = true;
+            break;
+        case 's':
+            simulated = true;
+            break;
+        case 'x':
+            script_path = optarg;
+            break;
+        case 'C':
+            compiled_path = optarg;
+            break;
+        case 't':
+            script_timing = true;
+            break;
+        case 'w':
+            trace_path = optarg;
+            break;
+        case 'R':
+            replay_path = optarg;
+            break;
+        case 'g':
+        {
+            char *end{nullptr};
+            replay_scale = std::strtod(optarg, &end);
+            if (*end != '\0' || replay_scale < 0)
+            {
+                print_usage(argv[0]);
+                return 1;
+            }
+            break;
+        }
+        case OPTION_RT:
+            realtime = true;
+            break;
+        case OPTION_HUGE_WINDOWS:
+            huge_windows = true;
+            break;
+        case OPTION_SERVE:
+        {
+            char *end{nullptr};
+            unsigned long const port{std::strtoul(optarg, &end, 0)};
+            if (*end != '\0' || port > UINT16_MAX)
+            {
+                print_usage(argv[0]);
+                return 1;
+            }
+            serve_port = static_cast<uint16_t>(port);
+            serve = true;
+            break;
+        }
+        case OPTION_REMOTE:
+            try
+            {
+                remote_endpoints = RemoteEndpoint::parse_list(optarg);
+            }
+            catch (const std::runtime_error &e)
+            {
+                std::cerr << e.what() << std::endl;
+                return 1;
+            }
+            break;
+        case OPTION_SERVE_BIND:
+            serve_bind = optarg;
+            break;
+        case OPTION_SERVE_READ_ONLY:
+            serve_read_only = true;
+            break;
+        case OPTION_RANDOM:
+        {
+            char *end{nullptr};
+            random_bytes = std::strtoull(optarg, &end, 0);
+            if (*end != '\0' || random_bytes == 0)
+            {
+                print_usage(argv[0]);
+                return 1;
+            }
+            break;
+        }
         case 'h':
             print_usage(argv[0]);
             return 0;
@@ -404,22 +977,195 @@ int main(int argc, char *argv[])
         }
     }
 
+    if (!telemetry_dump_path.empty())
+    {
+        try
+        {
+            print_telemetry_csv(telemetry_dump_path, telemetry_dump_format);
+            return 0;
+        }
+        catch (const std::runtime_error &e)
+        {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+    }
+
+    // Remaining arguments are peek/poke operations, parsed before any mapping is opened
+    std::vector<RegisterOp> register_ops;
+    try
+    {
+        register_ops = parse_register_ops(argc - optind, argv + optind);
+    }
+    catch (const std::runtime_error &e)
+    {
+        std::cerr << e.what() << std::endl;
+        print_usage(argv[0]);
+        return 1;
+    }
+
+    // Remote operations need no local mappings, so they run before any are opened
+    if (!remote_endpoints.empty())
+    {
+        try
+        {
+            return run_remote_register_ops(register_ops, remote_endpoints) ? 0 : 1;
+        }
+        catch (const std::runtime_error &e)
+        {
+            std::cerr << e.what() << std::endl;
+            return 1;
+        }
+    }
+
     try
     {
-        RegisterManager scc_reg_access(SCC_BASE_ADDR, verbose);
-        RegisterManager apb_reg_access(APB_BASE_ADDR, verbose);
-        RegisterManager axi_reg_access(AXI_BASE_ADDR, verbose);
+        // Compile before mapping anything, so script errors never touch the board
+        std::optional<RegisterScript> script;
+        if (!script_path.empty())
+        {
+            script = RegisterScript::load(script_path);
+            if (!compiled_path.empty())
+            {
+                script->save(compiled_path);
+                std::cout << "Compiled " << script->size() << " ops from " << script_path << " to " << compiled_path << std::endl;
+                return 0;
+            }
+        }
+
+        // --random owns stdout, so the mapping messages are left out and setup reports go to stderr
+        bool const announce{random_bytes == 0};
+        std::ostream &report{announce ? std::cout : std::cerr};
+
+        // Enter real-time mode before mapping, so the mappings are locked too
+        std::optional<RealtimeSession> realtime_session;
+        if (realtime)
+        {
+            realtime_session.emplace(sample_cpu, RealtimeSession::DEFAULT_PRIORITY, report);
+            RealtimeSession::calibrate(2000, 500, 100, report);
+        }
+
+        std::optional<TraceReader> replay;
+        if (!replay_path.empty())
+        {
+            replay.emplace(replay_path);
+        }
 
-        std::cout << "ARM Juno Platform Information:" << get_board_info(apb_reg_access.readReg(APBRegister::SYS_ID)) << std::endl;
-        std::cout << "LogicTile Information:" << get_logictile_info(apb_reg_access.readReg(APBRegister::SYS_PROC_ID1)) << std::endl;                  
+        // Declared before the managers so it outlives every access they record
+        std::optional<TraceWriter> trace;
+        if (!trace_path.empty())
+        {
+            trace.emplace(trace_path);
+        }
+
+        RegisterManager scc_reg_access(SCC_BASE_ADDR, verbose, simulated, announce);
+        RegisterManager apb_reg_access(APB_BASE_ADDR, verbose, simulated, announce);
+        RegisterManager axi_reg_access(AXI_BASE_ADDR, verbose, simulated, announce);
+        RegisterRegions const regions{&scc_reg_access, &apb_reg_access, &axi_reg_access};
+
+        // Calibrated before tracing starts, so the probe reads stay out of the trace
+        ThreadPlacement const placement{place_threads ? ThreadPlacement::calibrate(regions) : ThreadPlacement::from_topology()};
+        if (place_threads)
+        {
+            placement.print_report(report);
+            if (sample_cpu < 0)
+            {
+                sample_cpu = static_cast<int>(placement.hot_cpu());
+            }
+        }
+        if (trace)
+        {
+            for (auto *manager : {&scc_reg_access, &apb_reg_access, &axi_reg_access})
+            {
+                manager->setTrace(&*trace);
+            }
+        }
+
+        if (replay)
+        {
+            std::cout << "[REPLAY] " << replay->size() << " records from " << replay_path << std::endl;
+            ReplayResult const result{replay_trace(*replay, regions, replay_scale)};
+            print_replay_report(result, replay_scale, std::cout);
+            return result.mismatches == 0 ? 0 : 1;
+        }
+
+        if (serve)
+        {
+            run_register_server(regions, serve_port, serve_bind, serve_read_only);
+            return 0;
+        }
+        if (random_bytes != 0)
+        {
+            random_output_sequence(axi_reg_access, random_bytes, place_threads ? placement.cpus(ThreadRole::Hot) : std::vector<unsigned>{});
+            return 0;
+        }
+        if (!sample_specs.empty())
+        {
+            run_register_sampler(sample_specs, regions, sample_seconds, sample_cpu);
+            return 0;
+        }
+        if (script)
+        {
+            return run_register_script(*script, regions, script_timing) ? 0 : 1;
+        }
+        if (!register_ops.empty())
+        {
+            return run_register_ops(register_ops, regions) ? 0 : 1;
+        }
+
+        // Identity registers are constant, so later reads through the shadow stay off the bus
+        ShadowRegisters apb_shadow(apb_reg_access);
+        char info[APB_DECODE_BYTES];
+        std::cout << "ARM Juno Platform Information:";
+        std::cout.write(info, format_board_info(apb_shadow.read(APBRegister::SYS_ID), info, info + sizeof(info)) - info) << std::endl;
+        std::cout << "LogicTile Information:";
+        std::cout.write(info, format_logictile_info(apb_shadow.read(APBRegister::SYS_PROC_ID1), info, info + sizeof(info)) - info) << std::endl;
                   
         if (run_rng_test)
         {
             axi_slave_rng_test_sequence(axi_reg_access);
         }
+        if (run_dma_test)
+        {
+            axi_dma_ring_test_sequence(axi_reg_access, dma_ring_base, dma_ring_bytes);
+        }
+        if (run_perf_sample)
+        {
+            std::optional<TelemetryWriter> telemetry;
+            if (!telemetry_path.empty())
+            {
+                telemetry.emplace(telemetry_path, std::vector<std::string>{"AMS_PERFCYCLES", "AMS_PERFIDLE", "AMS_PERFRBEATS",
+                                                                           "AMS_PERFWBEATS", "AMS_PERFRSTALL", "AMS_PERFBSTALL",
+                                                                           "AMS_PERFSLVERR", "AMS_PERFMAXOUT"});
+            }
+            axi_slave_perf_sample_sequence(axi_reg_access, perf_interval_ms, perf_samples, telemetry ? &*telemetry : nullptr);
+        }
+        if (clock_seconds != 0)
+        {
+            board_clock_sequence(apb_reg_access, clock_seconds, place_threads ? placement.cpus(ThreadRole::Background) : std::vector<unsigned>{});
+        }
+        if (scan_bytes != 0)
+        {
+            PhysicalWindows windows(huge_windows ? PhysicalWindows::HUGE_WINDOW_BYTES : PhysicalWindows::DEFAULT_WINDOW_BYTES,
+                                    PhysicalWindows::DEFAULT_MAX_MAPPED_BYTES, huge_windows, simulated);
+            physical_scan_sequence(windows, scan_base, scan_bytes, scan_stride);
+        }
+        if (run_bandwidth)
+        {
+            axi_bandwidth_sequence(bandwidth_base, bandwidth_bytes, bandwidth_threads, simulated);
+        }
+        if (batch_rounds != 0)
+        {
+            write_batch_sequence(scc_reg_access, axi_reg_access, batch_rounds);
+        }
         if (run_led_test)
         {
-            logictile_led_test_sequence(scc_reg_access);
+            ShadowRegisters scc_shadow(scc_reg_access);
+            logictile_led_test_sequence(scc_shadow);
+            if (verbose)
+            {
+                scc_shadow.print_counters("SCC", std::cout);
+            }
         }
     }
     catch (const std::runtime_error &e)
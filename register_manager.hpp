@@ -0,0 +1,403 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <optional>
+#include <sstream>
+#include <stdexcept>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "register_trace.hpp"
+#include "registers.hpp"
+
+/**
+ * @brief One store in a RegisterManager::writeBatch().
+ */
+struct RegisterWrite
+{
+    uint32_t offset; // Byte offset from the base address (4-byte aligned, below MAP_SIZE)
+    uint32_t value;
+};
+
+/**
+ * @brief What writeBatch() does after its trailing barrier.
+ */
+struct WriteBatchCheck
+{
+    std::optional<uint32_t> read_back; // Offset to read once, so the posted writes have reached the device
+    bool verify{false};                // Read every written register back and compare it with its last write
+};
+
+/**
+ * @brief Outcome of a writeBatch().
+ */
+struct WriteBatchResult
+{
+    uint32_t read_back_value{0}; // Value of the WriteBatchCheck::read_back read, if one was asked for
+    size_t mismatches{0};        // Registers whose read-back differed from their last write (verify only)
+    size_t first_mismatch{0};    // Index in the batch of the earliest such write
+};
+
+/**
+ * @brief Waits until every earlier store has completed: dsb st on AArch64, mfence on x86.
+ */
+inline void io_write_barrier()
+{
+#if defined(__aarch64__)
+    asm volatile("dsb st" ::: "memory");
+#elif defined(__x86_64__) || defined(__i386__)
+    asm volatile("mfence" ::: "memory");
+#else
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+#endif
+}
+
+/**
+ * @brief Manages memory mapping and provides read/write access to hardware registers.
+ *
+ * This class handles opening /dev/mem and mapping the physical base address
+ * into the process's virtual memory space. In simulated mode the page is
+ * ordinary anonymous memory instead, so register traffic can be exercised
+ * (and benchmarked) without a board or root access.
+ */
+class RegisterManager
+{
+private:
+    int m_fd{-1};
+    void *m_map_base{nullptr};
+    const uint64_t m_physical_base;
+    const bool m_logging;
+    const bool m_simulated;
+    const bool m_announce;
+    TraceWriter *m_trace{nullptr};
+    uint8_t m_trace_region{0};
+
+public:
+    /**
+     * @brief Constructor: Initializes the memory map.
+     * @param physical_base The starting physical address to map.
+     * @param logging Whether to log accesses to stdout
+     * @param simulated Back the registers with anonymous memory instead of /dev/mem
+     * @param announce Print the [INFO] lines for mapping and unmapping (off for library use)
+     */
+    RegisterManager(uint64_t const physical_base, bool const logging, bool const simulated = false, bool const announce = true)
+        : m_physical_base(physical_base), m_logging(logging), m_simulated(simulated), m_announce(announce)
+    {
+        if (m_simulated)
+        {
+            m_map_base = mmap(0, MAP_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+            if (m_map_base == MAP_FAILED)
+            {
+                throw std::runtime_error("Error: mmap failed to allocate simulated registers.");
+            }
+            if (m_announce)
+            {
+                std::cout << "[INFO] Simulating physical address 0x" << std::hex
+                          << m_physical_base << " at virtual address " << m_map_base << std::dec << std::endl;
+            }
+            return;
+        }
+
+        m_fd = open("/dev/mem", O_RDWR | O_SYNC);
+        if (m_fd == -1)
+        {
+            throw std::runtime_error("Error: Could not open /dev/mem. Must run as root or with appropriate permissions.");
+        }
+
+        // 2. Map the physical address range into virtual memory
+        m_map_base = mmap(
+            0,                      // addr: Let the kernel choose the address
+            MAP_SIZE,               // len: The size of the memory region
+            PROT_READ | PROT_WRITE, // prot: Read/Write access
+            MAP_SHARED,             // flags: Share changes with other processes/hardware
+            m_fd,                   // fd: File descriptor for /dev/mem
+            m_physical_base         // offset: The physical address start
+        );
+
+        if (m_map_base == MAP_FAILED)
+        {
+            close(m_fd);
+            throw std::runtime_error("Error: mmap failed to map physical address.");
+        }
+
+        if (m_announce)
+        {
+            std::cout << "[INFO] Successfully mapped physical address 0x" << std::hex
+                      << m_physical_base << " to virtual address " << m_map_base << std::dec << std::endl;
+        }
+    }
+
+    /**
+     * @brief Destructor: Cleans up the memory map and file descriptor.
+     */
+    ~RegisterManager()
+    {
+        if (m_map_base != MAP_FAILED && m_map_base != nullptr)
+        {
+            if (munmap(m_map_base, MAP_SIZE) == -1)
+            {
+                std::cerr << "[ERROR] Failed to unmap memory." << std::endl;
+            }
+            else if (m_announce)
+            {
+                std::cout << "[INFO] Memory unmapped successfully." << std::endl;
+            }
+        }
+        if (m_fd != -1)
+        {
+            close(m_fd);
+        }
+    }
+
+    /**
+     * @brief Reads a 32-bit value from a register offset.
+     * @param reg Register enum which encodes it's offset from the base address.
+     * @return The 32-bit value read from the register.
+     */
+    template <typename T>
+    uint32_t readReg(T const &reg) const
+    {
+        if (!m_map_base)
+        {
+            std::cerr << "[ERROR] Cannot read: memory not mapped." << std::endl;
+            return 0;
+        }
+        uint32_t const offset{static_cast<uint32_t>(reg)};
+        volatile uint32_t *reg_ptr{(volatile uint32_t *)((char *)m_map_base + offset)};
+        uint32_t const value{*reg_ptr};
+
+        if (m_trace)
+        {
+            m_trace->append(m_trace_region, offset, value, TraceRecord::READ);
+        }
+        if (m_logging)
+        {
+            std::cout << "  > Read 0x" << std::hex << std::setw(8) << std::setfill('0') << value
+                      << " from register " << (+reg)._to_string() << " (base 0x" << m_physical_base << " + offset 0x" << offset << std::dec << ")" << std::endl;
+        }
+        return value;
+    }
+
+    /**
+     * @brief Writes a 32-bit value to a register offset.
+     * @param reg Register enum which encodes it's offset from the base address.
+     * @param value The 32-bit value to write.
+     */
+    template <typename T>
+    void writeReg(T const &reg, uint32_t value) const
+    {
+        if (!m_map_base)
+        {
+            std::cerr << "[ERROR] Cannot write: memory not mapped." << std::endl;
+            return;
+        }
+        uint32_t const offset{static_cast<uint32_t>(reg)};
+        volatile uint32_t *reg_ptr{(volatile uint32_t *)((char *)m_map_base + offset)};
+
+        if (m_logging)
+        {
+            std::cout << "  > Writing 0x" << std::hex << std::setw(8) << std::setfill('0') << value
+                      << " to register " << (+reg)._to_string() << " (base 0x" << m_physical_base << " offset 0x" << offset << std::dec << ")" << std::endl;
+        }
+        *reg_ptr = value;
+        if (m_trace)
+        {
+            m_trace->append(m_trace_region, offset, value, TraceRecord::WRITE);
+        }
+    }
+
+    [[nodiscard]] bool isSimulated() const
+    {
+        return m_simulated;
+    }
+
+    [[nodiscard]] uint64_t physicalBase() const
+    {
+        return m_physical_base;
+    }
+
+    /**
+     * @brief The mapped page, for callers that issue their own loads and stores (nullptr if unmapped).
+     */
+    [[nodiscard]] volatile uint32_t *mappedBase() const
+    {
+        return static_cast<volatile uint32_t *>(m_map_base);
+    }
+
+    /**
+     * @brief Records every subsequent access to 'trace' (nullptr stops recording).
+     * @param trace The trace to append to; must outlive this manager or be detached first.
+     */
+    void setTrace(TraceWriter *const trace)
+    {
+        m_trace = trace;
+        if (m_trace)
+        {
+            m_trace_region = m_trace->region_id(m_physical_base);
+        }
+    }
+
+    /**
+     * @brief Reads a 32-bit value from a raw byte offset, for registers addressed by number.
+     * @param offset Byte offset from the base address (4-byte aligned, below MAP_SIZE).
+     * @return The 32-bit value read from the register.
+     * @throws std::runtime_error If the offset is unaligned or outside the mapping.
+     */
+    uint32_t readOffset(uint32_t const offset) const
+    {
+        check_offset(offset);
+        if (!m_map_base)
+        {
+            std::cerr << "[ERROR] Cannot read: memory not mapped." << std::endl;
+            return 0;
+        }
+        volatile uint32_t *reg_ptr{(volatile uint32_t *)((char *)m_map_base + offset)};
+        uint32_t const value{*reg_ptr};
+
+        if (m_trace)
+        {
+            m_trace->append(m_trace_region, offset, value, TraceRecord::READ);
+        }
+        if (m_logging)
+        {
+            std::cout << "  > Read 0x" << std::hex << std::setw(8) << std::setfill('0') << value
+                      << " from base 0x" << m_physical_base << " + offset 0x" << offset << std::dec << std::endl;
+        }
+        return value;
+    }
+
+    /**
+     * @brief Writes a 32-bit value to a raw byte offset, for registers addressed by number.
+     * @param offset Byte offset from the base address (4-byte aligned, below MAP_SIZE).
+     * @param value The 32-bit value to write.
+     * @throws std::runtime_error If the offset is unaligned or outside the mapping.
+     */
+    void writeOffset(uint32_t const offset, uint32_t const value) const
+    {
+        check_offset(offset);
+        if (!m_map_base)
+        {
+            std::cerr << "[ERROR] Cannot write: memory not mapped." << std::endl;
+            return;
+        }
+        volatile uint32_t *reg_ptr{(volatile uint32_t *)((char *)m_map_base + offset)};
+
+        if (m_logging)
+        {
+            std::cout << "  > Writing 0x" << std::hex << std::setw(8) << std::setfill('0') << value
+                      << " to base 0x" << m_physical_base << " offset 0x" << offset << std::dec << std::endl;
+        }
+        *reg_ptr = value;
+        if (m_trace)
+        {
+            m_trace->append(m_trace_region, offset, value, TraceRecord::WRITE);
+        }
+    }
+
+    /**
+     * @brief Issues 'count' stores back-to-back, then one barrier, then the optional checks.
+     *
+     * Unlike a loop of writeOffset(), nothing runs between the stores (logging
+     * happens before them and tracing after), and the cost of making them
+     * visible is paid once per batch instead of once per write.
+     * @param writes The stores, in issue order; an offset may appear more than once.
+     * @param count Number of entries in 'writes'.
+     * @param check Read-back and verification to run after the barrier.
+     * @return The read-back value and, with check.verify, the registers that did not hold their last write.
+     * @throws std::runtime_error If any offset, or check.read_back, is unaligned or outside the mapping;
+     * the whole batch is then rejected before its first store.
+     */
+    WriteBatchResult writeBatch(RegisterWrite const *const writes, size_t const count, WriteBatchCheck const &check = {}) const
+    {
+        for (size_t i{0}; i < count; ++i)
+        {
+            check_offset(writes[i].offset);
+        }
+        if (check.read_back)
+        {
+            check_offset(*check.read_back);
+        }
+        WriteBatchResult result;
+        if (!m_map_base)
+        {
+            std::cerr << "[ERROR] Cannot write: memory not mapped." << std::endl;
+            return result;
+        }
+        auto *const base{static_cast<char *>(m_map_base)};
+
+        if (m_logging)
+        {
+            for (size_t i{0}; i < count; ++i)
+            {
+                std::cout << "  > Batch writing 0x" << std::hex << std::setw(8) << std::setfill('0') << writes[i].value
+                          << " to base 0x" << m_physical_base << " offset 0x" << writes[i].offset << std::dec << std::endl;
+            }
+        }
+        for (size_t i{0}; i < count; ++i)
+        {
+            *reinterpret_cast<volatile uint32_t *>(base + writes[i].offset) = writes[i].value;
+        }
+        io_write_barrier();
+        if (m_trace)
+        {
+            for (size_t i{0}; i < count; ++i)
+            {
+                m_trace->append(m_trace_region, writes[i].offset, writes[i].value, TraceRecord::WRITE);
+            }
+        }
+
+        if (check.read_back)
+        {
+            result.read_back_value = readOffset(*check.read_back);
+        }
+        if (check.verify)
+        {
+            // Newest write first, so each register is read once and compared with the value it should hold
+            std::array<uint32_t, MAP_SIZE / 4 / 32> seen{};
+            for (size_t i{count}; i-- > 0;)
+            {
+                uint32_t const word{writes[i].offset / 4};
+                if (seen[word / 32] & (1u << (word % 32)))
+                {
+                    continue;
+                }
+                seen[word / 32] |= 1u << (word % 32);
+                if (readOffset(writes[i].offset) != writes[i].value)
+                {
+                    ++result.mismatches;
+                    result.first_mismatch = i;
+                }
+            }
+        }
+        return result;
+    }
+
+    /**
+     * @brief writeBatch() over a fixed-size batch.
+     */
+    template <size_t N>
+    WriteBatchResult writeBatch(std::array<RegisterWrite, N> const &writes, WriteBatchCheck const &check = {}) const
+    {
+        return writeBatch(writes.data(), N, check);
+    }
+
+private:
+    /**
+     * @brief Throws unless 'offset' addresses a whole, aligned register inside the mapping.
+     */
+    static void check_offset(uint32_t const offset)
+    {
+        if (offset % sizeof(uint32_t) != 0 || offset >= MAP_SIZE)
+        {
+            std::ostringstream message;
+            message << "Error: register offset 0x" << std::hex << offset << " is unaligned or outside the 0x" << MAP_SIZE
+                    << "-byte mapping.";
+            throw std::runtime_error(message.str());
+        }
+    }
+};
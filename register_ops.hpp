@@ -0,0 +1,378 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+#include <strings.h>
+
+#include "apb_fields.hpp"
+#include "register_manager.hpp"
+#include "registers.hpp"
+
+/**
+ * @brief Register regions addressable from the command line.
+ */
+enum class RegisterRegion : uint8_t
+{
+    SCC,
+    APB,
+    AXI
+};
+
+constexpr std::array<char const *, 3> REGISTER_REGION_NAMES{"SCC", "APB", "AXI"};
+
+/**
+ * @brief Open mappings for each RegisterRegion, indexed by its value.
+ */
+using RegisterRegions = std::array<RegisterManager const *, 3>;
+
+/**
+ * @brief How long a poll operation waits for its condition before failing.
+ */
+constexpr std::chrono::milliseconds POLL_TIMEOUT{1000};
+
+/**
+ * @brief Polls re-read back-to-back for this long before backing off to sleeps,
+ * which start at POLL_MIN_SLEEP and double up to POLL_MAX_SLEEP.
+ */
+constexpr std::chrono::microseconds POLL_SPIN_TIME{20};
+constexpr std::chrono::microseconds POLL_MIN_SLEEP{1};
+constexpr std::chrono::microseconds POLL_MAX_SLEEP{1000};
+
+/**
+ * @brief Waits shorter than this are spun rather than slept, since a sleep
+ * overshoots by more than the wait itself.
+ */
+constexpr std::chrono::microseconds WAIT_SPIN_LIMIT{50};
+
+/**
+ * @brief Waits until 'deadline', spinning for short waits and sleeping for long ones.
+ */
+inline void wait_until(std::chrono::steady_clock::time_point const deadline)
+{
+    auto const now{std::chrono::steady_clock::now()};
+    if (deadline - now > WAIT_SPIN_LIMIT)
+    {
+        std::this_thread::sleep_until(deadline - WAIT_SPIN_LIMIT);
+    }
+    while (std::chrono::steady_clock::now() < deadline)
+    {
+    }
+}
+
+/**
+ * @brief Re-reads a register until (value & mask) == expected (or != when want_equal is false).
+ *
+ * Most conditions are met within a few bus reads, so the register is first
+ * read back-to-back; only a slow condition pays for sleeping.
+ *
+ * @param manager The mapping holding the register.
+ * @param offset Byte offset of the register.
+ * @param mask Bits to compare.
+ * @param expected The masked value to compare against.
+ * @param want_equal Whether to wait for equality or inequality.
+ * @param timeout How long to wait before giving up.
+ * @param value Receives the last value read.
+ * @return True if the condition was met before the timeout.
+ */
+inline bool poll_register(RegisterManager const &manager, uint32_t const offset, uint32_t const mask, uint32_t const expected,
+                          bool const want_equal, std::chrono::microseconds const timeout, uint32_t &value)
+{
+    auto const met{[&] { return ((value & mask) == expected) == want_equal; }};
+
+    value = manager.readOffset(offset);
+    if (met())
+    {
+        return true;
+    }
+
+    auto const start{std::chrono::steady_clock::now()};
+    auto const deadline{start + timeout};
+    auto const spin_end{start + std::min(timeout, POLL_SPIN_TIME)};
+    auto now{start};
+    while (now < spin_end)
+    {
+        // Check the clock every few reads so it does not dominate the spin
+        for (unsigned read{0}; read < 16; ++read)
+        {
+            value = manager.readOffset(offset);
+            if (met())
+            {
+                return true;
+            }
+        }
+        now = std::chrono::steady_clock::now();
+    }
+
+    auto sleep{POLL_MIN_SLEEP};
+    while (now < deadline)
+    {
+        std::this_thread::sleep_for(std::min<std::chrono::steady_clock::duration>(sleep, deadline - now));
+        value = manager.readOffset(offset);
+        if (met())
+        {
+            return true;
+        }
+        sleep = std::min(sleep * 2, POLL_MAX_SLEEP);
+        now = std::chrono::steady_clock::now();
+    }
+    return false;
+}
+
+/**
+ * @brief One peek/poke operation, with the register name already resolved to an offset.
+ */
+struct RegisterOp
+{
+    enum class Kind : uint8_t
+    {
+        Read,
+        Write,
+        PollEqual,
+        PollNotEqual
+    };
+
+    Kind kind;
+    RegisterRegion region;
+    uint16_t offset;
+    uint32_t value;   // Write data, or the value a poll compares against
+    uint32_t mask;    // Bits a poll compares
+    char const *name; // Register name, or nullptr when addressed by offset
+};
+
+/**
+ * @brief Prints an operation's target as REGION:NAME (or REGION:0xOFFSET).
+ */
+inline std::ostream &operator<<(std::ostream &stream, RegisterOp const &op)
+{
+    stream << REGISTER_REGION_NAMES[static_cast<size_t>(op.region)] << ':';
+    if (op.name)
+    {
+        return stream << op.name;
+    }
+    return stream << "0x" << std::hex << std::setw(3) << std::setfill('0') << op.offset << std::dec;
+}
+
+namespace register_ops_detail
+{
+
+[[nodiscard]] inline uint32_t parse_u32(std::string const &text, char const *what)
+{
+    char *end{nullptr};
+    unsigned long long const value{std::strtoull(text.c_str(), &end, 0)};
+    if (text.empty() || *end != '\0' || value > UINT32_MAX)
+    {
+        throw std::runtime_error("Error: invalid " + std::string(what) + " '" + text + "'.");
+    }
+    return static_cast<uint32_t>(value);
+}
+
+template <typename Enum>
+[[nodiscard]] bool find_register(std::string const &name, RegisterOp &op)
+{
+    auto const reg{Enum::_from_string_nocase_nothrow(name.c_str())};
+    if (!reg)
+    {
+        return false;
+    }
+    op.offset = static_cast<uint16_t>(reg->_to_integral());
+    op.name = reg->_to_string();
+    return true;
+}
+
+// Resolves "REGION:REG" into op.region, op.offset and op.name
+inline void parse_target(std::string const &target, RegisterOp &op)
+{
+    size_t const colon{target.find(':')};
+    if (colon == std::string::npos)
+    {
+        throw std::runtime_error("Error: expected REGION:REG, got '" + target + "'.");
+    }
+
+    std::string const region{target.substr(0, colon)};
+    std::string const reg{target.substr(colon + 1)};
+    size_t index{0};
+    while (index < REGISTER_REGION_NAMES.size() && strcasecmp(region.c_str(), REGISTER_REGION_NAMES[index]) != 0)
+    {
+        ++index;
+    }
+    if (index == REGISTER_REGION_NAMES.size())
+    {
+        throw std::runtime_error("Error: unknown region '" + region + "' (expected SCC, APB or AXI).");
+    }
+    op.region = static_cast<RegisterRegion>(index);
+    op.name = nullptr;
+
+    bool found{false};
+    switch (op.region)
+    {
+    case RegisterRegion::SCC:
+        found = find_register<SCCRegister>(reg, op);
+        break;
+    case RegisterRegion::APB:
+        found = find_register<APBRegister>(reg, op);
+        break;
+    case RegisterRegion::AXI:
+        found = find_register<AXIRegister>(reg, op);
+        break;
+    }
+    if (found)
+    {
+        return;
+    }
+
+    // Not a known name, so it must be a byte offset within the mapped page
+    uint32_t const offset{parse_u32(reg, "register")};
+    if (offset % sizeof(uint32_t) != 0 || offset >= MAP_SIZE)
+    {
+        throw std::runtime_error("Error: register offset '" + reg + "' must be 4-byte aligned and below the 4KB map.");
+    }
+    op.offset = static_cast<uint16_t>(offset);
+}
+
+} // namespace register_ops_detail
+
+/**
+ * @brief Parses command-line operations into an op vector.
+ *
+ * Accepted forms, in any number and order:
+ *   read REGION:REG
+ *   write REGION:REG=VALUE
+ *   poll REGION:REG[&MASK]==VALUE   (or !=VALUE)
+ * REGION is SCC, APB or AXI; REG is a register name (any case) or a byte offset.
+ *
+ * @param count The number of arguments.
+ * @param args The arguments.
+ * @return The operations, in command-line order.
+ */
+[[nodiscard]] inline std::vector<RegisterOp> parse_register_ops(int const count, char *const args[])
+{
+    using register_ops_detail::parse_target;
+    using register_ops_detail::parse_u32;
+
+    std::vector<RegisterOp> ops;
+    ops.reserve(static_cast<size_t>(count) / 2);
+    for (int i{0}; i < count; i += 2)
+    {
+        std::string const verb{args[i]};
+        if (i + 1 >= count)
+        {
+            throw std::runtime_error("Error: '" + verb + "' is missing its operand.");
+        }
+        std::string const operand{args[i + 1]};
+
+        RegisterOp op{};
+        op.mask = UINT32_MAX;
+        if (verb == "read")
+        {
+            op.kind = RegisterOp::Kind::Read;
+            parse_target(operand, op);
+        }
+        else if (verb == "write")
+        {
+            size_t const equals{operand.find('=')};
+            if (equals == std::string::npos)
+            {
+                throw std::runtime_error("Error: expected REGION:REG=VALUE, got '" + operand + "'.");
+            }
+            op.kind = RegisterOp::Kind::Write;
+            parse_target(operand.substr(0, equals), op);
+            op.value = parse_u32(operand.substr(equals + 1), "value");
+        }
+        else if (verb == "poll")
+        {
+            size_t const compare{operand.find_first_of("=!")};
+            if (compare == std::string::npos || compare + 1 >= operand.size() || operand[compare + 1] != '=')
+            {
+                throw std::runtime_error("Error: expected REGION:REG[&MASK]==VALUE or !=VALUE, got '" + operand + "'.");
+            }
+            op.kind = operand[compare] == '=' ? RegisterOp::Kind::PollEqual : RegisterOp::Kind::PollNotEqual;
+            op.value = parse_u32(operand.substr(compare + 2), "value");
+
+            std::string target{operand.substr(0, compare)};
+            size_t const ampersand{target.find('&')};
+            if (ampersand != std::string::npos)
+            {
+                op.mask = parse_u32(target.substr(ampersand + 1), "mask");
+                target.resize(ampersand);
+            }
+            parse_target(target, op);
+        }
+        else
+        {
+            throw std::runtime_error("Error: unknown operation '" + verb + "' (expected read, write or poll).");
+        }
+        ops.push_back(op);
+    }
+    return ops;
+}
+
+/**
+ * @brief Executes parsed operations back-to-back on already-open mappings.
+ *
+ * Reads and completed polls print "REGION:REG = 0xVALUE"; APB reads are
+ * followed by their decoded fields, where the register has any. Execution
+ * stops at the first poll that times out.
+ *
+ * @param ops The operations to run.
+ * @param regions The open mapping for each region.
+ * @return True if every operation completed.
+ */
+inline bool run_register_ops(std::vector<RegisterOp> const &ops, RegisterRegions const &regions)
+{
+    for (auto const &op : ops)
+    {
+        RegisterManager const &manager{*regions[static_cast<size_t>(op.region)]};
+        switch (op.kind)
+        {
+        case RegisterOp::Kind::Read:
+        {
+            uint32_t const value{manager.readOffset(op.offset)};
+            std::cout << op << " = 0x" << std::hex << std::setw(8) << std::setfill('0') << value << std::dec;
+            if (op.region == RegisterRegion::APB)
+            {
+                char decoded[APB_DECODE_BYTES];
+                char const *const end{format_apb_register(op.offset, value, decoded, decoded + sizeof(decoded))};
+                if (end && end != decoded)
+                {
+                    std::cout << "  ";
+                    std::cout.write(decoded, end - decoded);
+                }
+            }
+            std::cout << '\n';
+            break;
+        }
+        case RegisterOp::Kind::Write:
+            manager.writeOffset(op.offset, op.value);
+            break;
+        case RegisterOp::Kind::PollEqual:
+        case RegisterOp::Kind::PollNotEqual:
+        {
+            bool const want_equal{op.kind == RegisterOp::Kind::PollEqual};
+            auto const start{std::chrono::steady_clock::now()};
+            uint32_t value{0};
+            if (!poll_register(manager, op.offset, op.mask, op.value, want_equal, POLL_TIMEOUT, value))
+            {
+                std::cout << std::flush;
+                std::cerr << "Error: poll of " << op << " timed out, last read 0x" << std::hex << value << std::dec << std::endl;
+                return false;
+            }
+            auto const waited{std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - start)};
+            std::cout << op << " = 0x" << std::hex << std::setw(8) << std::setfill('0') << value << std::dec
+                      << " (after " << waited.count() << " us)\n";
+            break;
+        }
+        }
+    }
+    std::cout << std::flush;
+    return true;
+}
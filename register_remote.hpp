@@ -0,0 +1,1317 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <list>
+#include <stdexcept>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+#include <arpa/inet.h>
+#include <csignal>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/signalfd.h>
+#include <sys/socket.h>
+#include <sys/timerfd.h>
+#include <unistd.h>
+
+#include "register_manager.hpp"
+#include "register_ops.hpp"
+
+/**
+ * @brief Remote register access: a TCP server around the open register
+ * regions, and a client that drives any number of boards from one thread.
+ *
+ * Every message is a RemoteHeader followed by its payload, in the boards' and
+ * hosts' native little-endian byte order. Requests carry a client-chosen ID
+ * that comes back on the reply, so a client can keep many requests in flight
+ * on one connection and match replies as they arrive; replies to batches that
+ * wait on a poll may overtake earlier ones. A batch runs its ops in order on
+ * the server, polls included, and a subscription makes the server read a set
+ * of registers on a fixed interval and push each result as a Sample.
+ */
+
+constexpr uint16_t REMOTE_PROTOCOL_VERSION{1};
+constexpr uint16_t REMOTE_DEFAULT_PORT{5027};
+
+/**
+ * @brief Address a server listens on unless told otherwise: this host only.
+ */
+constexpr char const *REMOTE_DEFAULT_BIND{"127.0.0.1"};
+
+/**
+ * @brief Largest payload either side accepts; a peer sending more is disconnected.
+ */
+constexpr size_t REMOTE_MAX_PAYLOAD{64 << 10};
+
+/**
+ * @brief Unsent bytes a server queues for one client before it drops samples for it and stops reading its requests.
+ */
+constexpr size_t REMOTE_MAX_QUEUED_BYTES{1 << 20};
+
+enum class RemoteMessage : uint8_t
+{
+    Hello,       // Server to client on connect; count is the protocol version
+    Batch,       // count RemoteOpWire; the reply holds one uint32_t per completed op
+    Subscribe,   // RemoteSubscribeWire, then count RemoteOpWire reads; acknowledged with an empty reply
+    Unsubscribe, // One uint32_t: the subscription's request ID
+    Sample       // Server push: RemoteSampleWire, then count uint32_t values
+};
+
+enum class RemoteStatus : uint8_t
+{
+    Ok,
+    PollTimeout, // The last value is the timed-out poll's last read
+    BadRequest
+};
+
+struct RemoteHeader
+{
+    uint32_t bytes;      // Payload bytes following the header
+    uint32_t request_id; // Chosen by the client; replies and samples carry it back
+    uint8_t type;        // RemoteMessage
+    uint8_t status;      // RemoteStatus; Ok in requests
+    uint16_t count;      // Ops in a request, values in a reply or sample
+};
+
+struct RemoteOpWire
+{
+    uint8_t kind;   // RegisterOp::Kind
+    uint8_t region; // RegisterRegion
+    uint16_t offset;
+    uint32_t value;
+    uint32_t mask;
+    uint32_t timeout_us; // Polls only
+};
+
+struct RemoteSubscribeWire
+{
+    uint32_t interval_us;
+    uint32_t samples; // Samples to send, not counting dropped ones (0 = until unsubscribed)
+};
+
+struct RemoteSampleWire
+{
+    uint64_t timestamp_ns; // Server steady clock when the registers were read
+    uint32_t dropped;      // Samples skipped since the previous one, because the client fell behind
+    uint32_t reserved;
+};
+
+static_assert(sizeof(RemoteHeader) == 12 && sizeof(RemoteOpWire) == 16 && sizeof(RemoteSubscribeWire) == 8 &&
+                  sizeof(RemoteSampleWire) == 16,
+              "Remote wire layouts must not change");
+
+namespace register_remote_detail
+{
+
+inline void set_nodelay(int const fd)
+{
+    int const one{1};
+    setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+}
+
+inline void append_message(std::vector<char> &out, RemoteHeader const &header, void const *const payload)
+{
+    size_t const at{out.size()};
+    out.resize(at + sizeof(header) + header.bytes);
+    std::memcpy(out.data() + at, &header, sizeof(header));
+    if (payload && header.bytes != 0)
+    {
+        std::memcpy(out.data() + at + sizeof(header), payload, header.bytes);
+    }
+}
+
+inline RemoteOpWire to_wire(RegisterOp const &op, std::chrono::microseconds const timeout)
+{
+    return RemoteOpWire{static_cast<uint8_t>(op.kind), static_cast<uint8_t>(op.region), op.offset, op.value, op.mask,
+                        static_cast<uint32_t>(timeout.count())};
+}
+
+/**
+ * @brief A socket's unsent output and its unparsed input.
+ */
+struct Stream
+{
+    int fd{-1};
+    std::vector<char> in;
+    std::vector<char> out;
+    size_t sent{0};          // Bytes of 'out' already written
+    uint32_t events{EPOLLIN}; // Events registered with epoll
+    bool paused{false};       // Not reading, until the peer takes its queued output
+
+    // Writes as much queued output as the socket takes; false if the peer is gone
+    bool flush()
+    {
+        while (sent < out.size())
+        {
+            ssize_t const written{send(fd, out.data() + sent, out.size() - sent, MSG_NOSIGNAL)};
+            if (written < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return errno == EAGAIN || errno == EWOULDBLOCK;
+            }
+            sent += static_cast<size_t>(written);
+        }
+        out.clear();
+        sent = 0;
+        return true;
+    }
+
+    // Reads what is available, stopping once 'in' holds 'limit' bytes; false on EOF or error
+    bool fill(size_t const limit = SIZE_MAX)
+    {
+        while (in.size() < limit)
+        {
+            size_t const at{in.size()};
+            in.resize(at + (64 << 10));
+            ssize_t const got{recv(fd, in.data() + at, 64 << 10, 0)};
+            in.resize(at + static_cast<size_t>(std::max<ssize_t>(got, 0)));
+            if (got > 0)
+            {
+                continue;
+            }
+            if (got < 0 && errno == EINTR)
+            {
+                continue;
+            }
+            return got < 0 && (errno == EAGAIN || errno == EWOULDBLOCK);
+        }
+        return true;
+    }
+
+    [[nodiscard]] size_t queued() const
+    {
+        return out.size() - sent;
+    }
+
+    // Registers EPOLLOUT while output is queued, and EPOLLIN unless paused
+    void update_interest(int const epoll_fd, uint64_t const key)
+    {
+        uint32_t const want{(paused ? 0u : static_cast<uint32_t>(EPOLLIN)) | (queued() != 0 ? static_cast<uint32_t>(EPOLLOUT) : 0u)};
+        if (want != events)
+        {
+            epoll_event event{};
+            event.events = want;
+            event.data.u64 = key;
+            epoll_ctl(epoll_fd, EPOLL_CTL_MOD, fd, &event);
+            events = want;
+        }
+    }
+
+    /**
+     * @brief Calls handler(header, payload) for each complete message in 'in', then drops them.
+     * @return False if a message is larger than REMOTE_MAX_PAYLOAD.
+     */
+    template <typename Handler>
+    bool parse(Handler &&handler)
+    {
+        size_t consumed{0};
+        bool ok{true};
+        while (in.size() - consumed >= sizeof(RemoteHeader))
+        {
+            RemoteHeader header;
+            std::memcpy(&header, in.data() + consumed, sizeof(header));
+            if (header.bytes > REMOTE_MAX_PAYLOAD)
+            {
+                ok = false;
+                break;
+            }
+            if (in.size() - consumed - sizeof(header) < header.bytes)
+            {
+                break;
+            }
+            handler(header, in.data() + consumed + sizeof(header));
+            consumed += sizeof(header) + header.bytes;
+        }
+        in.erase(in.begin(), in.begin() + static_cast<std::ptrdiff_t>(consumed));
+        return ok;
+    }
+};
+
+inline uint64_t steady_ns(std::chrono::steady_clock::time_point const time)
+{
+    return static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count());
+}
+
+} // namespace register_remote_detail
+
+/**
+ * @brief Serves register batches and subscriptions over TCP on one thread.
+ *
+ * All sockets, the poll re-checks and the subscription ticks share one epoll
+ * loop, with a timerfd armed for the next re-check or tick. A batch that
+ * reaches an unmet poll is parked and re-read with the same doubling backoff
+ * as poll_register(), so it never holds up other requests or other clients.
+ */
+class RegisterServer
+{
+public:
+    struct Counters
+    {
+        uint64_t connections{0};
+        uint64_t requests{0};
+        uint64_t ops{0};
+        uint64_t samples{0};
+        uint64_t dropped_samples{0};
+        uint64_t rejected_writes{0}; // Batches refused by a read-only server
+    };
+
+    /**
+     * @param regions The open mapping for each region; must outlive the server.
+     * @param port TCP port to listen on (0 picks a free one; see port()).
+     * @param bind_address IPv4 address to listen on; "0.0.0.0" accepts connections on every interface.
+     * @param read_only Reject every batch that contains a write, so clients can only read and poll.
+     * @throws std::runtime_error If the address is invalid or the socket cannot be set up.
+     */
+    RegisterServer(RegisterRegions const &regions, uint16_t const port, std::string const &bind_address = REMOTE_DEFAULT_BIND,
+                   bool const read_only = false)
+        : m_regions(regions), m_bind_address(bind_address), m_read_only(read_only)
+    {
+        in_addr listen_address{};
+        if (inet_pton(AF_INET, bind_address.c_str(), &listen_address) != 1)
+        {
+            throw std::runtime_error("Error: invalid bind address '" + bind_address + "' (expected an IPv4 address).");
+        }
+        m_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        m_listen_fd = socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0);
+        m_wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        m_timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (m_epoll_fd == -1 || m_listen_fd == -1 || m_wake_fd == -1 || m_timer_fd == -1)
+        {
+            close_all();
+            throw std::runtime_error(std::string("Error: could not create server sockets: ") + std::strerror(errno));
+        }
+
+        int const one{1};
+        setsockopt(m_listen_fd, SOL_SOCKET, SO_REUSEADDR, &one, sizeof(one));
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_port = htons(port);
+        address.sin_addr = listen_address;
+        if (bind(m_listen_fd, reinterpret_cast<sockaddr *>(&address), sizeof(address)) == -1 || listen(m_listen_fd, 64) == -1)
+        {
+            std::string const reason{std::strerror(errno)};
+            close_all();
+            throw std::runtime_error("Error: could not listen on " + bind_address + ":" + std::to_string(port) + ": " + reason);
+        }
+        socklen_t length{sizeof(address)};
+        getsockname(m_listen_fd, reinterpret_cast<sockaddr *>(&address), &length);
+        m_port = ntohs(address.sin_port);
+
+        watch(m_listen_fd, LISTEN_KEY);
+        watch(m_wake_fd, WAKE_KEY);
+        watch(m_timer_fd, TIMER_KEY);
+    }
+
+    ~RegisterServer()
+    {
+        for (auto &[key, client] : m_clients)
+        {
+            close(client.fd);
+        }
+        close_all();
+    }
+
+    RegisterServer(RegisterServer const &) = delete;
+    RegisterServer &operator=(RegisterServer const &) = delete;
+
+    [[nodiscard]] uint16_t port() const
+    {
+        return m_port;
+    }
+
+    [[nodiscard]] std::string const &bind_address() const
+    {
+        return m_bind_address;
+    }
+
+    [[nodiscard]] bool read_only() const
+    {
+        return m_read_only;
+    }
+
+    [[nodiscard]] Counters counters() const
+    {
+        return m_counters;
+    }
+
+    /**
+     * @brief Makes run() return on SIGINT or SIGTERM instead of the process being killed.
+     */
+    void stopOnSignals()
+    {
+        sigset_t signals;
+        sigemptyset(&signals);
+        sigaddset(&signals, SIGINT);
+        sigaddset(&signals, SIGTERM);
+        pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+        m_signal_fd = signalfd(-1, &signals, SFD_NONBLOCK | SFD_CLOEXEC);
+        if (m_signal_fd == -1)
+        {
+            throw std::runtime_error("Error: could not create a signalfd for the server.");
+        }
+        watch(m_signal_fd, SIGNAL_KEY);
+    }
+
+    /**
+     * @brief Makes run() return; safe to call from any thread.
+     */
+    void stop()
+    {
+        uint64_t const one{1};
+        ssize_t const written{write(m_wake_fd, &one, sizeof(one))};
+        (void)written;
+    }
+
+    /**
+     * @brief Serves clients until stop() or, with stopOnSignals(), SIGINT/SIGTERM.
+     */
+    void run()
+    {
+        std::array<epoll_event, 64> events;
+        bool running{true};
+        while (running)
+        {
+            int const ready{epoll_wait(m_epoll_fd, events.data(), static_cast<int>(events.size()), -1)};
+            if (ready < 0 && errno != EINTR)
+            {
+                throw std::runtime_error(std::string("Error: epoll_wait failed: ") + std::strerror(errno));
+            }
+            for (int i{0}; i < ready; ++i)
+            {
+                uint64_t const key{events[static_cast<size_t>(i)].data.u64};
+                switch (key)
+                {
+                case LISTEN_KEY:
+                    accept_clients();
+                    break;
+                case WAKE_KEY:
+                case SIGNAL_KEY:
+                    running = false;
+                    break;
+                case TIMER_KEY:
+                {
+                    uint64_t expirations;
+                    ssize_t const got{read(m_timer_fd, &expirations, sizeof(expirations))};
+                    (void)got;
+                    break;
+                }
+                default:
+                    service_client(key, events[static_cast<size_t>(i)].events);
+                    break;
+                }
+            }
+            service_timers(std::chrono::steady_clock::now());
+            flush_clients();
+        }
+    }
+
+    void print_counters(std::ostream &stream) const
+    {
+        stream << "[REMOTE] " << m_bind_address << ":" << m_port << ": " << m_counters.connections << " connections, "
+               << m_counters.requests << " requests, " << m_counters.ops << " ops, " << m_counters.samples << " samples ("
+               << m_counters.dropped_samples << " dropped), " << m_counters.rejected_writes << " rejected writes" << std::endl;
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+    using Stream = register_remote_detail::Stream;
+
+    static constexpr uint64_t LISTEN_KEY{0};
+    static constexpr uint64_t WAKE_KEY{1};
+    static constexpr uint64_t TIMER_KEY{2};
+    static constexpr uint64_t SIGNAL_KEY{3};
+    static constexpr uint64_t FIRST_CLIENT_KEY{16};
+
+    // A batch in progress; only parked while waiting on a poll
+    struct PendingBatch
+    {
+        uint64_t client{0};
+        uint32_t request_id{0};
+        std::vector<RegisterOp> ops;
+        std::vector<uint32_t> values;
+        std::vector<uint32_t> timeouts_us;
+        bool polling{false};          // ops[values.size()] is a poll that has been read at least once
+        Clock::time_point deadline;   // When that poll gives up
+        Clock::time_point next_check; // When it is read again
+        std::chrono::microseconds sleep{POLL_MIN_SLEEP};
+    };
+
+    struct Subscription
+    {
+        uint64_t client;
+        uint32_t id;
+        std::vector<RegisterOp> reads;
+        std::chrono::nanoseconds interval;
+        Clock::time_point due;
+        uint32_t remaining; // 0 = until unsubscribed
+        uint32_t dropped{0};
+    };
+
+    RegisterRegions const m_regions;
+    std::string const m_bind_address;
+    bool const m_read_only;
+    int m_epoll_fd{-1};
+    int m_listen_fd{-1};
+    int m_wake_fd{-1};
+    int m_timer_fd{-1};
+    int m_signal_fd{-1};
+    uint16_t m_port{0};
+    uint64_t m_next_key{FIRST_CLIENT_KEY};
+    std::unordered_map<uint64_t, Stream> m_clients;
+    std::list<PendingBatch> m_pending;
+    std::list<Subscription> m_subscriptions;
+    Clock::time_point m_armed{Clock::time_point::max()};
+    Counters m_counters;
+
+    void close_all()
+    {
+        for (int const fd : {m_signal_fd, m_timer_fd, m_wake_fd, m_listen_fd, m_epoll_fd})
+        {
+            if (fd != -1)
+            {
+                close(fd);
+            }
+        }
+    }
+
+    void watch(int const fd, uint64_t const key)
+    {
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = key;
+        epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &event);
+    }
+
+    void accept_clients()
+    {
+        while (true)
+        {
+            int const fd{accept4(m_listen_fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC)};
+            if (fd == -1)
+            {
+                return;
+            }
+            register_remote_detail::set_nodelay(fd);
+            uint64_t const key{m_next_key++};
+            Stream &client{m_clients[key]};
+            client.fd = fd;
+            watch(fd, key);
+            ++m_counters.connections;
+            register_remote_detail::append_message(client.out, RemoteHeader{0, 0, static_cast<uint8_t>(RemoteMessage::Hello), 0,
+                                                                            REMOTE_PROTOCOL_VERSION},
+                                                   nullptr);
+        }
+    }
+
+    void drop_client(uint64_t const key)
+    {
+        auto const found{m_clients.find(key)};
+        if (found == m_clients.end())
+        {
+            return;
+        }
+        close(found->second.fd);
+        m_clients.erase(found);
+        m_pending.remove_if([key](PendingBatch const &batch) { return batch.client == key; });
+        m_subscriptions.remove_if([key](Subscription const &subscription) { return subscription.client == key; });
+    }
+
+    void service_client(uint64_t const key, uint32_t const events)
+    {
+        auto const found{m_clients.find(key)};
+        if (found == m_clients.end())
+        {
+            return;
+        }
+        Stream &client{found->second};
+        bool alive{true};
+        if (events & EPOLLIN)
+        {
+            // At most one largest message per wakeup; epoll is level-triggered, so the rest waits for the next
+            alive = client.fill(sizeof(RemoteHeader) + REMOTE_MAX_PAYLOAD);
+            // Requests that arrived before the peer hung up are still carried out
+            if (!client.parse([&](RemoteHeader const &header, char const *payload) { handle(key, header, payload); }))
+            {
+                alive = false;
+            }
+        }
+        if (events & (EPOLLERR | EPOLLHUP))
+        {
+            alive = false;
+        }
+        if (!alive)
+        {
+            drop_client(key);
+        }
+    }
+
+    void reply(uint64_t const key, uint32_t const request_id, RemoteMessage const type, RemoteStatus const status,
+               uint32_t const *const values, size_t const count)
+    {
+        auto const found{m_clients.find(key)};
+        if (found != m_clients.end())
+        {
+            register_remote_detail::append_message(found->second.out,
+                                                   RemoteHeader{static_cast<uint32_t>(count * sizeof(uint32_t)), request_id,
+                                                                static_cast<uint8_t>(type), static_cast<uint8_t>(status),
+                                                                static_cast<uint16_t>(count)},
+                                                   values);
+        }
+    }
+
+    // Decodes and validates 'count' wire ops; false if any is malformed
+    static bool decode_ops(char const *payload, size_t const count, std::vector<RegisterOp> &ops, std::vector<uint32_t> &timeouts_us)
+    {
+        ops.resize(count);
+        timeouts_us.resize(count);
+        for (size_t i{0}; i < count; ++i)
+        {
+            RemoteOpWire wire;
+            std::memcpy(&wire, payload + i * sizeof(wire), sizeof(wire));
+            if (wire.kind > static_cast<uint8_t>(RegisterOp::Kind::PollNotEqual) || wire.region >= REGISTER_REGION_NAMES.size() ||
+                wire.offset % 4 != 0 || wire.offset >= MAP_SIZE)
+            {
+                return false;
+            }
+            ops[i] = RegisterOp{static_cast<RegisterOp::Kind>(wire.kind), static_cast<RegisterRegion>(wire.region), wire.offset,
+                                wire.value, wire.mask, nullptr};
+            timeouts_us[i] = wire.timeout_us;
+        }
+        return true;
+    }
+
+    void handle(uint64_t const key, RemoteHeader const &header, char const *const payload)
+    {
+        ++m_counters.requests;
+        switch (static_cast<RemoteMessage>(header.type))
+        {
+        case RemoteMessage::Batch:
+        {
+            PendingBatch batch;
+            batch.client = key;
+            batch.request_id = header.request_id;
+            if (header.bytes != header.count * sizeof(RemoteOpWire) || !decode_ops(payload, header.count, batch.ops, batch.timeouts_us))
+            {
+                break;
+            }
+            // A read-only server refuses the whole batch, so none of its ops run
+            if (m_read_only && std::any_of(batch.ops.begin(), batch.ops.end(),
+                                           [](RegisterOp const &op) { return op.kind == RegisterOp::Kind::Write; }))
+            {
+                ++m_counters.rejected_writes;
+                break;
+            }
+            batch.values.reserve(batch.ops.size());
+            m_counters.ops += batch.ops.size();
+            if (!advance(batch, Clock::now()))
+            {
+                m_pending.push_back(std::move(batch));
+            }
+            return;
+        }
+        case RemoteMessage::Subscribe:
+        {
+            RemoteSubscribeWire settings;
+            if (header.bytes != sizeof(settings) + header.count * sizeof(RemoteOpWire) || header.count == 0)
+            {
+                break;
+            }
+            std::memcpy(&settings, payload, sizeof(settings));
+            Subscription subscription{key, header.request_id, {}, std::chrono::microseconds(std::max<uint32_t>(settings.interval_us, 1)),
+                                      Clock::now(), settings.samples};
+            std::vector<uint32_t> unused;
+            if (!decode_ops(payload + sizeof(settings), header.count, subscription.reads, unused))
+            {
+                break;
+            }
+            m_subscriptions.push_back(std::move(subscription));
+            reply(key, header.request_id, RemoteMessage::Subscribe, RemoteStatus::Ok, nullptr, 0);
+            return;
+        }
+        case RemoteMessage::Unsubscribe:
+        {
+            uint32_t subscription;
+            if (header.bytes != sizeof(subscription))
+            {
+                break;
+            }
+            std::memcpy(&subscription, payload, sizeof(subscription));
+            size_t const before{m_subscriptions.size()};
+            m_subscriptions.remove_if([&](Subscription const &entry) { return entry.client == key && entry.id == subscription; });
+            reply(key, header.request_id, RemoteMessage::Unsubscribe,
+                  m_subscriptions.size() != before ? RemoteStatus::Ok : RemoteStatus::BadRequest, nullptr, 0);
+            return;
+        }
+        default:
+            break;
+        }
+        reply(key, header.request_id, static_cast<RemoteMessage>(header.type), RemoteStatus::BadRequest, nullptr, 0);
+    }
+
+    /**
+     * @brief Runs a batch's ops from where it stopped, replying once it finishes.
+     * @return True if the batch finished; false if it is waiting on a poll until batch.next_check.
+     */
+    bool advance(PendingBatch &batch, Clock::time_point const now)
+    {
+        RemoteStatus status{RemoteStatus::Ok};
+        while (batch.values.size() < batch.ops.size())
+        {
+            RegisterOp const &op{batch.ops[batch.values.size()]};
+            RegisterManager const &manager{*m_regions[static_cast<size_t>(op.region)]};
+            if (op.kind == RegisterOp::Kind::Write)
+            {
+                manager.writeOffset(op.offset, op.value);
+                batch.values.push_back(op.value);
+                continue;
+            }
+
+            uint32_t const value{manager.readOffset(op.offset)};
+            bool const met{op.kind == RegisterOp::Kind::Read ||
+                           (((value & op.mask) == op.value) == (op.kind == RegisterOp::Kind::PollEqual))};
+            if (!met)
+            {
+                if (!batch.polling)
+                {
+                    batch.polling = true;
+                    batch.deadline = now + std::chrono::microseconds(batch.timeouts_us[batch.values.size()]);
+                    batch.sleep = POLL_MIN_SLEEP;
+                }
+                if (now < batch.deadline)
+                {
+                    batch.next_check = std::min(now + batch.sleep, batch.deadline);
+                    batch.sleep = std::min(batch.sleep * 2, POLL_MAX_SLEEP);
+                    return false;
+                }
+                status = RemoteStatus::PollTimeout;
+            }
+            batch.polling = false;
+            batch.values.push_back(value);
+            if (status != RemoteStatus::Ok)
+            {
+                break;
+            }
+        }
+        reply(batch.client, batch.request_id, RemoteMessage::Batch, status, batch.values.data(), batch.values.size());
+        return true;
+    }
+
+    // Re-checks parked polls and takes subscription samples that are due, then re-arms the timer
+    void service_timers(Clock::time_point const now)
+    {
+        for (auto batch{m_pending.begin()}; batch != m_pending.end();)
+        {
+            if (batch->next_check <= now && advance(*batch, now))
+            {
+                batch = m_pending.erase(batch);
+            }
+            else
+            {
+                ++batch;
+            }
+        }
+
+        std::vector<char> payload;
+        for (auto subscription{m_subscriptions.begin()}; subscription != m_subscriptions.end();)
+        {
+            if (subscription->due <= now && !sample(*subscription, now, payload))
+            {
+                subscription = m_subscriptions.erase(subscription);
+            }
+            else
+            {
+                ++subscription;
+            }
+        }
+
+        Clock::time_point next{Clock::time_point::max()};
+        for (PendingBatch const &batch : m_pending)
+        {
+            next = std::min(next, batch.next_check);
+        }
+        for (Subscription const &subscription : m_subscriptions)
+        {
+            next = std::min(next, subscription.due);
+        }
+        if (next != m_armed)
+        {
+            itimerspec timer{};
+            if (next != Clock::time_point::max())
+            {
+                uint64_t const ns{std::max<uint64_t>(register_remote_detail::steady_ns(next), 1)};
+                timer.it_value.tv_sec = static_cast<time_t>(ns / 1000000000);
+                timer.it_value.tv_nsec = static_cast<long>(ns % 1000000000);
+            }
+            timerfd_settime(m_timer_fd, TFD_TIMER_ABSTIME, &timer, nullptr);
+            m_armed = next;
+        }
+    }
+
+    /**
+     * @brief Reads a subscription's registers and queues the sample (or counts it dropped).
+     * @return False once the subscription has sent all the samples it was asked for.
+     */
+    bool sample(Subscription &subscription, Clock::time_point const now, std::vector<char> &payload)
+    {
+        Stream &client{m_clients.at(subscription.client)};
+        size_t const count{subscription.reads.size()};
+        bool const sent{client.queued() <= REMOTE_MAX_QUEUED_BYTES};
+        if (!sent)
+        {
+            ++subscription.dropped;
+            ++m_counters.dropped_samples;
+        }
+        else
+        {
+            payload.resize(sizeof(RemoteSampleWire) + count * sizeof(uint32_t));
+            RemoteSampleWire const header{register_remote_detail::steady_ns(now), subscription.dropped, 0};
+            std::memcpy(payload.data(), &header, sizeof(header));
+            for (size_t i{0}; i < count; ++i)
+            {
+                RegisterOp const &op{subscription.reads[i]};
+                uint32_t const value{m_regions[static_cast<size_t>(op.region)]->readOffset(op.offset)};
+                std::memcpy(payload.data() + sizeof(header) + i * sizeof(value), &value, sizeof(value));
+            }
+            register_remote_detail::append_message(client.out,
+                                                   RemoteHeader{static_cast<uint32_t>(payload.size()), subscription.id,
+                                                                static_cast<uint8_t>(RemoteMessage::Sample), 0,
+                                                                static_cast<uint16_t>(count)},
+                                                   payload.data());
+            subscription.dropped = 0;
+            ++m_counters.samples;
+        }
+
+        // Ticks missed while the loop was busy are skipped rather than sent late in a burst
+        subscription.due += subscription.interval;
+        if (subscription.due <= now)
+        {
+            auto const missed{(now - subscription.due) / subscription.interval + 1};
+            subscription.due += subscription.interval * missed;
+            subscription.dropped += static_cast<uint32_t>(missed);
+            m_counters.dropped_samples += static_cast<uint64_t>(missed);
+        }
+        // Only samples actually sent count towards the total, so a client can wait for all of them
+        return !sent || subscription.remaining == 0 || --subscription.remaining != 0;
+    }
+
+    void flush_clients()
+    {
+        std::vector<uint64_t> lost;
+        for (auto &[key, client] : m_clients)
+        {
+            if (client.queued() == 0)
+            {
+                continue;
+            }
+            if (!client.flush())
+            {
+                lost.push_back(key);
+                continue;
+            }
+            // A client that sends requests without reading the replies is not read from until it catches up
+            client.paused = client.queued() > REMOTE_MAX_QUEUED_BYTES;
+            client.update_interest(m_epoll_fd, key);
+        }
+        for (uint64_t const key : lost)
+        {
+            drop_client(key);
+        }
+    }
+};
+
+/**
+ * @brief A board to connect to, as HOST[:PORT].
+ */
+struct RemoteEndpoint
+{
+    std::string host;
+    uint16_t port{REMOTE_DEFAULT_PORT};
+
+    [[nodiscard]] std::string name() const
+    {
+        return host + ":" + std::to_string(port);
+    }
+
+    /**
+     * @brief Parses a comma-separated list of HOST[:PORT].
+     * @throws std::runtime_error If a port is not a number from 1 to 65535.
+     */
+    [[nodiscard]] static std::vector<RemoteEndpoint> parse_list(std::string const &text)
+    {
+        std::vector<RemoteEndpoint> endpoints;
+        size_t start{0};
+        while (start <= text.size())
+        {
+            size_t const comma{std::min(text.find(',', start), text.size())};
+            std::string const item{text.substr(start, comma - start)};
+            size_t const colon{item.rfind(':')};
+            RemoteEndpoint endpoint{item.substr(0, colon)};
+            if (colon != std::string::npos)
+            {
+                char *end{nullptr};
+                unsigned long const port{std::strtoul(item.c_str() + colon + 1, &end, 10)};
+                if (*end != '\0' || port == 0 || port > UINT16_MAX)
+                {
+                    throw std::runtime_error("Error: invalid port in '" + item + "'.");
+                }
+                endpoint.port = static_cast<uint16_t>(port);
+            }
+            if (endpoint.host.empty())
+            {
+                throw std::runtime_error("Error: missing host in '" + text + "'.");
+            }
+            endpoints.push_back(endpoint);
+            start = comma + 1;
+        }
+        return endpoints;
+    }
+};
+
+/**
+ * @brief A completed batch, as passed to a RemoteClient reply handler.
+ */
+struct RemoteReply
+{
+    size_t board;
+    uint32_t request_id;
+    RemoteStatus status;
+    uint32_t const *values; // One per completed op; valid only during the handler
+    size_t count;
+    std::chrono::nanoseconds latency; // From submit() to the reply being read
+};
+
+/**
+ * @brief One subscription sample, as passed to a RemoteClient sample handler.
+ */
+struct RemoteSample
+{
+    size_t board;
+    uint32_t subscription;
+    uint64_t timestamp_ns; // Server steady clock
+    uint32_t dropped;
+    uint32_t const *values; // Valid only during the handler
+    size_t count;
+};
+
+/**
+ * @brief Talks to any number of RegisterServers from one thread.
+ *
+ * submit() and subscribe() only queue the request; wait() and poll() run the
+ * epoll loop that sends queued requests to every board and dispatches replies
+ * and samples to their handlers as they arrive, so requests to different
+ * boards, and pipelined requests to the same board, overlap on the wire.
+ */
+class RemoteClient
+{
+public:
+    using ReplyHandler = std::function<void(RemoteReply const &)>;
+    using SampleHandler = std::function<void(RemoteSample const &)>;
+
+    /**
+     * @brief Connects to every board at once and waits for each one's Hello.
+     * @throws std::runtime_error If a board cannot be reached within 'connect_timeout' or speaks another protocol version.
+     */
+    explicit RemoteClient(std::vector<RemoteEndpoint> endpoints,
+                          std::chrono::milliseconds const connect_timeout = std::chrono::milliseconds(2000))
+        : m_endpoints(std::move(endpoints)), m_boards(m_endpoints.size())
+    {
+        m_epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+        if (m_epoll_fd == -1)
+        {
+            throw std::runtime_error("Error: could not create the client epoll instance.");
+        }
+        try
+        {
+            for (size_t board{0}; board < m_boards.size(); ++board)
+            {
+                start_connect(board);
+            }
+            auto const deadline{std::chrono::steady_clock::now() + connect_timeout};
+            while (m_ready < m_boards.size())
+            {
+                auto const left{std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now())};
+                if (left.count() <= 0)
+                {
+                    for (size_t board{0}; board < m_boards.size(); ++board)
+                    {
+                        if (!m_boards[board].ready)
+                        {
+                            throw std::runtime_error("Error: timed out connecting to " + m_endpoints[board].name() + ".");
+                        }
+                    }
+                }
+                poll(left);
+            }
+        }
+        catch (...)
+        {
+            close_all();
+            throw;
+        }
+    }
+
+    ~RemoteClient()
+    {
+        close_all();
+    }
+
+    RemoteClient(RemoteClient const &) = delete;
+    RemoteClient &operator=(RemoteClient const &) = delete;
+
+    [[nodiscard]] size_t boards() const
+    {
+        return m_boards.size();
+    }
+
+    [[nodiscard]] RemoteEndpoint const &endpoint(size_t const board) const
+    {
+        return m_endpoints[board];
+    }
+
+    /**
+     * @brief Requests awaiting a reply, on every board.
+     */
+    [[nodiscard]] size_t outstanding() const
+    {
+        return m_outstanding;
+    }
+
+    /**
+     * @brief Queues a batch for one board; 'handler' runs from wait()/poll() when it completes.
+     * @param poll_timeout How long the server lets each poll op wait.
+     * @return The batch's request ID.
+     */
+    uint32_t submit(size_t const board, std::vector<RegisterOp> const &ops, ReplyHandler handler,
+                    std::chrono::microseconds const poll_timeout = POLL_TIMEOUT)
+    {
+        std::vector<RemoteOpWire> wire(ops.size());
+        std::transform(ops.begin(), ops.end(), wire.begin(),
+                       [&](RegisterOp const &op) { return register_remote_detail::to_wire(op, poll_timeout); });
+        return send(board, RemoteMessage::Batch, static_cast<uint16_t>(ops.size()), wire.data(), wire.size() * sizeof(RemoteOpWire),
+                    std::move(handler));
+    }
+
+    /**
+     * @brief Asks one board to read 'reads' every 'interval' and push each result to 'handler'.
+     * @param samples How many samples to send (0 = until unsubscribe()); wait() waits for these.
+     * @return The subscription's ID, for unsubscribe().
+     */
+    uint32_t subscribe(size_t const board, std::vector<RegisterOp> const &reads, std::chrono::microseconds const interval,
+                       uint32_t const samples, SampleHandler handler)
+    {
+        std::vector<char> payload(sizeof(RemoteSubscribeWire) + reads.size() * sizeof(RemoteOpWire));
+        RemoteSubscribeWire const settings{static_cast<uint32_t>(interval.count()), samples};
+        std::memcpy(payload.data(), &settings, sizeof(settings));
+        for (size_t i{0}; i < reads.size(); ++i)
+        {
+            RemoteOpWire const wire{register_remote_detail::to_wire(reads[i], std::chrono::microseconds(0))};
+            std::memcpy(payload.data() + sizeof(settings) + i * sizeof(wire), &wire, sizeof(wire));
+        }
+        uint32_t const id{send(board, RemoteMessage::Subscribe, static_cast<uint16_t>(reads.size()), payload.data(), payload.size(),
+                               [this](RemoteReply const &reply)
+                               {
+                                   if (reply.status != RemoteStatus::Ok)
+                                   {
+                                       std::cerr << "[ERROR] " << m_endpoints[reply.board].name() << " refused subscription "
+                                                 << reply.request_id << "." << std::endl;
+                                       drop_subscription(reply.board, reply.request_id);
+                                   }
+                               })};
+        m_boards[board].subscriptions.emplace(id, SubscriptionState{std::move(handler), samples});
+        m_waiting_samples += samples;
+        return id;
+    }
+
+    /**
+     * @brief Stops a subscription; samples already on the wire are discarded.
+     */
+    void unsubscribe(size_t const board, uint32_t const subscription)
+    {
+        drop_subscription(board, subscription);
+        send(board, RemoteMessage::Unsubscribe, 0, &subscription, sizeof(subscription), nullptr);
+    }
+
+    /**
+     * @brief Runs the event loop until every request is answered and every
+     * counted subscription has delivered its samples.
+     * @return False if 'timeout' passed first.
+     */
+    bool wait(std::chrono::milliseconds const timeout = std::chrono::milliseconds(10000))
+    {
+        auto const deadline{std::chrono::steady_clock::now() + timeout};
+        while (m_outstanding != 0 || m_waiting_samples != 0)
+        {
+            auto const left{std::chrono::duration_cast<std::chrono::milliseconds>(deadline - std::chrono::steady_clock::now())};
+            if (left.count() <= 0)
+            {
+                return false;
+            }
+            poll(left);
+        }
+        return true;
+    }
+
+    /**
+     * @brief One pass of the event loop: sends what it can, then handles what arrived within 'timeout'.
+     * @throws std::runtime_error If a board disconnects or sends a malformed message.
+     */
+    void poll(std::chrono::milliseconds const timeout)
+    {
+        flush_boards();
+        std::array<epoll_event, 64> events;
+        int const ready{epoll_wait(m_epoll_fd, events.data(), static_cast<int>(events.size()), static_cast<int>(timeout.count()))};
+        if (ready < 0 && errno != EINTR)
+        {
+            throw std::runtime_error(std::string("Error: epoll_wait failed: ") + std::strerror(errno));
+        }
+        for (int i{0}; i < ready; ++i)
+        {
+            size_t const board{static_cast<size_t>(events[static_cast<size_t>(i)].data.u64)};
+            uint32_t const flags{events[static_cast<size_t>(i)].events};
+            Board &state{m_boards[board]};
+            if (!state.connected)
+            {
+                finish_connect(board, flags);
+                continue;
+            }
+            bool alive{!(flags & (EPOLLERR | EPOLLHUP))};
+            if (flags & EPOLLIN)
+            {
+                alive = state.stream.fill() && alive;
+                if (!state.stream.parse([&](RemoteHeader const &header, char const *payload) { dispatch(board, header, payload); }))
+                {
+                    throw std::runtime_error("Error: " + m_endpoints[board].name() + " sent an oversized message.");
+                }
+            }
+            if (!alive)
+            {
+                throw std::runtime_error("Error: lost connection to " + m_endpoints[board].name() + ".");
+            }
+        }
+        flush_boards();
+    }
+
+private:
+    using Clock = std::chrono::steady_clock;
+
+    struct SubscriptionState
+    {
+        SampleHandler handler;
+        uint32_t remaining; // 0 = until unsubscribed
+    };
+
+    struct PendingRequest
+    {
+        ReplyHandler handler;
+        Clock::time_point sent;
+    };
+
+    struct Board
+    {
+        register_remote_detail::Stream stream;
+        bool connected{false}; // TCP connection established
+        bool ready{false};     // Hello received
+        uint32_t next_id{1};
+        std::unordered_map<uint32_t, PendingRequest> pending;
+        std::unordered_map<uint32_t, SubscriptionState> subscriptions;
+    };
+
+    std::vector<RemoteEndpoint> const m_endpoints;
+    std::vector<Board> m_boards;
+    int m_epoll_fd{-1};
+    size_t m_ready{0};
+    size_t m_outstanding{0};
+    uint64_t m_waiting_samples{0};
+    std::vector<uint32_t> m_values;
+
+    void close_all()
+    {
+        for (Board &board : m_boards)
+        {
+            if (board.stream.fd != -1)
+            {
+                close(board.stream.fd);
+                board.stream.fd = -1;
+            }
+        }
+        if (m_epoll_fd != -1)
+        {
+            close(m_epoll_fd);
+            m_epoll_fd = -1;
+        }
+    }
+
+    void start_connect(size_t const board)
+    {
+        RemoteEndpoint const &endpoint{m_endpoints[board]};
+        addrinfo hints{};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo *addresses{nullptr};
+        int const resolved{getaddrinfo(endpoint.host.c_str(), std::to_string(endpoint.port).c_str(), &hints, &addresses)};
+        if (resolved != 0)
+        {
+            throw std::runtime_error("Error: could not resolve " + endpoint.name() + ": " + gai_strerror(resolved));
+        }
+        int const fd{socket(AF_INET, SOCK_STREAM | SOCK_NONBLOCK | SOCK_CLOEXEC, 0)};
+        int const connected{fd == -1 ? -1 : connect(fd, addresses->ai_addr, addresses->ai_addrlen)};
+        freeaddrinfo(addresses);
+        if (fd == -1 || (connected == -1 && errno != EINPROGRESS))
+        {
+            std::string const reason{std::strerror(errno)};
+            if (fd != -1)
+            {
+                close(fd);
+            }
+            throw std::runtime_error("Error: could not connect to " + endpoint.name() + ": " + reason);
+        }
+        register_remote_detail::set_nodelay(fd);
+        m_boards[board].stream.fd = fd;
+
+        // Writable once the connection completes; after that only input is watched until output queues up
+        epoll_event event{};
+        event.events = EPOLLOUT;
+        event.data.u64 = board;
+        epoll_ctl(m_epoll_fd, EPOLL_CTL_ADD, fd, &event);
+    }
+
+    void finish_connect(size_t const board, uint32_t const flags)
+    {
+        Board &state{m_boards[board]};
+        int error{0};
+        socklen_t length{sizeof(error)};
+        getsockopt(state.stream.fd, SOL_SOCKET, SO_ERROR, &error, &length);
+        if (error != 0 || (flags & EPOLLERR))
+        {
+            throw std::runtime_error("Error: could not connect to " + m_endpoints[board].name() + ": " + std::strerror(error));
+        }
+        state.connected = true;
+        state.stream.events = EPOLLOUT; // As registered by connect()
+        state.stream.update_interest(m_epoll_fd, board);
+    }
+
+    uint32_t send(size_t const board, RemoteMessage const type, uint16_t const count, void const *const payload, size_t const bytes,
+                  ReplyHandler handler)
+    {
+        if (bytes > REMOTE_MAX_PAYLOAD)
+        {
+            throw std::runtime_error("Error: request of " + std::to_string(bytes) + " bytes is too large to send.");
+        }
+        Board &state{m_boards[board]};
+        uint32_t const id{state.next_id++};
+        register_remote_detail::append_message(
+            state.stream.out, RemoteHeader{static_cast<uint32_t>(bytes), id, static_cast<uint8_t>(type), 0, count}, payload);
+        state.pending.emplace(id, PendingRequest{std::move(handler), Clock::now()});
+        ++m_outstanding;
+        return id;
+    }
+
+    void drop_subscription(size_t const board, uint32_t const subscription)
+    {
+        auto &subscriptions{m_boards[board].subscriptions};
+        auto const found{subscriptions.find(subscription)};
+        if (found != subscriptions.end())
+        {
+            m_waiting_samples -= found->second.remaining;
+            subscriptions.erase(found);
+        }
+    }
+
+    void flush_boards()
+    {
+        for (size_t board{0}; board < m_boards.size(); ++board)
+        {
+            Board &state{m_boards[board]};
+            if (!state.connected || state.stream.queued() == 0)
+            {
+                continue;
+            }
+            if (!state.stream.flush())
+            {
+                throw std::runtime_error("Error: lost connection to " + m_endpoints[board].name() + ".");
+            }
+            state.stream.update_interest(m_epoll_fd, board);
+        }
+    }
+
+    // Copies 'count' values out of a payload, which need not be 4-byte aligned
+    uint32_t const *copy_values(char const *const payload, size_t const count)
+    {
+        m_values.resize(count);
+        std::memcpy(m_values.data(), payload, count * sizeof(uint32_t));
+        return m_values.data();
+    }
+
+    void dispatch(size_t const board, RemoteHeader const &header, char const *const payload)
+    {
+        Board &state{m_boards[board]};
+        auto const type{static_cast<RemoteMessage>(header.type)};
+        if (type == RemoteMessage::Hello)
+        {
+            if (header.count != REMOTE_PROTOCOL_VERSION)
+            {
+                throw std::runtime_error("Error: " + m_endpoints[board].name() + " speaks protocol version " +
+                                         std::to_string(header.count) + ", expected " + std::to_string(REMOTE_PROTOCOL_VERSION) + ".");
+            }
+            state.ready = true;
+            ++m_ready;
+            return;
+        }
+        if (type == RemoteMessage::Sample)
+        {
+            auto const found{state.subscriptions.find(header.request_id)};
+            if (found == state.subscriptions.end() || header.bytes != sizeof(RemoteSampleWire) + header.count * sizeof(uint32_t))
+            {
+                return;
+            }
+            RemoteSampleWire sample;
+            std::memcpy(&sample, payload, sizeof(sample));
+            // Copied first, since the handler may unsubscribe
+            SampleHandler const handler{found->second.handler};
+            if (found->second.remaining != 0)
+            {
+                --m_waiting_samples;
+                if (--found->second.remaining == 0)
+                {
+                    state.subscriptions.erase(found);
+                }
+            }
+            if (handler)
+            {
+                handler(RemoteSample{board, header.request_id, sample.timestamp_ns, sample.dropped,
+                                     copy_values(payload + sizeof(sample), header.count), header.count});
+            }
+            return;
+        }
+
+        auto const found{state.pending.find(header.request_id)};
+        if (found == state.pending.end())
+        {
+            return;
+        }
+        PendingRequest const request{std::move(found->second)};
+        state.pending.erase(found);
+        --m_outstanding;
+        if (request.handler)
+        {
+            size_t const count{std::min<size_t>(header.count, header.bytes / sizeof(uint32_t))};
+            request.handler(RemoteReply{board, header.request_id, static_cast<RemoteStatus>(header.status), copy_values(payload, count),
+                                        count, Clock::now() - request.sent});
+        }
+    }
+};
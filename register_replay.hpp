@@ -0,0 +1,134 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+
+#include "register_manager.hpp"
+#include "register_ops.hpp"
+#include "register_trace.hpp"
+
+/**
+ * @brief Outcome of replaying a trace.
+ */
+struct ReplayResult
+{
+    uint64_t reads{0};
+    uint64_t writes{0};
+    uint64_t mismatches{0};                     // Reads that returned a different value than recorded
+    std::chrono::nanoseconds elapsed{0};
+    std::chrono::nanoseconds max_lateness{0};   // Worst delay past a record's scheduled time
+    std::chrono::nanoseconds total_lateness{0};
+};
+
+/**
+ * @brief Re-executes a recorded trace against open mappings.
+ *
+ * Each record is issued at its recorded timestamp multiplied by 'time_scale':
+ * 1 preserves the original pacing, values below 1 compress it, and 0 issues
+ * records back-to-back to measure the access layer alone. Reads are compared
+ * against the recorded value; the first 'report_limit' mismatches are printed.
+ *
+ * @param trace The trace to replay.
+ * @param regions The open mapping for each region; every region in the trace must be among them.
+ * @param time_scale Multiplier applied to the recorded inter-access timing.
+ * @param report_limit How many mismatching reads to print.
+ * @return Counts and timing for the replay.
+ */
+inline ReplayResult replay_trace(TraceReader const &trace, RegisterRegions const &regions, double const time_scale,
+                                 unsigned const report_limit = 10)
+{
+    // Resolve the trace's region ids to this run's mappings by physical base
+    TraceHeader const &header{trace.header()};
+    std::array<RegisterManager const *, TraceHeader::MAX_REGIONS> managers{};
+    for (uint32_t id{0}; id < header.region_count; ++id)
+    {
+        auto const match{std::find_if(regions.begin(), regions.end(), [&](RegisterManager const *manager)
+                                      { return manager->physicalBase() == header.region_bases[id]; })};
+        if (match == regions.end())
+        {
+            std::ostringstream message;
+            message << "Error: trace region 0x" << std::hex << header.region_bases[id] << " is not mapped.";
+            throw std::runtime_error(message.str());
+        }
+        managers[id] = *match;
+    }
+
+    TraceRecord const *const records{trace.records()};
+    uint64_t const count{trace.size()};
+    for (uint64_t index{0}; index < count; ++index)
+    {
+        if (records[index].region >= header.region_count || records[index].offset % sizeof(uint32_t) != 0 ||
+            records[index].offset >= MAP_SIZE)
+        {
+            throw std::runtime_error("Error: trace record " + std::to_string(index) + " addresses an invalid register.");
+        }
+    }
+
+    ReplayResult result{};
+    bool const paced{time_scale > 0};
+    uint64_t const first_timestamp{count ? records[0].timestamp_ns : 0};
+    auto const start{std::chrono::steady_clock::now()};
+    for (uint64_t index{0}; index < count; ++index)
+    {
+        TraceRecord const &record{records[index]};
+        if (paced)
+        {
+            auto const due{start + std::chrono::nanoseconds{static_cast<int64_t>((record.timestamp_ns - first_timestamp) * time_scale)}};
+            auto const now{std::chrono::steady_clock::now()};
+            if (now < due)
+            {
+                wait_until(due);
+            }
+            else
+            {
+                auto const late{std::chrono::duration_cast<std::chrono::nanoseconds>(now - due)};
+                result.max_lateness = std::max(result.max_lateness, late);
+                result.total_lateness += late;
+            }
+        }
+
+        RegisterManager const &manager{*managers[record.region]};
+        if (record.kind == TraceRecord::WRITE)
+        {
+            manager.writeOffset(record.offset, record.value);
+            ++result.writes;
+            continue;
+        }
+
+        uint32_t const value{manager.readOffset(record.offset)};
+        ++result.reads;
+        if (value != record.value && result.mismatches++ < report_limit)
+        {
+            std::cout << "[REPLAY] Record " << index << ": base 0x" << std::hex << header.region_bases[record.region] << " + 0x"
+                      << record.offset << " read 0x" << std::setw(8) << std::setfill('0') << value << ", recorded 0x" << std::setw(8)
+                      << record.value << std::dec << std::endl;
+        }
+    }
+    result.elapsed = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - start);
+    return result;
+}
+
+/**
+ * @brief Prints a replay summary: throughput, pacing error and read mismatches.
+ */
+inline void print_replay_report(ReplayResult const &result, double const time_scale, std::ostream &stream)
+{
+    uint64_t const accesses{result.reads + result.writes};
+    double const seconds{std::chrono::duration<double>(result.elapsed).count()};
+    stream << "[REPLAY] " << accesses << " accesses (" << result.reads << " reads, " << result.writes << " writes) in " << std::fixed
+           << std::setprecision(3) << seconds * 1e3 << " ms (" << (seconds > 0 ? accesses / seconds / 1e6 : 0.0) << " Mops/s)\n";
+    if (time_scale > 0 && accesses != 0)
+    {
+        stream << "[REPLAY] Timing x" << time_scale << ": mean lateness " << std::setprecision(2)
+               << result.total_lateness.count() / 1e3 / accesses << " us, max " << result.max_lateness.count() / 1e3 << " us\n";
+    }
+    stream << "[REPLAY] " << result.mismatches << " of " << result.reads << " reads differed from the recording" << std::defaultfloat
+           << std::endl;
+}
@@ -0,0 +1,275 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cerrno>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <queue>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+#include <sys/prctl.h>
+#include <time.h>
+
+#include "cpu_topology.hpp"
+#include "register_manager.hpp"
+#include "register_ops.hpp"
+
+/**
+ * @brief One register to sample, and how often.
+ */
+struct SampleSpec
+{
+    RegisterOp target;     // Region, offset and name of the register
+    uint64_t period_ns;
+};
+
+/**
+ * @brief Parses REGION:REG@HZ (e.g. "APB:SYS_FAN_SPEED@10") into a sample spec.
+ */
+[[nodiscard]] inline SampleSpec parse_sample_spec(std::string const &text)
+{
+    size_t const at{text.rfind('@')};
+    if (at == std::string::npos)
+    {
+        throw std::runtime_error("Error: expected REGION:REG@HZ, got '" + text + "'.");
+    }
+    char *end{nullptr};
+    std::string const rate{text.substr(at + 1)};
+    double const hz{std::strtod(rate.c_str(), &end)};
+    if (rate.empty() || *end != '\0' || !(hz > 0) || hz > 1e6)
+    {
+        throw std::runtime_error("Error: invalid sample rate '" + rate + "' (expected 0 < HZ <= 1000000).");
+    }
+
+    SampleSpec spec{};
+    spec.target.kind = RegisterOp::Kind::Read;
+    register_ops_detail::parse_target(text.substr(0, at), spec.target);
+    spec.period_ns = static_cast<uint64_t>(std::llround(1e9 / hz));
+    return spec;
+}
+
+/**
+ * @brief Samples registers at independent rates from one thread, earliest deadline first.
+ *
+ * Deadlines are kept in a min-heap and the thread sleeps to the earliest with
+ * clock_nanosleep(TIMER_ABSTIME), so sleeping never accumulates drift. Every
+ * register falling due by the time the thread wakes is read in the same pass,
+ * grouped by region so each mapping is touched once per pass. A register
+ * whose next deadline has already passed skips the missed periods rather
+ * than bursting to catch up, and each skip is counted as a missed deadline.
+ */
+class RegisterSampler
+{
+public:
+    /**
+     * @brief Per-register scheduling statistics.
+     */
+    struct Stats
+    {
+        uint64_t samples{0};
+        uint64_t missed{0};         // Deadlines skipped because an earlier one ran too late
+        uint64_t total_late_ns{0};  // Sum of (read time - deadline)
+        uint64_t max_late_ns{0};
+        std::array<uint64_t, 32> late_histogram{}; // Bucket k counts lateness in [2^(k-1), 2^k) ns
+        uint32_t last_value{0};
+        uint64_t changes{0};        // Samples that differed from the previous one
+    };
+
+    /**
+     * @brief Whole-run statistics.
+     */
+    struct Report
+    {
+        std::vector<Stats> stats;   // One per spec, in spec order
+        uint64_t elapsed_ns{0};
+        uint64_t busy_ns{0};        // Time spent reading registers
+        uint64_t passes{0};         // Wake-ups that read at least one register
+    };
+
+    /**
+     * @brief Constructor: Validates the specs against the open mappings.
+     * @param specs The registers to sample.
+     * @param regions The open mapping for each region.
+     */
+    RegisterSampler(std::vector<SampleSpec> specs, RegisterRegions const &regions) : m_specs(std::move(specs)), m_regions(regions)
+    {
+        if (m_specs.empty())
+        {
+            throw std::runtime_error("Error: no registers to sample.");
+        }
+        for (auto const &spec : m_specs)
+        {
+            if (!m_regions[static_cast<size_t>(spec.target.region)])
+            {
+                throw std::runtime_error("Error: sampled region is not mapped.");
+            }
+        }
+    }
+
+    /**
+     * @brief Samples every register for 'duration_ns' on a dedicated thread.
+     * @param duration_ns How long to sample.
+     * @param cpu The CPU to pin the sampling thread to, or -1 to leave it unpinned.
+     * @param sink Called as sink(spec_index, timestamp_ns, value) for every sample, on the sampling thread.
+     * @return The scheduling statistics.
+     */
+    template <typename Sink>
+    Report run(uint64_t const duration_ns, int const cpu, Sink &&sink) const
+    {
+        Report report;
+        std::thread sampler([&]
+        {
+            // The default 50us timer slack would otherwise dominate the measured jitter
+            prctl(PR_SET_TIMERSLACK, 1UL);
+            if (cpu >= 0 && !CpuTopology::pin_current_thread(static_cast<unsigned>(cpu)))
+            {
+                std::cerr << "[WARN] Could not pin the sampler to CPU " << cpu << std::endl;
+            }
+            report = sample(duration_ns, sink);
+        });
+        sampler.join();
+        return report;
+    }
+
+    /**
+     * @brief Prints per-register rate, lateness percentiles, missed deadlines and value changes, plus the thread's load.
+     */
+    void print_report(Report const &report, std::ostream &stream) const
+    {
+        double const seconds{report.elapsed_ns / 1e9};
+        stream << "[SAMPLE] " << report.passes << " passes in " << std::fixed << std::setprecision(3) << seconds << " s, sampler busy "
+               << std::setprecision(2) << (report.elapsed_ns ? 100.0 * report.busy_ns / report.elapsed_ns : 0.0) << "% reading\n";
+        stream << std::left << std::setw(29) << "[SAMPLE] register" << std::right << std::setw(10) << "target Hz" << std::setw(10)
+               << "actual Hz" << std::setw(9) << "missed" << std::setw(11) << "mean us" << std::setw(11) << "p99 us" << std::setw(11)
+               << "max us" << std::setw(10) << "changes" << std::setw(12) << "last" << '\n';
+        for (size_t index{0}; index < m_specs.size(); ++index)
+        {
+            Stats const &stats{report.stats[index]};
+            std::ostringstream target;
+            target << m_specs[index].target;
+            stream << "[SAMPLE] " << std::left << std::setw(20) << target.str() << std::right << std::setprecision(1) << std::setw(10)
+                   << 1e9 / m_specs[index].period_ns << std::setw(10) << (seconds > 0 ? stats.samples / seconds : 0.0) << std::setw(9)
+                   << stats.missed << std::setprecision(2) << std::setw(11)
+                   << (stats.samples ? stats.total_late_ns / 1e3 / stats.samples : 0.0) << std::setw(11)
+                   << late_percentile(stats, 0.99) / 1e3 << std::setw(11) << stats.max_late_ns / 1e3 << std::setw(10)
+                   << stats.changes << "  0x" << std::hex
+                   << std::setw(8) << std::setfill('0') << stats.last_value << std::setfill(' ') << std::dec << '\n';
+        }
+        stream << std::defaultfloat << std::flush;
+    }
+
+private:
+    std::vector<SampleSpec> const m_specs;
+    RegisterRegions const m_regions;
+
+    struct Due
+    {
+        uint64_t deadline_ns;
+        uint32_t spec;
+
+        bool operator>(Due const &other) const
+        {
+            return deadline_ns != other.deadline_ns ? deadline_ns > other.deadline_ns : spec > other.spec;
+        }
+    };
+
+    [[nodiscard]] static uint64_t now_ns()
+    {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000 + static_cast<uint64_t>(ts.tv_nsec);
+    }
+
+    static void sleep_until_ns(uint64_t const deadline_ns)
+    {
+        timespec const ts{static_cast<time_t>(deadline_ns / 1'000'000'000), static_cast<long>(deadline_ns % 1'000'000'000)};
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, nullptr) == EINTR)
+        {
+        }
+    }
+
+    // Upper bound of the histogram bucket holding the given fraction of samples
+    [[nodiscard]] static uint64_t late_percentile(Stats const &stats, double const fraction)
+    {
+        uint64_t const wanted{static_cast<uint64_t>(std::ceil(stats.samples * fraction))};
+        uint64_t seen{0};
+        for (unsigned bucket{0}; bucket < stats.late_histogram.size(); ++bucket)
+        {
+            seen += stats.late_histogram[bucket];
+            if (seen >= wanted && wanted != 0)
+            {
+                return std::min(stats.max_late_ns, uint64_t{1} << bucket);
+            }
+        }
+        return stats.max_late_ns;
+    }
+
+    template <typename Sink>
+    Report sample(uint64_t const duration_ns, Sink &sink) const
+    {
+        Report report;
+        report.stats.resize(m_specs.size());
+
+        // Every register's first deadline is one period after a common start
+        std::priority_queue<Due, std::vector<Due>, std::greater<Due>> heap;
+        uint64_t const start{now_ns()};
+        uint64_t const stop{start + duration_ns};
+        for (uint32_t index{0}; index < m_specs.size(); ++index)
+        {
+            heap.push(Due{start + m_specs[index].period_ns, index});
+        }
+
+        std::vector<Due> batch;
+        batch.reserve(m_specs.size());
+        while (heap.top().deadline_ns <= stop)
+        {
+            sleep_until_ns(heap.top().deadline_ns);
+
+            // Take everything due by now, then read it one region at a time
+            uint64_t const woke{now_ns()};
+            batch.clear();
+            while (!heap.empty() && heap.top().deadline_ns <= woke)
+            {
+                batch.push_back(heap.top());
+                heap.pop();
+            }
+            std::stable_sort(batch.begin(), batch.end(), [&](Due const &a, Due const &b)
+                             { return m_specs[a.spec].target.region < m_specs[b.spec].target.region; });
+
+            for (Due const &due : batch)
+            {
+                SampleSpec const &spec{m_specs[due.spec]};
+                uint32_t const value{m_regions[static_cast<size_t>(spec.target.region)]->readOffset(spec.target.offset)};
+                uint64_t const read_ns{now_ns()};
+                sink(due.spec, read_ns, value);
+
+                Stats &stats{report.stats[due.spec]};
+                uint64_t const late{read_ns - due.deadline_ns};
+                stats.changes += stats.samples != 0 && value != stats.last_value;
+                stats.last_value = value;
+                ++stats.samples;
+                stats.total_late_ns += late;
+                stats.max_late_ns = std::max(stats.max_late_ns, late);
+                ++stats.late_histogram[std::min<size_t>(late ? 64 - __builtin_clzll(late) : 0, stats.late_histogram.size() - 1)];
+
+                // Skip, rather than replay, any periods that have already gone by
+                uint64_t const skipped{late / spec.period_ns};
+                stats.missed += skipped;
+                heap.push(Due{due.deadline_ns + (skipped + 1) * spec.period_ns, due.spec});
+            }
+            report.busy_ns += now_ns() - woke;
+            ++report.passes;
+        }
+        report.elapsed_ns = now_ns() - start;
+        return report;
+    }
+};
@@ -0,0 +1,445 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <map>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "register_manager.hpp"
+#include "register_ops.hpp"
+
+/**
+ * @brief A register transaction script compiled to a flat op stream.
+ *
+ * Source is line based; '#' starts a comment:
+ *
+ *   LABEL:                               marks a loop target
+ *   read REGION:REG                      read a register (value kept for the report)
+ *   write REGION:REG=VALUE               write a register
+ *   poll REGION:REG[&MASK]==VALUE [US]   wait for a condition (or !=VALUE), default 1s timeout
+ *   delay US                             wait (spins below WAIT_SPIN_LIMIT, sleeps above)
+ *   loop LABEL COUNT                     run the ops from LABEL to here COUNT times in total
+ *
+ * Register targets use the same syntax as the command-line operations. The
+ * compiled form can be saved and loaded again, so long bring-up sequences are
+ * parsed once. It is executed by a direct-threaded interpreter: each op holds
+ * the address of its handler, and each handler jumps straight to the next.
+ */
+class RegisterScript
+{
+public:
+    enum class Opcode : uint8_t
+    {
+        Read,
+        Write,
+        PollEqual,
+        PollNotEqual,
+        Delay,
+        Loop,
+        Halt
+    };
+
+    /**
+     * @brief One compiled op. Operand meaning depends on the opcode:
+     *   Write: a = value
+     *   Poll*: a = mask, b = value, c = timeout in microseconds
+     *   Delay: a = microseconds
+     *   Loop:  a = target op, b = iteration count, c = loop counter slot
+     */
+    struct Op
+    {
+        Opcode opcode;
+        RegisterRegion region;
+        uint16_t offset;
+        uint32_t a;
+        uint32_t b;
+        uint32_t c;
+    };
+    static_assert(sizeof(Op) == 16, "compiled ops are stored as 16-byte records");
+
+    /**
+     * @brief Per-op measurements, filled when a script runs with timing enabled.
+     */
+    struct OpStats
+    {
+        uint64_t count{0};
+        uint64_t total_ns{0};
+        uint64_t max_ns{0};
+        uint32_t last_value{0};
+    };
+
+    struct Result
+    {
+        bool completed{false};
+        size_t failed_op{0};
+        uint32_t failed_value{0};
+        uint64_t ops_executed{0};
+        std::chrono::nanoseconds elapsed{0};
+    };
+
+    /**
+     * @brief Compiles script source.
+     * @param source The script text.
+     * @param name Name used in error messages.
+     */
+    static RegisterScript compile(std::istream &source, std::string const &name)
+    {
+        RegisterScript script;
+        std::map<std::string, uint32_t> labels;
+        std::string line;
+        uint32_t line_number{0};
+
+        auto const fail{[&](std::string const &message)
+        {
+            throw std::runtime_error("Error: " + name + ":" + std::to_string(line_number) + ": " + message);
+        }};
+
+        while (std::getline(source, line))
+        {
+            ++line_number;
+            line = line.substr(0, line.find('#'));
+            std::istringstream tokens{line};
+            std::string verb;
+            if (!(tokens >> verb))
+            {
+                continue;
+            }
+
+            std::vector<std::string> args;
+            for (std::string arg; tokens >> arg;)
+            {
+                args.push_back(arg);
+            }
+
+            Op op{};
+            if (verb.back() == ':' && args.empty())
+            {
+                verb.pop_back();
+                if (!labels.emplace(verb, static_cast<uint32_t>(script.m_ops.size())).second)
+                {
+                    fail("duplicate label '" + verb + "'");
+                }
+                continue;
+            }
+            else if (verb == "read" || verb == "write" || verb == "poll")
+            {
+                if (args.empty() || args.size() > (verb == "poll" ? 2u : 1u))
+                {
+                    fail("wrong number of operands for '" + verb + "'");
+                }
+                RegisterOp parsed{};
+                try
+                {
+                    char *argv[]{verb.data(), args[0].data()};
+                    parsed = parse_register_ops(2, argv).front();
+                }
+                catch (std::runtime_error const &e)
+                {
+                    // Drop the "Error: " prefix, fail() adds its own
+                    fail(std::string(e.what()).substr(std::strlen("Error: ")));
+                }
+                op.region = parsed.region;
+                op.offset = parsed.offset;
+                switch (parsed.kind)
+                {
+                case RegisterOp::Kind::Read:
+                    op.opcode = Opcode::Read;
+                    break;
+                case RegisterOp::Kind::Write:
+                    op.opcode = Opcode::Write;
+                    op.a = parsed.value;
+                    break;
+                case RegisterOp::Kind::PollEqual:
+                case RegisterOp::Kind::PollNotEqual:
+                    op.opcode = parsed.kind == RegisterOp::Kind::PollEqual ? Opcode::PollEqual : Opcode::PollNotEqual;
+                    op.a = parsed.mask;
+                    op.b = parsed.value;
+                    op.c = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::microseconds>(POLL_TIMEOUT).count());
+                    if (args.size() == 2)
+                    {
+                        op.c = parse_number(args[1], fail);
+                    }
+                    break;
+                }
+            }
+            else if (verb == "delay")
+            {
+                if (args.size() != 1)
+                {
+                    fail("expected 'delay US'");
+                }
+                op.opcode = Opcode::Delay;
+                op.a = parse_number(args[0], fail);
+            }
+            else if (verb == "loop")
+            {
+                if (args.size() != 2)
+                {
+                    fail("expected 'loop LABEL COUNT'");
+                }
+                auto const label{labels.find(args[0])};
+                if (label == labels.end())
+                {
+                    fail("loop target '" + args[0] + "' must be a label defined above the loop");
+                }
+                op.opcode = Opcode::Loop;
+                op.a = label->second;
+                op.b = parse_number(args[1], fail);
+                op.c = script.m_loop_count++;
+                if (op.b == 0)
+                {
+                    fail("loop count must be at least 1");
+                }
+            }
+            else
+            {
+                fail("unknown operation '" + verb + "'");
+            }
+            script.m_ops.push_back(op);
+            script.m_lines.push_back(line_number);
+        }
+
+        Op halt{};
+        halt.opcode = Opcode::Halt;
+        script.m_ops.push_back(halt);
+        script.m_lines.push_back(line_number);
+        return script;
+    }
+
+    /**
+     * @brief Loads a script from a file holding either source or a saved compiled script.
+     */
+    static RegisterScript load(std::string const &path)
+    {
+        std::ifstream file(path, std::ios::binary);
+        if (!file)
+        {
+            throw std::runtime_error("Error: could not open script '" + path + "'.");
+        }
+
+        char magic[sizeof(MAGIC)]{};
+        file.read(magic, sizeof(magic));
+        if (file.gcount() != sizeof(magic) || std::memcmp(magic, MAGIC, sizeof(magic)) != 0)
+        {
+            file.clear();
+            file.seekg(0);
+            return compile(file, path);
+        }
+
+        RegisterScript script;
+        uint32_t header[3]{};
+        file.read(reinterpret_cast<char *>(header), sizeof(header));
+        if (!file || header[0] != VERSION || header[1] == 0)
+        {
+            throw std::runtime_error("Error: '" + path + "' is not a compiled script of version " + std::to_string(VERSION) + ".");
+        }
+        script.m_ops.resize(header[1]);
+        script.m_lines.resize(header[1]);
+        script.m_loop_count = header[2];
+        file.read(reinterpret_cast<char *>(script.m_ops.data()), static_cast<std::streamsize>(header[1] * sizeof(Op)));
+        file.read(reinterpret_cast<char *>(script.m_lines.data()), static_cast<std::streamsize>(header[1] * sizeof(uint32_t)));
+        if (!file)
+        {
+            throw std::runtime_error("Error: compiled script '" + path + "' is truncated.");
+        }
+        script.validate(path);
+        return script;
+    }
+
+    /**
+     * @brief Saves the compiled script (host byte order) for later runs.
+     */
+    void save(std::string const &path) const
+    {
+        std::ofstream file(path, std::ios::binary | std::ios::trunc);
+        uint32_t const header[3]{VERSION, static_cast<uint32_t>(m_ops.size()), m_loop_count};
+        file.write(MAGIC, sizeof(MAGIC));
+        file.write(reinterpret_cast<char const *>(header), sizeof(header));
+        file.write(reinterpret_cast<char const *>(m_ops.data()), static_cast<std::streamsize>(m_ops.size() * sizeof(Op)));
+        file.write(reinterpret_cast<char const *>(m_lines.data()), static_cast<std::streamsize>(m_lines.size() * sizeof(uint32_t)));
+        if (!file)
+        {
+            throw std::runtime_error("Error: could not write compiled script '" + path + "'.");
+        }
+    }
+
+    /**
+     * @brief Runs the script to completion or to the first failed poll.
+     * @param regions The open mapping for each region.
+     * @param stats When non-null, receives per-op timing (one entry per op). Timing
+     *              adds a clock read per op, so leave it off to measure throughput.
+     */
+    Result run(RegisterRegions const &regions, std::vector<OpStats> *stats = nullptr) const
+    {
+        if (stats)
+        {
+            stats->assign(m_ops.size(), OpStats{});
+            return execute<true>(regions, stats->data());
+        }
+        return execute<false>(regions, nullptr);
+    }
+
+    [[nodiscard]] size_t size() const
+    {
+        return m_ops.size();
+    }
+
+    [[nodiscard]] uint32_t line(size_t const op) const
+    {
+        return m_lines[op];
+    }
+
+    /**
+     * @brief Prints per-op timing gathered by run().
+     */
+    void print_report(std::vector<OpStats> const &stats, std::ostream &out) const
+    {
+        static constexpr char const *OPCODE_NAMES[]{"read", "write", "poll==", "poll!=", "delay", "loop", "halt"};
+        out << "  op  line  opcode       count     avg ns     max ns  last value\n";
+        for (size_t i{0}; i + 1 < m_ops.size(); ++i)
+        {
+            OpStats const &op_stats{stats[i]};
+            out << std::setw(4) << i << std::setw(6) << m_lines[i] << "  " << std::left << std::setw(8)
+                << OPCODE_NAMES[static_cast<size_t>(m_ops[i].opcode)] << std::right << std::setw(10) << op_stats.count
+                << std::setw(11) << (op_stats.count ? op_stats.total_ns / op_stats.count : 0) << std::setw(11) << op_stats.max_ns;
+            if (m_ops[i].opcode == Opcode::Read || m_ops[i].opcode == Opcode::PollEqual || m_ops[i].opcode == Opcode::PollNotEqual)
+            {
+                out << "  0x" << std::hex << std::setw(8) << std::setfill('0') << op_stats.last_value << std::dec << std::setfill(' ');
+            }
+            out << '\n';
+        }
+        out << std::flush;
+    }
+
+private:
+    static constexpr char MAGIC[4]{'R', 'G', 'S', 'C'};
+    static constexpr uint32_t VERSION{1};
+
+    std::vector<Op> m_ops;
+    std::vector<uint32_t> m_lines; // Source line of each op, for reports
+    uint32_t m_loop_count{0};
+
+    template <typename Fail>
+    static uint32_t parse_number(std::string const &text, Fail const &fail)
+    {
+        char *end{nullptr};
+        unsigned long long const value{std::strtoull(text.c_str(), &end, 0)};
+        if (text.empty() || *end != '\0' || value > UINT32_MAX)
+        {
+            fail("invalid number '" + text + "'");
+        }
+        return static_cast<uint32_t>(value);
+    }
+
+    // Compiled files come from disk, so check every field the interpreter trusts
+    void validate(std::string const &path) const
+    {
+        for (size_t i{0}; i < m_ops.size(); ++i)
+        {
+            Op const &op{m_ops[i]};
+            bool const bad_target{static_cast<size_t>(op.region) >= REGISTER_REGION_NAMES.size() || op.offset >= MAP_SIZE || op.offset % 4 != 0};
+            bool const bad_loop{op.opcode == Opcode::Loop && (op.a > i || op.c >= m_loop_count || op.b == 0)};
+            if (op.opcode > Opcode::Halt || bad_target || bad_loop)
+            {
+                throw std::runtime_error("Error: compiled script '" + path + "' has an invalid op " + std::to_string(i) + ".");
+            }
+        }
+        if (m_ops.back().opcode != Opcode::Halt)
+        {
+            throw std::runtime_error("Error: compiled script '" + path + "' does not end in a halt.");
+        }
+    }
+
+    template <bool Timed>
+    Result execute(RegisterRegions const &regions, OpStats *const stats) const
+    {
+        // Handler addresses, in Opcode order
+        static void *const handlers[]{&&op_read, &&op_write, &&op_poll_equal, &&op_poll_not_equal, &&op_delay, &&op_loop, &&op_halt};
+
+        std::vector<void *> threaded(m_ops.size());
+        for (size_t i{0}; i < m_ops.size(); ++i)
+        {
+            threaded[i] = handlers[static_cast<size_t>(m_ops[i].opcode)];
+        }
+        std::vector<uint32_t> counters(m_loop_count, 0);
+
+        Result result;
+        Op const *const ops{m_ops.data()};
+        size_t pc{0};
+        uint32_t value{0};
+        uint64_t executed{0};
+        auto const start{std::chrono::steady_clock::now()};
+        auto op_start{start};
+
+        // Closes the timing of the op at 'pc', then jumps to the handler of 'next'
+#define REGISTER_SCRIPT_NEXT(next)                                                                          \
+        do                                                                                                  \
+        {                                                                                                   \
+            if constexpr (Timed)                                                                            \
+            {                                                                                               \
+                auto const op_end{std::chrono::steady_clock::now()};                                        \
+                uint64_t const ns{static_cast<uint64_t>((op_end - op_start).count())};                     \
+                ++stats[pc].count;                                                                          \
+                stats[pc].total_ns += ns;                                                                   \
+                stats[pc].max_ns = std::max(stats[pc].max_ns, ns);                                          \
+                stats[pc].last_value = value;                                                               \
+                op_start = op_end;                                                                          \
+            }                                                                                               \
+            ++executed;                                                                                     \
+            pc = (next);                                                                                    \
+            goto *threaded[pc];                                                                             \
+        } while (0)
+
+        goto *threaded[pc];
+
+    op_read:
+        value = regions[static_cast<size_t>(ops[pc].region)]->readOffset(ops[pc].offset);
+        REGISTER_SCRIPT_NEXT(pc + 1);
+
+    op_write:
+        regions[static_cast<size_t>(ops[pc].region)]->writeOffset(ops[pc].offset, ops[pc].a);
+        REGISTER_SCRIPT_NEXT(pc + 1);
+
+    op_poll_equal:
+    op_poll_not_equal:
+        if (!poll_register(*regions[static_cast<size_t>(ops[pc].region)], ops[pc].offset, ops[pc].a, ops[pc].b,
+                           ops[pc].opcode == Opcode::PollEqual, std::chrono::microseconds(ops[pc].c), value))
+        {
+            result.failed_op = pc;
+            result.failed_value = value;
+            goto done;
+        }
+        REGISTER_SCRIPT_NEXT(pc + 1);
+
+    op_delay:
+        wait_until(std::chrono::steady_clock::now() + std::chrono::microseconds(ops[pc].a));
+        REGISTER_SCRIPT_NEXT(pc + 1);
+
+    op_loop:
+        // Counters reset on exit so an enclosing loop can run this one again
+        if (++counters[ops[pc].c] < ops[pc].b)
+        {
+            REGISTER_SCRIPT_NEXT(ops[pc].a);
+        }
+        counters[ops[pc].c] = 0;
+        REGISTER_SCRIPT_NEXT(pc + 1);
+
+    op_halt:
+        result.completed = true;
+
+    done:
+#undef REGISTER_SCRIPT_NEXT
+        result.ops_executed = executed;
+        result.elapsed = std::chrono::steady_clock::now() - start;
+        return result;
+    }
+};
@@ -0,0 +1,259 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * @brief One register access in a trace file.
+ */
+struct TraceRecord
+{
+    enum Kind : uint8_t
+    {
+        READ = 0,
+        WRITE = 1
+    };
+
+    uint64_t timestamp_ns; // Since the trace was opened
+    uint32_t value;        // Value read or written
+    uint16_t offset;       // Byte offset within the region
+    uint8_t region;        // Index into TraceHeader::region_bases
+    uint8_t kind;
+};
+static_assert(sizeof(TraceRecord) == 16, "trace records are 16 bytes on disk");
+
+/**
+ * @brief Trace file header. Records follow at TRACE_RECORDS_OFFSET, in host byte order.
+ */
+struct TraceHeader
+{
+    static constexpr uint32_t MAX_REGIONS{8};
+
+    char magic[4];
+    uint32_t version;
+    uint32_t record_size;
+    uint32_t region_count;
+    uint64_t region_bases[MAX_REGIONS]; // Physical base address of each region
+    uint64_t record_count;              // Updated after every append, so a crashed run stays readable
+};
+
+constexpr char TRACE_MAGIC[4]{'R', 'G', 'T', 'R'};
+constexpr uint32_t TRACE_VERSION{1};
+constexpr size_t TRACE_RECORDS_OFFSET{128};
+static_assert(sizeof(TraceHeader) <= TRACE_RECORDS_OFFSET, "trace header overlaps the records");
+
+/**
+ * @brief Appends register accesses to a memory-mapped trace file.
+ *
+ * Appends are plain stores into a shared file mapping, so recording costs a
+ * clock read and a 16-byte store per access; the kernel writes the pages back.
+ * The file grows in GROW_RECORDS steps and is trimmed to its records when the
+ * writer is destroyed. Not thread-safe: attach it to managers used by one thread.
+ */
+class TraceWriter
+{
+public:
+    static constexpr size_t GROW_RECORDS{1 << 20}; // 16MB of records per step
+
+    /**
+     * @brief Constructor: Creates (or truncates) the trace file and maps its first chunk.
+     * @param path The trace file to write.
+     */
+    explicit TraceWriter(std::string const &path) : m_path(path)
+    {
+        m_fd = open(path.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+        if (m_fd == -1)
+        {
+            throw std::runtime_error("Error: could not create trace file '" + path + "'.");
+        }
+        map(GROW_RECORDS);
+
+        std::memcpy(m_header->magic, TRACE_MAGIC, sizeof(TRACE_MAGIC));
+        m_header->version = TRACE_VERSION;
+        m_header->record_size = sizeof(TraceRecord);
+        m_start = std::chrono::steady_clock::now();
+    }
+
+    /**
+     * @brief Destructor: Trims the file to the records written and closes it.
+     */
+    ~TraceWriter()
+    {
+        if (m_base != nullptr)
+        {
+            munmap(m_base, mapped_bytes());
+        }
+        if (m_fd != -1)
+        {
+            if (ftruncate(m_fd, static_cast<off_t>(TRACE_RECORDS_OFFSET + m_count * sizeof(TraceRecord))) == -1)
+            {
+                std::perror("[ERROR] Failed to trim trace file");
+            }
+            close(m_fd);
+        }
+    }
+
+    TraceWriter(TraceWriter const &) = delete;
+    TraceWriter &operator=(TraceWriter const &) = delete;
+
+    /**
+     * @brief Returns the trace's id for a region, adding it to the header if new.
+     * @param physical_base The region's physical base address.
+     */
+    uint8_t region_id(uint64_t const physical_base)
+    {
+        for (uint32_t id{0}; id < m_header->region_count; ++id)
+        {
+            if (m_header->region_bases[id] == physical_base)
+            {
+                return static_cast<uint8_t>(id);
+            }
+        }
+        if (m_header->region_count == TraceHeader::MAX_REGIONS)
+        {
+            throw std::runtime_error("Error: trace '" + m_path + "' already records the maximum number of regions.");
+        }
+        m_header->region_bases[m_header->region_count] = physical_base;
+        return static_cast<uint8_t>(m_header->region_count++);
+    }
+
+    /**
+     * @brief Appends one access.
+     */
+    void append(uint8_t const region, uint32_t const offset, uint32_t const value, TraceRecord::Kind const kind)
+    {
+        if (m_count == m_capacity)
+        {
+            grow();
+        }
+        uint64_t const timestamp_ns{static_cast<uint64_t>(
+            std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - m_start).count())};
+        m_records[m_count] = TraceRecord{timestamp_ns, value, static_cast<uint16_t>(offset), region, kind};
+        m_header->record_count = ++m_count;
+    }
+
+    [[nodiscard]] uint64_t size() const
+    {
+        return m_count;
+    }
+
+private:
+    std::string const m_path;
+    int m_fd{-1};
+    void *m_base{nullptr};
+    TraceHeader *m_header{nullptr};
+    TraceRecord *m_records{nullptr};
+    uint64_t m_count{0};
+    uint64_t m_capacity{0};
+    std::chrono::steady_clock::time_point m_start;
+
+    [[nodiscard]] size_t mapped_bytes() const
+    {
+        return TRACE_RECORDS_OFFSET + m_capacity * sizeof(TraceRecord);
+    }
+
+    void map(uint64_t const capacity)
+    {
+        m_capacity = capacity;
+        if (ftruncate(m_fd, static_cast<off_t>(mapped_bytes())) == -1)
+        {
+            throw std::runtime_error("Error: could not extend trace file '" + m_path + "'.");
+        }
+        m_base = mmap(0, mapped_bytes(), PROT_READ | PROT_WRITE, MAP_SHARED, m_fd, 0);
+        if (m_base == MAP_FAILED)
+        {
+            m_base = nullptr;
+            throw std::runtime_error("Error: mmap failed to map trace file '" + m_path + "'.");
+        }
+        m_header = static_cast<TraceHeader *>(m_base);
+        m_records = reinterpret_cast<TraceRecord *>(static_cast<char *>(m_base) + TRACE_RECORDS_OFFSET);
+    }
+
+    void grow()
+    {
+        munmap(m_base, mapped_bytes());
+        map(m_capacity + GROW_RECORDS);
+    }
+};
+
+/**
+ * @brief Read-only view of a trace file.
+ */
+class TraceReader
+{
+public:
+    /**
+     * @brief Constructor: Maps the trace and checks its header.
+     * @param path The trace file to read.
+     */
+    explicit TraceReader(std::string const &path)
+    {
+        m_fd = open(path.c_str(), O_RDONLY);
+        if (m_fd == -1)
+        {
+            throw std::runtime_error("Error: could not open trace file '" + path + "'.");
+        }
+        struct stat file_stat{};
+        if (fstat(m_fd, &file_stat) == -1 || static_cast<size_t>(file_stat.st_size) < TRACE_RECORDS_OFFSET)
+        {
+            close(m_fd);
+            throw std::runtime_error("Error: '" + path + "' is too short to be a trace.");
+        }
+        m_bytes = static_cast<size_t>(file_stat.st_size);
+        m_base = mmap(0, m_bytes, PROT_READ, MAP_SHARED, m_fd, 0);
+        if (m_base == MAP_FAILED)
+        {
+            close(m_fd);
+            throw std::runtime_error("Error: mmap failed to map trace file '" + path + "'.");
+        }
+
+        TraceHeader const &trace_header{header()};
+        uint64_t const available{(m_bytes - TRACE_RECORDS_OFFSET) / sizeof(TraceRecord)};
+        if (std::memcmp(trace_header.magic, TRACE_MAGIC, sizeof(TRACE_MAGIC)) != 0 || trace_header.version != TRACE_VERSION ||
+            trace_header.record_size != sizeof(TraceRecord) || trace_header.region_count > TraceHeader::MAX_REGIONS ||
+            trace_header.record_count > available)
+        {
+            munmap(m_base, m_bytes);
+            close(m_fd);
+            throw std::runtime_error("Error: '" + path + "' is not a version " + std::to_string(TRACE_VERSION) + " register trace.");
+        }
+    }
+
+    ~TraceReader()
+    {
+        munmap(m_base, m_bytes);
+        close(m_fd);
+    }
+
+    TraceReader(TraceReader const &) = delete;
+    TraceReader &operator=(TraceReader const &) = delete;
+
+    [[nodiscard]] TraceHeader const &header() const
+    {
+        return *static_cast<TraceHeader const *>(m_base);
+    }
+
+    [[nodiscard]] TraceRecord const *records() const
+    {
+        return reinterpret_cast<TraceRecord const *>(static_cast<char const *>(m_base) + TRACE_RECORDS_OFFSET);
+    }
+
+    [[nodiscard]] uint64_t size() const
+    {
+        return header().record_count;
+    }
+
+private:
+    int m_fd{-1};
+    void *m_base{nullptr};
+    size_t m_bytes{0};
+};
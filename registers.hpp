@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "enum.h"
+
+// NOTE: These must be page-aligned addresses for mmap.
+constexpr uint64_t SCC_BASE_ADDR{0x60010000}; // System Control Controller
+constexpr uint64_t APB_BASE_ADDR{0x1C010000}; // Juno Advanced Peripheral Bus
+constexpr uint64_t AXI_BASE_ADDR{0x64000000}; // LogicTile Spare AXI Slave
+
+// The size of the memory region to map. We map one standard page (4KB) to ensure we cover most registers around the base address.
+constexpr size_t MAP_SIZE{4096}; // 4KB, standard page size
+
+BETTER_ENUM(SCCRegister, uint32_t,
+            SCC_LED = 0x104
+)
+
+BETTER_ENUM(APBRegister, uint32_t,
+            SYS_ID = 0x000,
+            SYS_SQ = 0x004,
+            SYS_LED = 0x008,
+            SYS_100HZ = 0x0024,
+            SYS_FLAG = 0x0030,
+            SYS_FLAGSCLR = 0x0034,
+            SYS_NVFLAGS = 0x0038,
+            SYS_NVFLAGSCLR = 0x003C,
+            SYS_CFGSW = 0x0058,
+            SYS_24MHZ = 0x005C,
+            SYS_MISC = 0x0060,
+            SYS_PCIE_CNTL = 0x0070,
+            SYS_PCIE_GBE_L = 0x0074,
+            SYS_PCIE_GBE_H = 0x0078,
+            SYS_PROC_ID0 = 0x0084,
+            SYS_PROC_ID1 = 0x0088,
+            SYS_FAN_SPEED = 0x0120)
+
+BETTER_ENUM(AXIRegister, uint32_t,
+            AMS_RNGDATA = 0x000,
+            AMS_RNGCTRL = 0x004,
+            AMS_RNGSEED = 0x008,
+            AMS_RNGCNT = 0x00C,
+            AMS_DMABASE = 0x010,
+            AMS_DMALEN = 0x014,
+            AMS_DMACTRL = 0x018,
+            AMS_DMAPROD = 0x01C,
+            AMS_DMACONS = 0x020,
+            AMS_PERFCTRL = 0x040,
+            AMS_PERFCYCLES = 0x044,
+            AMS_PERFIDLE = 0x048,
+            AMS_PERFRBEATS = 0x04C,
+            AMS_PERFWBEATS = 0x050,
+            AMS_PERFRSTALL = 0x054,
+            AMS_PERFBSTALL = 0x058,
+            AMS_PERFSLVERR = 0x05C,
+            AMS_PERFMAXOUT = 0x060)
+
+// AMS_DMACTRL bits
+constexpr uint32_t DMACTRL_ENABLE{1u << 0};
+constexpr uint32_t DMACTRL_CLEAR{1u << 1};
+constexpr uint32_t DMACTRL_BUSY{1u << 16};
+constexpr uint32_t DMACTRL_ERROR{1u << 17};
+
+// AMS_PERFCTRL bits
+constexpr uint32_t PERFCTRL_SNAPSHOT{1u << 0};
+constexpr uint32_t PERFCTRL_CLEAR{1u << 1};
+
+// The DMA engine writes 16-beat bursts of 32-bit words
+constexpr size_t DMA_BURST_BYTES{64};
+
+// Block-RAM scratchpad in the AXI slave window (SCRATCH_BASE/SCRATCH_BYTES in axi_rng_slave.v)
+constexpr uint64_t AXI_SCRATCH_OFFSET{0x800000};
+constexpr size_t AXI_SCRATCH_BYTES{16384};
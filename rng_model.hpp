@@ -0,0 +1,319 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+
+#include "registers.hpp"
+
+/**
+ * @brief Bit-exact software model of the LFSR in rtl/src/lfsr.v.
+ *
+ * The hardware LFSR advances once per ACLK regardless of bus activity, so a
+ * sample is identified by the number of clocks since reset. Jumps of any
+ * length cost at most 64 matrix-vector products over GF(2), which keeps
+ * scoreboarding cheap however far apart two samples are.
+ */
+class LfsrModel
+{
+public:
+    static constexpr uint32_t RESET_STATE{0xACE1};
+
+    /**
+     * @brief Advances the LFSR by one clock (taps 32, 22, 2, 1).
+     * @param state The current LFSR state.
+     * @return The state after one clock.
+     */
+    [[nodiscard]] static constexpr uint32_t step(uint32_t const state)
+    {
+        uint32_t const feedback{((state >> 31) ^ (state >> 21) ^ (state >> 1) ^ state) & 1u};
+        return (state << 1) | feedback;
+    }
+
+    /**
+     * @brief Advances the LFSR by an arbitrary number of clocks.
+     * @param state The starting LFSR state.
+     * @param steps The number of clocks to advance.
+     * @return The state after 'steps' clocks.
+     */
+    [[nodiscard]] static uint32_t advance(uint32_t state, uint64_t steps)
+    {
+        // Short hops are cheaper to clock directly
+        if (steps < 32)
+        {
+            for (; steps != 0; --steps)
+            {
+                state = step(state);
+            }
+            return state;
+        }
+
+        auto const &powers{jump_tables()};
+        for (unsigned power{0}; steps != 0; ++power, steps >>= 1)
+        {
+            if (steps & 1)
+            {
+                state = apply(powers[power], state);
+            }
+        }
+        return state;
+    }
+
+    /**
+     * @brief Finds how many clocks separate two samples.
+     * @param from The earlier sample.
+     * @param to The later sample.
+     * @param max_steps The largest gap to search.
+     * @return The number of clocks (at least one) from 'from' to 'to', if within max_steps.
+     *         Never set if either sample is zero: zero is a fixed point the LFSR cannot enter, so it means a dead bus.
+     */
+    [[nodiscard]] static std::optional<uint64_t> distance(uint32_t const from, uint32_t const to, uint64_t const max_steps)
+    {
+        if (from == 0 || to == 0)
+        {
+            return std::nullopt;
+        }
+        uint32_t state{from};
+        for (uint64_t steps{1}; steps <= max_steps; ++steps)
+        {
+            state = step(state);
+            if (state == to)
+            {
+                return steps;
+            }
+        }
+        return std::nullopt;
+    }
+
+    /**
+     * @brief Checks that a capture of successive RNGDATA reads came from the LFSR.
+     * @param samples The captured values, in read order.
+     * @param count The number of samples.
+     * @param max_gap The largest number of clocks expected between two reads.
+     * @param total_clocks Receives the clocks spanned by the on-sequence pairs.
+     * @return The number of samples that follow their predecessor within max_gap clocks; zero samples never do.
+     */
+    [[nodiscard]] static size_t score(uint32_t const *samples, size_t const count, uint64_t const max_gap, uint64_t &total_clocks)
+    {
+        size_t on_sequence{0};
+        total_clocks = 0;
+        for (size_t i{1}; i < count; ++i)
+        {
+            if (auto const gap{distance(samples[i - 1], samples[i], max_gap)})
+            {
+                ++on_sequence;
+                total_clocks += *gap;
+            }
+        }
+        return on_sequence;
+    }
+
+private:
+    // Column j holds the image of basis vector (1 << j)
+    using Matrix = std::array<uint32_t, 32>;
+
+    [[nodiscard]] static uint32_t apply(Matrix const &matrix, uint32_t vector)
+    {
+        uint32_t result{0};
+        while (vector != 0)
+        {
+            result ^= matrix[__builtin_ctz(vector)];
+            vector &= vector - 1;
+        }
+        return result;
+    }
+
+    // powers[k] advances the LFSR by 2^k clocks
+    [[nodiscard]] static std::array<Matrix, 64> const &jump_tables()
+    {
+        static std::array<Matrix, 64> const powers{[]
+        {
+            std::array<Matrix, 64> tables{};
+            for (unsigned bit{0}; bit < 32; ++bit)
+            {
+                tables[0][bit] = step(1u << bit);
+            }
+            for (unsigned power{1}; power < 64; ++power)
+            {
+                for (unsigned bit{0}; bit < 32; ++bit)
+                {
+                    tables[power][bit] = apply(tables[power - 1], tables[power - 1][bit]);
+                }
+            }
+            return tables;
+        }()};
+        return powers;
+    }
+};
+
+/**
+ * @brief Register-level model of axi_rng_slave, shared by the RTL testbench
+ * (through rtl/sim/rng_model_dpi.cpp) and by host-side capture checks.
+ *
+ * Reads are timestamped with the number of ACLK edges since reset at which
+ * the address was accepted, matching the slave's decode-at-handshake
+ * behaviour. Registers whose contents are driven by logic outside the model
+ * (DMA status, counter snapshots) are loaded with set_register().
+ */
+class RngPeripheralModel
+{
+public:
+    enum Response : uint32_t
+    {
+        OKAY = 0,
+        SLVERR = 2
+    };
+
+    RngPeripheralModel()
+    {
+        for (auto const reg : AXIRegister::_values())
+        {
+            m_mapped[reg._to_integral() >> 2] = true;
+        }
+        reset();
+    }
+
+    /**
+     * @brief Returns the model to the slave's reset state.
+     */
+    void reset()
+    {
+        m_registers.fill(0);
+        m_registers[AXIRegister::AMS_RNGSEED >> 2] = LfsrModel::RESET_STATE;
+        m_lfsr_cycle = 0;
+        m_lfsr_state = LfsrModel::RESET_STATE;
+    }
+
+    /**
+     * @brief Predicts a read response.
+     * @param cycle ACLK edges since reset when the read address was accepted.
+     * @param offset Byte offset from the slave base.
+     * @param data Receives the predicted read data.
+     * @return The predicted RRESP.
+     */
+    Response read(uint64_t const cycle, uint32_t const offset, uint32_t &data)
+    {
+        if (!is_mapped(offset))
+        {
+            data = 0xDEADBEEF;
+            return SLVERR;
+        }
+
+        // The slave ignores address bits [1:0]
+        switch (offset & ~3u)
+        {
+        case AXIRegister::AMS_RNGDATA:
+            data = lfsr_at(cycle);
+            ++m_registers[AXIRegister::AMS_RNGCNT >> 2];
+            break;
+        case AXIRegister::AMS_PERFCTRL:
+            data = 0;
+            break;
+        default:
+            data = m_registers[offset >> 2];
+            break;
+        }
+        return OKAY;
+    }
+
+    /**
+     * @brief Returns the value a register would hold after a write, without applying it.
+     * @param offset Byte offset from the slave base.
+     * @param data Write data.
+     * @param strobe Byte lane strobes (bits 3:0).
+     * @return The post-write register value.
+     */
+    [[nodiscard]] uint32_t preview_write(uint32_t const offset, uint32_t const data, uint32_t const strobe) const
+    {
+        if (!is_mapped(offset) || !is_writable(offset))
+        {
+            return is_mapped(offset) ? m_registers[offset >> 2] : 0;
+        }
+
+        uint32_t value{m_registers[offset >> 2]};
+        for (unsigned lane{0}; lane < 4; ++lane)
+        {
+            if (strobe & (1u << lane))
+            {
+                uint32_t const lane_mask{0xFFu << (lane * 8)};
+                value = (value & ~lane_mask) | (data & lane_mask);
+            }
+        }
+        return value;
+    }
+
+    /**
+     * @brief Applies a write.
+     * @param offset Byte offset from the slave base.
+     * @param data Write data.
+     * @param strobe Byte lane strobes (bits 3:0).
+     * @return The predicted BRESP.
+     */
+    Response write(uint32_t const offset, uint32_t const data, uint32_t const strobe)
+    {
+        if (!is_mapped(offset))
+        {
+            return SLVERR;
+        }
+        m_registers[offset >> 2] = preview_write(offset, data, strobe);
+        return OKAY;
+    }
+
+    /**
+     * @brief Loads a register whose value the model does not derive itself.
+     * @param offset Byte offset from the slave base.
+     * @param value The value the hardware currently holds.
+     */
+    void set_register(uint32_t const offset, uint32_t const value)
+    {
+        if (is_mapped(offset))
+        {
+            m_registers[offset >> 2] = value;
+        }
+    }
+
+    /**
+     * @brief Returns the LFSR output after 'cycle' ACLK edges since reset.
+     */
+    [[nodiscard]] uint32_t lfsr_at(uint64_t const cycle)
+    {
+        // Scoreboards ask for monotonically increasing cycles, so step from the last answer
+        if (cycle < m_lfsr_cycle)
+        {
+            m_lfsr_cycle = 0;
+            m_lfsr_state = LfsrModel::RESET_STATE;
+        }
+        m_lfsr_state = LfsrModel::advance(m_lfsr_state, cycle - m_lfsr_cycle);
+        m_lfsr_cycle = cycle;
+        return m_lfsr_state;
+    }
+
+private:
+    static constexpr size_t REGISTER_WORDS{32}; // 0x000-0x07F
+
+    std::array<uint32_t, REGISTER_WORDS> m_registers{};
+    std::array<bool, REGISTER_WORDS> m_mapped{};
+    uint64_t m_lfsr_cycle{0};
+    uint32_t m_lfsr_state{LfsrModel::RESET_STATE};
+
+    [[nodiscard]] bool is_mapped(uint32_t const offset) const
+    {
+        return offset < REGISTER_WORDS * 4 && m_mapped[offset >> 2];
+    }
+
+    [[nodiscard]] static bool is_writable(uint32_t const offset)
+    {
+        switch (offset & ~3u)
+        {
+        case AXIRegister::AMS_RNGCTRL:
+        case AXIRegister::AMS_RNGSEED:
+        case AXIRegister::AMS_DMABASE:
+        case AXIRegister::AMS_DMALEN:
+        case AXIRegister::AMS_DMACONS:
+            return true;
+        default:
+            return false;
+        }
+    }
+};
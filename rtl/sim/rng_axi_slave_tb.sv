@@ -1,6 +1,15 @@
 `timescale 1ns/1ps
 
-module rng_axi_slave_tb;
+module rng_axi_slave_tb #(
+    // Constrained-random traffic run length and throughput regression floor
+    parameter integer RANDOM_READS        = 2000,
+    parameter real    MIN_READS_PER_CYCLE = 0.35,
+    // 0 runs the random traffic without the DPI golden model, to measure its cost
+    parameter bit     SCOREBOARD_DPI      = 1,
+    // Scratchpad burst throughput floors (data beats per cycle, back-to-back bursts)
+    parameter real    MIN_BURST_READ_BEATS_PER_CYCLE  = 0.9,
+    parameter real    MIN_BURST_WRITE_BEATS_PER_CYCLE = 0.75
+);
 
     // Clock and reset
     reg         ACLK;
@@ -44,8 +53,26 @@ module rng_axi_slave_tb;
     wire        BVALID;
     reg         BREADY;
     
+    // DMA AXI Master Write Channels
+    wire [15:0] M_AWID;
+    wire [31:0] M_AWADDR;
+    wire [3:0]  M_AWLEN;
+    wire [2:0]  M_AWSIZE;
+    wire [1:0]  M_AWBURST;
+    wire        M_AWVALID;
+    reg         M_AWREADY;
+    wire [31:0] M_WDATA;
+    wire [3:0]  M_WSTRB;
+    wire        M_WLAST;
+    wire        M_WVALID;
+    reg         M_WREADY;
+    reg  [15:0] M_BID;
+    reg  [1:0]  M_BRESP;
+    reg         M_BVALID;
+    wire        M_BREADY;
+    
     // Instantiate DUT
-    axi_rng_slave dut (
+    axi_rng_slave #(.DMA_ENABLE(1)) dut (
         .ACLK(ACLK),
         .ARESETn(ARESETn),
         .ARID(ARID),
@@ -75,7 +102,23 @@ module rng_axi_slave_tb;
         .BID(BID),
         .BRESP(BRESP),
         .BVALID(BVALID),
-        .BREADY(BREADY)
+        .BREADY(BREADY),
+        .M_AWID(M_AWID),
+        .M_AWADDR(M_AWADDR),
+        .M_AWLEN(M_AWLEN),
+        .M_AWSIZE(M_AWSIZE),
+        .M_AWBURST(M_AWBURST),
+        .M_AWVALID(M_AWVALID),
+        .M_AWREADY(M_AWREADY),
+        .M_WDATA(M_WDATA),
+        .M_WSTRB(M_WSTRB),
+        .M_WLAST(M_WLAST),
+        .M_WVALID(M_WVALID),
+        .M_WREADY(M_WREADY),
+        .M_BID(M_BID),
+        .M_BRESP(M_BRESP),
+        .M_BVALID(M_BVALID),
+        .M_BREADY(M_BREADY)
     );
     
     // Clock generation - 100MHz
@@ -84,6 +127,225 @@ module rng_axi_slave_tb;
         forever #5 ACLK = ~ACLK;
     end
     
+    // Simulated DRAM behind the DMA master port. Accepts the address before
+    // any data beats and inserts random AWREADY/WREADY stalls. Writes outside
+    // the modelled range complete with DECERR.
+    localparam DRAM_BASE  = 32'h80000000;
+    localparam DRAM_WORDS = 1024;
+    
+    reg  [31:0] dram [0:DRAM_WORDS-1];
+    reg  [31:0] dram_awaddr;
+    reg         dram_aw_pending;
+    reg         dram_decerr;
+    integer     dram_beat;
+    integer     dram_bursts = 0;
+    
+    always @(posedge ACLK or negedge ARESETn) begin
+        if (!ARESETn) begin
+            M_AWREADY       <= 1'b0;
+            M_WREADY        <= 1'b0;
+            M_BID           <= 16'h0;
+            M_BRESP         <= 2'b00;
+            M_BVALID        <= 1'b0;
+            dram_awaddr     <= 32'h0;
+            dram_aw_pending <= 1'b0;
+            dram_decerr     <= 1'b0;
+            dram_beat       <= 0;
+        end else begin
+            M_AWREADY <= !dram_aw_pending && !M_BVALID && ($random % 4 != 0);
+            M_WREADY  <= dram_aw_pending && ($random % 4 != 0);
+    
+            if (M_AWVALID && M_AWREADY) begin
+                dram_awaddr     <= M_AWADDR;
+                dram_aw_pending <= 1'b1;
+                dram_decerr     <= (M_AWADDR < DRAM_BASE) ||
+                                   (M_AWADDR + (M_AWLEN + 1) * 4 > DRAM_BASE + DRAM_WORDS * 4);
+                dram_beat       <= 0;
+                M_AWREADY       <= 1'b0;
+            end
+    
+            if (M_WVALID && M_WREADY && dram_aw_pending) begin
+                if (!dram_decerr)
+                    dram[(dram_awaddr - DRAM_BASE) / 4 + dram_beat] <= M_WDATA;
+                dram_beat <= dram_beat + 1;
+                if (M_WLAST) begin
+                    if (dram_beat != M_AWLEN)
+                        $display("ERROR: DMA WLAST on beat %0d, AWLEN %0d", dram_beat, M_AWLEN);
+                    dram_aw_pending <= 1'b0;
+                    M_WREADY        <= 1'b0;
+                    M_BID           <= M_AWID;
+                    M_BRESP         <= dram_decerr ? 2'b11 : 2'b00;
+                    M_BVALID        <= 1'b1;
+                    dram_bursts     <= dram_bursts + 1;
+                end
+            end
+    
+            if (M_BVALID && M_BREADY)
+                M_BVALID <= 1'b0;
+        end
+    end
+    
+    // Golden model shared with the host tools (rng_model.hpp via rng_model_dpi.cpp)
+    import "DPI-C" function void rng_model_reset();
+    import "DPI-C" function int rng_model_read(input longint unsigned cycle, input int unsigned offset,
+                                               output int unsigned data);
+    import "DPI-C" function int unsigned rng_model_preview_write(input int unsigned offset, input int unsigned data,
+                                                                 input int unsigned strobe);
+    import "DPI-C" function int rng_model_write(input int unsigned offset, input int unsigned data,
+                                                input int unsigned strobe);
+    import "DPI-C" function void rng_model_set_register(input int unsigned offset, input int unsigned value);
+    import "DPI-C" function int rng_model_lfsr_follows(input int unsigned from, input int unsigned to,
+                                                       input int unsigned max_steps);
+    
+    //=========================================================================
+    // CONSTRAINED-RANDOM TRAFFIC SCOREBOARD
+    //=========================================================================
+    // Read responses are predicted by the shared golden model when the
+    // address is accepted (the DUT decodes at the AR handshake) and checked
+    // against the oldest pending read with the same RID. A register with a
+    // write in flight may return either its old or its new value.
+    //
+    // Pending reads sit in one ring per RID (indexed by RID[3:0]; the random
+    // traffic uses 16 consecutive IDs at most), so matching a response is a
+    // lookup at the ring head rather than a scan. The rings are bounded by the
+    // outstanding reads, not the run length, and overflowing one is an error.
+    // Latencies go into histograms, so memory and per-transaction cost stay
+    // constant however many transactions run. With SCOREBOARD_DPI = 0 the
+    // golden model is not called: IDs, ordering and RLAST are still checked,
+    // which isolates the cost of the model in long runs.
+    localparam SB_ID_SLOTS     = 16;
+    localparam SB_QUEUE_DEPTH  = 64;   // Per RID; far above what the slave accepts
+    localparam SB_LAT_BUCKETS  = 256;  // One cycle each; the last also holds anything longer
+    
+    reg         sb_active = 1'b0;
+    reg  [31:0] sb_pending_offset;
+    reg  [31:0] sb_pending_value;
+    reg         sb_pending = 1'b0;
+    
+    reg  [15:0] sb_q_id    [0:SB_ID_SLOTS*SB_QUEUE_DEPTH-1];
+    reg  [31:0] sb_q_data  [0:SB_ID_SLOTS*SB_QUEUE_DEPTH-1];
+    reg  [31:0] sb_q_alt   [0:SB_ID_SLOTS*SB_QUEUE_DEPTH-1];
+    reg  [1:0]  sb_q_resp  [0:SB_ID_SLOTS*SB_QUEUE_DEPTH-1];
+    longint unsigned sb_q_start [0:SB_ID_SLOTS*SB_QUEUE_DEPTH-1];
+    int unsigned sb_q_head [0:SB_ID_SLOTS-1];
+    int unsigned sb_q_tail [0:SB_ID_SLOTS-1];
+    
+    // which = 0: reads, 1: writes
+    longint unsigned sb_lat_hist [0:1][0:SB_LAT_BUCKETS-1];
+    longint unsigned sb_lat_max  [0:1];
+    
+    integer     sb_rd_issued   = 0;
+    integer     sb_rd_received = 0;
+    integer     sb_wr_done     = 0;
+    integer     sb_errors      = 0;
+    longint unsigned sb_cycle  = 0; // ACLK edges since reset release (LFSR steps taken)
+    
+    initial begin : scoreboard_init
+        integer n;
+        for (n = 0; n < SB_ID_SLOTS; n = n + 1) begin
+            sb_q_head[n] = 0;
+            sb_q_tail[n] = 0;
+        end
+        for (n = 0; n < SB_LAT_BUCKETS; n = n + 1) begin
+            sb_lat_hist[0][n] = 0;
+            sb_lat_hist[1][n] = 0;
+        end
+        sb_lat_max[0] = 0;
+        sb_lat_max[1] = 0;
+    end
+    
+    task record_latency;
+        input integer which;
+        input longint unsigned cycles;
+        begin
+            sb_lat_hist[which][cycles < SB_LAT_BUCKETS ? cycles : SB_LAT_BUCKETS - 1] += 1;
+            if (cycles > sb_lat_max[which])
+                sb_lat_max[which] = cycles;
+        end
+    endtask
+    
+    always @(posedge ACLK) begin : scoreboard
+        integer slot, entry;
+        reg [31:0] offset;
+        int unsigned data;
+        
+        if (ARESETn) begin
+            if (sb_active && ARVALID && ARREADY) begin
+                slot = ARID[3:0];
+                if (sb_q_tail[slot] - sb_q_head[slot] >= SB_QUEUE_DEPTH) begin
+                    $display("  ERROR: more than %0d reads outstanding on RID %h", SB_QUEUE_DEPTH, ARID);
+                    sb_errors = sb_errors + 1;
+                end else begin
+                    entry  = slot * SB_QUEUE_DEPTH + sb_q_tail[slot] % SB_QUEUE_DEPTH;
+                    offset = ARADDR & 32'h00FFFFFF;
+                    sb_q_id[entry] = ARID;
+                    if (SCOREBOARD_DPI) begin
+                        sb_q_resp[entry] = rng_model_read(sb_cycle, offset, data);
+                        sb_q_data[entry] = data;
+                        sb_q_alt[entry]  = (sb_pending && offset[23:2] == sb_pending_offset[23:2]) ? sb_pending_value : 32'hx;
+                    end
+                    sb_q_start[entry] = sb_cycle;
+                    sb_q_tail[slot]   = sb_q_tail[slot] + 1;
+                end
+                sb_rd_issued = sb_rd_issued + 1;
+            end
+            
+            if (sb_active && RVALID && RREADY) begin
+                slot  = RID[3:0];
+                entry = slot * SB_QUEUE_DEPTH + sb_q_head[slot] % SB_QUEUE_DEPTH;
+                if (sb_q_head[slot] == sb_q_tail[slot] || sb_q_id[entry] !== RID) begin
+                    // Still counted, so a dropped or stray read fails the test instead of hanging it
+                    $display("  ERROR: unexpected read response, RID %h", RID);
+                    sb_errors = sb_errors + 1;
+                    sb_rd_received = sb_rd_received + 1;
+                end else begin
+                    if (!RLAST || (SCOREBOARD_DPI && (RRESP !== sb_q_resp[entry] ||
+                        (RDATA !== sb_q_data[entry] && RDATA !== sb_q_alt[entry])))) begin
+                        $display("  ERROR: RID %h got 0x%08h/%b, expected 0x%08h/%b",
+                                 RID, RDATA, RRESP, sb_q_data[entry], sb_q_resp[entry]);
+                        sb_errors = sb_errors + 1;
+                    end
+                    sb_q_head[slot] = sb_q_head[slot] + 1;
+                    record_latency(0, sb_cycle - sb_q_start[entry]);
+                    sb_rd_received = sb_rd_received + 1;
+                end
+            end
+            
+            sb_cycle = sb_cycle + 1;
+        end
+    end
+    
+    // Prints latency percentiles from a histogram
+    task report_latency;
+        input [8*8-1:0] label;
+        input integer which; // 0: reads, 1: writes
+        input integer count;
+        integer bucket, p;
+        longint unsigned seen;
+        integer pct [0:2];
+        integer at [0:2];
+        begin
+            pct[0] = 50;
+            pct[1] = 90;
+            pct[2] = 99;
+            seen = 0;
+            p = 0;
+            for (bucket = 0; bucket < SB_LAT_BUCKETS && p < 3; bucket = bucket + 1) begin
+                seen = seen + sb_lat_hist[which][bucket];
+                while (p < 3 && seen > longint'(count) * pct[p] / 100) begin
+                    at[p] = bucket;
+                    p = p + 1;
+                end
+            end
+            if (count > 0) begin
+                $display("  %0s latency (cycles): p50 %0d, p90 %0d, p99 %0d, max %0d", label,
+                         at[0], at[1], at[2], sb_lat_max[which]);
+                if (at[2] == SB_LAT_BUCKETS - 1)
+                    $display("  (a percentile of %0d means %0d cycles or more)", SB_LAT_BUCKETS - 1, SB_LAT_BUCKETS - 1);
+            end
+        end
+    endtask
+    
     // Test variables
     integer test_count = 0;
     integer pass_count = 0;
@@ -174,9 +436,304 @@ module rng_axi_slave_tb;
         end
     endtask
     
+    // Reference event counts for the performance counter bank, sampled the
+    // same way the DUT samples them while perf_window is set
+    reg     perf_window = 1'b0;
+    integer mon_rbeats  = 0;
+    integer mon_wbeats  = 0;
+    integer mon_rstall  = 0;
+    integer mon_bstall  = 0;
+    integer mon_slverr  = 0;
+    integer mon_cycles  = 0;
+    
+    always @(posedge ACLK) begin
+        if (perf_window) begin
+            mon_cycles = mon_cycles + 1;
+            if (RVALID && RREADY)  mon_rbeats = mon_rbeats + 1;
+            if (WVALID && WREADY)  mon_wbeats = mon_wbeats + 1;
+            if (RVALID && !RREADY) mon_rstall = mon_rstall + 1;
+            if (BVALID && !BREADY) mon_bstall = mon_bstall + 1;
+            if (RVALID && RREADY && RRESP[1]) mon_slverr = mon_slverr + 1;
+            if (BVALID && BREADY && BRESP[1]) mon_slverr = mon_slverr + 1;
+        end
+    end
+    
+    // AXI read that holds RREADY low for 'ready_delay' cycles after the address
+    // handshake. Inputs change 1ns after the clock edge so the DUT and the
+    // monitor above always sample the same values.
+    task axi_read_stalled;
+        input [31:0] addr;
+        input [15:0] id;
+        input integer ready_delay;
+        output [31:0] data;
+        output [1:0] resp;
+        begin
+            @(posedge ACLK);
+            #1;
+            ARADDR  = addr;
+            ARID    = id;
+            ARLEN   = 4'h0;
+            ARSIZE  = 3'b010;
+            ARBURST = 2'b01;
+            ARVALID = 1'b1;
+            RREADY  = 1'b0;
+            
+            @(posedge ACLK);
+            while (!ARREADY) @(posedge ACLK);
+            #1;
+            ARVALID = 1'b0;
+            
+            repeat (ready_delay) @(posedge ACLK);
+            #1;
+            RREADY = 1'b1;
+            @(posedge ACLK);
+            while (!RVALID) @(posedge ACLK);
+            data = RDATA;
+            resp = RRESP;
+            #1;
+            RREADY = 1'b0;
+        end
+    endtask
+    
+    // AXI write with independent address/data delays and a BREADY stall
+    task axi_write_stalled;
+        input [31:0] addr;
+        input [31:0] data;
+        input [15:0] id;
+        input integer data_delay;
+        input integer ready_delay;
+        output [1:0] resp;
+        begin
+            @(posedge ACLK);
+            #1;
+            AWADDR  = addr;
+            AWID    = id;
+            AWLEN   = 4'h0;
+            AWSIZE  = 3'b010;
+            AWBURST = 2'b01;
+            AWVALID = 1'b1;
+            BREADY  = 1'b0;
+            
+            fork
+                begin
+                    @(posedge ACLK);
+                    while (!AWREADY) @(posedge ACLK);
+                    #1;
+                    AWVALID = 1'b0;
+                end
+                begin
+                    repeat (data_delay) @(posedge ACLK);
+                    #1;
+                    WDATA  = data;
+                    WSTRB  = 8'hFF;
+                    WVALID = 1'b1;
+                    @(posedge ACLK);
+                    while (!WREADY) @(posedge ACLK);
+                    #1;
+                    WVALID = 1'b0;
+                end
+            join
+            
+            repeat (ready_delay) @(posedge ACLK);
+            #1;
+            BREADY = 1'b1;
+            @(posedge ACLK);
+            while (!BVALID) @(posedge ACLK);
+            resp = BRESP;
+            #1;
+            BREADY = 1'b0;
+        end
+    endtask
+    
+    // Task to poll a register until (value & mask) == expected
+    task axi_poll;
+        input [31:0] addr;
+        input [31:0] mask;
+        input [31:0] expected;
+        input integer max_polls;
+        output [31:0] data;
+        output ok;
+        integer polls;
+        reg [1:0] resp;
+        begin
+            ok = 1'b0;
+            for (polls = 0; polls < max_polls && !ok; polls = polls + 1) begin
+                axi_read(addr, 16'h00D0, data, resp);
+                if ((data & mask) == expected)
+                    ok = 1'b1;
+            end
+        end
+    endtask
+    
+    //=========================================================================
+    // SCRATCHPAD BURSTS
+    //=========================================================================
+    // The DUT's scratchpad sits at SCRATCH_BASE in the slave window. Burst
+    // tasks take beat data from burst_wdata and leave read data in
+    // burst_rdata; scratch_model tracks what every written word should hold.
+    localparam SCRATCH_ADDR  = 32'h64800000;
+    localparam SCRATCH_WORDS = 4096;
+    
+    reg  [31:0] burst_wdata [0:15];
+    reg  [31:0] burst_rdata [0:15];
+    reg  [31:0] scratch_model [0:SCRATCH_WORDS-1];
+    integer     scratch_errors = 0;
+    
+    // Applies one write beat to scratch_model, honouring the byte strobes
+    task scratch_model_write;
+        input [31:0] addr;
+        input [31:0] data;
+        input [7:0]  strb;
+        integer lane;
+        begin
+            for (lane = 0; lane < 4; lane = lane + 1)
+                if (strb[lane])
+                    scratch_model[(addr - SCRATCH_ADDR) / 4 % SCRATCH_WORDS][lane*8 +: 8] = data[lane*8 +: 8];
+        end
+    endtask
+    
+    // Write burst of len+1 beats from burst_wdata, WVALID held high so the
+    // DUT sets the pace. With w_first the first beat is offered before the
+    // address. data_cycles counts from the first data handshake to the last.
+    task axi_write_burst;
+        input [31:0] addr;
+        input [15:0] id;
+        input [3:0]  len;
+        input [1:0]  burst;
+        input [7:0]  strb;
+        input        w_first;
+        output [1:0] resp;
+        output integer data_cycles;
+        integer beats_sent;
+        longint unsigned first_beat;
+        begin
+            @(posedge ACLK);
+            #1;
+            AWADDR  = addr;
+            AWID    = id;
+            AWLEN   = len;
+            AWSIZE  = 3'b010;
+            AWBURST = burst;
+            AWVALID = !w_first;
+            BREADY  = 1'b0;
+            beats_sent = 0;
+            
+            fork
+                begin
+                    if (w_first) begin
+                        wait (beats_sent > 0);
+                        AWVALID = 1'b1;
+                    end
+                    @(posedge ACLK);
+                    while (!AWREADY) @(posedge ACLK);
+                    #1;
+                    AWVALID = 1'b0;
+                end
+                begin : w_beats
+                    integer beat;
+                    for (beat = 0; beat <= len; beat = beat + 1) begin
+                        WDATA  = burst_wdata[beat];
+                        WSTRB  = strb;
+                        WVALID = 1'b1;
+                        @(posedge ACLK);
+                        while (!WREADY) @(posedge ACLK);
+                        if (beat == 0)
+                            first_beat = sb_cycle;
+                        data_cycles = sb_cycle - first_beat + 1;
+                        if (burst != 2'b10)
+                            scratch_model_write(burst == 2'b00 ? addr : addr + beat * 4, burst_wdata[beat], strb);
+                        #1;
+                        beats_sent = beat + 1;
+                    end
+                    WVALID = 1'b0;
+                end
+            join
+            
+            BREADY = 1'b1;
+            @(posedge ACLK);
+            while (!BVALID) @(posedge ACLK);
+            resp = BRESP;
+            if (BID !== id) begin
+                $display("  ERROR: burst BID mismatch! Expected %h, got %h", id, BID);
+                ++scratch_errors;
+            end
+            #1;
+            BREADY = 1'b0;
+        end
+    endtask
+    
+    // Read burst of len+1 beats into burst_rdata, with RREADY dropped on
+    // about stall_pct percent of cycles. Checks RID and that RLAST marks only
+    // the final beat; resp is the worst response seen. data_cycles counts
+    // from the first data beat to the last.
+    task axi_read_burst;
+        input [31:0] addr;
+        input [15:0] id;
+        input [3:0]  len;
+        input [1:0]  burst;
+        input integer stall_pct;
+        output [1:0] resp;
+        output integer data_cycles;
+        integer beat;
+        reg     ar_accepted;
+        longint unsigned first_beat;
+        begin
+            @(posedge ACLK);
+            #1;
+            ARADDR  = addr;
+            ARID    = id;
+            ARLEN   = len;
+            ARSIZE  = 3'b010;
+            ARBURST = burst;
+            ARVALID = 1'b1;
+            RREADY  = ($unsigned($random) % 100) >= stall_pct;
+            resp    = 2'b00;
+            beat    = 0;
+            while (beat <= len) begin
+                @(posedge ACLK);
+                ar_accepted = ARVALID && ARREADY;
+                if (RVALID && RREADY) begin
+                    if (beat == 0)
+                        first_beat = sb_cycle;
+                    data_cycles = sb_cycle - first_beat + 1;
+                    burst_rdata[beat] = RDATA;
+                    if (RRESP > resp)
+                        resp = RRESP;
+                    if (RID !== id || RLAST !== (beat == len)) begin
+                        $display("  ERROR: burst beat %0d RID %h RLAST %b (expected %h, %b)", beat, RID, RLAST, id, beat == len);
+                        ++scratch_errors;
+                    end
+                    beat = beat + 1;
+                end
+                #1;
+                if (ar_accepted)
+                    ARVALID = 1'b0;
+                RREADY = ($unsigned($random) % 100) >= stall_pct;
+            end
+            RREADY = 1'b0;
+        end
+    endtask
+    
+    // Compares burst_rdata with scratch_model for an INCR burst; returns the mismatch count
+    function integer scratch_check;
+        input [31:0] addr;
+        input [3:0]  len;
+        integer beat;
+        begin
+            scratch_check = 0;
+            for (beat = 0; beat <= len; beat = beat + 1)
+                if (burst_rdata[beat] !== scratch_model[(addr - SCRATCH_ADDR) / 4 % SCRATCH_WORDS + beat]) begin
+                    $display("  ERROR: scratch 0x%08h read 0x%08h, expected 0x%08h", addr + beat * 4,
+                             burst_rdata[beat], scratch_model[(addr - SCRATCH_ADDR) / 4 % SCRATCH_WORDS + beat]);
+                    scratch_check = scratch_check + 1;
+                end
+        end
+    endfunction
+    
     // Main test sequence
     initial begin
         // Initialize signals
+        rng_model_reset();
         ARESETn = 0;
         ARVALID = 0;
         RREADY  = 0;
@@ -320,6 +877,597 @@ module rng_axi_slave_tb;
             ++pass_count; 
         end
         
+        // Test 9: DMA descriptor registers
+        begin
+            reg [31:0] base, len;
+            reg [1:0] rresp, wresp;
+            $display("\nTest %0d: DMA descriptor registers (0x010/0x014)", ++test_count);
+            axi_write(32'h64000010, DRAM_BASE, 8'hFF, 16'h0010, wresp);
+            axi_write(32'h64000014, 32'd256, 8'hFF, 16'h0011, wresp);
+            axi_read(32'h64000010, 16'h0012, base, rresp);
+            axi_read(32'h64000014, 16'h0013, len, rresp);
+            if (base == DRAM_BASE && len == 32'd256 && rresp == 2'b00) begin
+                $display("  PASS: Ring base = 0x%08h, length = %0d bytes", base, len);
+                ++pass_count;
+            end else begin
+                $display("  FAIL: Ring base = 0x%08h, length = %0d", base, len);
+                ++fail_count;
+            end
+        end
+        
+        // Test 10: DMA fills the ring and stops when full
+        begin
+            reg [31:0] status, prod;
+            reg [1:0] rresp, wresp;
+            reg ok;
+            $display("\nTest %0d: DMA fills 256-byte ring then stalls", ++test_count);
+            axi_write(32'h64000018, 32'h1, 8'hFF, 16'h0014, wresp);
+            // Wait for full (bit 18) and idle (bit 16)
+            axi_poll(32'h64000018, 32'h00050000, 32'h00040000, 200, status, ok);
+            axi_read(32'h6400001C, 16'h0015, prod, rresp);
+            if (ok && prod == 32'd64 && dram_bursts == 4) begin
+                $display("  PASS: Producer index = %0d after %0d bursts", prod, dram_bursts);
+                ++pass_count;
+            end else begin
+                $display("  FAIL: status = 0x%08h, producer index = %0d, bursts = %0d", status, prod, dram_bursts);
+                ++fail_count;
+            end
+        end
+        
+        // Test 11: DMA data integrity
+        begin
+            integer burst, beat, bad;
+            $display("\nTest %0d: DMA beats are consecutive LFSR samples", ++test_count);
+            bad = 0;
+            for (burst = 0; burst < 4; burst = burst + 1)
+                for (beat = 1; beat < 16; beat = beat + 1)
+                    if (!rng_model_lfsr_follows(dram[burst * 16 + beat - 1], dram[burst * 16 + beat], 64))
+                        bad = bad + 1;
+            if (bad == 0) begin
+                $display("  PASS: All 64 ring words follow the LFSR sequence");
+                ++pass_count;
+            end else begin
+                $display("  FAIL: %0d words do not follow their predecessor", bad);
+                ++fail_count;
+            end
+        end
+        
+        // Test 12: Consumer index release lets the DMA wrap the ring
+        begin
+            reg [31:0] status, prod, old_word;
+            reg [1:0] rresp, wresp;
+            reg ok;
+            $display("\nTest %0d: Consumer release wraps the ring", ++test_count);
+            old_word = dram[0];
+            axi_write(32'h64000020, 32'd32, 8'hFF, 16'h0016, wresp);
+            axi_poll(32'h6400001C, 32'hFFFFFFFF, 32'd96, 200, prod, ok);
+            axi_poll(32'h64000018, 32'h00050000, 32'h00040000, 200, status, ok);
+            if (ok && prod == 32'd96 && dram_bursts == 6 && dram[0] !== old_word) begin
+                $display("  PASS: Producer index = %0d, ring head rewritten", prod);
+                ++pass_count;
+            end else begin
+                $display("  FAIL: producer index = %0d, bursts = %0d", prod, dram_bursts);
+                ++fail_count;
+            end
+        end
+        
+        // Test 13: Write error halts the DMA until cleared
+        begin
+            reg [31:0] status, prod;
+            reg [1:0] rresp, wresp;
+            reg ok;
+            $display("\nTest %0d: DMA error response and clear", ++test_count);
+            axi_write(32'h64000018, 32'h0, 8'hFF, 16'h0017, wresp);
+            axi_write(32'h64000018, 32'h2, 8'hFF, 16'h0018, wresp);
+            axi_write(32'h64000020, 32'd0, 8'hFF, 16'h0019, wresp);
+            axi_write(32'h64000010, 32'h40000000, 8'hFF, 16'h001A, wresp);
+            axi_write(32'h64000018, 32'h1, 8'hFF, 16'h001B, wresp);
+            // Wait for error (bit 17) and idle
+            axi_poll(32'h64000018, 32'h00030000, 32'h00020000, 200, status, ok);
+            axi_read(32'h6400001C, 16'h001C, prod, rresp);
+            axi_write(32'h64000018, 32'h2, 8'hFF, 16'h001D, wresp);
+            axi_read(32'h64000018, 16'h001E, status, rresp);
+            if (ok && prod == 32'd0 && status[17] == 1'b0) begin
+                $display("  PASS: Error latched, producer held, clear accepted");
+                ++pass_count;
+            end else begin
+                $display("  FAIL: status = 0x%08h, producer index = %0d", status, prod);
+                ++fail_count;
+            end
+        end
+        
+        // Test 14: Multiple outstanding reads with interleaved IDs
+        begin
+            reg [31:0] known_addr [0:3];
+            reg [31:0] known_data [0:3];
+            reg [31:0] issue_addr [0:11];
+            reg [15:0] issue_id   [0:11];
+            reg [31:0] issue_data [0:11];
+            reg [11:0] retired;
+            reg [1:0]  rresp;
+            integer n, m, accepted, received, oldest, reordered, order_errors, peak_pending;
+            $display("\nTest %0d: Interleaved multi-ID outstanding reads", ++test_count);
+            
+            // Registers with stable contents, so each response identifies its request
+            known_addr[0] = 32'h64000004;
+            known_addr[1] = 32'h64000008;
+            known_addr[2] = 32'h64000010;
+            known_addr[3] = 32'h64000014;
+            for (n = 0; n < 4; n = n + 1)
+                axi_read(known_addr[n], 16'h00E0, known_data[n], rresp);
+            for (n = 0; n < 12; n = n + 1) begin
+                issue_id[n]   = 16'h0100 + (n * 7) % 3;
+                issue_addr[n] = known_addr[(n * 3 + issue_id[n]) % 4];
+                issue_data[n] = known_data[(n * 3 + issue_id[n]) % 4];
+            end
+            
+            retired      = 12'h0;
+            accepted     = 0;
+            received     = 0;
+            reordered    = 0;
+            order_errors = 0;
+            peak_pending = 0;
+            
+            fork
+                // Address issuer: back-to-back ARs, no waiting on R
+                begin
+                    for (n = 0; n < 12; n = n + 1) begin
+                        @(posedge ACLK);
+                        ARADDR  = issue_addr[n];
+                        ARID    = issue_id[n];
+                        ARLEN   = 4'h0;
+                        ARSIZE  = 3'b010;
+                        ARBURST = 2'b01;
+                        ARVALID = 1'b1;
+                        @(posedge ACLK);
+                        while (!ARREADY) @(posedge ACLK);
+                        ARVALID = 1'b0;
+                        ++accepted;
+                        if (accepted - received > peak_pending)
+                            peak_pending = accepted - received;
+                    end
+                end
+                // Response collector: held off until reads pile up, then random RREADY
+                begin
+                    RREADY = 1'b0;
+                    wait (accepted >= 4);
+                    while (received < 12) begin
+                        @(posedge ACLK);
+                        if (RVALID && RREADY) begin
+                            // Must match the oldest unretired request with this ID
+                            oldest = -1;
+                            for (m = 11; m >= 0; m = m - 1)
+                                if (!retired[m] && issue_id[m] == RID && m < accepted)
+                                    oldest = m;
+                            if (oldest < 0 || RDATA !== issue_data[oldest] || RRESP != 2'b00 || !RLAST) begin
+                                $display("  ERROR: RID %h returned 0x%08h out of order", RID, RDATA);
+                                ++order_errors;
+                            end else begin
+                                for (m = 0; m < oldest; m = m + 1)
+                                    if (!retired[m])
+                                        reordered = reordered + 1;
+                                retired[oldest] = 1'b1;
+                            end
+                            ++received;
+                        end
+                        RREADY = ($random % 3) != 0;
+                    end
+                    @(posedge ACLK);
+                    RREADY = 1'b0;
+                end
+            join
+            
+            if (order_errors == 0 && peak_pending >= 4) begin
+                $display("  PASS: %0d reads, %0d outstanding at peak, %0d overtaken by other IDs", received, peak_pending, reordered);
+                ++pass_count;
+            end else begin
+                $display("  FAIL: %0d ordering errors, peak outstanding %0d", order_errors, peak_pending);
+                ++fail_count;
+            end
+        end
+        
+        // Test 15: Performance counters under randomised traffic
+        begin
+            reg [31:0] cycles, idle, rbeats, wbeats, rstall, bstall, slverr, maxout, rdata;
+            reg [1:0]  rresp, wresp;
+            reg [31:0] addr;
+            integer n;
+            $display("\nTest %0d: Performance counters under random traffic", ++test_count);
+            
+            axi_write(32'h64000040, 32'h2, 8'hFF, 16'h00F0, wresp); // clear
+            @(posedge ACLK);
+            #1;
+            perf_window = 1'b1;
+            for (n = 0; n < 200; n = n + 1) begin
+                // Mostly mapped registers, with some out-of-range addresses
+                addr = ($random % 8 == 0) ? 32'h64000100 : 32'h64000000 + (($random & 32'h7) << 2);
+                if ($random % 2)
+                    axi_read_stalled(addr, n, $unsigned($random) % 4, rdata, rresp);
+                else
+                    axi_write_stalled(addr == 32'h64000018 ? 32'h64000004 : addr, $random, n,
+                                      $unsigned($random) % 3, $unsigned($random) % 4, wresp);
+                repeat ($unsigned($random) % 3) @(posedge ACLK);
+            end
+            @(posedge ACLK);
+            #1;
+            perf_window = 1'b0;
+            // The snapshot write's own data beat lands before the copy is taken
+            axi_write(32'h64000040, 32'h1, 8'hFF, 16'h00F1, wresp);
+            axi_read(32'h64000044, 16'h00F2, cycles, rresp);
+            axi_read(32'h64000048, 16'h00F3, idle, rresp);
+            axi_read(32'h6400004C, 16'h00F4, rbeats, rresp);
+            axi_read(32'h64000050, 16'h00F5, wbeats, rresp);
+            axi_read(32'h64000054, 16'h00F6, rstall, rresp);
+            axi_read(32'h64000058, 16'h00F7, bstall, rresp);
+            axi_read(32'h6400005C, 16'h00F8, slverr, rresp);
+            axi_read(32'h64000060, 16'h00F9, maxout, rresp);
+            
+            if (rbeats == mon_rbeats && wbeats == mon_wbeats + 1 &&
+                rstall == mon_rstall && bstall == mon_bstall && slverr == mon_slverr &&
+                cycles >= mon_cycles && cycles <= mon_cycles + 16 &&
+                idle > 0 && idle < cycles && maxout == 1) begin
+                $display("  PASS: %0d cycles (%0d idle), %0d R / %0d W beats, R stall %0d, B stall %0d, %0d SLVERR",
+                         cycles, idle, rbeats, wbeats, rstall, bstall, slverr);
+                ++pass_count;
+            end else begin
+                $display("  FAIL: DUT cycles %0d rbeats %0d wbeats %0d rstall %0d bstall %0d slverr %0d maxout %0d idle %0d",
+                         cycles, rbeats, wbeats, rstall, bstall, slverr, maxout, idle);
+                $display("        TB  cycles %0d rbeats %0d wbeats %0d rstall %0d bstall %0d slverr %0d",
+                         mon_cycles, mon_rbeats, mon_wbeats + 1, mon_rstall, mon_bstall, mon_slverr);
+                ++fail_count;
+            end
+        end
+        
+        // Test 16: Concurrent constrained-random traffic with throughput floor
+        begin
+            reg [31:0] rdata;
+            reg [1:0]  rresp;
+            integer n, start_cycle, cycles, writes_issued;
+            real reads_per_cycle, txn_per_cycle;
+            $display("\nTest %0d: Constrained-random concurrent traffic (%0d reads)", ++test_count, RANDOM_READS);
+            
+            // Load register contents the model cannot derive (earlier tests
+            // and the DMA/counter logic) from the DUT. The read counter is
+            // read last so it already includes the reads above.
+            for (n = 5'h01; n <= 5'h18; n = n + 1) begin
+                if (n == 5'h03 || (n > 5'h08 && n < 5'h11))
+                    continue;
+                axi_read(32'h64000000 + (n << 2), 16'h0F00, rdata, rresp);
+                rng_model_set_register(n << 2, rdata);
+            end
+            axi_read(32'h6400000C, 16'h0F01, rdata, rresp);
+            rng_model_set_register(32'h00C, rdata);
+            
+            @(posedge ACLK);
+            #1;
+            sb_active   = 1'b1;
+            start_cycle = sb_cycle;
+            writes_issued = 0;
+            
+            fork
+                // Read address issuer: mostly back-to-back, random IDs and addresses
+                begin : rand_ar
+                    integer delay;
+                    for (n = 0; n < RANDOM_READS; n = n + 1) begin
+                        delay = ($unsigned($random) % 4 == 0) ? 1 + $unsigned($random) % 3 : 0;
+                        if (delay) begin
+                            ARVALID = 1'b0;
+                            repeat (delay) @(posedge ACLK);
+                            #1;
+                        end
+                        case ($unsigned($random) % 8)
+                            0:       ARADDR = 32'h64000100;                           // out of range
+                            1:       ARADDR = 32'h64000024 + (($random & 32'h3) << 2); // unmapped hole
+                            2:       ARADDR = 32'h64000040 + (($random & 32'h7) << 2); // counter snapshots
+                            3:       ARADDR = 32'h64000010 + (($random & 32'h3) << 2); // DMA descriptor
+                            default: ARADDR = 32'h64000000 + (($random & 32'h3) << 2); // RNG registers
+                        endcase
+                        ARID    = 16'h0200 + ($unsigned($random) % 4);
+                        ARLEN   = 4'h0;
+                        ARSIZE  = 3'b010;
+                        ARBURST = 2'b01;
+                        ARVALID = 1'b1;
+                        @(posedge ACLK);
+                        while (!ARREADY) @(posedge ACLK);
+                        #1;
+                    end
+                    ARVALID = 1'b0;
+                end
+                // Read data consumer: random RREADY back-pressure
+                begin : rand_r
+                    while (sb_rd_received < RANDOM_READS) begin
+                        RREADY = ($unsigned($random) % 4) != 0;
+                        @(posedge ACLK);
+                        #1;
+                    end
+                    RREADY = 1'b0;
+                end
+                // Writer: random delays, strobes and addresses until the reads drain
+                begin : rand_w
+                    reg [31:0] waddr, wdata;
+                    reg [7:0]  wstrb;
+                    reg [1:0]  exp_resp;
+                    integer    wstart, aw_delay, w_delay, b_delay;
+                    while (sb_rd_received < RANDOM_READS) begin
+                        case ($unsigned($random) % 6)
+                            0:       waddr = 32'h64000080;                           // unmapped
+                            1:       waddr = 32'h64000000 + (($random & 32'h1) * 32'hC); // read-only RNG registers
+                            2:       waddr = 32'h64000044 + (($random & 32'h7) << 2); // read-only snapshots
+                            3, 4:    waddr = 32'h64000004;                           // control
+                            default: waddr = 32'h64000008;                           // seed
+                        endcase
+                        wdata = $random;
+                        wstrb = $random & 8'h0F;
+                        
+                        // Reads overlapping this write may see either value
+                        if (SCOREBOARD_DPI) begin
+                            sb_pending_offset = waddr & 32'h00FFFFFF;
+                            sb_pending_value  = rng_model_preview_write(sb_pending_offset, wdata, wstrb);
+                            sb_pending        = 1'b1;
+                        end
+                        
+                        aw_delay = $unsigned($random) % 3;
+                        w_delay  = $unsigned($random) % 3;
+                        b_delay  = $unsigned($random) % 3;
+                        wstart   = sb_cycle;
+                        fork
+                            begin
+                                repeat (aw_delay) @(posedge ACLK);
+                                #1;
+                                AWADDR  = waddr;
+                                AWID    = 16'h0300 + writes_issued[3:0];
+                                AWLEN   = 4'h0;
+                                AWSIZE  = 3'b010;
+                                AWBURST = 2'b01;
+                                AWVALID = 1'b1;
+                                @(posedge ACLK);
+                                while (!AWREADY) @(posedge ACLK);
+                                #1;
+                                AWVALID = 1'b0;
+                            end
+                            begin
+                                repeat (w_delay) @(posedge ACLK);
+                                #1;
+                                WDATA  = wdata;
+                                WSTRB  = wstrb;
+                                WVALID = 1'b1;
+                                @(posedge ACLK);
+                                while (!WREADY) @(posedge ACLK);
+                                #1;
+                                WVALID = 1'b0;
+                            end
+                        join
+                        repeat (b_delay) @(posedge ACLK);
+                        #1;
+                        BREADY = 1'b1;
+                        @(posedge ACLK);
+                        while (!BVALID) @(posedge ACLK);
+                        exp_resp = SCOREBOARD_DPI ? rng_model_write(waddr & 32'h00FFFFFF, wdata, wstrb) : BRESP;
+                        if (BRESP !== exp_resp || BID !== 16'h0300 + writes_issued[3:0]) begin
+                            $display("  ERROR: write to 0x%08h got BRESP %b BID %h", waddr, BRESP, BID);
+                            ++sb_errors;
+                        end
+                        record_latency(1, sb_cycle - wstart);
+                        ++sb_wr_done;
+                        ++writes_issued;
+                        #1;
+                        BREADY = 1'b0;
+                        sb_pending = 1'b0;
+                    end
+                end
+            join
+            
+            cycles = sb_cycle - start_cycle;
+            sb_active = 1'b0;
+            reads_per_cycle = sb_rd_received * 1.0 / cycles;
+            txn_per_cycle   = (sb_rd_received + sb_wr_done) * 1.0 / cycles;
+            $display("  %0d reads + %0d writes in %0d cycles: %0.3f txn/cycle (%0.3f reads/cycle)",
+                     sb_rd_received, sb_wr_done, cycles, txn_per_cycle, reads_per_cycle);
+            report_latency("Read", 0, sb_rd_received);
+            report_latency("Write", 1, sb_wr_done);
+            
+            if (sb_errors == 0 && reads_per_cycle >= MIN_READS_PER_CYCLE) begin
+                $display("  PASS: Scoreboard clean, read throughput above %0.2f/cycle", MIN_READS_PER_CYCLE);
+                ++pass_count;
+            end else begin
+                $display("  FAIL: %0d scoreboard errors, %0.3f reads/cycle (floor %0.2f)",
+                         sb_errors, reads_per_cycle, MIN_READS_PER_CYCLE);
+                ++fail_count;
+            end
+        end
+        
+        // Test 17: Scratchpad single-beat access with byte strobes
+        begin
+            reg [31:0] rdata;
+            reg [1:0]  rresp, wresp;
+            $display("\nTest %0d: Scratchpad single-beat write/read with strobes", ++test_count);
+            
+            axi_write(SCRATCH_ADDR + 32'h10, 32'h11223344, 8'h0F, 16'h0A00, wresp);
+            axi_write(SCRATCH_ADDR + 32'h10, 32'hAABBCCDD, 8'h05, 16'h0A01, wresp);
+            axi_read(SCRATCH_ADDR + 32'h10, 16'h0A02, rdata, rresp);
+            if (rdata == 32'h11BB33DD && rresp == 2'b00 && wresp == 2'b00) begin
+                $display("  PASS: Read 0x%08h after a strobed write", rdata);
+                ++pass_count;
+            end else begin
+                $display("  FAIL: Read 0x%08h/%b, expected 0x11BB33DD/00", rdata, rresp);
+                ++fail_count;
+            end
+            scratch_model[4] = rdata;
+        end
+        
+        // Test 18: 16-beat INCR bursts stream one beat per cycle
+        begin
+            reg [1:0] rresp, wresp;
+            integer n, beat, errors, write_cycles, read_cycles;
+            $display("\nTest %0d: Scratchpad 16-beat INCR write and read bursts", ++test_count);
+            
+            // Fill the first 1KB, then read every burst back without back-pressure
+            errors = 0;
+            for (n = 0; n < 16; n = n + 1) begin
+                for (beat = 0; beat < 16; beat = beat + 1)
+                    burst_wdata[beat] = $random;
+                axi_write_burst(SCRATCH_ADDR + n * 64, 16'h0B00 + n, 4'hF, 2'b01, 8'hFF, 1'b0, wresp, write_cycles);
+                if (wresp != 2'b00 || write_cycles != 16)
+                    errors = errors + 1;
+            end
+            for (n = 0; n < 16; n = n + 1) begin
+                axi_read_burst(SCRATCH_ADDR + n * 64, 16'h0B10 + n, 4'hF, 2'b01, 0, rresp, read_cycles);
+                errors = errors + scratch_check(SCRATCH_ADDR + n * 64, 4'hF);
+                if (rresp != 2'b00 || read_cycles != 16)
+                    errors = errors + 1;
+            end
+            
+            if (errors == 0 && scratch_errors == 0) begin
+                $display("  PASS: 16 write and 16 read bursts, 16 beats in %0d/%0d cycles", write_cycles, read_cycles);
+                ++pass_count;
+            end else begin
+                $display("  FAIL: %0d errors, last bursts took %0d/%0d cycles for 16 beats", errors + scratch_errors,
+                         write_cycles, read_cycles);
+                ++fail_count;
+            end
+        end
+        
+        // Test 19: Data before address, partial strobes and read back-pressure
+        begin
+            reg [1:0] rresp, wresp;
+            integer beat, errors, cycles;
+            $display("\nTest %0d: Scratchpad W-before-AW burst, strobes and RREADY stalls", ++test_count);
+            
+            errors = 0;
+            for (beat = 0; beat < 8; beat = beat + 1)
+                burst_wdata[beat] = 32'hC0DE0000 + beat;
+            axi_write_burst(SCRATCH_ADDR + 32'h100, 16'h0C00, 4'h7, 2'b01, 8'h03, 1'b1, wresp, cycles);
+            if (wresp != 2'b00)
+                errors = errors + 1;
+            axi_read_burst(SCRATCH_ADDR + 32'h100, 16'h0C01, 4'hF, 2'b01, 50, rresp, cycles);
+            errors = errors + scratch_check(SCRATCH_ADDR + 32'h100, 4'hF);
+            if (rresp != 2'b00)
+                errors = errors + 1;
+            
+            if (errors == 0 && scratch_errors == 0) begin
+                $display("  PASS: Low halfwords merged, 16 beats read in %0d cycles at 50%% RREADY", cycles);
+                ++pass_count;
+            end else begin
+                $display("  FAIL: %0d errors", errors + scratch_errors);
+                ++fail_count;
+            end
+        end
+        
+        // Test 20: FIXED bursts repeat one address; WRAP bursts are refused
+        begin
+            reg [1:0] rresp, wresp, wrap_wresp, wrap_rresp;
+            integer beat, errors, cycles;
+            $display("\nTest %0d: Scratchpad FIXED and WRAP bursts", ++test_count);
+            
+            errors = 0;
+            for (beat = 0; beat < 4; beat = beat + 1)
+                burst_wdata[beat] = 32'hF1ED0000 + beat;
+            axi_write_burst(SCRATCH_ADDR + 32'h200, 16'h0D00, 4'h3, 2'b00, 8'hFF, 1'b0, wresp, cycles);
+            axi_read_burst(SCRATCH_ADDR + 32'h200, 16'h0D01, 4'h3, 2'b00, 0, rresp, cycles);
+            for (beat = 0; beat < 4; beat = beat + 1)
+                if (burst_rdata[beat] !== 32'hF1ED0003)
+                    errors = errors + 1;
+            
+            // A refused WRAP write must leave the scratchpad untouched
+            for (beat = 0; beat < 4; beat = beat + 1)
+                burst_wdata[beat] = 32'hBAD00000 + beat;
+            axi_write_burst(SCRATCH_ADDR + 32'h200, 16'h0D02, 4'h3, 2'b10, 8'hFF, 1'b0, wrap_wresp, cycles);
+            axi_read_burst(SCRATCH_ADDR + 32'h200, 16'h0D03, 4'h3, 2'b10, 0, wrap_rresp, cycles);
+            axi_read_burst(SCRATCH_ADDR + 32'h200, 16'h0D04, 4'h0, 2'b01, 0, rresp, cycles);
+            if (burst_rdata[0] !== 32'hF1ED0003)
+                errors = errors + 1;
+            
+            if (errors == 0 && wresp == 2'b00 && wrap_wresp == 2'b10 && wrap_rresp == 2'b10 && scratch_errors == 0) begin
+                $display("  PASS: FIXED burst kept its last beat; WRAP write and read got SLVERR");
+                ++pass_count;
+            end else begin
+                $display("  FAIL: %0d data errors, FIXED BRESP %b, WRAP BRESP %b RRESP %b", errors, wresp, wrap_wresp, wrap_rresp);
+                ++fail_count;
+            end
+        end
+        
+        // Test 21: Sustained burst throughput
+        begin
+            reg [1:0] wresp;
+            integer n, beat, errors, cycles, beats;
+            longint unsigned start_cycle, first_beat, last_beat;
+            real read_rate, write_rate;
+            $display("\nTest %0d: Scratchpad sustained burst throughput", ++test_count);
+            
+            // Back-to-back write bursts, one after another's response
+            start_cycle = sb_cycle;
+            for (n = 0; n < 32; n = n + 1) begin
+                for (beat = 0; beat < 16; beat = beat + 1)
+                    burst_wdata[beat] = {n[15:0], beat[15:0]};
+                axi_write_burst(SCRATCH_ADDR + 32'h400 + n * 64, 16'h0E00, 4'hF, 2'b01, 8'hFF, 1'b0, wresp, cycles);
+            end
+            write_rate = 32 * 16 * 1.0 / (sb_cycle - start_cycle);
+            
+            // Read bursts with the address channel running ahead of the data
+            errors = 0;
+            beats  = 0;
+            fork
+                begin : burst_ar
+                    for (n = 0; n < 32; n = n + 1) begin
+                        ARADDR  = SCRATCH_ADDR + 32'h400 + n * 64;
+                        ARID    = 16'h0E10;
+                        ARLEN   = 4'hF;
+                        ARSIZE  = 3'b010;
+                        ARBURST = 2'b01;
+                        ARVALID = 1'b1;
+                        @(posedge ACLK);
+                        while (!ARREADY) @(posedge ACLK);
+                        #1;
+                    end
+                    ARVALID = 1'b0;
+                end
+                begin : burst_r
+                    RREADY = 1'b1;
+                    while (beats < 32 * 16) begin
+                        @(posedge ACLK);
+                        if (RVALID) begin
+                            if (beats == 0)
+                                first_beat = sb_cycle;
+                            last_beat = sb_cycle;
+                            if (RDATA !== scratch_model[32'h100 + beats] || RLAST !== (beats % 16 == 15))
+                                errors = errors + 1;
+                            beats = beats + 1;
+                        end
+                    end
+                    #1;
+                    RREADY = 1'b0;
+                end
+            join
+            read_rate = beats * 1.0 / (last_beat - first_beat + 1);
+            
+            $display("  Writes: %0.3f beats/cycle including AW and B; reads: %0.3f beats/cycle", write_rate, read_rate);
+            if (errors == 0 && scratch_errors == 0 && read_rate >= MIN_BURST_READ_BEATS_PER_CYCLE &&
+                write_rate >= MIN_BURST_WRITE_BEATS_PER_CYCLE) begin
+                $display("  PASS: Above %0.2f read and %0.2f write beats/cycle", MIN_BURST_READ_BEATS_PER_CYCLE,
+                         MIN_BURST_WRITE_BEATS_PER_CYCLE);
+                ++pass_count;
+            end else begin
+                $display("  FAIL: %0d data errors, floors %0.2f read / %0.2f write", errors + scratch_errors,
+                         MIN_BURST_READ_BEATS_PER_CYCLE, MIN_BURST_WRITE_BEATS_PER_CYCLE);
+                ++fail_count;
+            end
+        end
+
+        // Test 22: The golden model rejects an all-zero capture
+        begin
+            integer bad;
+            $display("\nTest %0d: All-zero RNGDATA capture is off-sequence", ++test_count);
+            bad = rng_model_lfsr_follows(0, 0, 64) + rng_model_lfsr_follows(0, 32'hACE1, 64) +
+                  rng_model_lfsr_follows(32'hACE1, 0, 64);
+            if (bad == 0 && rng_model_lfsr_follows(32'hACE1, 32'h000159C3, 64)) begin
+                $display("  PASS: Zero samples never follow the LFSR, a real step still does");
+                ++pass_count;
+            end else begin
+                $display("  FAIL: %0d zero pairs accepted as LFSR steps", bad);
+                ++fail_count;
+            end
+        end
+
         #200;
         
         // Summary
@@ -341,9 +1489,9 @@ module rng_axi_slave_tb;
         $finish;
     end
     
-    // Timeout watchdog
+    // Timeout watchdog: the directed tests plus a generous 20 cycles per random read
     initial begin
-        #100000;
+        #(64'd1000000 + 64'd200 * RANDOM_READS);
         $display("ERROR: Testbench timeout!");
         $finish;
     end
@@ -0,0 +1,60 @@
+// DPI-C bindings exposing the host-side RNG peripheral model (rng_model.hpp)
+// to rng_axi_slave_tb.sv, so simulation and on-board captures are scored by
+// the same implementation. Only C-compatible argument types are used, so no
+// simulator-specific svdpi.h is required.
+//
+// Build: make dpi (produces rtl/sim/rng_model_dpi.so)
+
+#include "../../rng_model.hpp"
+
+namespace
+{
+RngPeripheralModel &model()
+{
+    static RngPeripheralModel instance;
+    return instance;
+}
+} // namespace
+
+extern "C"
+{
+
+void rng_model_reset()
+{
+    model().reset();
+}
+
+int rng_model_read(unsigned long long const cycle, unsigned int const offset, unsigned int *data)
+{
+    uint32_t value{0};
+    int const resp{static_cast<int>(model().read(cycle, offset, value))};
+    *data = value;
+    return resp;
+}
+
+unsigned int rng_model_preview_write(unsigned int const offset, unsigned int const data, unsigned int const strobe)
+{
+    return model().preview_write(offset, data, strobe);
+}
+
+int rng_model_write(unsigned int const offset, unsigned int const data, unsigned int const strobe)
+{
+    return static_cast<int>(model().write(offset, data, strobe));
+}
+
+void rng_model_set_register(unsigned int const offset, unsigned int const value)
+{
+    model().set_register(offset, value);
+}
+
+unsigned int rng_model_lfsr_advance(unsigned int const state, unsigned long long const steps)
+{
+    return LfsrModel::advance(state, steps);
+}
+
+int rng_model_lfsr_follows(unsigned int const from, unsigned int const to, unsigned int const max_steps)
+{
+    return LfsrModel::distance(from, to, max_steps).has_value();
+}
+
+} // extern "C"
@@ -0,0 +1,188 @@
+`timescale 1ns / 1ps
+//////////////////////////////////////////////////////////////////////////////////
+// Company:
+// Engineer:
+//
+// Create Date: 18.10.2026 10:12:40
+// Design Name:
+// Module Name: axi_rng_dma
+// Project Name:
+// Target Devices:
+// Tool Versions:
+// Description: AXI master that streams LFSR output into a DRAM ring buffer.
+//              The ring is described by the AMS_DMA* registers of
+//              axi_rng_slave. The producer index only advances once the
+//              interconnect has returned an OKAY write response, so the host
+//              never observes words that have not landed in memory.
+//
+// Dependencies: lfsr.v (via axi_rng_slave)
+//
+// Revision:
+// Revision 0.01 - File Created
+// Additional Comments:
+//   Producer/consumer indices are free-running 32-bit word counts, so the
+//   ring is empty when they are equal and holds (prod - cons) words otherwise.
+//   base_addr must be BURST_BYTES aligned and ring_bytes a non-zero multiple
+//   of BURST_BYTES; bursts then never cross a 4KB boundary.
+//
+//////////////////////////////////////////////////////////////////////////////////
+
+module axi_rng_dma #(
+    parameter BURST_BEATS = 16
+)(
+    // Global signals
+    input  wire        ACLK,
+    input  wire        ARESETn,
+
+    // Descriptor (from the axi_rng_slave register file)
+    input  wire        enable,
+    input  wire        clear,
+    input  wire [31:0] base_addr,
+    input  wire [31:0] ring_bytes,
+    input  wire [31:0] cons_index,
+    input  wire [31:0] random_data,
+
+    // Status
+    output reg  [31:0] prod_index,
+    output wire        busy,
+    output reg         error,
+    output wire        full,
+
+    // AXI Master Write Address Channel
+    output wire [15:0] M_AWID,
+    output reg  [31:0] M_AWADDR,
+    output wire [3:0]  M_AWLEN,
+    output wire [2:0]  M_AWSIZE,
+    output wire [1:0]  M_AWBURST,
+    output reg         M_AWVALID,
+    input  wire        M_AWREADY,
+
+    // AXI Master Write Data Channel
+    output reg  [31:0] M_WDATA,
+    output wire [3:0]  M_WSTRB,
+    output reg         M_WLAST,
+    output reg         M_WVALID,
+    input  wire        M_WREADY,
+
+    // AXI Master Write Response Channel
+    input  wire [15:0] M_BID,
+    input  wire [1:0]  M_BRESP,
+    input  wire        M_BVALID,
+    output reg         M_BREADY
+);
+
+    localparam BURST_BYTES = BURST_BEATS * 4;
+
+    // Fixed burst shape: INCR, 32-bit beats, all byte lanes
+    assign M_AWID    = 16'h0;
+    assign M_AWLEN   = BURST_BEATS - 1;
+    assign M_AWSIZE  = 3'b010;
+    assign M_AWBURST = 2'b01;
+    assign M_WSTRB   = 4'hF;
+
+    reg  [31:0] ring_offset;
+    reg  [7:0]  beat_count;
+    reg         clear_pending;
+
+    wire [31:0] ring_words = {2'b00, ring_bytes[31:2]};
+    wire [31:0] fill       = prod_index - cons_index;
+    wire        space      = (fill + BURST_BEATS) <= ring_words;
+
+    assign full = !space;
+
+    // State machine states
+    reg [1:0] dma_state;
+
+    localparam DMA_IDLE  = 2'b00;
+    localparam DMA_BURST = 2'b01;
+    localparam DMA_RESP  = 2'b10;
+
+    assign busy = (dma_state != DMA_IDLE);
+
+    //=========================================================================
+    // DMA WRITE STATE MACHINE
+    //=========================================================================
+    always @(posedge ACLK or negedge ARESETn) begin
+        if (!ARESETn) begin
+            M_AWADDR      <= 32'h0;
+            M_AWVALID     <= 1'b0;
+            M_WDATA       <= 32'h0;
+            M_WLAST       <= 1'b0;
+            M_WVALID      <= 1'b0;
+            M_BREADY      <= 1'b0;
+            prod_index    <= 32'h0;
+            ring_offset   <= 32'h0;
+            beat_count    <= 8'h0;
+            error         <= 1'b0;
+            clear_pending <= 1'b0;
+            dma_state     <= DMA_IDLE;
+        end else begin
+            // A clear may arrive mid-burst; hold it until the burst retires
+            if (clear)
+                clear_pending <= 1'b1;
+
+            case (dma_state)
+                DMA_IDLE: begin
+                    if (clear || clear_pending) begin
+                        prod_index    <= 32'h0;
+                        ring_offset   <= 32'h0;
+                        error         <= 1'b0;
+                        clear_pending <= 1'b0;
+                    end else if (enable && !error && space && ring_bytes >= BURST_BYTES) begin
+                        // Issue address and first data beat together
+                        M_AWADDR   <= base_addr + ring_offset;
+                        M_AWVALID  <= 1'b1;
+                        M_WDATA    <= random_data;
+                        M_WVALID   <= 1'b1;
+                        M_WLAST    <= (BURST_BEATS == 1);
+                        beat_count <= 8'h0;
+                        dma_state  <= DMA_BURST;
+                    end
+                end
+
+                DMA_BURST: begin
+                    if (M_AWVALID && M_AWREADY)
+                        M_AWVALID <= 1'b0;
+
+                    if (M_WVALID && M_WREADY) begin
+                        if (M_WLAST) begin
+                            M_WVALID  <= 1'b0;
+                            M_WLAST   <= 1'b0;
+                            M_BREADY  <= 1'b1;
+                            dma_state <= DMA_RESP;
+                        end else begin
+                            // Next beat samples the LFSR as it is now
+                            M_WDATA    <= random_data;
+                            M_WLAST    <= (beat_count == BURST_BEATS - 2);
+                            beat_count <= beat_count + 8'd1;
+                        end
+                    end
+                end
+
+                DMA_RESP: begin
+                    // The address may legally be accepted after the last beat
+                    if (M_AWVALID && M_AWREADY)
+                        M_AWVALID <= 1'b0;
+
+                    if (M_BVALID) begin
+                        M_BREADY <= 1'b0;
+                        if (M_BRESP != 2'b00) begin
+                            // Halt until the host clears the error
+                            error <= 1'b1;
+                        end else begin
+                            prod_index  <= prod_index + BURST_BEATS;
+                            ring_offset <= (ring_offset + BURST_BYTES >= ring_bytes) ?
+                                           32'h0 : ring_offset + BURST_BYTES;
+                        end
+                        dma_state <= DMA_IDLE;
+                    end
+                end
+
+                default: begin
+                    dma_state <= DMA_IDLE;
+                end
+            endcase
+        end
+    end
+
+endmodule
@@ -20,7 +20,14 @@
 //////////////////////////////////////////////////////////////////////////////////
 `timescale 1ns / 1ps
 
-module axi_rng_slave (
+module axi_rng_slave #(
+    parameter DMA_ENABLE    = 0,
+    parameter OUTSTANDING   = 4,
+    // Block-RAM scratchpad: a power-of-two size (0 leaves it out), based on a
+    // multiple of its size within the slave's 16MB window
+    parameter SCRATCH_BYTES = 16384,
+    parameter SCRATCH_BASE  = 24'h800000
+)(
     // Global signals
     input  wire        ACLK,
     input  wire        ARESETn,
@@ -36,7 +43,7 @@ module axi_rng_slave (
 
     // AXI Read Data Channel
     output reg  [15:0] RID,
-    output reg  [31:0] RDATA,
+    output wire [31:0] RDATA,
     output reg  [1:0]  RRESP,
     output reg         RLAST,
     output reg         RVALID,
@@ -61,7 +68,29 @@ module axi_rng_slave (
     output reg  [15:0] BID,
     output reg  [1:0]  BRESP,
     output reg         BVALID,
-    input  wire        BREADY
+    input  wire        BREADY,
+
+    // DMA AXI Master Write Address Channel (idle when DMA_ENABLE == 0)
+    output wire [15:0] M_AWID,
+    output wire [31:0] M_AWADDR,
+    output wire [3:0]  M_AWLEN,
+    output wire [2:0]  M_AWSIZE,
+    output wire [1:0]  M_AWBURST,
+    output wire        M_AWVALID,
+    input  wire        M_AWREADY,
+
+    // DMA AXI Master Write Data Channel
+    output wire [31:0] M_WDATA,
+    output wire [3:0]  M_WSTRB,
+    output wire        M_WLAST,
+    output wire        M_WVALID,
+    input  wire        M_WREADY,
+
+    // DMA AXI Master Write Response Channel
+    input  wire [15:0] M_BID,
+    input  wire [1:0]  M_BRESP,
+    input  wire        M_BVALID,
+    output wire        M_BREADY
 );
 
     // Internal registers
@@ -69,27 +98,116 @@ module axi_rng_slave (
     reg  [31:0] control_reg; // 0x004: Control register
     reg  [31:0] seed_reg; // 0x008: Seed register
     reg  [31:0] read_count; // 0x00C: Read counter
+    reg  [31:0] dma_base_reg; // 0x010: DMA ring base address
+    reg  [31:0] dma_len_reg; // 0x014: DMA ring length in bytes
+    reg         dma_enable; // 0x018: DMA control (bit 0)
+    reg         dma_clear; // 0x018: DMA control (bit 1, self-clearing)
+    reg  [31:0] dma_cons_reg; // 0x020: DMA consumer index
+
+    wire [31:0] dma_prod_index; // 0x01C: DMA producer index
+    wire        dma_busy;
+    wire        dma_error;
+    wire        dma_full;
+    wire [31:0] dma_status = {13'h0, dma_full, dma_error, dma_busy, 15'h0, dma_enable};
+
+    // Performance counters. Live counters run freely; a snapshot strobe
+    // copies all of them at once so the host reads a consistent set.
+    reg         perf_snapshot; // 0x040: bit 0, self-clearing
+    reg         perf_clear; // 0x040: bit 1, self-clearing
+    reg  [31:0] perf_cycles;
+    reg  [31:0] perf_idle;
+    reg  [31:0] perf_rbeats;
+    reg  [31:0] perf_wbeats;
+    reg  [31:0] perf_rstall;
+    reg  [31:0] perf_bstall;
+    reg  [31:0] perf_slverr;
+    reg  [31:0] perf_maxout;
+    reg  [31:0] snap_cycles; // 0x044
+    reg  [31:0] snap_idle; // 0x048
+    reg  [31:0] snap_rbeats; // 0x04C
+    reg  [31:0] snap_wbeats; // 0x050
+    reg  [31:0] snap_rstall; // 0x054
+    reg  [31:0] snap_bstall; // 0x058
+    reg  [31:0] snap_slverr; // 0x05C
+    reg  [31:0] snap_maxout; // 0x060
+
+    // Scratchpad: one byte-writable read port and one write port, so a
+    // read burst and a write burst can each stream one beat per cycle
+    localparam SCRATCH_ADDR_BITS = (SCRATCH_BYTES > 4) ? $clog2(SCRATCH_BYTES) : 3;
+    localparam SCRATCH_WORDS     = (SCRATCH_BYTES > 4) ? SCRATCH_BYTES / 4 : 1;
+    localparam [23:0] SCRATCH_MASK = ~(SCRATCH_BYTES - 1);
+
+    reg  [31:0] scratch_mem [0:SCRATCH_WORDS-1];
+    reg  [31:0] scratch_rdata;
+    integer     lane;
 
-    reg  [15:0] latched_arid;
-    reg  [31:0] latched_araddr;
     reg  [15:0] latched_awid;
     reg  [31:0] latched_awaddr;
     reg  [31:0] latched_wdata;
     reg  [7:0]  latched_wstrb;
 
+    // Outstanding read slots. Each slot holds a decoded response until the
+    // R channel can take it; slot_older[i][j] is set while slot j is an
+    // older, still-pending read than slot i.
+    localparam SLOT_BITS = (OUTSTANDING > 1) ? $clog2(OUTSTANDING) : 1;
+
+    reg  [OUTSTANDING-1:0] slot_valid;
+    reg  [OUTSTANDING-1:0] slot_older [0:OUTSTANDING-1];
+    reg  [15:0]            slot_id    [0:OUTSTANDING-1];
+    reg  [31:0]            slot_data  [0:OUTSTANDING-1];
+    reg  [1:0]             slot_resp  [0:OUTSTANDING-1];
+    reg  [SLOT_BITS-1:0]   last_grant;
+
+    // Scratchpad reads are bursts: the slot keeps where the burst starts and
+    // the R channel streams its beats from the scratchpad once granted
+    reg  [OUTSTANDING-1:0]       slot_burst;
+    reg  [SCRATCH_ADDR_BITS-1:0] slot_addr  [0:OUTSTANDING-1];
+    reg  [3:0]                   slot_len   [0:OUTSTANDING-1];
+    reg  [2:0]                   slot_size  [0:OUTSTANDING-1];
+    reg  [OUTSTANDING-1:0]       slot_fixed;
+
+    // Read burst in progress on the R channel
+    reg  [31:0]                  r_reg_data; // RDATA for register reads
+    reg                          r_from_scratch;
+    reg  [3:0]                   rburst_left; // Beats still to issue after the one on the channel
+    reg  [SCRATCH_ADDR_BITS-1:0] rburst_addr;
+    reg  [2:0]                   rburst_size;
+    reg                          rburst_fixed;
+
+    // Write burst in progress (WRITE_BURST)
+    reg  [3:0]                   wburst_left; // Beats still to accept after the current one
+    reg  [SCRATCH_ADDR_BITS-1:0] wburst_addr;
+    reg  [2:0]                   wburst_size;
+    reg                          wburst_fixed;
+    reg  [1:0]                   wburst_resp;
+    reg                          wburst_latched; // First beat arrived before the address and is in latched_wdata
+
     // State machine states
-    reg [1:0] read_state;
     reg [2:0] write_state;
 
-    localparam READ_IDLE     = 2'b00;
-    localparam READ_DECODE   = 2'b01;
-    localparam READ_RESPOND  = 2'b10;
-
     localparam WRITE_IDLE    = 3'b000;
     localparam WRITE_ADDR    = 3'b001;
     localparam WRITE_DATA    = 3'b010;
     localparam WRITE_EXEC    = 3'b011;
     localparam WRITE_RESP    = 3'b100;
+    localparam WRITE_BURST   = 3'b101;
+
+    // Address of the next beat of a burst: FIXED repeats it, INCR moves to the
+    // next 'size'-aligned transfer (WRAP is refused when the burst is accepted)
+    function [SCRATCH_ADDR_BITS-1:0] next_beat_addr;
+        input [SCRATCH_ADDR_BITS-1:0] addr;
+        input [2:0]                   size;
+        input                         fixed;
+        begin
+            if (fixed)
+                next_beat_addr = addr;
+            else
+                next_beat_addr = (addr & ~((1 << size) - 1)) + (1 << size);
+        end
+    endfunction
+
+    wire ar_scratch = (SCRATCH_BYTES != 0) && ((ARADDR[23:0] & SCRATCH_MASK) == SCRATCH_BASE);
+    wire aw_scratch = (SCRATCH_BYTES != 0) && ((AWADDR[23:0] & SCRATCH_MASK) == SCRATCH_BASE);
 
     // RNG instance
     lfsr u_rng (
@@ -99,89 +217,373 @@ module axi_rng_slave (
         .random_data(random_data)
     );
 
+    // Optional DMA engine
+    generate
+        if (DMA_ENABLE) begin : g_dma
+            axi_rng_dma u_dma (
+                .ACLK(ACLK),
+                .ARESETn(ARESETn),
+                .enable(dma_enable),
+                .clear(dma_clear),
+                .base_addr(dma_base_reg),
+                .ring_bytes(dma_len_reg),
+                .cons_index(dma_cons_reg),
+                .random_data(random_data),
+                .prod_index(dma_prod_index),
+                .busy(dma_busy),
+                .error(dma_error),
+                .full(dma_full),
+                .M_AWID(M_AWID),
+                .M_AWADDR(M_AWADDR),
+                .M_AWLEN(M_AWLEN),
+                .M_AWSIZE(M_AWSIZE),
+                .M_AWBURST(M_AWBURST),
+                .M_AWVALID(M_AWVALID),
+                .M_AWREADY(M_AWREADY),
+                .M_WDATA(M_WDATA),
+                .M_WSTRB(M_WSTRB),
+                .M_WLAST(M_WLAST),
+                .M_WVALID(M_WVALID),
+                .M_WREADY(M_WREADY),
+                .M_BID(M_BID),
+                .M_BRESP(M_BRESP),
+                .M_BVALID(M_BVALID),
+                .M_BREADY(M_BREADY)
+            );
+        end else begin : g_no_dma
+            assign dma_prod_index = 32'h0;
+            assign dma_busy       = 1'b0;
+            assign dma_error      = 1'b0;
+            assign dma_full       = 1'b0;
+            assign M_AWID         = 16'h0;
+            assign M_AWADDR       = 32'h0;
+            assign M_AWLEN        = 4'h0;
+            assign M_AWSIZE       = 3'b010;
+            assign M_AWBURST      = 2'b01;
+            assign M_AWVALID      = 1'b0;
+            assign M_WDATA        = 32'h0;
+            assign M_WSTRB        = 4'h0;
+            assign M_WLAST        = 1'b0;
+            assign M_WVALID       = 1'b0;
+            assign M_BREADY       = 1'b1;
+        end
+    endgenerate
+
+    //=========================================================================
+    // READ ADDRESS DECODE
+    //=========================================================================
+    // Responses are decoded as the address is accepted, so a slot is ready to
+    // return on the cycle after ARREADY.
+    reg [31:0] ar_rdata;
+    reg [1:0]  ar_rresp;
+
+    always @(*) begin
+        ar_rdata = 32'h0;
+        ar_rresp = 2'b00;
+
+        if (ar_scratch) begin
+            // Data streams from the scratchpad when the burst is granted
+            ar_rdata = 32'h0;
+            ar_rresp = (ARBURST == 2'b10) ? 2'b10 : 2'b00; // WRAP bursts are not supported
+        end else if (ARADDR[23:7] == 17'h0) begin
+            // Registers: 0x000-0x07F
+            case (ARADDR[6:2])
+                5'h00: begin // 0x000: RNG data
+                    ar_rdata = random_data;
+                    ar_rresp = 2'b00;
+                end
+                5'h01: begin // 0x004: Control register
+                    ar_rdata = control_reg;
+                    ar_rresp = 2'b00;
+                end
+                5'h02: begin // 0x008: Seed register
+                    ar_rdata = seed_reg;
+                    ar_rresp = 2'b00;
+                end
+                5'h03: begin // 0x00C: Read counter
+                    ar_rdata = read_count;
+                    ar_rresp = 2'b00;
+                end
+                5'h04: begin // 0x010: DMA ring base
+                    ar_rdata = dma_base_reg;
+                    ar_rresp = DMA_ENABLE ? 2'b00 : 2'b10;
+                end
+                5'h05: begin // 0x014: DMA ring length
+                    ar_rdata = dma_len_reg;
+                    ar_rresp = DMA_ENABLE ? 2'b00 : 2'b10;
+                end
+                5'h06: begin // 0x018: DMA control/status
+                    ar_rdata = dma_status;
+                    ar_rresp = DMA_ENABLE ? 2'b00 : 2'b10;
+                end
+                5'h07: begin // 0x01C: DMA producer index
+                    ar_rdata = dma_prod_index;
+                    ar_rresp = DMA_ENABLE ? 2'b00 : 2'b10;
+                end
+                5'h08: begin // 0x020: DMA consumer index
+                    ar_rdata = dma_cons_reg;
+                    ar_rresp = DMA_ENABLE ? 2'b00 : 2'b10;
+                end
+                5'h10: begin // 0x040: Performance counter control (write-only strobes)
+                    ar_rdata = 32'h0;
+                    ar_rresp = 2'b00;
+                end
+                5'h11: begin // 0x044: Snapshot cycle count
+                    ar_rdata = snap_cycles;
+                    ar_rresp = 2'b00;
+                end
+                5'h12: begin // 0x048: Snapshot idle cycles
+                    ar_rdata = snap_idle;
+                    ar_rresp = 2'b00;
+                end
+                5'h13: begin // 0x04C: Snapshot read beats
+                    ar_rdata = snap_rbeats;
+                    ar_rresp = 2'b00;
+                end
+                5'h14: begin // 0x050: Snapshot write beats
+                    ar_rdata = snap_wbeats;
+                    ar_rresp = 2'b00;
+                end
+                5'h15: begin // 0x054: Snapshot RREADY back-pressure cycles
+                    ar_rdata = snap_rstall;
+                    ar_rresp = 2'b00;
+                end
+                5'h16: begin // 0x058: Snapshot BREADY back-pressure cycles
+                    ar_rdata = snap_bstall;
+                    ar_rresp = 2'b00;
+                end
+                5'h17: begin // 0x05C: Snapshot SLVERR responses
+                    ar_rdata = snap_slverr;
+                    ar_rresp = 2'b00;
+                end
+                5'h18: begin // 0x060: Snapshot peak outstanding reads
+                    ar_rdata = snap_maxout;
+                    ar_rresp = 2'b00;
+                end
+                default: begin
+                    ar_rdata = 32'hDEADBEEF;
+                    ar_rresp = 2'b10; // SLVERR
+                end
+            endcase
+        end else begin
+            // Out of range - return error
+            ar_rdata = 32'hDEADBEEF;
+            ar_rresp = 2'b10; // SLVERR
+        end
+    end
+
+    //=========================================================================
+    // READ SLOT ALLOCATION AND RESPONSE ARBITRATION
+    //=========================================================================
+    reg  [OUTSTANDING-1:0] slot_eligible;
+    reg  [SLOT_BITS-1:0]   free_slot;
+    reg  [SLOT_BITS:0]     free_count;
+    reg  [SLOT_BITS-1:0]   grant_slot;
+    reg                    grant_found;
+    integer                i, j, k;
+
+    always @(*) begin
+        free_slot  = {SLOT_BITS{1'b0}};
+        free_count = {(SLOT_BITS+1){1'b0}};
+        for (i = OUTSTANDING - 1; i >= 0; i = i - 1) begin
+            if (!slot_valid[i]) begin
+                free_slot  = i;
+                free_count = free_count + 1'b1;
+            end
+        end
+
+        // A slot may respond once no older read with the same ID is pending
+        for (i = 0; i < OUTSTANDING; i = i + 1) begin
+            slot_eligible[i] = slot_valid[i];
+            for (j = 0; j < OUTSTANDING; j = j + 1)
+                if (slot_older[i][j] && slot_id[j] == slot_id[i])
+                    slot_eligible[i] = 1'b0;
+        end
+
+        // Round-robin between eligible slots, starting after the last grant
+        grant_found = 1'b0;
+        grant_slot  = {SLOT_BITS{1'b0}};
+        for (i = 1; i <= OUTSTANDING; i = i + 1) begin
+            if (!grant_found && slot_eligible[(last_grant + i) % OUTSTANDING]) begin
+                grant_found = 1'b1;
+                grant_slot  = (last_grant + i) % OUTSTANDING;
+            end
+        end
+    end
+
+    wire ar_handshake = ARVALID && ARREADY;
+    wire r_advance    = !RVALID || RREADY;
+    wire r_burst_beat = r_advance && (rburst_left != 4'h0);
+    wire r_load       = grant_found && r_advance && (rburst_left == 4'h0);
+
+    assign RDATA = r_from_scratch ? scratch_rdata : r_reg_data;
+
+    //=========================================================================
+    // SCRATCHPAD
+    //=========================================================================
+    // The read port fetches a beat only when the R channel can take it, so
+    // scratch_rdata holds the beat on the channel steady under back-pressure
+    wire                         scratch_ren  = r_burst_beat || (r_load && slot_burst[grant_slot]);
+    wire [SCRATCH_ADDR_BITS-1:0] scratch_raddr = r_burst_beat ? rburst_addr : slot_addr[grant_slot];
+
+    wire        scratch_wbeat = (write_state == WRITE_BURST) && (wburst_latched || (WVALID && WREADY));
+    wire        scratch_we    = scratch_wbeat && (wburst_resp == 2'b00);
+    wire [31:0] scratch_wdata = wburst_latched ? latched_wdata : WDATA;
+    wire [3:0]  scratch_wstrb = wburst_latched ? latched_wstrb[3:0] : WSTRB[3:0];
+
+    always @(posedge ACLK) begin
+        if (scratch_ren)
+            scratch_rdata <= scratch_mem[scratch_raddr[SCRATCH_ADDR_BITS-1:2]];
+        if (scratch_we) begin
+            for (lane = 0; lane < 4; lane = lane + 1)
+                if (scratch_wstrb[lane])
+                    scratch_mem[wburst_addr[SCRATCH_ADDR_BITS-1:2]][lane*8 +: 8] <= scratch_wdata[lane*8 +: 8];
+        end
+    end
+
     //=========================================================================
-    // READ CHANNEL STATE MACHINE
+    // READ CHANNEL
     //=========================================================================
     always @(posedge ACLK or negedge ARESETn) begin
         if (!ARESETn) begin
             ARREADY        <= 1'b0;
             RID            <= 16'h0;
-            RDATA          <= 32'h0;
+            r_reg_data     <= 32'h0;
+            r_from_scratch <= 1'b0;
             RRESP          <= 2'b00;
             RLAST          <= 1'b0;
             RVALID         <= 1'b0;
-            latched_arid   <= 16'h0;
-            latched_araddr <= 32'h0;
             read_count     <= 32'h0;
-            read_state     <= READ_IDLE;
+            slot_valid     <= {OUTSTANDING{1'b0}};
+            slot_burst     <= {OUTSTANDING{1'b0}};
+            slot_fixed     <= {OUTSTANDING{1'b0}};
+            last_grant     <= {SLOT_BITS{1'b0}};
+            rburst_left    <= 4'h0;
+            rburst_addr    <= {SCRATCH_ADDR_BITS{1'b0}};
+            rburst_size    <= 3'b010;
+            rburst_fixed   <= 1'b0;
+            for (k = 0; k < OUTSTANDING; k = k + 1) begin
+                slot_older[k] <= {OUTSTANDING{1'b0}};
+                slot_id[k]    <= 16'h0;
+                slot_data[k]  <= 32'h0;
+                slot_resp[k]  <= 2'b00;
+                slot_addr[k]  <= {SCRATCH_ADDR_BITS{1'b0}};
+                slot_len[k]   <= 4'h0;
+                slot_size[k]  <= 3'b010;
+            end
         end else begin
-            case (read_state)
-                READ_IDLE: begin
-                    ARREADY <= 1'b0;
-                    RVALID  <= 1'b0;
-                    RLAST   <= 1'b0;
-
-                    if (ARVALID) begin
-                        // Accept address
-                        ARREADY        <= 1'b1;
-                        latched_arid   <= ARID;
-                        latched_araddr <= ARADDR;
-                        read_state     <= READ_DECODE;
-                    end
+            if (r_burst_beat) begin
+                // Next beat of a scratchpad burst; the read port fetches it this cycle
+                RVALID      <= 1'b1;
+                RLAST       <= (rburst_left == 4'h1);
+                rburst_left <= rburst_left - 4'h1;
+                rburst_addr <= next_beat_addr(rburst_addr, rburst_size, rburst_fixed);
+            end else if (r_load) begin
+                // Move the granted slot into the R channel output register
+                RID            <= slot_id[grant_slot];
+                r_reg_data     <= slot_data[grant_slot];
+                r_from_scratch <= slot_burst[grant_slot];
+                RRESP          <= slot_resp[grant_slot];
+                RLAST          <= !slot_burst[grant_slot] || (slot_len[grant_slot] == 4'h0);
+                RVALID         <= 1'b1;
+                last_grant     <= grant_slot;
+                slot_valid[grant_slot] <= 1'b0;
+                for (k = 0; k < OUTSTANDING; k = k + 1)
+                    slot_older[k][grant_slot] <= 1'b0;
+                if (slot_burst[grant_slot]) begin
+                    rburst_left  <= slot_len[grant_slot];
+                    rburst_addr  <= next_beat_addr(slot_addr[grant_slot], slot_size[grant_slot], slot_fixed[grant_slot]);
+                    rburst_size  <= slot_size[grant_slot];
+                    rburst_fixed <= slot_fixed[grant_slot];
                 end
+            end else if (RREADY) begin
+                // Master accepted data
+                RVALID <= 1'b0;
+                RLAST  <= 1'b0;
+            end
+
+            // Accept a new address into the lowest free slot
+            if (ar_handshake) begin
+                slot_valid[free_slot] <= 1'b1;
+                slot_older[free_slot] <= r_load ? (slot_valid & ~(1 << grant_slot)) : slot_valid;
+                slot_id[free_slot]    <= ARID;
+                slot_data[free_slot]  <= ar_rdata;
+                slot_resp[free_slot]  <= ar_rresp;
+                slot_burst[free_slot] <= ar_scratch;
+                slot_addr[free_slot]  <= ARADDR[SCRATCH_ADDR_BITS-1:0];
+                slot_len[free_slot]   <= ARLEN;
+                slot_size[free_slot]  <= ARSIZE;
+                slot_fixed[free_slot] <= (ARBURST == 2'b00);
+                if (ARADDR[23:2] == 22'h0)
+                    read_count <= read_count + 32'd1;
+            end
+
+            // Keep ARREADY high while a slot will be free next cycle
+            ARREADY <= (free_count - ar_handshake + r_load) != 0;
+        end
+    end
 
-                READ_DECODE: begin
-                    ARREADY <= 1'b0;
-
-                    // Decode address and prepare response
-                    RID   <= latched_arid;
-                    RLAST <= 1'b1;
-
-                    // Check if address is within valid range (0x000-0x00F)
-                    if (latched_araddr[23:4] == 4'h0) begin
-                        case (latched_araddr[3:2])
-                            2'h0: begin // 0x000: RNG data
-                                RDATA <= random_data;
-                                RRESP <= 2'b00;
-                                read_count <= read_count + 32'd1;
-                            end
-                            2'h1: begin // 0x004: Control register
-                                RDATA <= control_reg;
-                                RRESP <= 2'b00;
-                            end
-                            2'h2: begin // 0x008: Seed register
-                                RDATA <= seed_reg;
-                                RRESP <= 2'b00;
-                            end
-                            2'h3: begin // 0x00C: Read counter
-                                RDATA <= read_count;
-                                RRESP <= 2'b00;
-                            end
-                        endcase
-                    end else begin
-                        // Out of range - return error
-                        RDATA <= 32'hDEADBEEF;
-                        RRESP <= 2'b10; // SLVERR
-                    end
-
-                    RVALID     <= 1'b1;
-                    read_state <= READ_RESPOND;
-                end
+    //=========================================================================
+    // PERFORMANCE COUNTERS
+    //=========================================================================
+    // Reads in flight: occupied slots plus the response held on the R channel
+    wire [SLOT_BITS+1:0] reads_outstanding = (OUTSTANDING - free_count) + RVALID;
 
-                READ_RESPOND: begin
-                    if (RREADY) begin
-                        // Master accepted data
-                        RVALID     <= 1'b0;
-                        RLAST      <= 1'b0;
-                        read_state <= READ_IDLE;
-                    end
-                    // Otherwise stay in this state until master is ready
-                end
+    wire       slave_idle = (slot_valid == {OUTSTANDING{1'b0}}) && !RVALID && !ARVALID && (rburst_left == 4'h0) &&
+                            (write_state == WRITE_IDLE) && !AWVALID && !WVALID;
+    wire [1:0] slverr_events = (RVALID && RREADY && RRESP[1]) + (BVALID && BREADY && BRESP[1]);
 
-                default: begin
-                    read_state <= READ_IDLE;
-                end
-            endcase
+    always @(posedge ACLK or negedge ARESETn) begin
+        if (!ARESETn) begin
+            perf_cycles <= 32'h0;
+            perf_idle   <= 32'h0;
+            perf_rbeats <= 32'h0;
+            perf_wbeats <= 32'h0;
+            perf_rstall <= 32'h0;
+            perf_bstall <= 32'h0;
+            perf_slverr <= 32'h0;
+            perf_maxout <= 32'h0;
+            snap_cycles <= 32'h0;
+            snap_idle   <= 32'h0;
+            snap_rbeats <= 32'h0;
+            snap_wbeats <= 32'h0;
+            snap_rstall <= 32'h0;
+            snap_bstall <= 32'h0;
+            snap_slverr <= 32'h0;
+            snap_maxout <= 32'h0;
+        end else begin
+            // Snapshot sees the counts up to (not including) this cycle
+            if (perf_snapshot) begin
+                snap_cycles <= perf_cycles;
+                snap_idle   <= perf_idle;
+                snap_rbeats <= perf_rbeats;
+                snap_wbeats <= perf_wbeats;
+                snap_rstall <= perf_rstall;
+                snap_bstall <= perf_bstall;
+                snap_slverr <= perf_slverr;
+                snap_maxout <= perf_maxout;
+            end
+
+            if (perf_clear) begin
+                perf_cycles <= 32'h0;
+                perf_idle   <= 32'h0;
+                perf_rbeats <= 32'h0;
+                perf_wbeats <= 32'h0;
+                perf_rstall <= 32'h0;
+                perf_bstall <= 32'h0;
+                perf_slverr <= 32'h0;
+                perf_maxout <= 32'h0;
+            end else begin
+                perf_cycles <= perf_cycles + 32'd1;
+                perf_idle   <= perf_idle   + slave_idle;
+                perf_rbeats <= perf_rbeats + (RVALID && RREADY);
+                perf_wbeats <= perf_wbeats + (WVALID && WREADY);
+                perf_rstall <= perf_rstall + (RVALID && !RREADY);
+                perf_bstall <= perf_bstall + (BVALID && !BREADY);
+                perf_slverr <= perf_slverr + slverr_events;
+                if (reads_outstanding > perf_maxout)
+                    perf_maxout <= reads_outstanding;
+            end
         end
     end
 
@@ -201,8 +603,26 @@ module axi_rng_slave (
             latched_wstrb  <= 8'h0;
             control_reg    <= 32'h0;
             seed_reg       <= 32'hACE1;
+            dma_base_reg   <= 32'h0;
+            dma_len_reg    <= 32'h0;
+            dma_enable     <= 1'b0;
+            dma_clear      <= 1'b0;
+            dma_cons_reg   <= 32'h0;
+            perf_snapshot  <= 1'b0;
+            perf_clear     <= 1'b0;
+            wburst_left    <= 4'h0;
+            wburst_addr    <= {SCRATCH_ADDR_BITS{1'b0}};
+            wburst_size    <= 3'b010;
+            wburst_fixed   <= 1'b0;
+            wburst_resp    <= 2'b00;
+            wburst_latched <= 1'b0;
             write_state    <= WRITE_IDLE;
         end else begin
+            // DMA clear and counter control are single-cycle strobes
+            dma_clear     <= 1'b0;
+            perf_snapshot <= 1'b0;
+            perf_clear    <= 1'b0;
+
             case (write_state)
                 WRITE_IDLE: begin
                     AWREADY <= 1'b0;
@@ -210,7 +630,19 @@ module axi_rng_slave (
                     BVALID  <= 1'b0;
 
                     // Wait for either address or data first
-                    if (AWVALID && WVALID) begin
+                    if (AWVALID && aw_scratch) begin
+                        // Scratchpad burst: take the address, then stream the data beats
+                        AWREADY        <= 1'b1;
+                        WREADY         <= 1'b1;
+                        latched_awid   <= AWID;
+                        wburst_left    <= AWLEN;
+                        wburst_addr    <= AWADDR[SCRATCH_ADDR_BITS-1:0];
+                        wburst_size    <= AWSIZE;
+                        wburst_fixed   <= (AWBURST == 2'b00);
+                        wburst_resp    <= (AWBURST == 2'b10) ? 2'b10 : 2'b00;
+                        wburst_latched <= 1'b0;
+                        write_state    <= WRITE_BURST;
+                    end else if (AWVALID && WVALID) begin
                         // Both arrive together
                         AWREADY        <= 1'b1;
                         WREADY         <= 1'b1;
@@ -238,7 +670,18 @@ module axi_rng_slave (
                     // Waiting for address (already have data)
                     WREADY <= 1'b0;
 
-                    if (AWVALID) begin
+                    if (AWVALID && aw_scratch) begin
+                        // Scratchpad burst whose first beat is already latched
+                        AWREADY        <= 1'b1;
+                        latched_awid   <= AWID;
+                        wburst_left    <= AWLEN;
+                        wburst_addr    <= AWADDR[SCRATCH_ADDR_BITS-1:0];
+                        wburst_size    <= AWSIZE;
+                        wburst_fixed   <= (AWBURST == 2'b00);
+                        wburst_resp    <= (AWBURST == 2'b10) ? 2'b10 : 2'b00;
+                        wburst_latched <= 1'b1;
+                        write_state    <= WRITE_BURST;
+                    end else if (AWVALID) begin
                         AWREADY        <= 1'b1;
                         latched_awid   <= AWID;
                         latched_awaddr <= AWADDR;
@@ -246,6 +689,26 @@ module axi_rng_slave (
                     end
                 end
 
+                WRITE_BURST: begin
+                    // One beat per cycle: WREADY stays high until the last beat is taken
+                    AWREADY <= 1'b0;
+
+                    if (scratch_wbeat) begin
+                        wburst_latched <= 1'b0;
+                        if (wburst_left == 4'h0) begin
+                            WREADY      <= 1'b0;
+                            BID         <= latched_awid;
+                            BRESP       <= wburst_resp;
+                            BVALID      <= 1'b1;
+                            write_state <= WRITE_RESP;
+                        end else begin
+                            WREADY      <= 1'b1;
+                            wburst_left <= wburst_left - 4'h1;
+                            wburst_addr <= next_beat_addr(wburst_addr, wburst_size, wburst_fixed);
+                        end
+                    end
+                end
+
                 WRITE_DATA: begin
                     // Waiting for data (already have address)
                     AWREADY <= 1'b0;
@@ -263,29 +726,73 @@ module axi_rng_slave (
                     AWREADY <= 1'b0;
                     WREADY  <= 1'b0;
 
-                    // Check if address is within valid range (0x000-0x00F)
-                    if (latched_awaddr[23:4] == 4'h0) begin
-                        case (latched_awaddr[3:2])
-                            2'h0: begin // 0x000: RNG data (read-only)
+                    // Check if address is within valid range (0x000-0x07F)
+                    if (latched_awaddr[23:7] == 17'h0) begin
+                        case (latched_awaddr[6:2])
+                            5'h00: begin // 0x000: RNG data (read-only)
                                 BRESP <= 2'b00; // OKAY but ignored
                             end
-                            2'h1: begin // 0x004: Control register
+                            5'h01: begin // 0x004: Control register
                                 if (latched_wstrb[0]) control_reg[7:0]   <= latched_wdata[7:0];
                                 if (latched_wstrb[1]) control_reg[15:8]  <= latched_wdata[15:8];
                                 if (latched_wstrb[2]) control_reg[23:16] <= latched_wdata[23:16];
                                 if (latched_wstrb[3]) control_reg[31:24] <= latched_wdata[31:24];
                                 BRESP <= 2'b00;
                             end
-                            2'h2: begin // 0x008: Seed register
+                            5'h02: begin // 0x008: Seed register
                                 if (latched_wstrb[0]) seed_reg[7:0]   <= latched_wdata[7:0];
                                 if (latched_wstrb[1]) seed_reg[15:8]  <= latched_wdata[15:8];
                                 if (latched_wstrb[2]) seed_reg[23:16] <= latched_wdata[23:16];
                                 if (latched_wstrb[3]) seed_reg[31:24] <= latched_wdata[31:24];
                                 BRESP <= 2'b00;
                             end
-                            2'h3: begin // 0x00C: Read counter (read-only)
+                            5'h03: begin // 0x00C: Read counter (read-only)
+                                BRESP <= 2'b00; // OKAY but ignored
+                            end
+                            5'h04: begin // 0x010: DMA ring base
+                                if (latched_wstrb[0]) dma_base_reg[7:0]   <= latched_wdata[7:0];
+                                if (latched_wstrb[1]) dma_base_reg[15:8]  <= latched_wdata[15:8];
+                                if (latched_wstrb[2]) dma_base_reg[23:16] <= latched_wdata[23:16];
+                                if (latched_wstrb[3]) dma_base_reg[31:24] <= latched_wdata[31:24];
+                                BRESP <= DMA_ENABLE ? 2'b00 : 2'b10;
+                            end
+                            5'h05: begin // 0x014: DMA ring length
+                                if (latched_wstrb[0]) dma_len_reg[7:0]   <= latched_wdata[7:0];
+                                if (latched_wstrb[1]) dma_len_reg[15:8]  <= latched_wdata[15:8];
+                                if (latched_wstrb[2]) dma_len_reg[23:16] <= latched_wdata[23:16];
+                                if (latched_wstrb[3]) dma_len_reg[31:24] <= latched_wdata[31:24];
+                                BRESP <= DMA_ENABLE ? 2'b00 : 2'b10;
+                            end
+                            5'h06: begin // 0x018: DMA control (bit 0 enable, bit 1 clear)
+                                if (latched_wstrb[0]) begin
+                                    dma_enable <= latched_wdata[0];
+                                    dma_clear  <= latched_wdata[1];
+                                end
+                                BRESP <= DMA_ENABLE ? 2'b00 : 2'b10;
+                            end
+                            5'h07: begin // 0x01C: DMA producer index (read-only)
+                                BRESP <= DMA_ENABLE ? 2'b00 : 2'b10;
+                            end
+                            5'h08: begin // 0x020: DMA consumer index
+                                if (latched_wstrb[0]) dma_cons_reg[7:0]   <= latched_wdata[7:0];
+                                if (latched_wstrb[1]) dma_cons_reg[15:8]  <= latched_wdata[15:8];
+                                if (latched_wstrb[2]) dma_cons_reg[23:16] <= latched_wdata[23:16];
+                                if (latched_wstrb[3]) dma_cons_reg[31:24] <= latched_wdata[31:24];
+                                BRESP <= DMA_ENABLE ? 2'b00 : 2'b10;
+                            end
+                            5'h10: begin // 0x040: Performance counters (bit 0 snapshot, bit 1 clear)
+                                if (latched_wstrb[0]) begin
+                                    perf_snapshot <= latched_wdata[0];
+                                    perf_clear    <= latched_wdata[1];
+                                end
+                                BRESP <= 2'b00;
+                            end
+                            5'h11, 5'h12, 5'h13, 5'h14, 5'h15, 5'h16, 5'h17, 5'h18: begin // 0x044-0x060: Snapshots (read-only)
                                 BRESP <= 2'b00; // OKAY but ignored
                             end
+                            default: begin
+                                BRESP <= 2'b10; // SLVERR
+                            end
                         endcase
                     end else begin
                         // Out of range - return error
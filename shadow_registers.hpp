@@ -0,0 +1,192 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+
+#include "register_manager.hpp"
+#include "registers.hpp"
+
+/**
+ * @brief How far a register's last known value can be trusted.
+ */
+enum class ShadowPolicy : uint8_t
+{
+    Volatile,   // Hardware may change it at any time: every read goes to the bus
+    WriteOwned, // Only this process writes it: reads and read-modify-writes use the shadow
+    Constant    // Never changes (identity registers): read from the bus once, then from the shadow
+};
+
+/**
+ * @brief The policy a register gets unless overridden: LED and RNG control
+ * registers are owned by whoever drives them, identity registers are fixed,
+ * and everything else (counters, status, FIFOs) is volatile.
+ */
+[[nodiscard]] constexpr ShadowPolicy default_shadow_policy(uint64_t const physical_base, uint32_t const offset)
+{
+    switch (physical_base)
+    {
+    case SCC_BASE_ADDR:
+        return offset == SCCRegister::SCC_LED ? ShadowPolicy::WriteOwned : ShadowPolicy::Volatile;
+    case APB_BASE_ADDR:
+        return offset == APBRegister::SYS_LED                                        ? ShadowPolicy::WriteOwned
+               : offset == APBRegister::SYS_ID || offset == APBRegister::SYS_PROC_ID1 ? ShadowPolicy::Constant
+                                                                                      : ShadowPolicy::Volatile;
+    case AXI_BASE_ADDR:
+        return offset == AXIRegister::AMS_RNGCTRL ? ShadowPolicy::WriteOwned : ShadowPolicy::Volatile;
+    default:
+        return ShadowPolicy::Volatile;
+    }
+}
+
+/**
+ * @brief A shadow copy of one mapping's registers in front of its RegisterManager.
+ *
+ * Writes always reach the bus and update the shadow. Reads of write-owned and
+ * constant registers are served from the shadow once it holds a value (the
+ * first read fills it), so modify() on a write-owned register costs a single
+ * store. Volatile registers behave exactly as through the manager. Reads
+ * served from the shadow are not logged or traced, since they never reach
+ * the bus. Not thread-safe: give each thread its own shadow, or guard it.
+ */
+class ShadowRegisters
+{
+public:
+    /**
+     * @brief Bus traffic through this shadow, and what it saved.
+     */
+    struct Counters
+    {
+        uint64_t bus_reads{0};
+        uint64_t bus_writes{0};
+        uint64_t reads_avoided{0}; // Reads and read-modify-writes answered from the shadow
+    };
+
+    /**
+     * @brief Constructor: Applies default_shadow_policy() to every register of the mapping.
+     * @param reg_access The mapping to shadow; must outlive this object.
+     */
+    explicit ShadowRegisters(RegisterManager const &reg_access) : m_reg_access(reg_access)
+    {
+        for (uint32_t index{0}; index < m_entries.size(); ++index)
+        {
+            m_entries[index].policy = default_shadow_policy(reg_access.physicalBase(), index * sizeof(uint32_t));
+        }
+    }
+
+    /**
+     * @brief Sets a register's policy and forgets its shadow value.
+     */
+    template <typename T>
+    void setPolicy(T const &reg, ShadowPolicy const policy)
+    {
+        Entry &shadow{entry(static_cast<uint32_t>(reg))};
+        shadow.policy = policy;
+        shadow.valid = false;
+    }
+
+    template <typename T>
+    [[nodiscard]] ShadowPolicy policy(T const &reg) const
+    {
+        return m_entries[static_cast<uint32_t>(reg) / sizeof(uint32_t)].policy;
+    }
+
+    /**
+     * @brief Reads a register, from the shadow when its policy allows.
+     */
+    template <typename T>
+    uint32_t read(T const &reg)
+    {
+        Entry &shadow{entry(static_cast<uint32_t>(reg))};
+        if (shadow.valid && shadow.policy != ShadowPolicy::Volatile)
+        {
+            ++m_counters.reads_avoided;
+            return shadow.value;
+        }
+        ++m_counters.bus_reads;
+        shadow.value = m_reg_access.readReg(reg);
+        shadow.valid = true;
+        return shadow.value;
+    }
+
+    /**
+     * @brief Writes a register and records the value in its shadow.
+     * @throws std::runtime_error If the register is constant.
+     */
+    template <typename T>
+    void write(T const &reg, uint32_t const value)
+    {
+        Entry &shadow{entry(static_cast<uint32_t>(reg))};
+        if (shadow.policy == ShadowPolicy::Constant)
+        {
+            throw std::runtime_error(std::string("Error: cannot write constant register ") + (+reg)._to_string() + ".");
+        }
+        ++m_counters.bus_writes;
+        m_reg_access.writeReg(reg, value);
+        shadow.value = value;
+        shadow.valid = true;
+    }
+
+    /**
+     * @brief Clears then sets bits: (value & ~clear_mask) | set_mask. Write-owned
+     * registers with a known value skip the read.
+     * @return The value written.
+     */
+    template <typename T>
+    uint32_t modify(T const &reg, uint32_t const clear_mask, uint32_t const set_mask)
+    {
+        uint32_t const value{(read(reg) & ~clear_mask) | set_mask};
+        write(reg, value);
+        return value;
+    }
+
+    /**
+     * @brief Forgets every shadow value, e.g. after the hardware has been reset behind our back.
+     */
+    void invalidate()
+    {
+        for (auto &shadow : m_entries)
+        {
+            shadow.valid = false;
+        }
+    }
+
+    [[nodiscard]] Counters const &counters() const
+    {
+        return m_counters;
+    }
+
+    /**
+     * @brief Prints the counters as "[SHADOW] NAME: ...".
+     */
+    void print_counters(char const *name, std::ostream &stream) const
+    {
+        uint64_t const reads{m_counters.bus_reads + m_counters.reads_avoided};
+        stream << "[SHADOW] " << name << ": " << m_counters.bus_reads << " bus reads, " << m_counters.bus_writes << " bus writes, "
+               << m_counters.reads_avoided << " reads avoided (" << (reads ? 100 * m_counters.reads_avoided / reads : 0) << "% of reads)"
+               << std::endl;
+    }
+
+private:
+    struct Entry
+    {
+        uint32_t value{0};
+        ShadowPolicy policy{ShadowPolicy::Volatile};
+        bool valid{false};
+    };
+
+    RegisterManager const &m_reg_access;
+    std::array<Entry, MAP_SIZE / sizeof(uint32_t)> m_entries{};
+    Counters m_counters{};
+
+    Entry &entry(uint32_t const offset)
+    {
+        if (offset >= MAP_SIZE || offset % sizeof(uint32_t) != 0)
+        {
+            throw std::runtime_error("Error: register offset outside the mapped page.");
+        }
+        return m_entries[offset / sizeof(uint32_t)];
+    }
+};
@@ -0,0 +1,863 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Decoding uses the baseline vector ISA of the target (SSE2 on x86-64, NEON on
+// AArch64); define TELEMETRY_NO_SIMD to build the scalar decoder instead.
+#if !defined(TELEMETRY_NO_SIMD) && defined(__SSE2__)
+#define TELEMETRY_SIMD_SSE2
+#include <emmintrin.h>
+#elif !defined(TELEMETRY_NO_SIMD) && defined(__ARM_NEON)
+#define TELEMETRY_SIMD_NEON
+#include <arm_neon.h>
+#endif
+
+/**
+ * @brief Block-compressed register time series.
+ *
+ * A capture is a sequence of rows: a timestamp plus one 32-bit value per
+ * column (register). Rows are grouped into blocks, and within a block each
+ * column - the timestamps included - is stored as one of:
+ *   - Delta:        zig-zag(v[i] - v[i-1])                           (slowly changing values)
+ *   - DeltaOfDelta: zig-zag((v[i] - v[i-1]) - (v[i-1] - v[i-2])) (counters and timestamps)
+ *   - Xor:          v[i] ^ v[i-1]                                    (noisy values, as in Gorilla)
+ * whichever packs smallest. Residuals are bit-packed at one width per column
+ * per block, with the few that do not fit stored as patches (PFOR), so one
+ * late sample does not widen the whole block. Arithmetic is modulo 2^32, so
+ * wrapping counters such as SYS_24MHZ cost nothing extra.
+ *
+ * File layout: TelemetryFileHeader, blocks, a block index, TelemetryTrailer.
+ * The index holds each block's offset and time range, so readers can seek to a
+ * time without decoding what precedes it. All fields are host byte order.
+ */
+constexpr char TELEMETRY_MAGIC[4]{'R', 'G', 'T', 'S'};
+constexpr char TELEMETRY_INDEX_MAGIC[4]{'R', 'G', 'T', 'I'};
+constexpr uint32_t TELEMETRY_VERSION{1};
+constexpr uint32_t TELEMETRY_MAX_COLUMNS{16};
+constexpr uint32_t TELEMETRY_NAME_BYTES{32};
+constexpr uint32_t TELEMETRY_MAX_BLOCK_SAMPLES{65536}; // Patch indices are 16-bit
+
+enum class TelemetryEncoding : uint8_t
+{
+    Delta,
+    DeltaOfDelta,
+    Xor
+};
+
+struct TelemetryFileHeader
+{
+    char magic[4];
+    uint32_t version;
+    uint32_t column_count;      // Value columns, excluding the timestamp
+    uint32_t timestamp_unit_ns; // Timestamps are stored in multiples of this
+    uint32_t block_samples;     // Rows per full block
+    uint32_t reserved;
+    char names[TELEMETRY_MAX_COLUMNS][TELEMETRY_NAME_BYTES];
+};
+
+struct TelemetryBlockHeader
+{
+    uint32_t sample_count;
+    uint32_t payload_bytes;   // Column data following this header
+    uint64_t first_timestamp; // In timestamp units; the timestamp column is relative to it
+};
+
+struct TelemetryColumnHeader
+{
+    uint8_t encoding;         // TelemetryEncoding
+    uint8_t width;            // Bits per packed residual
+    uint16_t patch_count;     // Residuals wider than 'width'
+    uint32_t first;           // v[0]
+    uint32_t base;            // v[1] - v[0], for DeltaOfDelta
+    uint32_t packed_bytes;    // Followed by patch_count uint16 indices, then patch_count uint32 high bits
+};
+
+struct TelemetryIndexEntry
+{
+    uint64_t offset;          // File offset of the TelemetryBlockHeader
+    uint64_t first_timestamp_ns;
+    uint64_t last_timestamp_ns;
+    uint32_t sample_count;
+    uint32_t reserved;
+};
+
+struct TelemetryTrailer
+{
+    uint64_t index_offset;
+    uint32_t block_count;
+    char magic[4];
+};
+
+static_assert(sizeof(TelemetryBlockHeader) == 16 && sizeof(TelemetryColumnHeader) == 16 && sizeof(TelemetryIndexEntry) == 32 && sizeof(TelemetryTrailer) == 16,
+              "telemetry structures are written as-is");
+
+namespace telemetry_detail
+{
+
+[[nodiscard]] constexpr uint32_t zigzag(uint32_t const value)
+{
+    return (value << 1) ^ (0u - (value >> 31));
+}
+
+[[nodiscard]] constexpr uint32_t unzigzag(uint32_t const value)
+{
+    return (value >> 1) ^ (0u - (value & 1));
+}
+
+[[nodiscard]] constexpr unsigned bit_length(uint32_t const value)
+{
+    return value ? 32 - static_cast<unsigned>(__builtin_clz(value)) : 0;
+}
+
+/**
+ * @brief Replaces data[i] with seed + data[0] + ... + data[i], zig-zag decoding each term first if ZigZag.
+ */
+template <bool ZigZag>
+void prefix_sum(uint32_t *data, size_t const count, uint32_t seed)
+{
+    size_t i{0};
+#if defined(TELEMETRY_SIMD_SSE2)
+    __m128i carry{_mm_set1_epi32(static_cast<int>(seed))};
+    __m128i const one{_mm_set1_epi32(1)};
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i x{_mm_loadu_si128(reinterpret_cast<__m128i const *>(data + i))};
+        if constexpr (ZigZag)
+        {
+            x = _mm_xor_si128(_mm_srli_epi32(x, 1), _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(x, one)));
+        }
+        x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+        x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+        x = _mm_add_epi32(x, carry);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(data + i), x);
+        carry = _mm_shuffle_epi32(x, 0xFF);
+    }
+    seed = static_cast<uint32_t>(_mm_cvtsi128_si32(carry));
+#elif defined(TELEMETRY_SIMD_NEON)
+    uint32x4_t carry{vdupq_n_u32(seed)};
+    uint32x4_t const zero{vdupq_n_u32(0)};
+    for (; i + 4 <= count; i += 4)
+    {
+        uint32x4_t x{vld1q_u32(data + i)};
+        if constexpr (ZigZag)
+        {
+            x = veorq_u32(vshrq_n_u32(x, 1), vsubq_u32(zero, vandq_u32(x, vdupq_n_u32(1))));
+        }
+        x = vaddq_u32(x, vextq_u32(zero, x, 3));
+        x = vaddq_u32(x, vextq_u32(zero, x, 2));
+        x = vaddq_u32(x, carry);
+        vst1q_u32(data + i, x);
+        carry = vdupq_n_u32(vgetq_lane_u32(x, 3));
+    }
+    seed = vgetq_lane_u32(carry, 0);
+#endif
+    for (; i < count; ++i)
+    {
+        seed += ZigZag ? unzigzag(data[i]) : data[i];
+        data[i] = seed;
+    }
+}
+
+/**
+ * @brief Two zig-zag prefix sums in one pass: the first seeded with 'base' gives the deltas, the second seeded with 'first' the values.
+ */
+inline void prefix_sum2(uint32_t *data, size_t const count, uint32_t base, uint32_t first)
+{
+    size_t i{0};
+#if defined(TELEMETRY_SIMD_SSE2)
+    __m128i delta{_mm_set1_epi32(static_cast<int>(base))};
+    __m128i value{_mm_set1_epi32(static_cast<int>(first))};
+    __m128i const one{_mm_set1_epi32(1)};
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i x{_mm_loadu_si128(reinterpret_cast<__m128i const *>(data + i))};
+        x = _mm_xor_si128(_mm_srli_epi32(x, 1), _mm_sub_epi32(_mm_setzero_si128(), _mm_and_si128(x, one)));
+        x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+        x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+        x = _mm_add_epi32(x, delta);
+        delta = _mm_shuffle_epi32(x, 0xFF);
+        x = _mm_add_epi32(x, _mm_slli_si128(x, 4));
+        x = _mm_add_epi32(x, _mm_slli_si128(x, 8));
+        x = _mm_add_epi32(x, value);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(data + i), x);
+        value = _mm_shuffle_epi32(x, 0xFF);
+    }
+    base = static_cast<uint32_t>(_mm_cvtsi128_si32(delta));
+    first = static_cast<uint32_t>(_mm_cvtsi128_si32(value));
+#elif defined(TELEMETRY_SIMD_NEON)
+    uint32x4_t delta{vdupq_n_u32(base)};
+    uint32x4_t value{vdupq_n_u32(first)};
+    uint32x4_t const zero{vdupq_n_u32(0)};
+    for (; i + 4 <= count; i += 4)
+    {
+        uint32x4_t x{vld1q_u32(data + i)};
+        x = veorq_u32(vshrq_n_u32(x, 1), vsubq_u32(zero, vandq_u32(x, vdupq_n_u32(1))));
+        x = vaddq_u32(x, vextq_u32(zero, x, 3));
+        x = vaddq_u32(x, vextq_u32(zero, x, 2));
+        x = vaddq_u32(x, delta);
+        delta = vdupq_n_u32(vgetq_lane_u32(x, 3));
+        x = vaddq_u32(x, vextq_u32(zero, x, 3));
+        x = vaddq_u32(x, vextq_u32(zero, x, 2));
+        x = vaddq_u32(x, value);
+        vst1q_u32(data + i, x);
+        value = vdupq_n_u32(vgetq_lane_u32(x, 3));
+    }
+    base = vgetq_lane_u32(delta, 0);
+    first = vgetq_lane_u32(value, 0);
+#endif
+    for (; i < count; ++i)
+    {
+        base += unzigzag(data[i]);
+        first += base;
+        data[i] = first;
+    }
+}
+
+/**
+ * @brief Replaces data[i] with seed ^ data[0] ^ ... ^ data[i].
+ */
+inline void prefix_xor(uint32_t *data, size_t const count, uint32_t seed)
+{
+    size_t i{0};
+#if defined(TELEMETRY_SIMD_SSE2)
+    __m128i carry{_mm_set1_epi32(static_cast<int>(seed))};
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i x{_mm_loadu_si128(reinterpret_cast<__m128i const *>(data + i))};
+        x = _mm_xor_si128(x, _mm_slli_si128(x, 4));
+        x = _mm_xor_si128(x, _mm_slli_si128(x, 8));
+        x = _mm_xor_si128(x, carry);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(data + i), x);
+        carry = _mm_shuffle_epi32(x, 0xFF);
+    }
+    seed = static_cast<uint32_t>(_mm_cvtsi128_si32(carry));
+#elif defined(TELEMETRY_SIMD_NEON)
+    uint32x4_t carry{vdupq_n_u32(seed)};
+    uint32x4_t const zero{vdupq_n_u32(0)};
+    for (; i + 4 <= count; i += 4)
+    {
+        uint32x4_t x{vld1q_u32(data + i)};
+        x = veorq_u32(x, vextq_u32(zero, x, 3));
+        x = veorq_u32(x, vextq_u32(zero, x, 2));
+        x = veorq_u32(x, carry);
+        vst1q_u32(data + i, x);
+        carry = vdupq_n_u32(vgetq_lane_u32(x, 3));
+    }
+    seed = vgetq_lane_u32(carry, 0);
+#endif
+    for (; i < count; ++i)
+    {
+        seed ^= data[i];
+        data[i] = seed;
+    }
+}
+
+/**
+ * @brief Writes out[i] = base + relative[i] * unit, widening to 64 bits.
+ */
+inline void widen_timestamps(uint32_t const *relative, size_t const count, uint64_t const base, uint32_t const unit, uint64_t *out)
+{
+    size_t i{0};
+#if defined(TELEMETRY_SIMD_SSE2)
+    __m128i const bases{_mm_set1_epi64x(static_cast<long long>(base))};
+    __m128i const units{_mm_set1_epi32(static_cast<int>(unit))};
+    __m128i const zero{_mm_setzero_si128()};
+    for (; i + 4 <= count; i += 4)
+    {
+        __m128i const x{_mm_loadu_si128(reinterpret_cast<__m128i const *>(relative + i))};
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_add_epi64(bases, _mm_mul_epu32(_mm_unpacklo_epi32(x, zero), units)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i + 2), _mm_add_epi64(bases, _mm_mul_epu32(_mm_unpackhi_epi32(x, zero), units)));
+    }
+#elif defined(TELEMETRY_SIMD_NEON)
+    uint64x2_t const bases{vdupq_n_u64(base)};
+    uint32x2_t const units{vdup_n_u32(unit)};
+    for (; i + 4 <= count; i += 4)
+    {
+        uint32x4_t const x{vld1q_u32(relative + i)};
+        vst1q_u64(out + i, vaddq_u64(bases, vmull_u32(vget_low_u32(x), units)));
+        vst1q_u64(out + i + 2, vaddq_u64(bases, vmull_u32(vget_high_u32(x), units)));
+    }
+#endif
+    for (; i < count; ++i)
+    {
+        out[i] = base + uint64_t{relative[i]} * unit;
+    }
+}
+
+template <unsigned Width, size_t... Fields>
+inline void unpack_group(uint8_t const *packed, uint32_t *out, std::index_sequence<Fields...>)
+{
+    constexpr uint64_t mask{(uint64_t{1} << Width) - 1};
+    uint64_t word;
+    ((std::memcpy(&word, packed + Fields * Width / 8, sizeof(word)), out[Fields] = static_cast<uint32_t>((word >> (Fields * Width % 8)) & mask)), ...);
+}
+
+/**
+ * @brief Unpacks groups of eight Width-bit fields, which occupy exactly Width bytes.
+ *
+ * With the width a template parameter every field is a 64-bit load at a
+ * constant offset, a constant shift and a mask. The group is expanded field
+ * by field in unpack_group, since GCC at -O2 keeps a loop over the fields and
+ * shifts by a register. Stops before a group whose loads would run past the end.
+ * @return The number of fields unpacked (a multiple of eight).
+ */
+template <unsigned Width>
+size_t unpack_groups(uint8_t const *packed, size_t const packed_bytes, size_t const count, uint32_t *out)
+{
+    size_t const groups{std::min(count / 8, packed_bytes >= sizeof(uint64_t) ? (packed_bytes - sizeof(uint64_t)) / Width : 0)};
+    for (size_t group{0}; group < groups; ++group, packed += Width, out += 8)
+    {
+        unpack_group<Width>(packed, out, std::make_index_sequence<8>{});
+    }
+    return groups * 8;
+}
+
+template <unsigned... Widths>
+constexpr auto make_unpackers(std::integer_sequence<unsigned, Widths...>)
+{
+    using Unpacker = size_t (*)(uint8_t const *, size_t, size_t, uint32_t *);
+    return std::array<Unpacker, sizeof...(Widths)>{&unpack_groups<Widths + 1>...};
+}
+
+/**
+ * @brief Unpacks 'count' little-endian 'width'-bit fields.
+ *
+ * The bulk goes through an unpacker specialised for the width; the last few
+ * fields, where a 64-bit load would run past the packed bytes, are assembled
+ * bytewise.
+ */
+inline void unpack(uint8_t const *packed, size_t const packed_bytes, unsigned const width, size_t const count, uint32_t *out)
+{
+    if (width == 0)
+    {
+        std::fill(out, out + count, 0u);
+        return;
+    }
+    static constexpr auto unpackers{make_unpackers(std::make_integer_sequence<unsigned, 32>{})};
+    size_t i{unpackers[width - 1](packed, packed_bytes, count, out)};
+
+    uint64_t const mask{(uint64_t{1} << width) - 1};
+    for (size_t bit{i * width}; i < count; ++i, bit += width)
+    {
+        uint64_t word{0};
+        for (size_t byte{bit >> 3}, shift{0}; byte < packed_bytes && shift < 64; ++byte, shift += 8)
+        {
+            word |= uint64_t{packed[byte]} << shift;
+        }
+        out[i] = static_cast<uint32_t>((word >> (bit & 7)) & mask);
+    }
+}
+
+inline void pack(uint32_t const *values, size_t const count, unsigned const width, std::string &out)
+{
+    size_t const start{out.size()};
+    out.resize(start + (count * width + 7) / 8, '\0');
+    if (width == 0)
+    {
+        return;
+    }
+    uint64_t const mask{(uint64_t{1} << width) - 1};
+    size_t bit{0};
+    for (size_t i{0}; i < count; ++i, bit += width)
+    {
+        uint64_t field{(values[i] & mask) << (bit & 7)};
+        for (size_t byte{start + (bit >> 3)}; field != 0; ++byte, field >>= 8)
+        {
+            out[byte] = static_cast<char>(static_cast<uint8_t>(out[byte]) | static_cast<uint8_t>(field));
+        }
+    }
+}
+
+template <typename T>
+void append_raw(std::string &out, T const &value)
+{
+    out.append(reinterpret_cast<char const *>(&value), sizeof(value));
+}
+
+/**
+ * @brief Picks the packed width minimising packed bits plus patch cost.
+ * @param residuals The residuals to pack.
+ * @param count The number of residuals.
+ * @param bits Receives the total encoded size in bits.
+ * @return The chosen width.
+ */
+inline unsigned choose_width(uint32_t const *residuals, size_t const count, size_t &bits)
+{
+    constexpr size_t PATCH_BITS{(sizeof(uint16_t) + sizeof(uint32_t)) * 8};
+    std::array<size_t, 33> histogram{};
+    for (size_t i{0}; i < count; ++i)
+    {
+        ++histogram[bit_length(residuals[i])];
+    }
+
+    // Walk widths from widest down, accumulating how many residuals would need patches
+    unsigned best_width{32};
+    bits = count * 32;
+    size_t wider{0};
+    for (unsigned width{32}; width-- > 0;)
+    {
+        wider += histogram[width + 1];
+        size_t const cost{count * width + wider * PATCH_BITS};
+        if (cost <= bits)
+        {
+            bits = cost;
+            best_width = width;
+        }
+    }
+    return best_width;
+}
+
+/**
+ * @brief Encodes one column of a block, choosing the smallest encoding.
+ */
+inline void encode_column(uint32_t const *values, size_t const count, std::vector<uint32_t> &scratch, std::string &out)
+{
+    size_t const residual_count{count - 1};
+    scratch.resize(3 * residual_count);
+    uint32_t *const delta{scratch.data()};
+    uint32_t *const delta_of_delta{delta + residual_count};
+    uint32_t *const xored{delta_of_delta + residual_count};
+
+    uint32_t const base{count > 1 ? values[1] - values[0] : 0};
+    uint32_t previous_delta{base};
+    for (size_t i{1}; i < count; ++i)
+    {
+        uint32_t const d{values[i] - values[i - 1]};
+        delta[i - 1] = zigzag(d);
+        delta_of_delta[i - 1] = zigzag(d - previous_delta);
+        xored[i - 1] = values[i] ^ values[i - 1];
+        previous_delta = d;
+    }
+
+    TelemetryColumnHeader header{};
+    header.first = values[0];
+    header.base = base;
+    uint32_t const *residuals{nullptr};
+    size_t best_bits{SIZE_MAX};
+    for (auto const encoding : {TelemetryEncoding::DeltaOfDelta, TelemetryEncoding::Delta, TelemetryEncoding::Xor})
+    {
+        uint32_t const *const candidate{encoding == TelemetryEncoding::Delta          ? delta
+                                        : encoding == TelemetryEncoding::DeltaOfDelta ? delta_of_delta
+                                                                                      : xored};
+        size_t bits{0};
+        unsigned const width{choose_width(candidate, residual_count, bits)};
+        if (bits < best_bits)
+        {
+            best_bits = bits;
+            residuals = candidate;
+            header.encoding = static_cast<uint8_t>(encoding);
+            header.width = static_cast<uint8_t>(width);
+        }
+    }
+
+    std::vector<uint16_t> patch_index;
+    std::vector<uint32_t> patch_high;
+    if (header.width < 32)
+    {
+        for (size_t i{0}; i < residual_count; ++i)
+        {
+            if (residuals[i] >> header.width)
+            {
+                patch_index.push_back(static_cast<uint16_t>(i));
+                patch_high.push_back(residuals[i] >> header.width);
+            }
+        }
+    }
+    header.patch_count = static_cast<uint16_t>(patch_index.size());
+    header.packed_bytes = static_cast<uint32_t>((residual_count * header.width + 7) / 8);
+
+    append_raw(out, header);
+    pack(residuals, residual_count, header.width, out);
+    out.append(reinterpret_cast<char const *>(patch_index.data()), patch_index.size() * sizeof(uint16_t));
+    out.append(reinterpret_cast<char const *>(patch_high.data()), patch_high.size() * sizeof(uint32_t));
+}
+
+/**
+ * @brief Decodes one column of a block into out[0..count).
+ * @return The byte after the column.
+ */
+inline uint8_t const *decode_column(uint8_t const *cursor, uint8_t const *end, size_t const count, uint32_t *out)
+{
+    TelemetryColumnHeader header;
+    if (static_cast<size_t>(end - cursor) < sizeof(header))
+    {
+        throw std::runtime_error("Error: telemetry column header is truncated.");
+    }
+    std::memcpy(&header, cursor, sizeof(header));
+    cursor += sizeof(header);
+
+    size_t const residual_count{count - 1};
+    size_t const patch_bytes{header.patch_count * (sizeof(uint16_t) + sizeof(uint32_t))};
+    if (header.encoding > static_cast<uint8_t>(TelemetryEncoding::Xor) || header.width > 32 || header.packed_bytes != (residual_count * header.width + 7) / 8 ||
+        static_cast<size_t>(end - cursor) < header.packed_bytes + patch_bytes || (header.width == 32 && header.patch_count != 0))
+    {
+        throw std::runtime_error("Error: telemetry column is corrupt.");
+    }
+
+    out[0] = header.first;
+    uint32_t *const residuals{out + 1};
+    unpack(cursor, header.packed_bytes, header.width, residual_count, residuals);
+    cursor += header.packed_bytes;
+
+    uint8_t const *const high{cursor + header.patch_count * sizeof(uint16_t)};
+    for (size_t patch{0}; patch < header.patch_count; ++patch)
+    {
+        uint16_t index;
+        uint32_t bits;
+        std::memcpy(&index, cursor + patch * sizeof(index), sizeof(index));
+        std::memcpy(&bits, high + patch * sizeof(bits), sizeof(bits));
+        if (index >= residual_count)
+        {
+            throw std::runtime_error("Error: telemetry column patch is out of range.");
+        }
+        residuals[index] |= bits << header.width;
+    }
+    cursor += patch_bytes;
+
+    switch (static_cast<TelemetryEncoding>(header.encoding))
+    {
+    case TelemetryEncoding::Delta:
+        prefix_sum<true>(residuals, residual_count, header.first);
+        break;
+    case TelemetryEncoding::DeltaOfDelta:
+        prefix_sum2(residuals, residual_count, header.base, header.first);
+        break;
+    case TelemetryEncoding::Xor:
+        prefix_xor(residuals, residual_count, header.first);
+        break;
+    }
+    return cursor;
+}
+
+} // namespace telemetry_detail
+
+/**
+ * @brief Streams rows into a telemetry file, compressing a block at a time.
+ */
+class TelemetryWriter
+{
+public:
+    /**
+     * @brief Constructor: Creates the file and writes its header.
+     * @param path The file to create (truncated if it exists).
+     * @param columns Column names, at most TELEMETRY_MAX_COLUMNS (names are truncated to TELEMETRY_NAME_BYTES - 1).
+     * @param timestamp_unit_ns Timestamp resolution; timestamps are rounded down to it.
+     * @param block_samples Rows per block; larger blocks compress better, smaller ones seek finer.
+     */
+    TelemetryWriter(std::string const &path, std::vector<std::string> const &columns, uint32_t const timestamp_unit_ns = 1000,
+           uint32_t const block_samples = 1024)
+        : m_path(path), m_file(path, std::ios::binary | std::ios::trunc), m_columns(static_cast<uint32_t>(columns.size())),
+          m_unit_ns(timestamp_unit_ns), m_block_samples(block_samples)
+    {
+        if (!m_file)
+        {
+            throw std::runtime_error("Error: could not create telemetry file '" + path + "'.");
+        }
+        if (columns.empty() || columns.size() > TELEMETRY_MAX_COLUMNS || timestamp_unit_ns == 0 || block_samples < 2 ||
+            block_samples > TELEMETRY_MAX_BLOCK_SAMPLES)
+        {
+            throw std::runtime_error("Error: telemetry needs 1-16 columns, a non-zero time unit and 2-65536 rows per block.");
+        }
+
+        TelemetryFileHeader header{};
+        std::memcpy(header.magic, TELEMETRY_MAGIC, sizeof(TELEMETRY_MAGIC));
+        header.version = TELEMETRY_VERSION;
+        header.column_count = m_columns;
+        header.timestamp_unit_ns = m_unit_ns;
+        header.block_samples = m_block_samples;
+        for (size_t column{0}; column < columns.size(); ++column)
+        {
+            columns[column].copy(header.names[column], TELEMETRY_NAME_BYTES - 1);
+        }
+        m_file.write(reinterpret_cast<char const *>(&header), sizeof(header));
+        m_offset = sizeof(header);
+        m_buffer.resize(size_t{m_columns + 1} * m_block_samples);
+    }
+
+    /**
+     * @brief Destructor: Flushes the last block and writes the index, if close() was not called.
+     */
+    ~TelemetryWriter()
+    {
+        try
+        {
+            close();
+        }
+        catch (std::exception const &e)
+        {
+            std::cerr << "[ERROR] " << e.what() << std::endl;
+        }
+    }
+
+    TelemetryWriter(TelemetryWriter const &) = delete;
+    TelemetryWriter &operator=(TelemetryWriter const &) = delete;
+
+    /**
+     * @brief Appends one row. Timestamps must not decrease.
+     * @param timestamp_ns The row's time in nanoseconds (any epoch).
+     * @param values One value per column.
+     */
+    void append(uint64_t const timestamp_ns, uint32_t const *values)
+    {
+        uint64_t const timestamp{timestamp_ns / m_unit_ns};
+        // Block timestamps are 32-bit offsets from the first row
+        if (m_count != 0 && (m_count == m_block_samples || timestamp - m_first_timestamp > UINT32_MAX))
+        {
+            flush();
+        }
+        if (m_count == 0)
+        {
+            m_first_timestamp = timestamp;
+        }
+        m_buffer[m_count] = static_cast<uint32_t>(timestamp - m_first_timestamp);
+        for (uint32_t column{0}; column < m_columns; ++column)
+        {
+            m_buffer[size_t{column + 1} * m_block_samples + m_count] = values[column];
+        }
+        ++m_count;
+        ++m_rows;
+    }
+
+    /**
+     * @brief Flushes the last block and writes the index and trailer. Further appends are an error.
+     */
+    void close()
+    {
+        if (m_closed)
+        {
+            return;
+        }
+        flush();
+        m_closed = true;
+
+        TelemetryTrailer trailer{};
+        trailer.index_offset = m_offset;
+        trailer.block_count = static_cast<uint32_t>(m_index.size());
+        std::memcpy(trailer.magic, TELEMETRY_INDEX_MAGIC, sizeof(TELEMETRY_INDEX_MAGIC));
+        m_file.write(reinterpret_cast<char const *>(m_index.data()), static_cast<std::streamsize>(m_index.size() * sizeof(TelemetryIndexEntry)));
+        m_file.write(reinterpret_cast<char const *>(&trailer), sizeof(trailer));
+        m_offset += m_index.size() * sizeof(TelemetryIndexEntry) + sizeof(trailer);
+        m_file.close();
+        if (!m_file)
+        {
+            throw std::runtime_error("Error: could not write telemetry file '" + m_path + "'.");
+        }
+    }
+
+    [[nodiscard]] uint64_t rows() const
+    {
+        return m_rows;
+    }
+
+    [[nodiscard]] uint64_t bytes() const
+    {
+        return m_offset;
+    }
+
+private:
+    std::string const m_path;
+    std::ofstream m_file;
+    uint32_t const m_columns;
+    uint32_t const m_unit_ns;
+    uint32_t const m_block_samples;
+    std::vector<uint32_t> m_buffer; // Column-major: timestamps, then each value column
+    std::vector<uint32_t> m_scratch;
+    std::vector<TelemetryIndexEntry> m_index;
+    std::string m_block;
+    uint64_t m_first_timestamp{0};
+    uint32_t m_count{0};
+    uint64_t m_rows{0};
+    uint64_t m_offset{0};
+    bool m_closed{false};
+
+    void flush()
+    {
+        if (m_closed)
+        {
+            throw std::runtime_error("Error: telemetry file '" + m_path + "' is already closed.");
+        }
+        if (m_count == 0)
+        {
+            return;
+        }
+
+        m_block.assign(sizeof(TelemetryBlockHeader), '\0');
+        for (uint32_t column{0}; column <= m_columns; ++column)
+        {
+            telemetry_detail::encode_column(m_buffer.data() + size_t{column} * m_block_samples, m_count, m_scratch, m_block);
+        }
+        TelemetryBlockHeader const header{m_count, static_cast<uint32_t>(m_block.size() - sizeof(TelemetryBlockHeader)), m_first_timestamp};
+        std::memcpy(&m_block[0], &header, sizeof(header));
+
+        m_index.push_back(TelemetryIndexEntry{m_offset, m_first_timestamp * m_unit_ns, (m_first_timestamp + m_buffer[m_count - 1]) * m_unit_ns,
+                                     m_count, 0});
+        m_file.write(m_block.data(), static_cast<std::streamsize>(m_block.size()));
+        m_offset += m_block.size();
+        m_count = 0;
+    }
+};
+
+/**
+ * @brief Memory-mapped reader with random access by block or by time.
+ */
+class TelemetryReader
+{
+public:
+    /**
+     * @brief Constructor: Maps the file and loads its index.
+     * @param path The telemetry file to read.
+     */
+    explicit TelemetryReader(std::string const &path)
+    {
+        m_fd = open(path.c_str(), O_RDONLY);
+        if (m_fd == -1)
+        {
+            throw std::runtime_error("Error: could not open telemetry file '" + path + "'.");
+        }
+        struct stat file_stat{};
+        if (fstat(m_fd, &file_stat) == -1 || static_cast<size_t>(file_stat.st_size) < sizeof(TelemetryFileHeader) + sizeof(TelemetryTrailer))
+        {
+            close(m_fd);
+            throw std::runtime_error("Error: '" + path + "' is too short to be a telemetry file.");
+        }
+        m_bytes = static_cast<size_t>(file_stat.st_size);
+        void *const base{mmap(0, m_bytes, PROT_READ, MAP_SHARED, m_fd, 0)};
+        if (base == MAP_FAILED)
+        {
+            close(m_fd);
+            throw std::runtime_error("Error: mmap failed to map telemetry file '" + path + "'.");
+        }
+        m_base = static_cast<uint8_t const *>(base);
+
+        std::memcpy(&m_header, m_base, sizeof(m_header));
+        TelemetryTrailer trailer;
+        std::memcpy(&trailer, m_base + m_bytes - sizeof(trailer), sizeof(trailer));
+        size_t const index_bytes{size_t{trailer.block_count} * sizeof(TelemetryIndexEntry)};
+        if (std::memcmp(m_header.magic, TELEMETRY_MAGIC, sizeof(TELEMETRY_MAGIC)) != 0 || m_header.version != TELEMETRY_VERSION ||
+            m_header.column_count == 0 || m_header.column_count > TELEMETRY_MAX_COLUMNS || m_header.block_samples > TELEMETRY_MAX_BLOCK_SAMPLES ||
+            std::memcmp(trailer.magic, TELEMETRY_INDEX_MAGIC, sizeof(TELEMETRY_INDEX_MAGIC)) != 0 || trailer.index_offset < sizeof(TelemetryFileHeader) ||
+            trailer.index_offset + index_bytes + sizeof(trailer) != m_bytes)
+        {
+            munmap(base, m_bytes);
+            close(m_fd);
+            throw std::runtime_error("Error: '" + path + "' is not a complete version " + std::to_string(TELEMETRY_VERSION) + " telemetry file.");
+        }
+        m_index.resize(trailer.block_count);
+        std::memcpy(m_index.data(), m_base + trailer.index_offset, index_bytes);
+        m_index_offset = trailer.index_offset;
+        for (auto const &entry : m_index)
+        {
+            m_rows += entry.sample_count;
+        }
+    }
+
+    ~TelemetryReader()
+    {
+        munmap(const_cast<uint8_t *>(m_base), m_bytes);
+        close(m_fd);
+    }
+
+    TelemetryReader(TelemetryReader const &) = delete;
+    TelemetryReader &operator=(TelemetryReader const &) = delete;
+
+    [[nodiscard]] uint32_t columns() const
+    {
+        return m_header.column_count;
+    }
+
+    [[nodiscard]] std::string column_name(uint32_t const column) const
+    {
+        return std::string(m_header.names[column], strnlen(m_header.names[column], TELEMETRY_NAME_BYTES));
+    }
+
+    [[nodiscard]] uint32_t timestamp_unit_ns() const
+    {
+        return m_header.timestamp_unit_ns;
+    }
+
+    [[nodiscard]] uint64_t rows() const
+    {
+        return m_rows;
+    }
+
+    [[nodiscard]] size_t blocks() const
+    {
+        return m_index.size();
+    }
+
+    [[nodiscard]] TelemetryIndexEntry const &block(size_t const index) const
+    {
+        return m_index[index];
+    }
+
+    /**
+     * @brief Finds the first block holding rows at or after 'timestamp_ns'.
+     * @return The block index, or blocks() if every row is earlier.
+     */
+    [[nodiscard]] size_t find_block(uint64_t const timestamp_ns) const
+    {
+        return static_cast<size_t>(std::partition_point(m_index.begin(), m_index.end(), [&](TelemetryIndexEntry const &entry)
+                                                        { return entry.last_timestamp_ns < timestamp_ns; }) -
+                                   m_index.begin());
+    }
+
+    /**
+     * @brief Decodes one block.
+     * @param index The block to decode.
+     * @param timestamps_ns Receives block(index).sample_count timestamps.
+     * @param values Receives the values column-major: column c of row i at values[c * sample_count + i].
+     * @param scratch Holds the relative timestamps; reused across calls to avoid allocation.
+     * @return The number of rows decoded.
+     */
+    size_t decode_block(size_t const index, uint64_t *timestamps_ns, uint32_t *values, std::vector<uint32_t> &scratch) const
+    {
+        TelemetryIndexEntry const &entry{m_index[index]};
+        TelemetryBlockHeader header;
+        if (entry.offset + sizeof(header) > m_index_offset)
+        {
+            throw std::runtime_error("Error: telemetry block " + std::to_string(index) + " is out of range.");
+        }
+        std::memcpy(&header, m_base + entry.offset, sizeof(header));
+        uint8_t const *cursor{m_base + entry.offset + sizeof(header)};
+        uint8_t const *const end{cursor + header.payload_bytes};
+        if (header.sample_count != entry.sample_count || header.sample_count == 0 || end > m_base + m_index_offset)
+        {
+            throw std::runtime_error("Error: telemetry block " + std::to_string(index) + " is corrupt.");
+        }
+
+        size_t const count{header.sample_count};
+        scratch.resize(count);
+        cursor = telemetry_detail::decode_column(cursor, end, count, scratch.data());
+        for (uint32_t column{0}; column < m_header.column_count; ++column)
+        {
+            cursor = telemetry_detail::decode_column(cursor, end, count, values + column * count);
+        }
+        uint32_t const unit{m_header.timestamp_unit_ns};
+        telemetry_detail::widen_timestamps(scratch.data(), count, header.first_timestamp * unit, unit, timestamps_ns);
+        return count;
+    }
+
+private:
+    int m_fd{-1};
+    uint8_t const *m_base{nullptr};
+    size_t m_bytes{0};
+    TelemetryFileHeader m_header{};
+    std::vector<TelemetryIndexEntry> m_index;
+    uint64_t m_index_offset{0};
+    uint64_t m_rows{0};
+};
+
@@ -0,0 +1,278 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <limits>
+#include <string>
+#include <thread>
+#include <vector>
+#include <time.h>
+
+#include "cpu_topology.hpp"
+#include "register_manager.hpp"
+#include "register_ops.hpp"
+#include "registers.hpp"
+
+/**
+ * @brief What a worker thread does, which decides where it runs.
+ */
+enum class ThreadRole : uint8_t
+{
+    Hot,        // Polls or harvests registers on a deadline (sampler, pollers)
+    Background  // Logging, compression, clock refresh: throughput matters, latency does not
+};
+
+/**
+ * @brief Chooses CPUs for register-heavy threads on big.LITTLE and homogeneous hosts alike.
+ *
+ * calibrate() pins a probe thread to each online CPU in turn and times reads
+ * of one side-effect-free register in each mapped region (SCC_LED, SYS_ID,
+ * AMS_RNGCNT). Hot threads go to the CPU with the lowest total read latency;
+ * CPUs within TIE_FRACTION of it are treated as equal and the higher capacity,
+ * then higher id (away from CPU 0's interrupt load) wins. Background threads
+ * get the lower-capacity cores (the A53 cluster on Juno), or on a homogeneous
+ * host every CPU except the hot one. from_topology() makes the same choice
+ * from cpu_capacity alone, without touching the bus.
+ */
+class ThreadPlacement
+{
+public:
+    static constexpr unsigned DEFAULT_READS{4096};  // Reads per CPU and region
+    static constexpr unsigned BATCH_READS{32};      // Reads per timed batch; the median batch is kept
+    static constexpr double TIE_FRACTION{0.05};
+
+    /**
+     * @brief One CPU's measured read latency per region, in ns (NaN if the region is not mapped).
+     */
+    struct CoreLatency
+    {
+        CpuInfo cpu;
+        bool available{false}; // False if the probe could not be pinned there (e.g. outside our cpuset)
+        std::array<double, REGISTER_REGION_NAMES.size()> read_ns{};
+    };
+
+    /**
+     * @brief Places threads by cpu_capacity alone.
+     */
+    [[nodiscard]] static ThreadPlacement from_topology()
+    {
+        ThreadPlacement placement;
+        for (auto const &cpu : CpuTopology::online())
+        {
+            CoreLatency core{cpu, true, {}};
+            core.read_ns.fill(std::numeric_limits<double>::quiet_NaN());
+            placement.m_cores.push_back(core);
+        }
+        placement.m_hot = CpuTopology::fastest_cpu();
+        placement.choose_background();
+        return placement;
+    }
+
+    /**
+     * @brief Measures per-core read latency to each mapped region and places threads by it.
+     * @param regions The open mapping for each region.
+     * @param reads Reads per CPU and region.
+     */
+    [[nodiscard]] static ThreadPlacement calibrate(RegisterRegions const &regions, unsigned const reads = DEFAULT_READS)
+    {
+        ThreadPlacement placement;
+        placement.m_measured = true;
+        for (auto const &cpu : CpuTopology::online())
+        {
+            CoreLatency core{cpu, false, {}};
+            core.read_ns.fill(std::numeric_limits<double>::quiet_NaN());
+            // A fresh thread per CPU, so the caller's own affinity is left alone
+            std::thread probe([&]
+            {
+                if (CpuTopology::pin_current_thread(cpu.id))
+                {
+                    core.available = true;
+                    measure(regions, std::max(reads, BATCH_READS), core.read_ns);
+                }
+            });
+            probe.join();
+            placement.m_cores.push_back(core);
+        }
+
+        double best{std::numeric_limits<double>::infinity()};
+        for (auto const &core : placement.m_cores)
+        {
+            if (core.available)
+            {
+                best = std::min(best, total_ns(core));
+            }
+        }
+        CoreLatency const *hot{nullptr};
+        for (auto const &core : placement.m_cores)
+        {
+            if (core.available && total_ns(core) <= best * (1 + TIE_FRACTION) &&
+                (!hot || core.cpu.capacity > hot->cpu.capacity || (core.cpu.capacity == hot->cpu.capacity && core.cpu.id > hot->cpu.id)))
+            {
+                hot = &core;
+            }
+        }
+        placement.m_hot = hot ? hot->cpu.id : CpuTopology::fastest_cpu();
+        placement.choose_background();
+        return placement;
+    }
+
+    /**
+     * @brief Returns the CPUs a thread with the given role should run on.
+     */
+    [[nodiscard]] std::vector<unsigned> cpus(ThreadRole const role) const
+    {
+        return role == ThreadRole::Hot ? std::vector<unsigned>{m_hot} : m_background;
+    }
+
+    [[nodiscard]] unsigned hot_cpu() const
+    {
+        return m_hot;
+    }
+
+    /**
+     * @brief Pins the calling thread to the CPUs for its role.
+     * @return True on success.
+     */
+    bool pin(ThreadRole const role) const
+    {
+        return CpuTopology::pin_current_thread(cpus(role));
+    }
+
+    /**
+     * @brief Prints the per-core latency table (when measured) and the chosen placement.
+     */
+    void print_report(std::ostream &stream) const
+    {
+        stream << std::left << std::setw(12) << "[PLACE] cpu" << std::right << std::setw(10) << "capacity" << std::setw(9) << "cluster";
+        if (m_measured)
+        {
+            for (auto const *name : REGISTER_REGION_NAMES)
+            {
+                stream << std::setw(9) << name << " ns";
+            }
+        }
+        stream << "  role\n";
+        for (auto const &core : m_cores)
+        {
+            stream << "[PLACE] " << std::left << std::setw(4) << core.cpu.id << std::right << std::setw(10) << core.cpu.capacity
+                   << std::setw(9) << core.cpu.cluster;
+            if (m_measured)
+            {
+                for (double const ns : core.read_ns)
+                {
+                    stream << std::setw(12);
+                    if (std::isnan(ns))
+                    {
+                        stream << '-';
+                    }
+                    else
+                    {
+                        stream << std::fixed << std::setprecision(1) << ns;
+                    }
+                }
+            }
+            stream << "  "
+                   << (!core.available                                                              ? "unavailable"
+                       : core.cpu.id == m_hot                                                       ? "hot"
+                       : std::count(m_background.begin(), m_background.end(), core.cpu.id) != 0 ? "background"
+                                                                                                    : "-")
+                   << '\n';
+        }
+        stream << "[PLACE] Hot threads on CPU " << m_hot << ", background threads on CPU";
+        for (unsigned const cpu : m_background)
+        {
+            stream << ' ' << cpu;
+        }
+        stream << (m_measured ? " (by measured read latency)" : " (by cpu_capacity)") << std::defaultfloat << std::endl;
+    }
+
+private:
+    bool m_measured{false};
+    std::vector<CoreLatency> m_cores;
+    unsigned m_hot{0};
+    std::vector<unsigned> m_background;
+
+    [[nodiscard]] static uint64_t now_ns()
+    {
+        timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return static_cast<uint64_t>(ts.tv_sec) * 1'000'000'000 + static_cast<uint64_t>(ts.tv_nsec);
+    }
+
+    [[nodiscard]] static double total_ns(CoreLatency const &core)
+    {
+        double total{0};
+        for (double const ns : core.read_ns)
+        {
+            total += std::isnan(ns) ? 0 : ns;
+        }
+        return total;
+    }
+
+    // Median batch time per read: robust to the odd interrupt landing in a batch
+    static void measure(RegisterRegions const &regions, unsigned const reads,
+                        std::array<double, REGISTER_REGION_NAMES.size()> &read_ns)
+    {
+        constexpr std::array<uint32_t, REGISTER_REGION_NAMES.size()> offsets{SCCRegister::SCC_LED, APBRegister::SYS_ID,
+                                                                             AXIRegister::AMS_RNGCNT};
+        std::vector<uint64_t> batches(reads / BATCH_READS);
+        for (size_t region{0}; region < regions.size(); ++region)
+        {
+            if (!regions[region])
+            {
+                continue;
+            }
+            RegisterManager const &manager{*regions[region]};
+            for (unsigned warmup{0}; warmup < BATCH_READS; ++warmup)
+            {
+                manager.readOffset(offsets[region]);
+            }
+            for (auto &batch : batches)
+            {
+                uint64_t const start{now_ns()};
+                for (unsigned read{0}; read < BATCH_READS; ++read)
+                {
+                    manager.readOffset(offsets[region]);
+                }
+                batch = now_ns() - start;
+            }
+            std::nth_element(batches.begin(), batches.begin() + batches.size() / 2, batches.end());
+            read_ns[region] = static_cast<double>(batches[batches.size() / 2]) / BATCH_READS;
+        }
+    }
+
+    // LITTLE cores if there are any, otherwise everything but the hot CPU
+    void choose_background()
+    {
+        unsigned top_capacity{0};
+        for (auto const &core : m_cores)
+        {
+            top_capacity = core.available ? std::max(top_capacity, core.cpu.capacity) : top_capacity;
+        }
+        for (auto const &core : m_cores)
+        {
+            if (core.available && core.cpu.capacity < top_capacity)
+            {
+                m_background.push_back(core.cpu.id);
+            }
+        }
+        if (m_background.empty())
+        {
+            for (auto const &core : m_cores)
+            {
+                if (core.available && core.cpu.id != m_hot)
+                {
+                    m_background.push_back(core.cpu.id);
+                }
+            }
+        }
+        if (m_background.empty())
+        {
+            m_background.push_back(m_hot);
+        }
+    }
+};